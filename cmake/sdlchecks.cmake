@@ -998,18 +998,39 @@ macro(CheckPTHREAD)
         endif()
       endif()
 
+      if(SDL_LINUX_FUTEX AND HAVE_GCC_ATOMICS)
+        check_c_source_compiles("
+            #include <linux/futex.h>
+            #include <sys/syscall.h>
+            #include <unistd.h>
+            int main(int argc, char **argv) {
+              int word = 0;
+              return (int) syscall(SYS_futex, &word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+            }" HAVE_LINUX_FUTEX)
+      endif()
+
       set(SOURCE_FILES ${SOURCE_FILES}
           ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_systhread.c
-          ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_sysmutex.c   # Can be faked, if necessary
-          ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_syscond.c    # Can be faked, if necessary
           ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_systls.c
           )
-      if(HAVE_PTHREADS_SEM)
+      if(HAVE_LINUX_FUTEX)
+        set(SDL_THREAD_LINUX_FUTEX 1)
         set(SOURCE_FILES ${SOURCE_FILES}
-            ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_syssem.c)
+            ${SDL2_SOURCE_DIR}/src/thread/linux/SDL_sysmutex.c
+            ${SDL2_SOURCE_DIR}/src/thread/linux/SDL_syscond.c
+            ${SDL2_SOURCE_DIR}/src/thread/linux/SDL_syssem.c)
       else()
         set(SOURCE_FILES ${SOURCE_FILES}
-            ${SDL2_SOURCE_DIR}/src/thread/generic/SDL_syssem.c)
+            ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_sysmutex.c   # Can be faked, if necessary
+            ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_syscond.c    # Can be faked, if necessary
+            )
+        if(HAVE_PTHREADS_SEM)
+          set(SOURCE_FILES ${SOURCE_FILES}
+              ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_syssem.c)
+        else()
+          set(SOURCE_FILES ${SOURCE_FILES}
+              ${SDL2_SOURCE_DIR}/src/thread/generic/SDL_syssem.c)
+        endif()
       endif()
       set(HAVE_SDL_THREADS TRUE)
     endif()
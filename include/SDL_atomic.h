@@ -137,6 +137,46 @@ extern DECLSPEC void SDLCALL SDL_AtomicLock(SDL_SpinLock *lock);
  */
 extern DECLSPEC void SDLCALL SDL_AtomicUnlock(SDL_SpinLock *lock);
 
+/**
+ * Contention statistics for SDL's spin locks, for profiling.
+ *
+ * These are process-wide totals across every SDL_SpinLock, including the
+ * ones SDL uses internally.
+ *
+ * \sa SDL_AtomicGetSpinLockStats
+ */
+typedef struct SDL_SpinLockStats
+{
+    Uint32 contended;   /**< SDL_AtomicLock() calls that found the lock already held */
+    Uint32 spins;       /**< Backoff rounds spent spinning while waiting for a lock */
+    Uint32 waits;       /**< Times a waiting thread slept or yielded the CPU */
+} SDL_SpinLockStats;
+
+/**
+ * Get the spin lock contention statistics collected so far.
+ *
+ * Statistics are only collected when SDL itself is built with
+ * SDL_SPINLOCK_STATS defined to 1, and on platforms with native atomic
+ * operations; otherwise all counters are zero. The counters wrap around on
+ * overflow.
+ *
+ * \param stats a pointer filled in with the current statistics
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_AtomicResetSpinLockStats
+ */
+extern DECLSPEC void SDLCALL SDL_AtomicGetSpinLockStats(SDL_SpinLockStats *stats);
+
+/**
+ * Reset the spin lock contention statistics to zero.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_AtomicGetSpinLockStats
+ */
+extern DECLSPEC void SDLCALL SDL_AtomicResetSpinLockStats(void);
+
 /* @} *//* SDL AtomicLock */
 
 
@@ -637,6 +637,141 @@ extern DECLSPEC SDL_AudioDeviceID SDLCALL SDL_OpenAudioDevice(
                                                   SDL_AudioSpec *obtained,
                                                   int allowed_changes);
 
+/**
+ * Open an output audio device that the application feeds directly.
+ *
+ * A device opened this way has no audio callback and no audio thread.
+ * Instead, the application calls SDL_GetAudioDeviceBuffer() to get the
+ * driver's buffer, writes one buffer's worth of audio into it, and hands it
+ * back with SDL_PlayAudioDeviceBuffer(). This avoids the extra period of
+ * latency and the copy of the callback model, so `obtained` always contains
+ * the device's native format: SDL won't convert anything, and any changes
+ * from `desired` are allowed. The callback in `desired` is ignored.
+ *
+ * Typically, an application runs its own audio thread:
+ *
+ * ```c
+ * while (running) {
+ *     int len;
+ *     Uint8 *buf = SDL_GetAudioDeviceBuffer(dev, &len);  // waits for the device
+ *     mix_audio(buf, len, SDL_GetAudioDeviceDelay(dev));
+ *     SDL_PlayAudioDeviceBuffer(dev);
+ * }
+ * ```
+ *
+ * Pull mode isn't available with audio drivers that run their own audio
+ * thread, such as PipeWire, CoreAudio or Android.
+ *
+ * \param device a UTF-8 string reported by SDL_GetAudioDeviceName(); see
+ *               SDL_OpenAudioDevice()
+ * \param desired an SDL_AudioSpec structure representing the desired output
+ *                format; the callback is ignored
+ * \param obtained an SDL_AudioSpec structure filled in with the device's
+ *                 actual output format
+ * \returns a valid device ID that is > 0 on success or 0 on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_CloseAudioDevice
+ * \sa SDL_GetAudioDeviceBuffer
+ * \sa SDL_GetAudioDeviceDelay
+ * \sa SDL_OpenAudioDevice
+ * \sa SDL_PlayAudioDeviceBuffer
+ */
+extern DECLSPEC SDL_AudioDeviceID SDLCALL SDL_OpenAudioDevicePull(
+                                                  const char *device,
+                                                  const SDL_AudioSpec *desired,
+                                                  SDL_AudioSpec *obtained);
+
+/**
+ * Get the next buffer to fill on an audio device opened in pull mode.
+ *
+ * This waits until the device can take more audio, and returns the memory
+ * to write the next buffer to, in the device's format. The buffer stays
+ * valid until it is handed back with SDL_PlayAudioDeviceBuffer(); calling
+ * this function again before then returns the same buffer.
+ *
+ * A pull mode device should only be fed from one thread at a time.
+ *
+ * \param dev the ID of an audio device opened with SDL_OpenAudioDevicePull()
+ * \param len a pointer filled in with the size of the buffer in bytes, may be
+ *            NULL
+ * \returns the buffer to write audio to or NULL on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_OpenAudioDevicePull
+ * \sa SDL_PlayAudioDeviceBuffer
+ */
+extern DECLSPEC Uint8 *SDLCALL SDL_GetAudioDeviceBuffer(SDL_AudioDeviceID dev, int *len);
+
+/**
+ * Play the buffer returned by SDL_GetAudioDeviceBuffer().
+ *
+ * The whole buffer is played, so it must have been filled completely.
+ *
+ * \param dev the ID of an audio device opened with SDL_OpenAudioDevicePull()
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_GetAudioDeviceBuffer
+ * \sa SDL_OpenAudioDevicePull
+ */
+extern DECLSPEC int SDLCALL SDL_PlayAudioDeviceBuffer(SDL_AudioDeviceID dev);
+
+/**
+ * Get how long until audio written now to an output device will be heard.
+ *
+ * This is the number of sample frames between the next frame given to the
+ * device and the frame currently being played, as reported by the audio
+ * backend where possible (for example, by ALSA, PulseAudio and PipeWire),
+ * so audio can be scheduled precisely. When the backend can't tell, it is
+ * estimated from when the last buffer was played. Audio drivers that run
+ * their own audio thread, such as CoreAudio, may not support this at all.
+ *
+ * This works with devices in pull mode, using a callback, or queueing
+ * audio; for the latter two, it doesn't include the audio in the callback
+ * or queue that hasn't been given to the device yet.
+ *
+ * \param dev the ID of an output audio device
+ * \returns the number of sample frames, at the device's frequency, or a
+ *          negative error code on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_OpenAudioDevicePull
+ * \sa SDL_GetAudioDeviceBuffer
+ */
+extern DECLSPEC int SDLCALL SDL_GetAudioDeviceDelay(SDL_AudioDeviceID dev);
+
+/**
+ * Get how much audio an audio device has played or captured so far.
+ *
+ * This is the device's own clock: the number of sample frames it has
+ * played (not counting audio that was given to it but isn't audible yet,
+ * see SDL_GetAudioDeviceDelay()) or captured since it was opened,
+ * converted to nanoseconds at the device's frequency.
+ *
+ * When the disk or dummy driver runs on a virtual clock (see
+ * SDL_HINT_AUDIO_VIRTUAL_CLOCK), this advances by exactly one buffer per
+ * buffer played and is fully deterministic, so code that paces itself by
+ * the audio should read this instead of SDL_GetTicks().
+ *
+ * \param dev the ID of an audio device
+ * \returns the time in nanoseconds, or 0 on failure; call SDL_GetError() for
+ *          more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_GetAudioDeviceDelay
+ */
+extern DECLSPEC Uint64 SDLCALL SDL_GetAudioDeviceTimeNS(SDL_AudioDeviceID dev);
+
 
 
 /**
@@ -1082,6 +1217,150 @@ extern DECLSPEC void SDLCALL SDL_AudioStreamClear(SDL_AudioStream *stream);
  */
 extern DECLSPEC void SDLCALL SDL_FreeAudioStream(SDL_AudioStream *stream);
 
+/* WAVE streaming decoder */
+struct _SDL_WAVDecoder;
+typedef struct _SDL_WAVDecoder SDL_WAVDecoder;
+
+/**
+ * Open a WAVE file for decoding on demand.
+ *
+ * Unlike SDL_LoadWAV_RW(), this doesn't read or decode the audio data up
+ * front. The data is decoded as it's needed, an ADPCM block at a time, so
+ * memory use stays small no matter how long the file is, and playback can
+ * start right away. The file can be in any format SDL_LoadWAV_RW()
+ * supports, and the decoded audio is the same.
+ *
+ * The decoder reads from `src` as it goes, so `src` must stay valid and
+ * should not be used by anything else until the decoder is closed. A
+ * decoder is not thread safe.
+ *
+ * \param src the data source for the WAVE data
+ * \param freesrc if non-zero, `src` is closed when the decoder is closed
+ *                (or immediately, if opening fails)
+ * \param spec an SDL_AudioSpec that will be filled in with the format of
+ *             the decoded audio, as SDL_LoadWAV_RW() would
+ * \returns a new decoder, or NULL on error; call SDL_GetError() for more
+ *          information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_CloseWAVDecoder
+ * \sa SDL_WAVDecoderRead
+ * \sa SDL_WAVDecoderPutStream
+ * \sa SDL_WAVDecoderSeek
+ */
+extern DECLSPEC SDL_WAVDecoder *SDLCALL SDL_OpenWAVDecoder_RW(SDL_RWops *src,
+                                                              int freesrc,
+                                                              SDL_AudioSpec *spec);
+
+/**
+ *  Opens a WAVE file for decoding on demand.
+ *  Convenience macro, like SDL_LoadWAV().
+ */
+#define SDL_OpenWAVDecoder(file, spec) \
+    SDL_OpenWAVDecoder_RW(SDL_RWFromFile(file, "rb"), 1, spec)
+
+/**
+ * Decode audio from a WAVE decoder.
+ *
+ * Only whole sample frames are decoded, so the amount returned is a multiple
+ * of the frame size even if `len` is not.
+ *
+ * \param decoder the decoder to read from
+ * \param buf a buffer to fill with decoded audio
+ * \param len the maximum number of bytes to fill
+ * \returns the number of bytes decoded, 0 at the end of the data, or -1 on
+ *          error; call SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_OpenWAVDecoder_RW
+ * \sa SDL_WAVDecoderPutStream
+ */
+extern DECLSPEC int SDLCALL SDL_WAVDecoderRead(SDL_WAVDecoder *decoder, void *buf, int len);
+
+/**
+ * Decode audio from a WAVE decoder straight into an audio stream.
+ *
+ * This is like SDL_WAVDecoderRead() followed by SDL_AudioStreamPut(), but
+ * needs no buffer of its own. The stream's source format must match the
+ * spec reported by SDL_OpenWAVDecoder_RW(). Calling this whenever
+ * SDL_AudioStreamAvailable() runs low keeps a long file playing with
+ * bounded memory.
+ *
+ * \param decoder the decoder to read from
+ * \param stream the audio stream to put the decoded audio into
+ * \param len the maximum number of bytes to decode
+ * \returns the number of bytes put into the stream, 0 at the end of the
+ *          data, or -1 on error; call SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_OpenWAVDecoder_RW
+ * \sa SDL_AudioStreamPut
+ */
+extern DECLSPEC int SDLCALL SDL_WAVDecoderPutStream(SDL_WAVDecoder *decoder, SDL_AudioStream *stream, int len);
+
+/**
+ * Move a WAVE decoder to a sample frame.
+ *
+ * Seeking is cheap: nothing is read until audio is decoded again, and then
+ * only the ADPCM block containing the frame needs decoding.
+ *
+ * \param decoder the decoder to seek
+ * \param frame the sample frame to decode next, from 0 to the value of
+ *              SDL_WAVDecoderLength()
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_WAVDecoderTell
+ * \sa SDL_WAVDecoderLength
+ */
+extern DECLSPEC int SDLCALL SDL_WAVDecoderSeek(SDL_WAVDecoder *decoder, Sint64 frame);
+
+/**
+ * Get the sample frame a WAVE decoder will decode next.
+ *
+ * \param decoder the decoder to query
+ * \returns the sample frame, or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_WAVDecoderSeek
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_WAVDecoderTell(SDL_WAVDecoder *decoder);
+
+/**
+ * Get the number of sample frames a WAVE decoder can decode.
+ *
+ * \param decoder the decoder to query
+ * \returns the number of sample frames, or a negative error code on
+ *          failure; call SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_WAVDecoderSeek
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_WAVDecoderLength(SDL_WAVDecoder *decoder);
+
+/**
+ * Close a WAVE decoder.
+ *
+ * If the decoder was opened with `freesrc`, its data source is closed too.
+ * Otherwise, the data source is left at the end of the WAVE data, as after
+ * SDL_LoadWAV_RW(). It is safe to call this function with a NULL pointer.
+ *
+ * \param decoder the decoder to close
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_OpenWAVDecoder_RW
+ */
+extern DECLSPEC void SDLCALL SDL_CloseWAVDecoder(SDL_WAVDecoder *decoder);
+
 #define SDL_MIX_MAXVOLUME 128
 
 /**
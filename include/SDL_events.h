@@ -851,6 +851,49 @@ extern DECLSPEC void SDLCALL SDL_FlushEvents(Uint32 minType, Uint32 maxType);
  */
 extern DECLSPEC int SDLCALL SDL_PollEvent(SDL_Event * event);
 
+/**
+ * Poll for all currently pending events in a range of types.
+ *
+ * This pumps the event loop once and then moves up to `numevents` events
+ * with types between `minType` and `maxType`, inclusive, from the queue into
+ * `events`, taking the event queue lock only once for the whole batch. Events
+ * outside of the range are left on the queue.
+ *
+ * This is equivalent to calling SDL_PollEvent() until it returns 0, but is
+ * much cheaper when many events are queued, e.g. from high rate mice:
+ *
+ * ```c
+ * SDL_Event events[64];
+ * int i, count;
+ * while ((count = SDL_PollEvents(events, SDL_arraysize(events), SDL_FIRSTEVENT, SDL_LASTEVENT)) > 0) {
+ *     for (i = 0; i < count; ++i) {
+ *         // decide what to do with events[i].
+ *     }
+ * }
+ * ```
+ *
+ * As this function implicitly calls SDL_PumpEvents(), you can only call this
+ * function in the thread that set the video mode.
+ *
+ * \param events an array of SDL_Event structures to be filled with events
+ *               from the queue
+ * \param numevents the maximum number of events to retrieve
+ * \param minType minimum value of the event type to be retrieved; see
+ *                SDL_EventType for details
+ * \param maxType maximum value of the event type to be retrieved; see
+ *                SDL_EventType for details
+ * \returns the number of events stored in `events` or a negative error code
+ *          on failure; call SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_PeepEvents
+ * \sa SDL_PollEvent
+ * \sa SDL_PumpEvents
+ */
+extern DECLSPEC int SDLCALL SDL_PollEvents(SDL_Event * events, int numevents,
+                                           Uint32 minType, Uint32 maxType);
+
 /**
  * Wait indefinitely for the next available event.
  *
@@ -934,6 +977,60 @@ extern DECLSPEC int SDLCALL SDL_WaitEventTimeout(SDL_Event * event,
  */
 extern DECLSPEC int SDLCALL SDL_PushEvent(SDL_Event * event);
 
+/**
+ * Retrieve raw motion samples that were recorded while coalescing events.
+ *
+ * When SDL_HINT_EVENT_COALESCING is set to "2", every motion event added to
+ * the queue is also recorded, whether or not it was merged, so applications
+ * that need every sample (for example for drawing or gesture analysis) can
+ * read them in bulk while still polling one merged event per device. The
+ * most recent 1024 samples are kept; older samples are discarded.
+ *
+ * Samples are returned oldest first and removed from the history.
+ *
+ * This function is thread-safe.
+ *
+ * \param events an array of events to fill with samples
+ * \param numevents the maximum number of samples to return
+ * \returns the number of samples returned, or a negative error code on
+ *          failure; call SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_HINT_EVENT_COALESCING
+ */
+extern DECLSPEC int SDLCALL SDL_GetMotionHistory(SDL_Event * events, int numevents);
+
+/**
+ * Get the high resolution timestamp of an event.
+ *
+ * Events queued by SDL carry a nanosecond timestamp in addition to the
+ * millisecond `timestamp` field, measured against SDL_GetTicksNS(). Where
+ * the platform reports when input was generated (for example the kernel
+ * time of Linux evdev and joystick events), that time is used instead of
+ * the time the event was queued, and the millisecond field is derived from
+ * it.
+ *
+ * Events returned by SDL_PollEvent(), SDL_WaitEvent(), SDL_PeepEvents() and
+ * SDL_GetMotionHistory() carry it in space the event structures don't use,
+ * so it is preserved when the event is copied as a whole SDL_Event. Event
+ * filters and watchers can query the event they are given. For other
+ * events, events whose `type` or `timestamp` were changed, and for
+ * SDL_TEXTEDITING events, this returns the millisecond timestamp converted
+ * to nanoseconds. SDL_PushEvent() only updates the `timestamp` field of the
+ * event passed to it.
+ *
+ * \param event the event to query
+ * \returns the event timestamp in nanoseconds since SDL library
+ *          initialization.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_GetTicksNS
+ * \sa SDL_PushEvent
+ */
+extern DECLSPEC Uint64 SDLCALL SDL_GetEventTimestampNS(const SDL_Event * event);
+
 /**
  * A function pointer used for callbacks that watch the event queue.
  *
@@ -1018,7 +1115,8 @@ extern DECLSPEC SDL_bool SDLCALL SDL_GetEventFilter(SDL_EventFilter * filter,
  * ignored.
  *
  * **WARNING**: Be very careful of what you do in the event filter function,
- * as it may run in a different thread!
+ * as it may run in a different thread! As of SDL 2.0.20, events pushed from
+ * several threads are dispatched to the watchers concurrently.
  *
  * If the quit event is generated by a signal (e.g. SIGINT), it will bypass
  * the internal queue and be delivered to the watch callback immediately, and
@@ -167,6 +167,62 @@ extern DECLSPEC int SDLCALL SDL_GameControllerAddMappingsFromRW(SDL_RWops * rw,
  */
 #define SDL_GameControllerAddMappingsFromFile(file)   SDL_GameControllerAddMappingsFromRW(SDL_RWFromFile(file, "rb"), 1)
 
+/**
+ * Load a set of mappings from a binary mapping cache.
+ *
+ * A mapping cache holds the whole mappings database of a platform, as
+ * written by SDL_GameControllerSaveMappingCacheRW(). Loading it doesn't need
+ * to parse any text, so it's a faster alternative to
+ * SDL_GameControllerAddMappingsFromRW() for large databases: write the cache
+ * once after loading the text databases, and load it at startup instead.
+ *
+ * The cache is kept in memory until all of its mappings have been used or
+ * replaced. A cache written for a different platform is rejected.
+ *
+ * You can also set SDL_HINT_GAMECONTROLLERCONFIG_CACHE_FILE to have a cache
+ * loaded when the game controller subsystem is initialized.
+ *
+ * \param rw the data stream for the mapping cache
+ * \param freerw non-zero to close the stream after being read
+ * \returns the number of mappings added or -1 on error; call SDL_GetError()
+ *          for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_GameControllerAddMappingsFromCacheFile
+ * \sa SDL_GameControllerSaveMappingCacheRW
+ */
+extern DECLSPEC int SDLCALL SDL_GameControllerAddMappingsFromCacheRW(SDL_RWops * rw, int freerw);
+
+/**
+ *  Load a set of mappings from a binary mapping cache file
+ *
+ *  Convenience macro.
+ */
+#define SDL_GameControllerAddMappingsFromCacheFile(file)   SDL_GameControllerAddMappingsFromCacheRW(SDL_RWFromFile(file, "rb"), 1)
+
+/**
+ * Write the current mappings database as a binary mapping cache.
+ *
+ * \param rw the data stream to write the mapping cache to
+ * \param freerw non-zero to close the stream after being written
+ * \returns the number of mappings written or -1 on error; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_GameControllerAddMappingsFromCacheRW
+ * \sa SDL_GameControllerSaveMappingCacheFile
+ */
+extern DECLSPEC int SDLCALL SDL_GameControllerSaveMappingCacheRW(SDL_RWops * rw, int freerw);
+
+/**
+ *  Write the current mappings database to a binary mapping cache file
+ *
+ *  Convenience macro.
+ */
+#define SDL_GameControllerSaveMappingCacheFile(file)   SDL_GameControllerSaveMappingCacheRW(SDL_RWFromFile(file, "wb"), 1)
+
 /**
  * Add support for controllers that SDL is unaware of or to cause an existing
  * controller to have a different binding.
@@ -294,6 +294,27 @@ extern "C" {
  */
 #define SDL_HINT_AUDIO_RESAMPLING_MODE   "SDL_AUDIO_RESAMPLING_MODE"
 
+/**
+ *  \brief  A variable controlling whether the disk and dummy audio drivers run on a virtual clock.
+ *
+ *  Normally these drivers sleep between buffers to simulate a real device
+ *  playing in real time. With a virtual clock they don't sleep at all: each
+ *  buffer advances the device's simulated time by exactly one buffer's worth
+ *  of audio, and the audio callback runs as fast as the CPU allows. This
+ *  makes it possible to render long stretches of audio through the whole
+ *  audio pipeline in a short, reproducible amount of time. Code that needs
+ *  to follow the simulated time should use SDL_GetAudioDeviceTimeNS() instead
+ *  of SDL_GetTicks(). While a device is paused, its simulated time stands
+ *  still and nothing is played.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - The disk and dummy drivers play in real time (default)
+ *    "1"       - The disk and dummy drivers run on a virtual clock
+ *
+ *  This hint is checked when an audio device is opened.
+ */
+#define SDL_HINT_AUDIO_VIRTUAL_CLOCK "SDL_AUDIO_VIRTUAL_CLOCK"
+
 /**
  *  \brief  A variable controlling whether SDL updates joystick state when getting input events
  *
@@ -351,6 +372,20 @@ extern "C" {
  */
 #define SDL_HINT_DISPLAY_USABLE_BOUNDS "SDL_DISPLAY_USABLE_BOUNDS"
 
+/**
+ *  \brief  A variable controlling whether $1 gestures are recognized on a separate thread.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Gestures are recognized when the finger is lifted, in the thread pushing the touch events (default)
+ *    "1"       - Gestures are recognized on a background thread, and SDL_DOLLARGESTURE is pushed when done
+ *
+ *  With large template libraries loaded through SDL_LoadDollarTemplates(),
+ *  recognition can take a noticeable amount of time, so this keeps it from
+ *  stalling the event loop. SDL_DOLLARGESTURE will then arrive after the
+ *  SDL_FINGERUP event that completed the gesture.
+ */
+#define SDL_HINT_DOLLAR_GESTURE_THREAD "SDL_DOLLAR_GESTURE_THREAD"
+
 /**
  *  \brief Disable giving back control to the browser automatically
  *  when running with asyncify
@@ -412,6 +447,28 @@ extern "C" {
  */
 #define SDL_HINT_EVENT_LOGGING   "SDL_EVENT_LOGGING"
 
+/**
+ *  \brief  A variable controlling whether consecutive motion events are merged in the event queue.
+ *
+ *  This variable can be set to the following values:
+ *
+ *    "0"     - Queue every motion event (default)
+ *    "1"     - Merge motion events into the last queued event when it is a
+ *              motion event for the same device and window.
+ *    "2"     - Merge motion events, and also keep the raw samples so they can
+ *              be retrieved with SDL_GetMotionHistory().
+ *
+ *  This covers SDL_MOUSEMOTION, SDL_FINGERMOTION, SDL_SENSORUPDATE and
+ *  SDL_CONTROLLERSENSORUPDATE. A merged event has the latest position and
+ *  sensor values, the sum of the relative motion, and the latest timestamp,
+ *  so the queue length no longer depends on the device polling rate. Events
+ *  are only merged with the end of the queue, so ordering relative to other
+ *  events such as button presses is preserved.
+ *
+ *  This hint can be toggled on and off at runtime.
+ */
+#define SDL_HINT_EVENT_COALESCING   "SDL_EVENT_COALESCING"
+
 /**
  *  \brief  A variable controlling how 3D acceleration is used to accelerate the SDL screen surface.
  *
@@ -449,6 +506,18 @@ extern "C" {
  */
 #define SDL_HINT_GAMECONTROLLERCONFIG_FILE "SDL_GAMECONTROLLERCONFIG_FILE"
 
+/**
+ *  \brief  A variable that lets you provide a binary mapping cache with gamecontroller db entries.
+ *
+ *  The file should be written by SDL_GameControllerSaveMappingCacheRW(), see SDL_gamecontroller.h
+ *
+ *  The cache is loaded before SDL_HINT_GAMECONTROLLERCONFIG_FILE and SDL_HINT_GAMECONTROLLERCONFIG,
+ *  so mappings from those take precedence.
+ *
+ *  This hint must be set before calling SDL_Init(SDL_INIT_GAMECONTROLLER)
+ */
+#define SDL_HINT_GAMECONTROLLERCONFIG_CACHE_FILE "SDL_GAMECONTROLLERCONFIG_CACHE_FILE"
+
 /**
  *  \brief  A variable that overrides the automatic controller type detection
  *
@@ -844,6 +913,26 @@ extern "C" {
   */
 #define SDL_HINT_LINUX_JOYSTICK_DEADZONES "SDL_LINUX_JOYSTICK_DEADZONES"
 
+ /**
+  *  \brief  A variable controlling whether the kernel buffers of input devices on Linux are drained by a dedicated thread
+  *
+  *  This variable can be set to the following values:
+  *    "0"       - Input devices are read when events are pumped (the default)
+  *    "1"       - A background thread waits on all evdev and joystick devices and
+  *                drains their kernel buffers as soon as data arrives
+  *
+  *  When enabled, idle devices aren't read each time events are pumped, and
+  *  input isn't dropped by the kernel when the application pumps events
+  *  rarely. This does not make events reach the application sooner: the
+  *  buffered input is still translated into events by SDL_PumpEvents(),
+  *  timestamped with the time the kernel received it, so latency remains
+  *  tied to how often the application pumps events.
+  *
+  *  Controllers opened through HIDAPI are not read by this thread. This hint
+  *  must be set before the video or joystick subsystems are initialized.
+  */
+#define SDL_HINT_LINUX_INPUT_THREAD "SDL_LINUX_INPUT_THREAD"
+
 /**
 *  \brief  When set don't force the SDL app to become a foreground process
 *
@@ -1137,6 +1226,51 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_SCALE_QUALITY       "SDL_RENDER_SCALE_QUALITY"
 
+/**
+ *  \brief  A variable controlling whether batched draws are reordered to share state.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Draws are run in the order they were made
+ *    "1"       - Copies and geometry may be moved past draws they don't overlap
+ *
+ *  When enabled, queued copies and geometry using the same texture, blend
+ *  mode and color are grouped and merged into fewer draw calls, as long as
+ *  nothing drawn in between overlaps them, so the result is unchanged.
+ *  This only has an effect on renderers that batch their draws, is checked
+ *  when the renderer is created, and is disabled by default.
+ */
+#define SDL_HINT_RENDER_SORT_DRAWS          "SDL_RENDER_SORT_DRAWS"
+
+/**
+ *  \brief  A variable controlling whether renderers log their counters every frame.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Don't log the counters
+ *    "1"       - Log the counters of every frame in SDL_RenderPresent()
+ *
+ *  The counters are logged in the SDL_LOG_CATEGORY_RENDER category with
+ *  the debug priority, see SDL_RenderGetStats(). This is checked when the
+ *  renderer is created, and by default nothing is logged.
+ */
+#define SDL_HINT_RENDER_STATS_LOG           "SDL_RENDER_STATS_LOG"
+
+/**
+ *  \brief  A variable controlling whether the renderer draws on a separate thread.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Draw on the thread calling SDL_RenderPresent()
+ *    "1"       - Draw on a render thread, overlapping with the next frame
+ *
+ *  With a render thread, SDL_RenderPresent() hands the frame over and returns
+ *  while it is drawn, and the frame is shown by the next SDL_RenderPresent(),
+ *  so presentation lags one frame behind. Reading pixels, changing the render
+ *  target or updating a texture the frame uses waits for it to finish.
+ *
+ *  This is only supported by the software renderer, and is checked when the
+ *  renderer is created. By default rendering is done on the calling thread.
+ */
+#define SDL_HINT_RENDER_THREAD              "SDL_RENDER_THREAD"
+
 /**
  *  \brief  A variable controlling whether updates to the SDL screen surface should be synchronized with the vertical refresh, to avoid tearing.
  *
@@ -85,6 +85,33 @@ typedef struct SDL_RendererInfo
     int max_texture_height;     /**< The maximum texture height */
 } SDL_RendererInfo;
 
+/**
+ * Counters of the work done by a rendering context, see SDL_RenderGetStats().
+ */
+typedef struct SDL_RenderStats
+{
+    Uint32 frames;              /**< Calls to SDL_RenderPresent() */
+    Uint32 flushes;             /**< Times queued commands were sent to the backend */
+    Uint32 forced_flushes;      /**< Flushes and waits caused by changing a texture in use */
+    Uint32 target_switches;     /**< Render target changes */
+    Uint32 viewport_commands;   /**< Viewport changes */
+    Uint32 cliprect_commands;   /**< Clip rectangle changes */
+    Uint32 color_commands;      /**< Draw color changes */
+    Uint32 clear_commands;      /**< Clears */
+    Uint32 point_commands;      /**< Batches of points */
+    Uint32 line_commands;       /**< Batches of lines */
+    Uint32 rect_commands;       /**< Batches of filled rectangles */
+    Uint32 copy_commands;       /**< Batches of texture copies */
+    Uint32 copy_ex_commands;    /**< Rotated or flipped texture copies */
+    Uint32 geometry_commands;   /**< Batches of geometry */
+    Uint32 draw_calls;          /**< Draw calls issued to the underlying API */
+    Uint32 texture_uploads;     /**< Texture updates and locks */
+    Uint64 vertices;            /**< Vertices drawn */
+    Uint64 vertex_bytes;        /**< Bytes of vertex data sent to the backend */
+    Uint64 texture_upload_bytes;/**< Bytes of texture data updated or locked */
+    Uint64 run_time_ns;         /**< Time spent running commands, in nanoseconds */
+} SDL_RenderStats;
+
 /**
  *  Vertex structure
  */
@@ -147,6 +174,24 @@ typedef struct SDL_Renderer SDL_Renderer;
 struct SDL_Texture;
 typedef struct SDL_Texture SDL_Texture;
 
+/**
+ * A set of shared textures that many small textures are packed into.
+ */
+struct SDL_TextureAtlas;
+typedef struct SDL_TextureAtlas SDL_TextureAtlas;
+
+/**
+ * A recorded sequence of rendering commands that can be replayed.
+ */
+struct SDL_RenderCommandList;
+typedef struct SDL_RenderCommandList SDL_RenderCommandList;
+
+/**
+ * A pending read of the pixels of a rendering target.
+ */
+struct SDL_RenderReadback;
+typedef struct SDL_RenderReadback SDL_RenderReadback;
+
 /* Function prototypes */
 
 /**
@@ -350,6 +395,94 @@ extern DECLSPEC SDL_Texture * SDLCALL SDL_CreateTexture(SDL_Renderer * renderer,
  */
 extern DECLSPEC SDL_Texture * SDLCALL SDL_CreateTextureFromSurface(SDL_Renderer * renderer, SDL_Surface * surface);
 
+/**
+ * Create a texture atlas for a rendering context.
+ *
+ * An atlas packs many small textures into a few large shared textures
+ * ("pages"), each created with `page_w` x `page_h` pixels as they are
+ * needed. Textures created in an atlas can be used with SDL_RenderCopy() and
+ * friends like any other texture, but since they share a page consecutive
+ * copies from the same atlas can be drawn together, avoiding a texture
+ * switch and a draw call per copy.
+ *
+ * Textures in an atlas are static and can't be locked or used as a render
+ * target. They share the scale mode of their page, so changing it on one of
+ * them changes it for every texture on that page.
+ *
+ * \param renderer the rendering context
+ * \param format one of the enumerated values in SDL_PixelFormatEnum, or 0
+ *               to use a format with an alpha channel supported by the
+ *               renderer; FOURCC formats aren't supported
+ * \param page_w the width of each page in pixels
+ * \param page_h the height of each page in pixels
+ * \returns a pointer to the created atlas or NULL on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_CreateAtlasTexture
+ * \sa SDL_CreateAtlasTextureFromSurface
+ * \sa SDL_DestroyTextureAtlas
+ */
+extern DECLSPEC SDL_TextureAtlas * SDLCALL SDL_CreateTextureAtlas(SDL_Renderer * renderer, Uint32 format, int page_w, int page_h);
+
+/**
+ * Allocate a texture in a texture atlas.
+ *
+ * The texture is placed on the first page with enough room, and a new page
+ * is added if none has any. Its contents are undefined until set with
+ * SDL_UpdateTexture().
+ *
+ * The texture can be destroyed with SDL_DestroyTexture(), but the space it
+ * used in the atlas is only reclaimed when the atlas is destroyed.
+ *
+ * \param atlas the texture atlas
+ * \param w the width of the texture in pixels, at most the page width
+ * \param h the height of the texture in pixels, at most the page height
+ * \returns a pointer to the created texture or NULL on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_CreateAtlasTextureFromSurface
+ * \sa SDL_CreateTextureAtlas
+ * \sa SDL_UpdateTexture
+ */
+extern DECLSPEC SDL_Texture * SDLCALL SDL_CreateAtlasTexture(SDL_TextureAtlas * atlas, int w, int h);
+
+/**
+ * Create a texture in a texture atlas from an existing surface.
+ *
+ * The surface is converted to the format of the atlas. As with
+ * SDL_CreateTextureFromSurface(), the color and alpha modulation and the
+ * blend mode of the surface are copied to the texture.
+ *
+ * \param atlas the texture atlas
+ * \param surface the SDL_Surface structure containing pixel data used to
+ *                fill the texture
+ * \returns a pointer to the created texture or NULL on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_CreateAtlasTexture
+ * \sa SDL_CreateTextureAtlas
+ */
+extern DECLSPEC SDL_Texture * SDLCALL SDL_CreateAtlasTextureFromSurface(SDL_TextureAtlas * atlas, SDL_Surface * surface);
+
+/**
+ * Destroy a texture atlas, its pages and every texture created in it.
+ *
+ * Atlases are destroyed automatically when their rendering context is.
+ *
+ * \param atlas the texture atlas to destroy
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_CreateTextureAtlas
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyTextureAtlas(SDL_TextureAtlas * atlas);
+
 /**
  * Query the attributes of a texture.
  *
@@ -1680,6 +1813,75 @@ extern DECLSPEC int SDLCALL SDL_RenderReadPixels(SDL_Renderer * renderer,
                                                  Uint32 format,
                                                  void *pixels, int pitch);
 
+/**
+ * Start reading pixels from the current rendering target, without waiting
+ * for them.
+ *
+ * This is like SDL_RenderReadPixels(), but it returns as soon as the read
+ * has been requested. The OpenGL and OpenGL ES 3 renderers read into a
+ * pixel buffer object and check a fence later, the software renderer
+ * converts the pixels on a worker thread. Other renderers read the pixels
+ * right away. Rendering can go on while the read is pending, it sees what
+ * was drawn before this call.
+ *
+ * Call SDL_RenderGetReadbackPixels() to get the pixels once they're ready,
+ * and SDL_DestroyRenderReadback() when done.
+ *
+ * \param renderer the rendering context
+ * \param rect an SDL_Rect structure representing the area to read, or NULL
+ *             for the entire render target
+ * \param format an SDL_PixelFormatEnum value of the desired format of the
+ *               pixel data, or 0 to use the format of the rendering target
+ * \returns the pending read, or NULL on failure; call SDL_GetError() for
+ *          more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_RenderGetReadbackPixels
+ * \sa SDL_DestroyRenderReadback
+ * \sa SDL_RenderReadPixels
+ */
+extern DECLSPEC SDL_RenderReadback * SDLCALL SDL_RenderReadPixelsAsync(SDL_Renderer * renderer,
+                                                                       const SDL_Rect * rect,
+                                                                       Uint32 format);
+
+/**
+ * Copy the pixels of a read started with SDL_RenderReadPixelsAsync(), if
+ * they're ready.
+ *
+ * This never waits for the read to complete. `pixels` is laid out as for
+ * SDL_RenderReadPixels() with the same rectangle and format. The pixels can
+ * be copied any number of times until the read is destroyed.
+ *
+ * This must be called from the thread that uses the renderer.
+ *
+ * \param readback the pending read
+ * \param pixels a pointer to the pixel data to copy into
+ * \param pitch the pitch of the `pixels` parameter
+ * \returns 0 if the pixels were copied, 1 if they aren't ready yet, or a
+ *          negative error code on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_RenderReadPixelsAsync
+ */
+extern DECLSPEC int SDLCALL SDL_RenderGetReadbackPixels(SDL_RenderReadback * readback,
+                                                        void *pixels, int pitch);
+
+/**
+ * Destroy a read started with SDL_RenderReadPixelsAsync().
+ *
+ * Pending reads are destroyed along with their renderer.
+ *
+ * \param readback the read to destroy
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_RenderReadPixelsAsync
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyRenderReadback(SDL_RenderReadback * readback);
+
 /**
  * Update the screen with any rendering performed since the previous call.
  *
@@ -1774,6 +1976,88 @@ extern DECLSPEC void SDLCALL SDL_DestroyRenderer(SDL_Renderer * renderer);
  */
 extern DECLSPEC int SDLCALL SDL_RenderFlush(SDL_Renderer * renderer);
 
+/**
+ * Start recording rendering commands into a command list.
+ *
+ * Any pending commands are flushed first. Until SDL_RenderEndCommandList()
+ * is called, rendering calls are recorded instead of being drawn, so content
+ * that rarely changes, like a HUD or a tile layer, can be built once and
+ * drawn again each frame with SDL_RenderReplayCommandList(), skipping the
+ * validation and vertex generation of the original calls.
+ *
+ * The render target can't be changed while recording, and SDL_RenderFlush(),
+ * SDL_RenderPresent() and reading pixels fail, since nothing is drawn.
+ * Render scale, logical size, viewport and clip rectangle in effect during
+ * recording are baked into the list. Updating or locking a texture that was
+ * already drawn with during recording invalidates the list, because the
+ * recorded commands would draw with the new contents.
+ *
+ * \param renderer the rendering context
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_RenderEndCommandList
+ * \sa SDL_RenderReplayCommandList
+ */
+extern DECLSPEC int SDLCALL SDL_RenderBeginCommandList(SDL_Renderer * renderer);
+
+/**
+ * Stop recording and return the recorded command list.
+ *
+ * \param renderer the rendering context
+ * \returns the recorded command list, or NULL if the renderer wasn't
+ *          recording or there was an error; call SDL_GetError() for more
+ *          information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_RenderBeginCommandList
+ * \sa SDL_RenderReplayCommandList
+ * \sa SDL_DestroyRenderCommandList
+ */
+extern DECLSPEC SDL_RenderCommandList * SDLCALL SDL_RenderEndCommandList(SDL_Renderer * renderer);
+
+/**
+ * Draw a recorded command list to the current rendering target.
+ *
+ * Pending commands are flushed first, then the list is drawn immediately.
+ * The list can be replayed any number of times. The offset moves everything
+ * drawn by the list along with its viewport; the clip rectangle is relative
+ * to the viewport, so it moves too. SDL_RenderClear() commands still clear
+ * the whole rendering target.
+ *
+ * Destroying a texture used by the list invalidates it, and replaying it
+ * afterwards fails.
+ *
+ * \param renderer the rendering context the list was recorded with
+ * \param list the command list to draw
+ * \param offset an SDL_Point, in pixels of the rendering target, to move
+ *               the drawing by, or NULL to draw it where it was recorded
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_RenderBeginCommandList
+ * \sa SDL_RenderEndCommandList
+ */
+extern DECLSPEC int SDLCALL SDL_RenderReplayCommandList(SDL_Renderer * renderer, SDL_RenderCommandList * list, const SDL_Point * offset);
+
+/**
+ * Destroy a command list.
+ *
+ * Command lists are destroyed along with their renderer.
+ *
+ * \param list the command list to destroy
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_RenderEndCommandList
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyRenderCommandList(SDL_RenderCommandList * list);
+
 
 /**
  * Bind an OpenGL/ES/ES2 texture to the current context.
@@ -1875,6 +2159,42 @@ extern DECLSPEC void *SDLCALL SDL_RenderGetMetalCommandEncoder(SDL_Renderer * re
  */
 extern DECLSPEC int SDLCALL SDL_RenderSetVSync(SDL_Renderer* renderer, int vsync);
 
+/**
+ * Get counters of the work done by a rendering context.
+ *
+ * The counters cover the commands the renderer ran, not the calls made to
+ * it, so they show how well drawing is batched. A frame ends with
+ * SDL_RenderPresent(); commands run on a render thread (see
+ * SDL_HINT_RENDER_THREAD) are counted in the frame they finish in.
+ *
+ * Set SDL_HINT_RENDER_STATS_LOG to log the counters of every frame.
+ *
+ * \param renderer the rendering context
+ * \param total an SDL_RenderStats structure filled with the counters since
+ *              the renderer was created or SDL_RenderResetStats() was
+ *              called, may be NULL
+ * \param frame an SDL_RenderStats structure filled with the counters of the
+ *              last presented frame, may be NULL
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_RenderResetStats
+ */
+extern DECLSPEC int SDLCALL SDL_RenderGetStats(SDL_Renderer * renderer, SDL_RenderStats * total, SDL_RenderStats * frame);
+
+/**
+ * Reset the counters of a rendering context.
+ *
+ * \param renderer the rendering context
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_RenderGetStats
+ */
+extern DECLSPEC void SDLCALL SDL_RenderResetStats(SDL_Renderer * renderer);
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
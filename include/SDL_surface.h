@@ -725,7 +725,16 @@ extern DECLSPEC int SDLCALL SDL_ConvertPixels(int width, int height,
  *
  * This is safe to use with src == dst, but not for other overlapping areas.
  *
- * This function is currently only implemented for SDL_PIXELFORMAT_ARGB8888.
+ * Any combination of formats supported by SDL_ConvertPixels() may be used;
+ * formats without an alpha channel are treated as fully opaque. The
+ * 32-bit formats with an 8-bit alpha channel (SDL_PIXELFORMAT_ARGB8888,
+ * SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_ABGR8888 and
+ * SDL_PIXELFORMAT_BGRA8888) are converted and premultiplied in a single
+ * pass using SIMD where available, other formats go through an
+ * intermediate conversion.
+ *
+ * Each color channel is rounded to the nearest value of `color * alpha /
+ * 255`.
  *
  * \param width the width of the block to convert, in pixels
  * \param height the height of the block to convert, in pixels
@@ -746,6 +755,39 @@ extern DECLSPEC int SDLCALL SDL_PremultiplyAlpha(int width, int height,
                                                  Uint32 dst_format,
                                                  void * dst, int dst_pitch);
 
+/**
+ * Reverse alpha premultiplication on a block of pixels.
+ *
+ * This is safe to use with src == dst, but not for other overlapping areas.
+ *
+ * Each color channel is rounded to the nearest value of `color * 255 /
+ * alpha` and clamped to 255. Fully transparent pixels become transparent
+ * black. Since premultiplication loses precision at low alpha values, this
+ * doesn't exactly restore the colors passed to SDL_PremultiplyAlpha().
+ *
+ * The same formats as SDL_PremultiplyAlpha() are supported.
+ *
+ * \param width the width of the block to convert, in pixels
+ * \param height the height of the block to convert, in pixels
+ * \param src_format an SDL_PixelFormatEnum value of the `src` pixels format
+ * \param src a pointer to the premultiplied source pixels
+ * \param src_pitch the pitch of the source pixels, in bytes
+ * \param dst_format an SDL_PixelFormatEnum value of the `dst` pixels format
+ * \param dst a pointer to be filled in with straight alpha pixel data
+ * \param dst_pitch the pitch of the destination pixels, in bytes
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_PremultiplyAlpha
+ */
+extern DECLSPEC int SDLCALL SDL_UnpremultiplyAlpha(int width, int height,
+                                                   Uint32 src_format,
+                                                   const void * src, int src_pitch,
+                                                   Uint32 dst_format,
+                                                   void * dst, int dst_pitch);
+
 /**
  * Perform a fast fill of a rectangle with a specific color.
  *
@@ -81,6 +81,28 @@ extern DECLSPEC Uint32 SDLCALL SDL_GetTicks(void);
  */
 extern DECLSPEC Uint64 SDLCALL SDL_GetTicks64(void);
 
+/**
+ * Get the number of nanoseconds since SDL library initialization.
+ *
+ * This uses the same clock and starting point as SDL_GetTicks64(), so
+ * `SDL_GetTicksNS() / 1000000` matches the value SDL_GetTicks64() would
+ * return at the same moment. On platforms where the millisecond ticks come
+ * from a coarser clock, the performance counter provides the time within
+ * each millisecond.
+ *
+ * High resolution event timestamps from SDL_GetEventTimestampNS() are
+ * measured against this clock.
+ *
+ * \returns an unsigned 64-bit value representing the number of nanoseconds
+ *          since the SDL library initialized.
+ *
+ * \since This function is available since SDL 2.0.20.
+ *
+ * \sa SDL_GetTicks64
+ * \sa SDL_GetEventTimestampNS
+ */
+extern DECLSPEC Uint64 SDLCALL SDL_GetTicksNS(void);
+
 /**
  * Compare 32-bit SDL ticks values, and return true if `A` has passed `B`.
  *
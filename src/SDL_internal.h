@@ -121,6 +121,22 @@
 #define SDL_HAVE_YUV                    !SDL_LEAN_AND_MEAN
 #endif
 
+/* Allow individual functions to be compiled for instruction set extensions
+   that the rest of SDL isn't built for. Code using these must only be called
+   after checking for CPU support at runtime, e.g. with SDL_HasAVX2(). */
+#if (defined(__GNUC__) && (__GNUC__ >= 5)) || defined(__clang__)
+#define SDL_TARGETING(x) __attribute__((target(x)))
+#else
+#define SDL_TARGETING(x)
+#endif
+
+#if (defined(__i386__) || defined(__x86_64__)) && defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H) && \
+    ((defined(__GNUC__) && (__GNUC__ >= 5)) || defined(__clang__))
+#define HAVE_AVX2_INTRINSICS 1
+#elif defined(_MSC_VER) && (_MSC_VER >= 1700) && (defined(_M_IX86) || defined(_M_X64))
+#define HAVE_AVX2_INTRINSICS 1
+#endif
+
 #include "SDL_assert.h"
 #include "SDL_log.h"
 
@@ -40,6 +40,35 @@
 #include <xmmintrin.h>
 #endif
 
+/* On Linux we can park contended waiters on a futex instead of yielding blindly.
+   The lock word is then 0 (unlocked), 1 (locked) or 2 (locked, maybe waiters). */
+#if defined(__LINUX__) && HAVE_GCC_ATOMICS && !SDL_ATOMIC_DISABLED
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define SDL_SPINLOCK_FUTEX 1
+#endif
+
+/* Contention statistics put a shared counter on the contended path, so they
+   are only kept in builds that define SDL_SPINLOCK_STATS to 1, and only when
+   atomics don't fall back to the spinlock-based emulation, which would recurse
+   into SDL_AtomicLock(). */
+#if defined(SDL_SPINLOCK_STATS) && SDL_SPINLOCK_STATS && \
+    (HAVE_GCC_ATOMICS || defined(_MSC_VER)) && !SDL_ATOMIC_DISABLED
+#define SPINLOCK_KEEP_STATS 1
+static SDL_atomic_t SDL_spinlock_contended;
+static SDL_atomic_t SDL_spinlock_spins;
+static SDL_atomic_t SDL_spinlock_waits;
+#define SPINLOCK_STAT_ADD(counter, amount) SDL_AtomicAdd(&SDL_spinlock_##counter, (amount))
+#else
+#define SPINLOCK_STAT_ADD(counter, amount)
+#endif
+
+/* Spin for at most this many backoff rounds, doubling the number of pauses
+   per round up to SPIN_MAX_BACKOFF, before going to sleep. */
+#define SPIN_ROUNDS         12
+#define SPIN_MAX_BACKOFF    64
+
 #if defined(__WATCOMC__) && defined(__386__)
 SDL_COMPILE_TIME_ASSERT(locksize, 4==sizeof(SDL_SpinLock));
 extern __inline int _SDL_xchg_watcom(volatile int *a, int v);
@@ -72,6 +101,10 @@ SDL_AtomicTryLock(SDL_SpinLock *lock)
         return SDL_FALSE;
     }
 
+#elif SDL_SPINLOCK_FUTEX
+    /* Don't clobber the "waiters" state with a plain exchange. */
+    return (SDL_bool) __sync_bool_compare_and_swap(lock, 0, 1);
+
 #elif HAVE_GCC_ATOMICS || HAVE_GCC_SYNC_LOCK_TEST_AND_SET
     return (__sync_lock_test_and_set(lock, 1) == 0);
 
@@ -160,23 +193,57 @@ SDL_AtomicTryLock(SDL_SpinLock *lock)
 void
 SDL_AtomicLock(SDL_SpinLock *lock)
 {
-    int iterations = 0;
-    /* FIXME: Should we have an eventual timeout? */
-    while (!SDL_AtomicTryLock(lock)) {
-        if (iterations < 32) {
-            iterations++;
+    int rounds = 0;
+    int backoff = 1;
+
+    if (SDL_AtomicTryLock(lock)) {
+        return;  /* uncontended, the common case. */
+    }
+    SPINLOCK_STAT_ADD(contended, 1);
+
+    /* Spin with exponential backoff. Only retry the atomic operation once the
+       lock looks free, so waiters don't keep stealing the cache line. */
+    while (rounds < SPIN_ROUNDS) {
+        int i;
+        for (i = 0; i < backoff; ++i) {
             PAUSE_INSTRUCTION();
-        } else {
-            /* !!! FIXME: this doesn't definitely give up the current timeslice, it does different things on various platforms. */
-            SDL_Delay(0);
         }
+        ++rounds;
+        if (*(volatile SDL_SpinLock *)lock == 0 && SDL_AtomicTryLock(lock)) {
+            SPINLOCK_STAT_ADD(spins, rounds);
+            return;
+        }
+        if (backoff < SPIN_MAX_BACKOFF) {
+            backoff *= 2;
+        }
+    }
+    SPINLOCK_STAT_ADD(spins, rounds);
+
+#if SDL_SPINLOCK_FUTEX
+    /* Mark the lock contended and sleep until the holder wakes us up. */
+    while (__sync_lock_test_and_set(lock, 2) != 0) {
+        SPINLOCK_STAT_ADD(waits, 1);
+        syscall(SYS_futex, lock, FUTEX_WAIT_PRIVATE, 2, NULL, NULL, 0);
+    }
+#else
+    while (!SDL_AtomicTryLock(lock)) {
+        SPINLOCK_STAT_ADD(waits, 1);
+        /* !!! FIXME: this doesn't definitely give up the current timeslice, it does different things on various platforms. */
+        SDL_Delay(0);
     }
+#endif
 }
 
 void
 SDL_AtomicUnlock(SDL_SpinLock *lock)
 {
-#if HAVE_GCC_ATOMICS || HAVE_GCC_SYNC_LOCK_TEST_AND_SET
+#if SDL_SPINLOCK_FUTEX
+    /* Full barrier exchange; if anyone went to sleep on the lock, wake one up. */
+    if (__sync_fetch_and_and(lock, 0) == 2) {
+        syscall(SYS_futex, lock, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+
+#elif HAVE_GCC_ATOMICS || HAVE_GCC_SYNC_LOCK_TEST_AND_SET
     __sync_lock_release(lock);
 
 #elif defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
@@ -200,4 +267,29 @@ SDL_AtomicUnlock(SDL_SpinLock *lock)
 #endif
 }
 
+void
+SDL_AtomicGetSpinLockStats(SDL_SpinLockStats *stats)
+{
+    if (!stats) {
+        return;
+    }
+#if SPINLOCK_KEEP_STATS
+    stats->contended = (Uint32) SDL_AtomicGet(&SDL_spinlock_contended);
+    stats->spins = (Uint32) SDL_AtomicGet(&SDL_spinlock_spins);
+    stats->waits = (Uint32) SDL_AtomicGet(&SDL_spinlock_waits);
+#else
+    SDL_zerop(stats);
+#endif
+}
+
+void
+SDL_AtomicResetSpinLockStats(void)
+{
+#if SPINLOCK_KEEP_STATS
+    SDL_AtomicSet(&SDL_spinlock_contended, 0);
+    SDL_AtomicSet(&SDL_spinlock_spins, 0);
+    SDL_AtomicSet(&SDL_spinlock_waits, 0);
+#endif
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -297,6 +297,12 @@ SDL_AudioFreeDeviceHandle_Default(void *handle)
 {                               /* no-op. */
 }
 
+static int
+SDL_AudioGetDeviceDelay_Default(_THIS)
+{
+    return -1;  /* unknown, SDL will estimate it. */
+}
+
 
 static int
 SDL_AudioOpenDevice_Default(_THIS, void *handle, const char *devname, int iscapture)
@@ -375,6 +381,7 @@ finish_audio_entry_points_init(void)
     FILL_STUB(LockDevice);
     FILL_STUB(UnlockDevice);
     FILL_STUB(FreeDeviceHandle);
+    FILL_STUB(GetDeviceDelay);
     FILL_STUB(Deinitialize);
 #undef FILL_STUB
 }
@@ -694,6 +701,51 @@ SDL_ClearQueuedAudio(SDL_AudioDeviceID devid)
 }
 
 
+/* Wait as long as a buffer takes to play in real time */
+static void
+wait_real_period(SDL_AudioDevice *device)
+{
+    const Uint32 ms = (device->spec.samples * 1000) / device->spec.freq;
+    SDL_Delay(ms ? ms : 1);
+}
+
+/* Sleep for as long as one buffer takes to play, unless running on a virtual clock */
+static void
+wait_one_period(SDL_AudioDevice *device)
+{
+    if (!device->virtual_clock) {
+        wait_real_period(device);
+    }
+}
+
+static int
+get_device_delay(SDL_AudioDevice *device)
+{
+    if (device->virtual_clock) {
+        return 0;  /* everything is "heard" the moment it's played. */
+    }
+    return current_audio.impl.GetDeviceDelay(device);
+}
+
+/* Remember how long until the buffer that was just played is heard */
+static void
+update_device_delay(SDL_AudioDevice *device)
+{
+    int frames = get_device_delay(device);
+    const Uint64 now = SDL_GetTicksNS();
+
+    if (frames < 0) {
+        /* The backend can't tell, assume the buffer we just handed over is next. */
+        frames = device->spec.samples;
+    }
+
+    SDL_AtomicLock(&device->delay_lock);
+    device->delay_frames = frames;
+    device->delay_timestamp_ns = now;
+    device->frames_played += device->spec.samples;
+    SDL_AtomicUnlock(&device->delay_lock);
+}
+
 /* The general mixing thread function */
 static int SDLCALL
 SDL_RunAudio(void *devicep)
@@ -723,6 +775,13 @@ SDL_RunAudio(void *devicep)
 
     /* Loop, filling the audio buffers */
     while (!SDL_AtomicGet(&device->shutdown)) {
+        /* On a virtual clock, time stands still while paused, so there is
+           nothing to play; wait in real time for the app to unpause. */
+        if (device->virtual_clock && SDL_AtomicGet(&device->paused)) {
+            wait_real_period(device);
+            continue;
+        }
+
         current_audio.impl.BeginLoopIteration(device);
         data_len = device->callbackspec.size;
 
@@ -765,23 +824,25 @@ SDL_RunAudio(void *devicep)
                 SDL_assert((got <= 0) || (got == device->spec.size));
 
                 if (data == NULL) {  /* device is having issues... */
-                    const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
-                    SDL_Delay(delay);  /* wait for as long as this buffer would have played. Maybe device recovers later? */
+                    update_device_delay(device);
+                    wait_one_period(device);  /* wait for as long as this buffer would have played. Maybe device recovers later? */
                 } else {
                     if (got != device->spec.size) {
                         SDL_memset(data, device->spec.silence, device->spec.size);
                     }
                     current_audio.impl.PlayDevice(device);
+                    update_device_delay(device);
                     current_audio.impl.WaitDevice(device);
                 }
             }
         } else if (data == device->work_buffer) {
             /* nothing to do; pause like we queued a buffer to play. */
-            const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
-            SDL_Delay(delay);
+            update_device_delay(device);
+            wait_one_period(device);
         } else {  /* writing directly to the device. */
             /* queue this buffer and wait for it to finish playing. */
             current_audio.impl.PlayDevice(device);
+            update_device_delay(device);
             current_audio.impl.WaitDevice(device);
         }
     }
@@ -789,7 +850,8 @@ SDL_RunAudio(void *devicep)
     current_audio.impl.PrepareToClose(device);
 
     /* Wait for the audio to drain. */
-    SDL_Delay(((device->spec.samples * 1000) / device->spec.freq) * 2);
+    wait_one_period(device);
+    wait_one_period(device);
 
     current_audio.impl.ThreadDeinit(device);
 
@@ -803,7 +865,6 @@ SDL_CaptureAudio(void *devicep)
 {
     SDL_AudioDevice *device = (SDL_AudioDevice *) devicep;
     const int silence = (int) device->spec.silence;
-    const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
     const int data_len = device->spec.size;
     Uint8 *data;
     void *udata = device->callbackspec.userdata;
@@ -834,7 +895,7 @@ SDL_CaptureAudio(void *devicep)
         current_audio.impl.BeginLoopIteration(device);
 
         if (SDL_AtomicGet(&device->paused)) {
-            SDL_Delay(delay);  /* just so we don't cook the CPU. */
+            wait_real_period(device);  /* just so we don't cook the CPU, even on a virtual clock. */
             if (device->stream) {
                 SDL_AudioStreamClear(device->stream);
             }
@@ -856,7 +917,7 @@ SDL_CaptureAudio(void *devicep)
            But we don't process it further or call the app's callback. */
 
         if (!SDL_AtomicGet(&device->enabled)) {
-            SDL_Delay(delay);  /* try to keep callback firing at normal pace. */
+            wait_one_period(device);  /* try to keep callback firing at normal pace. */
         } else {
             while (still_need > 0) {
                 const int rc = current_audio.impl.CaptureFromDevice(device, ptr, still_need);
@@ -876,6 +937,10 @@ SDL_CaptureAudio(void *devicep)
             SDL_memset(ptr, silence, still_need);
         }
 
+        SDL_AtomicLock(&device->delay_lock);
+        device->frames_played += device->spec.samples;
+        SDL_AtomicUnlock(&device->delay_lock);
+
         if (device->stream) {
             /* if this fails...oh well. */
             SDL_AudioStreamPut(device->stream, data, data_len);
@@ -1207,6 +1272,10 @@ close_audio_device(SDL_AudioDevice * device)
     if (device->thread != NULL) {
         SDL_WaitThread(device->thread, NULL);
     }
+    if (device->pull_thread_init) {
+        current_audio.impl.PrepareToClose(device);
+        current_audio.impl.ThreadDeinit(device);
+    }
     if (device->mixer_lock != NULL) {
         SDL_DestroyMutex(device->mixer_lock);
     }
@@ -1299,7 +1368,7 @@ prepare_audiospec(const SDL_AudioSpec * orig, SDL_AudioSpec * prepared)
 static SDL_AudioDeviceID
 open_audio_device(const char *devname, int iscapture,
                   const SDL_AudioSpec * desired, SDL_AudioSpec * obtained,
-                  int allowed_changes, int min_id)
+                  int allowed_changes, int min_id, SDL_bool pullmode)
 {
     const SDL_bool is_internal_thread = (desired->callback == NULL);
     SDL_AudioDeviceID id = 0;
@@ -1319,6 +1388,11 @@ open_audio_device(const char *devname, int iscapture,
         return 0;
     }
 
+    if (pullmode && current_audio.impl.ProvidesOwnCallbackThread) {
+        SDL_SetError("Audio driver doesn't support pull mode");
+        return 0;
+    }
+
     /* !!! FIXME: there is a race condition here if two devices open from two threads at once. */
     /* Find an available device ID... */
     for (id = min_id - 1; id < SDL_arraysize(open_devices); id++) {
@@ -1415,9 +1489,10 @@ open_audio_device(const char *devname, int iscapture,
     device->spec = *obtained;
     device->iscapture = iscapture ? SDL_TRUE : SDL_FALSE;
     device->handle = handle;
+    device->pullmode = pullmode;
 
     SDL_AtomicSet(&device->shutdown, 0);  /* just in case. */
-    SDL_AtomicSet(&device->paused, 1);
+    SDL_AtomicSet(&device->paused, pullmode ? 0 : 1);  /* the app decides when to play in pull mode. */
     SDL_AtomicSet(&device->enabled, 1);
 
     /* Create a mutex for locking the sound buffers */
@@ -1491,7 +1566,7 @@ open_audio_device(const char *devname, int iscapture,
         }
     }
 
-    if (device->spec.callback == NULL) {  /* use buffer queueing? */
+    if (device->spec.callback == NULL && !pullmode) {  /* use buffer queueing? */
         /* pool a few packets to start. Enough for two callbacks. */
         device->buffer_queue = SDL_NewDataQueue(SDL_AUDIOBUFFERQUEUE_PACKETLEN, obtained->size * 2);
         if (!device->buffer_queue) {
@@ -1520,7 +1595,7 @@ open_audio_device(const char *devname, int iscapture,
     open_devices[id] = device;  /* add it to our list of open devices. */
 
     /* Start the audio thread if necessary */
-    if (!current_audio.impl.ProvidesOwnCallbackThread) {
+    if (!current_audio.impl.ProvidesOwnCallbackThread && !pullmode) {
         /* Start the audio thread */
         /* !!! FIXME: we don't force the audio thread stack size here if it calls into user code, but maybe we should? */
         /* buffer queueing callback only needs a few bytes, so make the stack tiny. */
@@ -1561,11 +1636,11 @@ SDL_OpenAudio(SDL_AudioSpec * desired, SDL_AudioSpec * obtained)
 
     if (obtained) {
         id = open_audio_device(NULL, 0, desired, obtained,
-                               SDL_AUDIO_ALLOW_ANY_CHANGE, 1);
+                               SDL_AUDIO_ALLOW_ANY_CHANGE, 1, SDL_FALSE);
     } else {
         SDL_AudioSpec _obtained;
         SDL_zero(_obtained);
-        id = open_audio_device(NULL, 0, desired, &_obtained, 0, 1);
+        id = open_audio_device(NULL, 0, desired, &_obtained, 0, 1, SDL_FALSE);
         /* On successful open, copy calculated values into 'desired'. */
         if (id > 0) {
             desired->size = _obtained.size;
@@ -1583,7 +1658,153 @@ SDL_OpenAudioDevice(const char *device, int iscapture,
                     int allowed_changes)
 {
     return open_audio_device(device, iscapture, desired, obtained,
-                             allowed_changes, 2);
+                             allowed_changes, 2, SDL_FALSE);
+}
+
+SDL_AudioDeviceID
+SDL_OpenAudioDevicePull(const char *device, const SDL_AudioSpec * desired,
+                        SDL_AudioSpec * obtained)
+{
+    SDL_AudioSpec spec;
+
+    if (!desired) {
+        SDL_InvalidParamError("desired");
+        return 0;
+    }
+
+    /* The app writes straight to the device, so nothing can be converted. */
+    spec = *desired;
+    spec.callback = NULL;
+    spec.userdata = NULL;
+    return open_audio_device(device, 0, &spec, obtained,
+                             SDL_AUDIO_ALLOW_ANY_CHANGE, 2, SDL_TRUE);
+}
+
+Uint8 *
+SDL_GetAudioDeviceBuffer(SDL_AudioDeviceID devid, int *len)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+    Uint8 *data;
+
+    if (!device) {
+        return NULL;  /* get_audio_device() will have set the error state */
+    } else if (!device->pullmode) {
+        SDL_SetError("Audio device wasn't opened in pull mode");
+        return NULL;
+    }
+
+    if (!device->pull_buffer) {
+        if (!device->pull_thread_init) {
+            current_audio.impl.ThreadInit(device);
+            device->pull_thread_init = SDL_TRUE;
+        }
+
+        /* Wait until the device can take another buffer */
+        if (device->pull_played == device->work_buffer) {
+            /* nothing was played; pause like we queued a buffer. */
+            wait_one_period(device);
+        } else if (device->pull_played) {
+            current_audio.impl.WaitDevice(device);
+        }
+        device->pull_played = NULL;
+
+        current_audio.impl.BeginLoopIteration(device);
+        data = SDL_AtomicGet(&device->enabled) ? current_audio.impl.GetDeviceBuf(device) : NULL;
+        device->pull_buffer = data ? data : device->work_buffer;
+    }
+
+    if (len) {
+        *len = (int) device->spec.size;
+    }
+    return device->pull_buffer;
+}
+
+int
+SDL_PlayAudioDeviceBuffer(SDL_AudioDeviceID devid)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+
+    if (!device) {
+        return -1;  /* get_audio_device() will have set the error state */
+    } else if (!device->pullmode) {
+        return SDL_SetError("Audio device wasn't opened in pull mode");
+    } else if (!device->pull_buffer) {
+        return SDL_SetError("No audio buffer to play, call SDL_GetAudioDeviceBuffer() first");
+    }
+
+    if (device->pull_buffer != device->work_buffer) {
+        current_audio.impl.PlayDevice(device);
+    }
+    update_device_delay(device);
+
+    device->pull_played = device->pull_buffer;
+    device->pull_buffer = NULL;
+    return 0;
+}
+
+int
+SDL_GetAudioDeviceDelay(SDL_AudioDeviceID devid)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+    Uint64 elapsed, timestamp_ns;
+    int frames;
+
+    if (!device) {
+        return -1;  /* get_audio_device() will have set the error state */
+    } else if (device->iscapture) {
+        return SDL_SetError("Audio device is a capture device");
+    }
+
+    /* Drivers with their own audio thread never report back when they play,
+       so their delay hook has to be safe to call from any thread. */
+    if (current_audio.impl.ProvidesOwnCallbackThread) {
+        frames = get_device_delay(device);
+        if (frames < 0) {
+            return SDL_Unsupported();
+        }
+        return frames;
+    }
+
+    /* Otherwise, count down from the measurement taken on the thread that
+       played the last buffer, so the backend is only used from that thread. */
+    SDL_AtomicLock(&device->delay_lock);
+    frames = device->delay_frames;
+    timestamp_ns = device->delay_timestamp_ns;
+    SDL_AtomicUnlock(&device->delay_lock);
+
+    if (timestamp_ns == 0) {
+        return 0;  /* nothing played yet. */
+    }
+    elapsed = ((SDL_GetTicksNS() - timestamp_ns) * device->spec.freq) / 1000000000;
+    return (elapsed >= (Uint64) frames) ? 0 : (int) (frames - elapsed);
+}
+
+Uint64
+SDL_GetAudioDeviceTimeNS(SDL_AudioDeviceID devid)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+    Uint64 frames;
+    int delay = 0;
+
+    if (!device) {
+        return 0;  /* get_audio_device() will have set the error state */
+    }
+
+    SDL_AtomicLock(&device->delay_lock);
+    frames = device->frames_played;
+    SDL_AtomicUnlock(&device->delay_lock);
+
+    /* Audio that was played but isn't audible yet hasn't happened yet. */
+    if (!device->iscapture) {
+        delay = SDL_GetAudioDeviceDelay(devid);
+        if (delay > 0) {
+            frames = ((Uint64) delay >= frames) ? 0 : (frames - delay);
+        }
+    }
+
+    /* split the division so hours of audio don't overflow. */
+    return ((frames / device->spec.freq) * 1000000000) +
+           (((frames % device->spec.freq) * 1000000000) / device->spec.freq);
 }
 
 SDL_AudioStatus
@@ -79,6 +79,7 @@ typedef struct SDL_AudioDriverImpl
     void (*LockDevice) (_THIS);
     void (*UnlockDevice) (_THIS);
     void (*FreeDeviceHandle) (void *handle);  /**< SDL is done with handle from SDL_AddAudioDevice() */
+    int (*GetDeviceDelay) (_THIS);  /**< Frames until the next frame written is heard, or -1 if unknown. Called after PlayDevice, or from any thread if ProvidesOwnCallbackThread */
     void (*Deinitialize) (void);
 
     /* !!! FIXME: add pause(), so we can optimize instead of mixing silence. */
@@ -166,6 +167,21 @@ struct SDL_AudioDevice
     /* Queued buffers (if app not using callback). */
     SDL_DataQueue *buffer_queue;
 
+    /* Pull mode: the app writes to the device buffer itself, and there's no audio thread. */
+    SDL_bool pullmode;
+    SDL_bool pull_thread_init;
+    Uint8 *pull_buffer;  /* handed out by SDL_GetAudioDeviceBuffer(), not played yet */
+    Uint8 *pull_played;  /* last buffer played, we have to wait for it before the next one */
+
+    /* Playback delay measured when the last buffer was played, see SDL_GetAudioDeviceDelay() */
+    SDL_SpinLock delay_lock;
+    int delay_frames;
+    Uint64 delay_timestamp_ns;
+    Uint64 frames_played;  /* frames handed to (or read from) the device so far */
+
+    /* Set by the driver: no real-time pacing, time only advances per buffer */
+    SDL_bool virtual_clock;
+
     /* * * */
     /* Data private to this driver */
     struct SDL_PrivateAudioData *hidden;
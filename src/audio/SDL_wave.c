@@ -1165,8 +1165,11 @@ LAW_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Expands sample_count companded samples to 16 bits in place. The buffer must
+ * have room for the expanded samples.
+ */
 static int
-LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+LAW_Expand(Uint16 encoding, Uint8 *src, size_t sample_count)
 {
 #ifdef SDL_WAVE_LAW_LUT
     const Sint16 alaw_lut[256] = {
@@ -1207,53 +1210,13 @@ LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     };
 #endif
 
-    WaveFormat *format = &file->format;
-    WaveChunk *chunk = &file->chunk;
-    size_t i, sample_count, expanded_len;
-    Uint8 *src;
-    Sint16 *dst;
-
-    if (chunk->length != chunk->size) {
-        file->sampleframes = WaveAdjustToFactValue(file, chunk->size / format->blockalign);
-        if (file->sampleframes < 0) {
-            return -1;
-        }
-    }
-
-    /* Nothing to decode, nothing to return. */
-    if (file->sampleframes == 0) {
-        *audio_buf = NULL;
-        *audio_len = 0;
-        return 0;
-    }
-
-    sample_count = (size_t)file->sampleframes;
-    if (SafeMult(&sample_count, format->channels)) {
-        return SDL_OutOfMemory();
-    }
-
-    expanded_len = sample_count;
-    if (SafeMult(&expanded_len, sizeof(Sint16))) {
-        return SDL_OutOfMemory();
-    } else if (expanded_len > SDL_MAX_UINT32 || file->sampleframes > SIZE_MAX) {
-        return SDL_SetError("WAVE file too big");
-    }
-
-    /* 1 to avoid allocating zero bytes, to keep static analysis happy. */
-    src = (Uint8 *)SDL_realloc(chunk->data, expanded_len ? expanded_len : 1);
-    if (src == NULL) {
-        return SDL_OutOfMemory();
-    }
-    chunk->data = NULL;
-    chunk->size = 0;
-
-    dst = (Sint16 *)src;
+    Sint16 *dst = (Sint16 *)src;
+    size_t i = sample_count;
 
     /* Work backwards, since we're expanding in-place. SDL_AudioSpec.format will
      * inform the caller about the byte order.
      */
-    i = sample_count;
-    switch (file->format.encoding) {
+    switch (encoding) {
 #ifdef SDL_WAVE_LAW_LUT
     case ALAW_CODE:
         while (i--) {
@@ -1298,10 +1261,59 @@ LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
         break;
 #endif
     default:
-        SDL_free(src);
         return SDL_SetError("Unknown companded encoding");
     }
 
+    return 0;
+}
+
+static int
+LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+    size_t sample_count, expanded_len;
+    Uint8 *src;
+
+    if (chunk->length != chunk->size) {
+        file->sampleframes = WaveAdjustToFactValue(file, chunk->size / format->blockalign);
+        if (file->sampleframes < 0) {
+            return -1;
+        }
+    }
+
+    /* Nothing to decode, nothing to return. */
+    if (file->sampleframes == 0) {
+        *audio_buf = NULL;
+        *audio_len = 0;
+        return 0;
+    }
+
+    sample_count = (size_t)file->sampleframes;
+    if (SafeMult(&sample_count, format->channels)) {
+        return SDL_OutOfMemory();
+    }
+
+    expanded_len = sample_count;
+    if (SafeMult(&expanded_len, sizeof(Sint16))) {
+        return SDL_OutOfMemory();
+    } else if (expanded_len > SDL_MAX_UINT32 || file->sampleframes > SIZE_MAX) {
+        return SDL_SetError("WAVE file too big");
+    }
+
+    /* 1 to avoid allocating zero bytes, to keep static analysis happy. */
+    src = (Uint8 *)SDL_realloc(chunk->data, expanded_len ? expanded_len : 1);
+    if (src == NULL) {
+        return SDL_OutOfMemory();
+    }
+    chunk->data = NULL;
+    chunk->size = 0;
+
+    if (LAW_Expand(file->format.encoding, src, sample_count) < 0) {
+        SDL_free(src);
+        return -1;
+    }
+
     *audio_buf = src;
     *audio_len = (Uint32)expanded_len;
 
@@ -1352,12 +1364,37 @@ PCM_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Shifts sample_count 24-bit samples to 32 bits in place. The buffer must
+ * have room for the expanded samples.
+ */
+static void
+PCM_ExpandSint24(Uint8 *ptr, size_t sample_count)
+{
+    size_t i;
+
+    /* work from end to start, since we're expanding in-place. */
+    for (i = sample_count; i > 0; i--) {
+        const size_t o = i - 1;
+        uint8_t b[4];
+
+        b[0] = 0;
+        b[1] = ptr[o * 3];
+        b[2] = ptr[o * 3 + 1];
+        b[3] = ptr[o * 3 + 2];
+
+        ptr[o * 4 + 0] = b[0];
+        ptr[o * 4 + 1] = b[1];
+        ptr[o * 4 + 2] = b[2];
+        ptr[o * 4 + 3] = b[3];
+    }
+}
+
 static int
 PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 {
     WaveFormat *format = &file->format;
     WaveChunk *chunk = &file->chunk;
-    size_t i, expanded_len, sample_count;
+    size_t expanded_len, sample_count;
     Uint8 *ptr;
 
     sample_count = (size_t)file->sampleframes;
@@ -1385,21 +1422,7 @@ PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     *audio_buf = ptr;
     *audio_len = (Uint32)expanded_len;
 
-    /* work from end to start, since we're expanding in-place. */
-    for (i = sample_count; i > 0; i--) {
-        const size_t o = i - 1;
-        uint8_t b[4];
-
-        b[0] = 0;
-        b[1] = ptr[o * 3];
-        b[2] = ptr[o * 3 + 1];
-        b[3] = ptr[o * 3 + 2];
-
-        ptr[o * 4 + 0] = b[0];
-        ptr[o * 4 + 1] = b[1];
-        ptr[o * 4 + 2] = b[2];
-        ptr[o * 4 + 3] = b[3];
-    }
+    PCM_ExpandSint24(ptr, sample_count);
 
     return 0;
 }
@@ -1783,8 +1806,12 @@ WaveCheckFormat(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Finds and checks the fmt and data chunks. On success, file->chunk is the
+ * data chunk (with no data read yet) and endposition is where the WAVE data
+ * ends in the stream.
+ */
 static int
-WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+WaveLoadHeaders(SDL_RWops *src, WaveFile *file, Sint64 *endposition)
 {
     int result;
     Uint32 chunkcount = 0;
@@ -1792,7 +1819,6 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
     char *envchunkcountlimit;
     Sint64 RIFFstart, RIFFend, lastchunkpos;
     SDL_bool RIFFlengthknown = SDL_FALSE;
-    WaveFormat *format = &file->format;
     WaveChunk *chunk = &file->chunk;
     WaveChunk RIFFchunk;
     WaveChunk fmtchunk;
@@ -1997,9 +2023,79 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
 
     WaveFreeChunkData(chunk);
 
-    /* Process data chunk. */
     *chunk = datachunk;
 
+    /* Report the end position back to the cleanup code. */
+    if (RIFFlengthknown) {
+        *endposition = RIFFend;
+    } else {
+        *endposition = lastchunkpos;
+    }
+
+    return 0;
+}
+
+/* Sets up the SDL_AudioSpec for the decoded data. All unsupported formats
+ * were filtered out by WaveCheckFormat().
+ */
+static int
+WaveSetSpec(WaveFile *file, SDL_AudioSpec *spec)
+{
+    WaveFormat *format = &file->format;
+
+    SDL_zerop(spec);
+    spec->freq = format->frequency;
+    spec->channels = (Uint8)format->channels;
+    spec->samples = 4096;       /* Good default buffer size */
+
+    switch (format->encoding) {
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE:
+    case ALAW_CODE:
+    case MULAW_CODE:
+        /* These can be easily stored in the byte order of the system. */
+        spec->format = AUDIO_S16SYS;
+        break;
+    case IEEE_FLOAT_CODE:
+        spec->format = AUDIO_F32LSB;
+        break;
+    case PCM_CODE:
+        switch (format->bitspersample) {
+        case 8:
+            spec->format = AUDIO_U8;
+            break;
+        case 16:
+            spec->format = AUDIO_S16LSB;
+            break;
+        case 24: /* Has been shifted to 32 bits. */
+        case 32:
+            spec->format = AUDIO_S32LSB;
+            break;
+        default:
+            /* Just in case something unexpected happened in the checks. */
+            return SDL_SetError("Unexpected %u-bit PCM data format", (unsigned int)format->bitspersample);
+        }
+        break;
+    }
+
+    spec->silence = SDL_SilenceValueForFormat(spec->format);
+
+    return 0;
+}
+
+static int
+WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    int result;
+    Sint64 endposition;
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+
+    if (WaveLoadHeaders(src, file, &endposition) < 0) {
+        return -1;
+    }
+
+    /* Process data chunk. */
     if (chunk->length > 0) {
         result = WaveReadChunkData(src, chunk);
         if (result == -1) {
@@ -2043,52 +2139,12 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
         break;
     }
 
-    /* Setting up the SDL_AudioSpec. All unsupported formats were filtered out
-     * by checks earlier in this function.
-     */
-    SDL_zerop(spec);
-    spec->freq = format->frequency;
-    spec->channels = (Uint8)format->channels;
-    spec->samples = 4096;       /* Good default buffer size */
-
-    switch (format->encoding) {
-    case MS_ADPCM_CODE:
-    case IMA_ADPCM_CODE:
-    case ALAW_CODE:
-    case MULAW_CODE:
-        /* These can be easily stored in the byte order of the system. */
-        spec->format = AUDIO_S16SYS;
-        break;
-    case IEEE_FLOAT_CODE:
-        spec->format = AUDIO_F32LSB;
-        break;
-    case PCM_CODE:
-        switch (format->bitspersample) {
-        case 8:
-            spec->format = AUDIO_U8;
-            break;
-        case 16:
-            spec->format = AUDIO_S16LSB;
-            break;
-        case 24: /* Has been shifted to 32 bits. */
-        case 32:
-            spec->format = AUDIO_S32LSB;
-            break;
-        default:
-            /* Just in case something unexpected happened in the checks. */
-            return SDL_SetError("Unexpected %u-bit PCM data format", (unsigned int)format->bitspersample);
-        }
-        break;
+    if (WaveSetSpec(file, spec) < 0) {
+        return -1;
     }
 
-    spec->silence = SDL_SilenceValueForFormat(spec->format);
-
     /* Report the end position back to the cleanup code. */
-    if (RIFFlengthknown) {
-        chunk->position = RIFFend;
-    } else {
-        chunk->position = lastchunkpos;
-    }
+    chunk->position = endposition;
 
     return 0;
 }
@@ -2152,4 +2208,460 @@ SDL_FreeWAV(Uint8 *audio_buf)
     SDL_free(audio_buf);
 }
 
+/* Streaming decoder. Only the current ADPCM block is kept in memory; PCM and
+ * companded data is read straight into the caller's buffer and expanded in
+ * place.
+ */
+
+/* Most bytes SDL_WAVDecoderPutStream() reads from PCM data at once. */
+#define WAVE_STREAM_CHUNK 65536
+
+struct _SDL_WAVDecoder
+{
+    SDL_RWops *src;
+    int freesrc;
+    WaveFile file;
+    SDL_AudioSpec spec;
+    Sint64 startposition;   /* Where src was when the decoder was opened. */
+    Sint64 endposition;     /* Where the WAVE data ends in src. */
+    size_t datalength;      /* Bytes of the data chunk that are actually in src. */
+    Sint64 srcoffset;       /* Offset into the data chunk src is at, -1 if unknown. */
+    size_t framesize;       /* Size of a decoded sample frame in bytes. */
+    Sint64 position;        /* Next sample frame to be returned. */
+
+    /* ADPCM: the current block, and the sample frames decoded from it. */
+    Uint8 *block;
+    Sint16 *decoded;
+    Sint64 decodedblock;    /* Index of the block in decoded, -1 if none. */
+    size_t decodedframes;
+    void *cstate;
+
+    /* PCM: bounce buffer for SDL_WAVDecoderPutStream(). */
+    Uint8 *scratch;
+};
+
+static SDL_bool
+WaveIsADPCM(WaveFile *file)
+{
+    return (file->format.encoding == MS_ADPCM_CODE || file->format.encoding == IMA_ADPCM_CODE) ? SDL_TRUE : SDL_FALSE;
+}
+
+/* Reads len bytes at offset into the data chunk, seeking only if necessary. */
+static size_t
+WaveStreamRead(SDL_WAVDecoder *decoder, Sint64 offset, void *ptr, size_t len)
+{
+    size_t got;
+
+    if (decoder->srcoffset != offset) {
+        const Sint64 position = decoder->file.chunk.position + offset;
+        if (SDL_RWseek(decoder->src, position, RW_SEEK_SET) != position) {
+            decoder->srcoffset = -1;
+            SDL_SetError("Could not seek in WAVE data chunk");
+            return 0;
+        }
+    }
+
+    got = SDL_RWread(decoder->src, ptr, 1, len);
+    decoder->srcoffset = offset + got;
+    if (got != len) {
+        SDL_SetError("Could not read data of WAVE data chunk");
+    }
+    return got;
+}
+
+static int
+WaveStreamInit(SDL_WAVDecoder *decoder)
+{
+    WaveFile *file = &decoder->file;
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+    const Sint64 srcsize = SDL_RWsize(decoder->src);
+    size_t available = chunk->length;
+
+    /* Only the part of the data chunk that's in the stream can be decoded.
+     * This is the streaming equivalent of a short read in WaveLoad().
+     */
+    if (srcsize >= 0) {
+        if (srcsize <= chunk->position) {
+            available = 0;
+        } else if ((Uint64)(srcsize - chunk->position) < available) {
+            available = (size_t)(srcsize - chunk->position);
+        }
+    }
+
+    if (available != chunk->length) {
+        if (file->trunchint == TruncVeryStrict || file->trunchint == TruncStrict) {
+            return SDL_SetError("Could not read data of WAVE data chunk");
+        }
+
+        /* Recalculate number of sample frames, like the decoders do. */
+        switch (format->encoding) {
+        case MS_ADPCM_CODE:
+            if (MS_ADPCM_CalculateSampleFrames(file, available) < 0) {
+                return -1;
+            }
+            break;
+        case IMA_ADPCM_CODE:
+            if (IMA_ADPCM_CalculateSampleFrames(file, available) < 0) {
+                return -1;
+            }
+            break;
+        default:
+            file->sampleframes = WaveAdjustToFactValue(file, available / format->blockalign);
+            if (file->sampleframes < 0) {
+                return -1;
+            }
+            break;
+        }
+    }
+
+    decoder->datalength = available;
+    decoder->srcoffset = -1;
+    decoder->decodedblock = -1;
+    decoder->framesize = SDL_AUDIO_BITSIZE(decoder->spec.format) / 8 * format->channels;
+
+    /* PCM sample frames are converted one block at a time, so a block must be
+     * exactly one sample frame. WaveLoad() is more lenient here.
+     */
+    if (!WaveIsADPCM(file) && format->blockalign * 8 != (size_t)format->bitspersample * format->channels) {
+        return SDL_SetError("Unsupported block alignment");
+    }
+
+    if (WaveIsADPCM(file)) {
+        const size_t samples = (size_t)format->samplesperblock * format->channels;
+        decoder->block = (Uint8 *)SDL_malloc(format->blockalign);
+        decoder->decoded = (Sint16 *)SDL_malloc(samples * sizeof(Sint16));
+        /* Big enough for either decoder's channel state. */
+        decoder->cstate = SDL_calloc(format->channels, sizeof(MS_ADPCM_ChannelState));
+        if (decoder->block == NULL || decoder->decoded == NULL || decoder->cstate == NULL) {
+            return SDL_OutOfMemory();
+        }
+    }
+
+    return 0;
+}
+
+static int
+WaveStreamDecodeBlock(SDL_WAVDecoder *decoder, Sint64 blockindex)
+{
+    WaveFile *file = &decoder->file;
+    const Uint32 channels = file->format.channels;
+    const size_t samplesperblock = file->format.samplesperblock;
+    const Uint64 offset = (Uint64)blockindex * file->format.blockalign;
+    ADPCM_DecoderState state;
+    size_t blocksize;
+    Sint64 blockframes;
+    int result;
+
+    SDL_zero(state);
+    state.channels = channels;
+    state.blocksize = file->format.blockalign;
+    state.samplesperblock = samplesperblock;
+    state.framesize = channels * sizeof(Sint16);
+    state.ddata = file->decoderdata;
+    state.framestotal = file->sampleframes;
+    state.framesleft = file->sampleframes - blockindex * (Sint64)samplesperblock;
+    state.cstate = decoder->cstate;
+    if (file->format.encoding == MS_ADPCM_CODE) {
+        state.blockheadersize = (size_t)channels * 7;
+    } else {
+        state.blockheadersize = (size_t)channels * 4;
+    }
+
+    blockframes = state.framesleft < (Sint64)samplesperblock ? state.framesleft : (Sint64)samplesperblock;
+
+    decoder->decodedblock = -1;
+    if (offset >= decoder->datalength) {
+        return SDL_SetError("Unexpected end of WAVE data chunk");
+    }
+    blocksize = decoder->datalength - (size_t)offset;
+    if (blocksize > state.blocksize) {
+        blocksize = state.blocksize;
+    }
+    if (blocksize < state.blockheadersize) {
+        return SDL_SetError("Truncated data chunk");
+    } else if (WaveStreamRead(decoder, (Sint64)offset, decoder->block, blocksize) != blocksize) {
+        return -1;
+    }
+
+    state.block.data = decoder->block;
+    state.block.size = blocksize;
+    state.output.data = decoder->decoded;
+    state.output.size = samplesperblock * channels;
+
+    /* Initialize decoder with the values from the block header, then decode
+     * the block data. A truncated block fails the data part, but the frame
+     * count already accounts for the frames that can be decoded from it.
+     */
+    if (file->format.encoding == MS_ADPCM_CODE) {
+        if (MS_ADPCM_DecodeBlockHeader(&state) < 0) {
+            return -1;
+        }
+        result = MS_ADPCM_DecodeBlockData(&state);
+    } else {
+        if (IMA_ADPCM_DecodeBlockHeader(&state) < 0) {
+            return -1;
+        }
+        result = IMA_ADPCM_DecodeBlockData(&state);
+    }
+
+    decoder->decodedframes = state.output.pos / channels;
+    if ((Sint64)decoder->decodedframes >= blockframes) {
+        decoder->decodedframes = (size_t)blockframes;
+    } else if (result < 0) {
+        return SDL_SetError("Truncated data chunk");
+    }
+    decoder->decodedblock = blockindex;
+
+    return 0;
+}
+
+/* Points frames at the decoded sample frames starting at the current position,
+ * decoding the next ADPCM block if necessary. Returns the number of frames.
+ */
+static Sint64
+WaveStreamPeekADPCM(SDL_WAVDecoder *decoder, const Sint16 **frames)
+{
+    const Uint32 samplesperblock = decoder->file.format.samplesperblock;
+    const Sint64 blockindex = decoder->position / samplesperblock;
+    const size_t offset = (size_t)(decoder->position - blockindex * samplesperblock);
+
+    if (decoder->decodedblock != blockindex) {
+        if (WaveStreamDecodeBlock(decoder, blockindex) < 0) {
+            return -1;
+        }
+    }
+
+    *frames = decoder->decoded + offset * decoder->file.format.channels;
+    return (Sint64)(decoder->decodedframes - offset);
+}
+
+/* Reads up to count sample frames of PCM or companded data into buf and
+ * converts them in place. buf must have room for count decoded frames.
+ */
+static Sint64
+WaveStreamReadPCM(SDL_WAVDecoder *decoder, Uint8 *buf, Sint64 count)
+{
+    WaveFormat *format = &decoder->file.format;
+    const Sint64 offset = decoder->position * format->blockalign;
+    size_t got;
+
+    got = WaveStreamRead(decoder, offset, buf, (size_t)count * format->blockalign);
+    count = got / format->blockalign;
+    if (count == 0) {
+        return -1;  /* error is already set. */
+    }
+
+    if (format->encoding == ALAW_CODE || format->encoding == MULAW_CODE) {
+        if (LAW_Expand(format->encoding, buf, (size_t)count * format->channels) < 0) {
+            return -1;
+        }
+    } else if (format->encoding == PCM_CODE && format->bitspersample == 24) {
+        PCM_ExpandSint24(buf, (size_t)count * format->channels);
+    }
+
+    return count;
+}
+
+SDL_WAVDecoder *
+SDL_OpenWAVDecoder_RW(SDL_RWops *src, int freesrc, SDL_AudioSpec *spec)
+{
+    SDL_WAVDecoder *decoder;
+
+    /* Make sure we are passed a valid data source */
+    if (src == NULL) {
+        /* Error may come from RWops. */
+        return NULL;
+    } else if (spec == NULL) {
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        SDL_InvalidParamError("spec");
+        return NULL;
+    }
+
+    decoder = (SDL_WAVDecoder *)SDL_calloc(1, sizeof(*decoder));
+    if (decoder == NULL) {
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    decoder->src = src;
+    decoder->freesrc = freesrc;
+    decoder->startposition = SDL_RWtell(src);
+    decoder->file.riffhint = WaveGetRiffSizeHint();
+    decoder->file.trunchint = WaveGetTruncationHint();
+    decoder->file.facthint = WaveGetFactChunkHint();
+
+    if (WaveLoadHeaders(src, &decoder->file, &decoder->endposition) < 0 ||
+        WaveSetSpec(&decoder->file, &decoder->spec) < 0 ||
+        WaveStreamInit(decoder) < 0) {
+        /* Leave src where it was. */
+        decoder->endposition = decoder->startposition;
+        SDL_CloseWAVDecoder(decoder);
+        return NULL;
+    }
+
+    *spec = decoder->spec;
+    return decoder;
+}
+
+int
+SDL_WAVDecoderRead(SDL_WAVDecoder *decoder, void *buf, int len)
+{
+    Uint8 *dst = (Uint8 *)buf;
+    Sint64 count, got;
+    int total = 0;
+
+    if (decoder == NULL) {
+        return SDL_InvalidParamError("decoder");
+    } else if (buf == NULL) {
+        return SDL_InvalidParamError("buf");
+    } else if (len < 0) {
+        return SDL_InvalidParamError("len");
+    }
+
+    count = len / decoder->framesize;
+    if (count > decoder->file.sampleframes - decoder->position) {
+        count = decoder->file.sampleframes - decoder->position;
+    }
+
+    while (count > 0) {
+        if (WaveIsADPCM(&decoder->file)) {
+            const Sint16 *frames;
+            got = WaveStreamPeekADPCM(decoder, &frames);
+            if (got > 0) {
+                got = (got < count) ? got : count;
+                SDL_memcpy(dst, frames, (size_t)got * decoder->framesize);
+            }
+        } else {
+            got = WaveStreamReadPCM(decoder, dst, count);
+        }
+
+        if (got <= 0) {
+            /* Return what we have; the error surfaces on the next call. */
+            return (total > 0) ? total : -1;
+        }
+
+        decoder->position += got;
+        dst += (size_t)got * decoder->framesize;
+        total += (int)(got * decoder->framesize);
+        count -= got;
+    }
+
+    return total;
+}
+
+int
+SDL_WAVDecoderPutStream(SDL_WAVDecoder *decoder, SDL_AudioStream *stream, int len)
+{
+    Sint64 count, got;
+    int total = 0;
+
+    if (decoder == NULL) {
+        return SDL_InvalidParamError("decoder");
+    } else if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    } else if (len < 0) {
+        return SDL_InvalidParamError("len");
+    }
+
+    count = len / decoder->framesize;
+    if (count > decoder->file.sampleframes - decoder->position) {
+        count = decoder->file.sampleframes - decoder->position;
+    }
+
+    while (count > 0) {
+        const void *data;
+
+        if (WaveIsADPCM(&decoder->file)) {
+            /* The decoded block goes to the stream without another copy. */
+            const Sint16 *frames;
+            got = WaveStreamPeekADPCM(decoder, &frames);
+            data = frames;
+        } else {
+            const Sint64 chunkframes = WAVE_STREAM_CHUNK / decoder->framesize;
+            if (decoder->scratch == NULL) {
+                decoder->scratch = (Uint8 *)SDL_malloc(WAVE_STREAM_CHUNK);
+                if (decoder->scratch == NULL) {
+                    return SDL_OutOfMemory();
+                }
+            }
+            got = WaveStreamReadPCM(decoder, decoder->scratch, (count < chunkframes) ? count : chunkframes);
+            data = decoder->scratch;
+        }
+
+        if (got <= 0) {
+            return (total > 0) ? total : -1;
+        }
+        got = (got < count) ? got : count;
+
+        if (SDL_AudioStreamPut(stream, data, (int)(got * decoder->framesize)) < 0) {
+            return -1;
+        }
+
+        decoder->position += got;
+        total += (int)(got * decoder->framesize);
+        count -= got;
+    }
+
+    return total;
+}
+
+int
+SDL_WAVDecoderSeek(SDL_WAVDecoder *decoder, Sint64 frame)
+{
+    if (decoder == NULL) {
+        return SDL_InvalidParamError("decoder");
+    } else if (frame < 0 || frame > decoder->file.sampleframes) {
+        return SDL_InvalidParamError("frame");
+    }
+
+    /* The data is read and decoded from the new position on the next read. */
+    decoder->position = frame;
+    return 0;
+}
+
+Sint64
+SDL_WAVDecoderTell(SDL_WAVDecoder *decoder)
+{
+    if (decoder == NULL) {
+        return SDL_InvalidParamError("decoder");
+    }
+    return decoder->position;
+}
+
+Sint64
+SDL_WAVDecoderLength(SDL_WAVDecoder *decoder)
+{
+    if (decoder == NULL) {
+        return SDL_InvalidParamError("decoder");
+    }
+    return decoder->file.sampleframes;
+}
+
+void
+SDL_CloseWAVDecoder(SDL_WAVDecoder *decoder)
+{
+    if (decoder == NULL) {
+        return;
+    }
+
+    if (decoder->freesrc) {
+        SDL_RWclose(decoder->src);
+    } else {
+        SDL_RWseek(decoder->src, decoder->endposition, RW_SEEK_SET);
+    }
+    WaveFreeChunkData(&decoder->file.chunk);
+    SDL_free(decoder->file.decoderdata);
+    SDL_free(decoder->block);
+    SDL_free(decoder->decoded);
+    SDL_free(decoder->cstate);
+    SDL_free(decoder->scratch);
+    SDL_free(decoder);
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -101,6 +101,7 @@ static int (*ALSA_snd_device_name_hint) (int, const char *, void ***);
 static char* (*ALSA_snd_device_name_get_hint) (const void *, const char *);
 static int (*ALSA_snd_device_name_free_hint) (void **);
 static snd_pcm_sframes_t (*ALSA_snd_pcm_avail)(snd_pcm_t *);
+static int (*ALSA_snd_pcm_delay)(snd_pcm_t *, snd_pcm_sframes_t *);
 #ifdef SND_CHMAP_API_VERSION
 static snd_pcm_chmap_t* (*ALSA_snd_pcm_get_chmap) (snd_pcm_t *);
 static int (*ALSA_snd_pcm_chmap_print) (const snd_pcm_chmap_t *map, size_t maxlen, char *buf);
@@ -171,6 +172,7 @@ load_alsa_syms(void)
     SDL_ALSA_SYM(snd_device_name_get_hint);
     SDL_ALSA_SYM(snd_device_name_free_hint);
     SDL_ALSA_SYM(snd_pcm_avail);
+    SDL_ALSA_SYM(snd_pcm_delay);
 #ifdef SND_CHMAP_API_VERSION
     SDL_ALSA_SYM(snd_pcm_get_chmap);
     SDL_ALSA_SYM(snd_pcm_chmap_print);
@@ -470,6 +472,17 @@ ALSA_FlushCapture(_THIS)
     ALSA_snd_pcm_reset(this->hidden->pcm_handle);
 }
 
+static int
+ALSA_GetDeviceDelay(_THIS)
+{
+    snd_pcm_sframes_t delay = 0;
+
+    if (ALSA_snd_pcm_delay(this->hidden->pcm_handle, &delay) < 0) {
+        return -1;
+    }
+    return (int) SDL_max(delay, 0);
+}
+
 static void
 ALSA_CloseDevice(_THIS)
 {
@@ -1014,6 +1027,7 @@ ALSA_Init(SDL_AudioDriverImpl * impl)
     impl->Deinitialize = ALSA_Deinitialize;
     impl->CaptureFromDevice = ALSA_CaptureFromDevice;
     impl->FlushCapture = ALSA_FlushCapture;
+    impl->GetDeviceDelay = ALSA_GetDeviceDelay;
 
     impl->HasCaptureSupport = SDL_TRUE;
 
@@ -31,6 +31,7 @@
 #include "SDL_rwops.h"
 #include "SDL_timer.h"
 #include "SDL_audio.h"
+#include "SDL_hints.h"
 #include "../SDL_audio_c.h"
 #include "SDL_diskaudio.h"
 
@@ -42,33 +43,53 @@
 #define DISKDEFAULT_INFILE      "sdlaudio-in.raw"
 #define DISKENVR_IODELAY      "SDL_DISKAUDIODELAY"
 
+/* With a virtual clock, buffers are collected and written in chunks of about this size. */
+#define DISK_BATCH_BYTES    (1024 * 1024)
+
 /* This function waits until it is possible to write a full sound buffer */
 static void
 DISKAUDIO_WaitDevice(_THIS)
 {
-    SDL_Delay(_this->hidden->io_delay);
+    if (_this->hidden->io_delay) {
+        SDL_Delay(_this->hidden->io_delay);
+    }
+}
+
+static SDL_bool
+DISKAUDIO_FlushOutput(_THIS)
+{
+    struct SDL_PrivateAudioData *h = _this->hidden;
+    const size_t written = SDL_RWwrite(h->io, h->mixbuf, 1, h->mixbuf_used);
+    const SDL_bool retval = (written == h->mixbuf_used) ? SDL_TRUE : SDL_FALSE;
+
+#ifdef DEBUG_AUDIO
+    fprintf(stderr, "Wrote %d bytes of audio data\n", (int) written);
+#endif
+    h->mixbuf_used = 0;
+    return retval;
 }
 
 static void
 DISKAUDIO_PlayDevice(_THIS)
 {
-    const size_t written = SDL_RWwrite(_this->hidden->io,
-                                       _this->hidden->mixbuf,
-                                       1, _this->spec.size);
+    struct SDL_PrivateAudioData *h = _this->hidden;
+
+    /* the buffer was mixed in place, just keep it until the batch is full. */
+    h->mixbuf_used += _this->spec.size;
+    if (h->mixbuf_used < h->mixbuf_len) {
+        return;
+    }
 
     /* If we couldn't write, assume fatal error for now */
-    if (written != _this->spec.size) {
+    if (!DISKAUDIO_FlushOutput(_this)) {
         SDL_OpenedAudioDeviceDisconnected(_this);
     }
-#ifdef DEBUG_AUDIO
-    fprintf(stderr, "Wrote %d bytes of audio data\n", written);
-#endif
 }
 
 static Uint8 *
 DISKAUDIO_GetDeviceBuf(_THIS)
 {
-    return (_this->hidden->mixbuf);
+    return (_this->hidden->mixbuf + _this->hidden->mixbuf_used);
 }
 
 static int
@@ -77,7 +98,9 @@ DISKAUDIO_CaptureFromDevice(_THIS, void *buffer, int buflen)
     struct SDL_PrivateAudioData *h = _this->hidden;
     const int origbuflen = buflen;
 
-    SDL_Delay(h->io_delay);
+    if (h->io_delay) {
+        SDL_Delay(h->io_delay);
+    }
 
     if (h->io) {
         const size_t br = SDL_RWread(h->io, buffer, 1, buflen);
@@ -106,6 +129,9 @@ static void
 DISKAUDIO_CloseDevice(_THIS)
 {
     if (_this->hidden->io != NULL) {
+        if (_this->hidden->mixbuf_used) {
+            DISKAUDIO_FlushOutput(_this);
+        }
         SDL_RWclose(_this->hidden->io);
     }
     SDL_free(_this->hidden->mixbuf);
@@ -139,7 +165,10 @@ DISKAUDIO_OpenDevice(_THIS, void *handle, const char *devname, int iscapture)
     }
     SDL_zerop(_this->hidden);
 
-    if (envr != NULL) {
+    _this->virtual_clock = SDL_GetHintBoolean(SDL_HINT_AUDIO_VIRTUAL_CLOCK, SDL_FALSE);
+    if (_this->virtual_clock) {
+        _this->hidden->io_delay = 0;
+    } else if (envr != NULL) {
         _this->hidden->io_delay = SDL_atoi(envr);
     } else {
         _this->hidden->io_delay = ((_this->spec.samples * 1000) / _this->spec.freq);
@@ -153,11 +182,18 @@ DISKAUDIO_OpenDevice(_THIS, void *handle, const char *devname, int iscapture)
 
     /* Allocate mixing buffer */
     if (!iscapture) {
-        _this->hidden->mixbuf = (Uint8 *) SDL_malloc(_this->spec.size);
+        /* In real time, every buffer goes to the file as soon as it's played.
+           Otherwise, nobody is listening, so fewer and larger writes win. */
+        Uint32 buffers = 1;
+        if (_this->virtual_clock && _this->spec.size < DISK_BATCH_BYTES) {
+            buffers = DISK_BATCH_BYTES / _this->spec.size;
+        }
+        _this->hidden->mixbuf_len = buffers * _this->spec.size;
+        _this->hidden->mixbuf = (Uint8 *) SDL_malloc(_this->hidden->mixbuf_len);
         if (_this->hidden->mixbuf == NULL) {
             return SDL_OutOfMemory();
         }
-        SDL_memset(_this->hidden->mixbuf, _this->spec.silence, _this->spec.size);
+        SDL_memset(_this->hidden->mixbuf, _this->spec.silence, _this->hidden->mixbuf_len);
     }
 
     SDL_LogCritical(SDL_LOG_CATEGORY_AUDIO,
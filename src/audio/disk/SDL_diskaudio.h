@@ -35,6 +35,8 @@ struct SDL_PrivateAudioData
     SDL_RWops *io;
     Uint32 io_delay;
     Uint8 *mixbuf;
+    Uint32 mixbuf_len;   /* a whole number of device buffers */
+    Uint32 mixbuf_used;  /* bytes played but not written to the file yet */
 };
 
 #endif /* SDL_diskaudio_h_ */
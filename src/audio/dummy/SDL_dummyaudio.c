@@ -24,6 +24,7 @@
 
 #include "SDL_timer.h"
 #include "SDL_audio.h"
+#include "SDL_hints.h"
 #include "../SDL_audio_c.h"
 #include "SDL_dummyaudio.h"
 
@@ -31,6 +32,7 @@ static int
 DUMMYAUDIO_OpenDevice(_THIS, void *handle, const char *devname, int iscapture)
 {
     _this->hidden = (void *) 0x1;  /* just something non-NULL */
+    _this->virtual_clock = SDL_GetHintBoolean(SDL_HINT_AUDIO_VIRTUAL_CLOCK, SDL_FALSE);
     return 0;                   /* always succeeds. */
 }
 
@@ -38,7 +40,9 @@ static int
 DUMMYAUDIO_CaptureFromDevice(_THIS, void *buffer, int buflen)
 {
     /* Delay to make this sort of simulate real audio input. */
-    SDL_Delay((_this->spec.samples * 1000) / _this->spec.freq);
+    if (!_this->virtual_clock) {
+        SDL_Delay((_this->spec.samples * 1000) / _this->spec.freq);
+    }
 
     /* always return a full buffer of silence. */
     SDL_memset(buffer, _this->spec.silence, buflen);
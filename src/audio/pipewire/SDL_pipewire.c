@@ -28,6 +28,7 @@
 #include "SDL_loadso.h"
 #include "SDL_pipewire.h"
 
+#include <time.h>
 #include <pipewire/extensions/metadata.h>
 #include <spa/param/audio/format-utils.h>
 
@@ -85,6 +86,7 @@ static int (*PIPEWIRE_pw_stream_connect)(struct pw_stream *, enum pw_direction,
 static enum pw_stream_state (*PIPEWIRE_pw_stream_get_state)(struct pw_stream *stream, const char **error);
 static struct pw_buffer *(*PIPEWIRE_pw_stream_dequeue_buffer)(struct pw_stream *);
 static int (*PIPEWIRE_pw_stream_queue_buffer)(struct pw_stream *, struct pw_buffer *);
+static int (*PIPEWIRE_pw_stream_get_time)(struct pw_stream *, struct pw_time *);
 static struct pw_properties *(*PIPEWIRE_pw_properties_new)(const char *, ...)SPA_SENTINEL;
 static void (*PIPEWIRE_pw_properties_free)(struct pw_properties *);
 static int (*PIPEWIRE_pw_properties_set)(struct pw_properties *, const char *, const char *);
@@ -175,6 +177,7 @@ load_pipewire_syms()
     SDL_PIPEWIRE_SYM(pw_stream_get_state);
     SDL_PIPEWIRE_SYM(pw_stream_dequeue_buffer);
     SDL_PIPEWIRE_SYM(pw_stream_queue_buffer);
+    SDL_PIPEWIRE_SYM(pw_stream_get_time);
     SDL_PIPEWIRE_SYM(pw_properties_new);
     SDL_PIPEWIRE_SYM(pw_properties_free);
     SDL_PIPEWIRE_SYM(pw_properties_set);
@@ -1165,6 +1168,28 @@ PIPEWIRE_OpenDevice(_THIS, void *handle, const char *devname, int iscapture)
     return 0;
 }
 
+/* Safe to call from any thread, the stream timing is kept in shared memory */
+static int PIPEWIRE_GetDeviceDelay(_THIS)
+{
+    struct pw_time  time;
+    struct timespec now;
+    Sint64          delay_ns;
+
+    if (!this->hidden->stream || PIPEWIRE_pw_stream_get_time(this->hidden->stream, &time) < 0 || time.rate.denom == 0) {
+        return -1;
+    }
+
+    /* The delay is in units of the graph clock rate, measured at time.now */
+    delay_ns = (time.delay * SPA_NSEC_PER_SEC * time.rate.num) / time.rate.denom;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    delay_ns -= SPA_TIMESPEC_TO_NSEC(&now) - time.now;
+
+    if (delay_ns <= 0) {
+        return 0;
+    }
+    return (int)((delay_ns * this->spec.freq) / SPA_NSEC_PER_SEC);
+}
+
 static void PIPEWIRE_CloseDevice(_THIS)
 {
     if (this->hidden->loop) {
@@ -1220,6 +1245,7 @@ PIPEWIRE_Init(SDL_AudioDriverImpl *impl)
     impl->DetectDevices = PIPEWIRE_DetectDevices;
     impl->OpenDevice    = PIPEWIRE_OpenDevice;
     impl->CloseDevice   = PIPEWIRE_CloseDevice;
+    impl->GetDeviceDelay = PIPEWIRE_GetDeviceDelay;
     impl->Deinitialize  = PIPEWIRE_Deinitialize;
 
     impl->HasCaptureSupport         = 1;
@@ -117,6 +117,7 @@ static int (*PULSEAUDIO_pa_stream_peek) (pa_stream *, const void **, size_t *);
 static int (*PULSEAUDIO_pa_stream_drop) (pa_stream *);
 static pa_operation * (*PULSEAUDIO_pa_stream_flush) (pa_stream *,
     pa_stream_success_cb_t, void *);
+static int (*PULSEAUDIO_pa_stream_get_latency) (pa_stream *, pa_usec_t *, int *);
 static int (*PULSEAUDIO_pa_stream_disconnect) (pa_stream *);
 static void (*PULSEAUDIO_pa_stream_unref) (pa_stream *);
 
@@ -225,6 +226,7 @@ load_pulseaudio_syms(void)
     SDL_PULSEAUDIO_SYM(pa_stream_begin_write);
     SDL_PULSEAUDIO_SYM(pa_stream_cancel_write);
     SDL_PULSEAUDIO_SYM(pa_stream_drain);
+    SDL_PULSEAUDIO_SYM(pa_stream_get_latency);
     SDL_PULSEAUDIO_SYM(pa_stream_disconnect);
     SDL_PULSEAUDIO_SYM(pa_stream_peek);
     SDL_PULSEAUDIO_SYM(pa_stream_drop);
@@ -486,6 +488,21 @@ PULSEAUDIO_FlushCapture(_THIS)
     }
 }
 
+static int
+PULSEAUDIO_GetDeviceDelay(_THIS)
+{
+    pa_usec_t latency = 0;
+    int negative = 0;
+
+    if (PULSEAUDIO_pa_stream_get_latency(this->hidden->stream, &latency, &negative) < 0) {
+        return -1;
+    }
+    if (negative) {
+        return 0;
+    }
+    return (int) ((latency * this->spec.freq) / 1000000);
+}
+
 static void
 PULSEAUDIO_CloseDevice(_THIS)
 {
@@ -679,6 +696,8 @@ PULSEAUDIO_OpenDevice(_THIS, void *handle, const char *devname, int iscapture)
     if (iscapture) {
         rc = PULSEAUDIO_pa_stream_connect_record(h->stream, h->device_name, &paattr, flags);
     } else {
+        /* Keep the timing info current, for PULSEAUDIO_GetDeviceDelay() */
+        flags |= PA_STREAM_INTERPOLATE_TIMING | PA_STREAM_AUTO_TIMING_UPDATE;
         rc = PULSEAUDIO_pa_stream_connect_playback(h->stream, h->device_name, &paattr, flags, NULL, NULL);
     }
 
@@ -856,6 +875,7 @@ PULSEAUDIO_Init(SDL_AudioDriverImpl * impl)
     impl->Deinitialize = PULSEAUDIO_Deinitialize;
     impl->CaptureFromDevice = PULSEAUDIO_CaptureFromDevice;
     impl->FlushCapture = PULSEAUDIO_FlushCapture;
+    impl->GetDeviceDelay = PULSEAUDIO_GetDeviceDelay;
 
     impl->HasCaptureSupport = SDL_TRUE;
 
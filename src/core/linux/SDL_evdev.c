@@ -45,6 +45,7 @@
 #include "../../events/scancodes_linux.h" /* adds linux_scancode_table */
 #include "../../core/linux/SDL_evdev_capabilities.h"
 #include "../../core/linux/SDL_udev.h"
+#include "../../core/linux/SDL_inputthread.h"
 
 /* These are not defined in older Linux kernel headers */
 #ifndef SYN_DROPPED
@@ -99,6 +100,12 @@ typedef struct SDL_evdevlist_item
     SDL_bool high_res_wheel;
     SDL_bool high_res_hwheel;
 
+    /* Set when the device is read by the input thread */
+    SDL_bool threaded;
+
+    /* Set when the kernel timestamps events with CLOCK_MONOTONIC */
+    SDL_bool monotonic_timestamps;
+
     struct SDL_evdevlist_item *next;
 } SDL_evdevlist_item;
 
@@ -109,6 +116,7 @@ typedef struct SDL_EVDEV_PrivateData
     SDL_evdevlist_item *first;
     SDL_evdevlist_item *last;
     SDL_EVDEV_keyboard_state *kbd;
+    SDL_bool input_thread;
 } SDL_EVDEV_PrivateData;
 
 #undef _THIS
@@ -175,6 +183,7 @@ SDL_EVDEV_Init(void)
 #endif /* SDL_USE_LIBUDEV */
 
         _this->kbd = SDL_EVDEV_kbd_init();
+        _this->input_thread = SDL_InputThread_Init();
     }
 
     SDL_GetMouse()->SetRelativeMouseMode = SDL_EVDEV_SetRelativeMouseMode;
@@ -206,6 +215,10 @@ SDL_EVDEV_Quit(void)
             SDL_EVDEV_device_removed(_this->first->path);
         }
 
+        if (_this->input_thread) {
+            SDL_InputThread_Quit();
+        }
+
         SDL_assert(_this->first == NULL);
         SDL_assert(_this->last == NULL);
         SDL_assert(_this->num_devices == 0);
@@ -246,221 +259,244 @@ static void SDL_EVDEV_udev_callback(SDL_UDEV_deviceevent udev_event, int udev_cl
 }
 #endif /* SDL_USE_LIBUDEV */
 
-void 
-SDL_EVDEV_Poll(void)
+static int
+SDL_EVDEV_read(SDL_evdevlist_item *item, struct input_event *events, size_t size)
+{
+    if (item->threaded) {
+        /* Already read from the device by the input thread */
+        return SDL_InputThread_Read(item->fd, events, size);
+    }
+    return read(item->fd, events, size);
+}
+
+static void
+SDL_EVDEV_read_device(SDL_evdevlist_item *item)
 {
     struct input_event events[32];
     int i, j, len;
-    SDL_evdevlist_item *item;
     SDL_Scancode scan_code;
     int mouse_button;
     SDL_Mouse *mouse;
     float norm_x, norm_y, norm_pressure;
 
-    if (!_this) {
-        return;
-    }
+    mouse = SDL_GetMouse();
 
-#if SDL_USE_LIBUDEV
-    SDL_UDEV_Poll();
-#endif
+    while ((len = SDL_EVDEV_read(item, events, (sizeof events))) > 0) {
+        len /= sizeof(events[0]);
+        for (i = 0; i < len; ++i) {
+            if (item->monotonic_timestamps) {
+                SDL_SetEventSourceTimestampNS(SDL_EVDEV_GetEventTimestampNS(&events[i]));
+            }
 
-    mouse = SDL_GetMouse();
+            /* special handling for touchscreen, that should eventually be
+               used for all devices */
+            if (item->out_of_sync && item->is_touchscreen &&
+                events[i].type == EV_SYN && events[i].code != SYN_REPORT) {
+                break;
+            }
 
-    for (item = _this->first; item != NULL; item = item->next) {
-        while ((len = read(item->fd, events, (sizeof events))) > 0) {
-            len /= sizeof(events[0]);
-            for (i = 0; i < len; ++i) {
-                /* special handling for touchscreen, that should eventually be
-                   used for all devices */
-                if (item->out_of_sync && item->is_touchscreen &&
-                    events[i].type == EV_SYN && events[i].code != SYN_REPORT) {
+            switch (events[i].type) {
+            case EV_KEY:
+                if (events[i].code >= BTN_MOUSE && events[i].code < BTN_MOUSE + SDL_arraysize(EVDEV_MouseButtons)) {
+                    mouse_button = events[i].code - BTN_MOUSE;
+                    if (events[i].value == 0) {
+                        SDL_SendMouseButton(mouse->focus, mouse->mouseID, SDL_RELEASED, EVDEV_MouseButtons[mouse_button]);
+                    } else if (events[i].value == 1) {
+                        SDL_SendMouseButton(mouse->focus, mouse->mouseID, SDL_PRESSED, EVDEV_MouseButtons[mouse_button]);
+                    }
                     break;
                 }
 
-                switch (events[i].type) {
-                case EV_KEY:
-                    if (events[i].code >= BTN_MOUSE && events[i].code < BTN_MOUSE + SDL_arraysize(EVDEV_MouseButtons)) {
-                        mouse_button = events[i].code - BTN_MOUSE;
-                        if (events[i].value == 0) {
-                            SDL_SendMouseButton(mouse->focus, mouse->mouseID, SDL_RELEASED, EVDEV_MouseButtons[mouse_button]);
-                        } else if (events[i].value == 1) {
-                            SDL_SendMouseButton(mouse->focus, mouse->mouseID, SDL_PRESSED, EVDEV_MouseButtons[mouse_button]);
-                        }
-                        break;
-                    }
-
-                    /* BTH_TOUCH event value 1 indicates there is contact with
-                       a touchscreen or trackpad (earlist finger's current
-                       position is sent in EV_ABS ABS_X/ABS_Y, switching to
-                       next finger after earlist is released) */
-                    if (item->is_touchscreen && events[i].code == BTN_TOUCH) {
-                        if (item->touchscreen_data->max_slots == 1) {
-                            if (events[i].value)
-                                item->touchscreen_data->slots[0].delta = EVDEV_TOUCH_SLOTDELTA_DOWN;
-                            else
-                                item->touchscreen_data->slots[0].delta = EVDEV_TOUCH_SLOTDELTA_UP;
-                        }
-                        break;
+                /* BTH_TOUCH event value 1 indicates there is contact with
+                   a touchscreen or trackpad (earlist finger's current
+                   position is sent in EV_ABS ABS_X/ABS_Y, switching to
+                   next finger after earlist is released) */
+                if (item->is_touchscreen && events[i].code == BTN_TOUCH) {
+                    if (item->touchscreen_data->max_slots == 1) {
+                        if (events[i].value)
+                            item->touchscreen_data->slots[0].delta = EVDEV_TOUCH_SLOTDELTA_DOWN;
+                        else
+                            item->touchscreen_data->slots[0].delta = EVDEV_TOUCH_SLOTDELTA_UP;
                     }
+                    break;
+                }
 
-                    /* Probably keyboard */
-                    scan_code = SDL_EVDEV_translate_keycode(events[i].code);
-                    if (scan_code != SDL_SCANCODE_UNKNOWN) {
-                        if (events[i].value == 0) {
-                            SDL_SendKeyboardKey(SDL_RELEASED, scan_code);
-                        } else if (events[i].value == 1 || events[i].value == 2 /* key repeated */) {
-                            SDL_SendKeyboardKey(SDL_PRESSED, scan_code);
-                        }
+                /* Probably keyboard */
+                scan_code = SDL_EVDEV_translate_keycode(events[i].code);
+                if (scan_code != SDL_SCANCODE_UNKNOWN) {
+                    if (events[i].value == 0) {
+                        SDL_SendKeyboardKey(SDL_RELEASED, scan_code);
+                    } else if (events[i].value == 1 || events[i].value == 2 /* key repeated */) {
+                        SDL_SendKeyboardKey(SDL_PRESSED, scan_code);
                     }
-                    SDL_EVDEV_kbd_keycode(_this->kbd, events[i].code, events[i].value);
-                    break;
-                case EV_ABS:
-                    switch(events[i].code) {
-                    case ABS_MT_SLOT:
-                        if (!item->is_touchscreen) /* FIXME: temp hack */
-                            break;
-                        item->touchscreen_data->current_slot = events[i].value;
-                        break;
-                    case ABS_MT_TRACKING_ID:
-                        if (!item->is_touchscreen) /* FIXME: temp hack */
-                            break;
-                        if (events[i].value >= 0) {
-                            item->touchscreen_data->slots[item->touchscreen_data->current_slot].tracking_id = events[i].value;
-                            item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta = EVDEV_TOUCH_SLOTDELTA_DOWN;
-                        } else {
-                            item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta = EVDEV_TOUCH_SLOTDELTA_UP;
-                        }
-                        break;
-                    case ABS_MT_POSITION_X:
-                        if (!item->is_touchscreen) /* FIXME: temp hack */
-                            break;
-                        item->touchscreen_data->slots[item->touchscreen_data->current_slot].x = events[i].value;
-                        if (item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta == EVDEV_TOUCH_SLOTDELTA_NONE) {
-                            item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta = EVDEV_TOUCH_SLOTDELTA_MOVE;
-                        }
-                        break;
-                    case ABS_MT_POSITION_Y:
-                        if (!item->is_touchscreen) /* FIXME: temp hack */
-                            break;
-                        item->touchscreen_data->slots[item->touchscreen_data->current_slot].y = events[i].value;
-                        if (item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta == EVDEV_TOUCH_SLOTDELTA_NONE) {
-                            item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta = EVDEV_TOUCH_SLOTDELTA_MOVE;
-                        }
-                        break;
-                    case ABS_MT_PRESSURE:
-                        if (!item->is_touchscreen) /* FIXME: temp hack */
-                            break;
-                        item->touchscreen_data->slots[item->touchscreen_data->current_slot].pressure = events[i].value;
-                        if (item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta == EVDEV_TOUCH_SLOTDELTA_NONE) {
-                            item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta = EVDEV_TOUCH_SLOTDELTA_MOVE;
-                        }
-                        break;
-                    case ABS_X:
-                        if (item->is_touchscreen) {
-                            if (item->touchscreen_data->max_slots != 1)
-                                break;
-                            item->touchscreen_data->slots[0].x = events[i].value;
-                        } else
-                            SDL_SendMouseMotion(mouse->focus, mouse->mouseID, SDL_FALSE, events[i].value, mouse->y);
-                        break;
-                    case ABS_Y:
-                        if (item->is_touchscreen) {
-                            if (item->touchscreen_data->max_slots != 1)
-                                break;
-                            item->touchscreen_data->slots[0].y = events[i].value;
-                        } else
-                            SDL_SendMouseMotion(mouse->focus, mouse->mouseID, SDL_FALSE, mouse->x, events[i].value);
+                }
+                SDL_EVDEV_kbd_keycode(_this->kbd, events[i].code, events[i].value);
+                break;
+            case EV_ABS:
+                switch(events[i].code) {
+                case ABS_MT_SLOT:
+                    if (!item->is_touchscreen) /* FIXME: temp hack */
                         break;
-                    default:
+                    item->touchscreen_data->current_slot = events[i].value;
+                    break;
+                case ABS_MT_TRACKING_ID:
+                    if (!item->is_touchscreen) /* FIXME: temp hack */
                         break;
+                    if (events[i].value >= 0) {
+                        item->touchscreen_data->slots[item->touchscreen_data->current_slot].tracking_id = events[i].value;
+                        item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta = EVDEV_TOUCH_SLOTDELTA_DOWN;
+                    } else {
+                        item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta = EVDEV_TOUCH_SLOTDELTA_UP;
                     }
                     break;
-                case EV_REL:
-                    switch(events[i].code) {
-                    case REL_X:
-                        SDL_SendMouseMotion(mouse->focus, mouse->mouseID, SDL_TRUE, events[i].value, 0);
-                        break;
-                    case REL_Y:
-                        SDL_SendMouseMotion(mouse->focus, mouse->mouseID, SDL_TRUE, 0, events[i].value);
-                        break;
-                    case REL_WHEEL:
-                        if (!item->high_res_wheel)
-                            SDL_SendMouseWheel(mouse->focus, mouse->mouseID, 0, events[i].value, SDL_MOUSEWHEEL_NORMAL);
+                case ABS_MT_POSITION_X:
+                    if (!item->is_touchscreen) /* FIXME: temp hack */
                         break;
-                    case REL_WHEEL_HI_RES:
-                        SDL_assert(item->high_res_wheel);
-                        SDL_SendMouseWheel(mouse->focus, mouse->mouseID, 0, events[i].value / 120.0f, SDL_MOUSEWHEEL_NORMAL);
-                        break;
-                    case REL_HWHEEL:
-                        if (!item->high_res_hwheel)
-                            SDL_SendMouseWheel(mouse->focus, mouse->mouseID, events[i].value, 0, SDL_MOUSEWHEEL_NORMAL);
-                        break;
-                    case REL_HWHEEL_HI_RES:
-                        SDL_assert(item->high_res_hwheel);
-                        SDL_SendMouseWheel(mouse->focus, mouse->mouseID, events[i].value / 120.0f, 0, SDL_MOUSEWHEEL_NORMAL);
+                    item->touchscreen_data->slots[item->touchscreen_data->current_slot].x = events[i].value;
+                    if (item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta == EVDEV_TOUCH_SLOTDELTA_NONE) {
+                        item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta = EVDEV_TOUCH_SLOTDELTA_MOVE;
+                    }
+                    break;
+                case ABS_MT_POSITION_Y:
+                    if (!item->is_touchscreen) /* FIXME: temp hack */
                         break;
-                    default:
+                    item->touchscreen_data->slots[item->touchscreen_data->current_slot].y = events[i].value;
+                    if (item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta == EVDEV_TOUCH_SLOTDELTA_NONE) {
+                        item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta = EVDEV_TOUCH_SLOTDELTA_MOVE;
+                    }
+                    break;
+                case ABS_MT_PRESSURE:
+                    if (!item->is_touchscreen) /* FIXME: temp hack */
                         break;
+                    item->touchscreen_data->slots[item->touchscreen_data->current_slot].pressure = events[i].value;
+                    if (item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta == EVDEV_TOUCH_SLOTDELTA_NONE) {
+                        item->touchscreen_data->slots[item->touchscreen_data->current_slot].delta = EVDEV_TOUCH_SLOTDELTA_MOVE;
                     }
                     break;
-                case EV_SYN:
-                    switch (events[i].code) {
-                    case SYN_REPORT:
-                        if (!item->is_touchscreen) /* FIXME: temp hack */
+                case ABS_X:
+                    if (item->is_touchscreen) {
+                        if (item->touchscreen_data->max_slots != 1)
+                            break;
+                        item->touchscreen_data->slots[0].x = events[i].value;
+                    } else
+                        SDL_SendMouseMotion(mouse->focus, mouse->mouseID, SDL_FALSE, events[i].value, mouse->y);
+                    break;
+                case ABS_Y:
+                    if (item->is_touchscreen) {
+                        if (item->touchscreen_data->max_slots != 1)
                             break;
+                        item->touchscreen_data->slots[0].y = events[i].value;
+                    } else
+                        SDL_SendMouseMotion(mouse->focus, mouse->mouseID, SDL_FALSE, mouse->x, events[i].value);
+                    break;
+                default:
+                    break;
+                }
+                break;
+            case EV_REL:
+                switch(events[i].code) {
+                case REL_X:
+                    SDL_SendMouseMotion(mouse->focus, mouse->mouseID, SDL_TRUE, events[i].value, 0);
+                    break;
+                case REL_Y:
+                    SDL_SendMouseMotion(mouse->focus, mouse->mouseID, SDL_TRUE, 0, events[i].value);
+                    break;
+                case REL_WHEEL:
+                    if (!item->high_res_wheel)
+                        SDL_SendMouseWheel(mouse->focus, mouse->mouseID, 0, events[i].value, SDL_MOUSEWHEEL_NORMAL);
+                    break;
+                case REL_WHEEL_HI_RES:
+                    SDL_assert(item->high_res_wheel);
+                    SDL_SendMouseWheel(mouse->focus, mouse->mouseID, 0, events[i].value / 120.0f, SDL_MOUSEWHEEL_NORMAL);
+                    break;
+                case REL_HWHEEL:
+                    if (!item->high_res_hwheel)
+                        SDL_SendMouseWheel(mouse->focus, mouse->mouseID, events[i].value, 0, SDL_MOUSEWHEEL_NORMAL);
+                    break;
+                case REL_HWHEEL_HI_RES:
+                    SDL_assert(item->high_res_hwheel);
+                    SDL_SendMouseWheel(mouse->focus, mouse->mouseID, events[i].value / 120.0f, 0, SDL_MOUSEWHEEL_NORMAL);
+                    break;
+                default:
+                    break;
+                }
+                break;
+            case EV_SYN:
+                switch (events[i].code) {
+                case SYN_REPORT:
+                    if (!item->is_touchscreen) /* FIXME: temp hack */
+                        break;
+
+                    for(j = 0; j < item->touchscreen_data->max_slots; j++) {
+                        norm_x = (float)(item->touchscreen_data->slots[j].x - item->touchscreen_data->min_x) /
+                            (float)item->touchscreen_data->range_x;
+                        norm_y = (float)(item->touchscreen_data->slots[j].y - item->touchscreen_data->min_y) /
+                            (float)item->touchscreen_data->range_y;
 
-                        for(j = 0; j < item->touchscreen_data->max_slots; j++) {
-                            norm_x = (float)(item->touchscreen_data->slots[j].x - item->touchscreen_data->min_x) /
-                                (float)item->touchscreen_data->range_x;
-                            norm_y = (float)(item->touchscreen_data->slots[j].y - item->touchscreen_data->min_y) /
-                                (float)item->touchscreen_data->range_y;
-
-                            if (item->touchscreen_data->range_pressure > 0) {
-                                norm_pressure = (float)(item->touchscreen_data->slots[j].pressure - item->touchscreen_data->min_pressure) /
-                                    (float)item->touchscreen_data->range_pressure;
-                            } else {
-                                /* This touchscreen does not support pressure */
-                                norm_pressure = 1.0f;
-                            }
-
-                            /* FIXME: the touch's window shouldn't be null, but
-                             * the coordinate space of touch positions needs to
-                             * be window-relative in that case. */
-                            switch(item->touchscreen_data->slots[j].delta) {
-                            case EVDEV_TOUCH_SLOTDELTA_DOWN:
-                                SDL_SendTouch(item->fd, item->touchscreen_data->slots[j].tracking_id, NULL, SDL_TRUE, norm_x, norm_y, norm_pressure);
-                                item->touchscreen_data->slots[j].delta = EVDEV_TOUCH_SLOTDELTA_NONE;
-                                break;
-                            case EVDEV_TOUCH_SLOTDELTA_UP:
-                                SDL_SendTouch(item->fd, item->touchscreen_data->slots[j].tracking_id, NULL, SDL_FALSE, norm_x, norm_y, norm_pressure);
-                                item->touchscreen_data->slots[j].tracking_id = -1;
-                                item->touchscreen_data->slots[j].delta = EVDEV_TOUCH_SLOTDELTA_NONE;
-                                break;
-                            case EVDEV_TOUCH_SLOTDELTA_MOVE:
-                                SDL_SendTouchMotion(item->fd, item->touchscreen_data->slots[j].tracking_id, NULL, norm_x, norm_y, norm_pressure);
-                                item->touchscreen_data->slots[j].delta = EVDEV_TOUCH_SLOTDELTA_NONE;
-                                break;
-                            default:
-                                break;
-                            }
+                        if (item->touchscreen_data->range_pressure > 0) {
+                            norm_pressure = (float)(item->touchscreen_data->slots[j].pressure - item->touchscreen_data->min_pressure) /
+                                (float)item->touchscreen_data->range_pressure;
+                        } else {
+                            /* This touchscreen does not support pressure */
+                            norm_pressure = 1.0f;
                         }
 
-                        if (item->out_of_sync)
-                            item->out_of_sync = 0;
-                        break;
-                    case SYN_DROPPED:
-                        if (item->is_touchscreen)
-                            item->out_of_sync = 1;
-                        SDL_EVDEV_sync_device(item);
-                        break;
-                    default:
-                        break;
+                        /* FIXME: the touch's window shouldn't be null, but
+                         * the coordinate space of touch positions needs to
+                         * be window-relative in that case. */
+                        switch(item->touchscreen_data->slots[j].delta) {
+                        case EVDEV_TOUCH_SLOTDELTA_DOWN:
+                            SDL_SendTouch(item->fd, item->touchscreen_data->slots[j].tracking_id, NULL, SDL_TRUE, norm_x, norm_y, norm_pressure);
+                            item->touchscreen_data->slots[j].delta = EVDEV_TOUCH_SLOTDELTA_NONE;
+                            break;
+                        case EVDEV_TOUCH_SLOTDELTA_UP:
+                            SDL_SendTouch(item->fd, item->touchscreen_data->slots[j].tracking_id, NULL, SDL_FALSE, norm_x, norm_y, norm_pressure);
+                            item->touchscreen_data->slots[j].tracking_id = -1;
+                            item->touchscreen_data->slots[j].delta = EVDEV_TOUCH_SLOTDELTA_NONE;
+                            break;
+                        case EVDEV_TOUCH_SLOTDELTA_MOVE:
+                            SDL_SendTouchMotion(item->fd, item->touchscreen_data->slots[j].tracking_id, NULL, norm_x, norm_y, norm_pressure);
+                            item->touchscreen_data->slots[j].delta = EVDEV_TOUCH_SLOTDELTA_NONE;
+                            break;
+                        default:
+                            break;
+                        }
                     }
+
+                    if (item->out_of_sync)
+                        item->out_of_sync = 0;
+                    break;
+                case SYN_DROPPED:
+                    if (item->is_touchscreen)
+                        item->out_of_sync = 1;
+                    SDL_EVDEV_sync_device(item);
+                    break;
+                default:
                     break;
                 }
+                break;
             }
-        }    
+        }
+    }    
+
+    SDL_SetEventSourceTimestampNS(0);
+}
+
+void 
+SDL_EVDEV_Poll(void)
+{
+    SDL_evdevlist_item *item;
+
+    if (!_this) {
+        return;
+    }
+
+#if SDL_USE_LIBUDEV
+    SDL_UDEV_Poll();
+#endif
+
+    for (item = _this->first; item != NULL; item = item->next) {
+        SDL_EVDEV_read_device(item);
     }
 }
 
@@ -759,6 +795,8 @@ SDL_EVDEV_device_added(const char *dev_path, int udev_class)
         return SDL_OutOfMemory();
     }
 
+    item->monotonic_timestamps = SDL_EVDEV_SetMonotonicTimestamps(item->fd);
+
     if (ioctl(item->fd, EVIOCGBIT(EV_REL, sizeof(relbit)), relbit) >= 0) {
         item->high_res_wheel = test_bit(REL_WHEEL_HI_RES, relbit);
         item->high_res_hwheel = test_bit(REL_HWHEEL_HI_RES, relbit);
@@ -784,6 +822,10 @@ SDL_EVDEV_device_added(const char *dev_path, int udev_class)
 
     SDL_EVDEV_sync_device(item);
 
+    if (_this->input_thread) {
+        item->threaded = (SDL_InputThread_AddFd(item->fd, sizeof(struct input_event)) == 0);
+    }
+
     return _this->num_devices++;
 }
 #endif /* SDL_USE_LIBUDEV */
@@ -806,6 +848,9 @@ SDL_EVDEV_device_removed(const char *dev_path)
             if (item == _this->last) {
                 _this->last = prev;
             }
+            if (item->threaded) {
+                SDL_InputThread_RemoveFd(item->fd);
+            }
             if (item->is_touchscreen) {
                 SDL_EVDEV_destroy_touchscreen(item);
             }
@@ -21,8 +21,12 @@
 */
 
 #include "SDL_evdev_capabilities.h"
+#include "SDL_timer.h"
 
-#if HAVE_LIBUDEV_H || defined(SDL_JOYSTICK_LINUX)
+#if HAVE_LIBUDEV_H || defined(SDL_JOYSTICK_LINUX) || defined(SDL_INPUT_LINUXEV)
+
+#include <time.h>
+#include <sys/ioctl.h>
 
 /* missing defines in older Linux kernel headers */
 #ifndef BTN_TRIGGER_HAPPY
@@ -142,4 +146,45 @@ SDL_EVDEV_GuessDeviceClass(unsigned long bitmask_ev[NBITS(EV_MAX)],
     return devclass;
 }
 
+SDL_bool
+SDL_EVDEV_SetMonotonicTimestamps(int fd)
+{
+#ifdef EVIOCSCLOCKID
+    int clock_id = CLOCK_MONOTONIC;
+
+    return (ioctl(fd, EVIOCSCLOCKID, &clock_id) == 0) ? SDL_TRUE : SDL_FALSE;
+#else
+    return SDL_FALSE;
+#endif
+}
+
+Uint64
+SDL_EVDEV_GetEventTimestampNS(const struct input_event *event)
+{
+    struct timespec now;
+    Uint64 now_ns, event_ns, ticks_ns;
+
+    /* Both clocks are sampled together, and the event is placed on the
+       SDL clock by how long ago it happened on the kernel clock. */
+    ticks_ns = SDL_GetTicksNS();
+    if (clock_gettime(CLOCK_MONOTONIC, &now) < 0) {
+        return 0;
+    }
+    now_ns = (Uint64)now.tv_sec * 1000000000 + now.tv_nsec;
+#ifdef input_event_sec
+    event_ns = (Uint64)event->input_event_sec * 1000000000 + (Uint64)event->input_event_usec * 1000;
+#else
+    event_ns = (Uint64)event->time.tv_sec * 1000000000 + (Uint64)event->time.tv_usec * 1000;
+#endif
+
+    if (event_ns >= now_ns) {
+        return ticks_ns;
+    }
+    if ((now_ns - event_ns) >= ticks_ns) {
+        /* The event happened before SDL was initialized */
+        return 0;
+    }
+    return ticks_ns - (now_ns - event_ns);
+}
+
 #endif
@@ -25,7 +25,7 @@
 #ifndef SDL_evdev_capabilities_h_
 #define SDL_evdev_capabilities_h_
 
-#if HAVE_LIBUDEV_H || defined(SDL_JOYSTICK_LINUX)
+#if HAVE_LIBUDEV_H || defined(SDL_JOYSTICK_LINUX) || defined(SDL_INPUT_LINUXEV)
 
 #include <linux/input.h>
 
@@ -53,7 +53,14 @@ extern int SDL_EVDEV_GuessDeviceClass(unsigned long bitmask_ev[NBITS(EV_MAX)],
                                       unsigned long bitmask_key[NBITS(KEY_MAX)],
                                       unsigned long bitmask_rel[NBITS(REL_MAX)]);
 
-#endif /* HAVE_LIBUDEV_H || defined(SDL_JOYSTICK_LINUX) */
+/* Ask the kernel to timestamp the device's events with CLOCK_MONOTONIC.
+   Returns SDL_FALSE if it can't, in which case the timestamps can't be used. */
+extern SDL_bool SDL_EVDEV_SetMonotonicTimestamps(int fd);
+
+/* Convert the CLOCK_MONOTONIC time of an event to the SDL_GetTicksNS() clock */
+extern Uint64 SDL_EVDEV_GetEventTimestampNS(const struct input_event *event);
+
+#endif /* HAVE_LIBUDEV_H || defined(SDL_JOYSTICK_LINUX) || defined(SDL_INPUT_LINUXEV) */
 
 #endif /* SDL_evdev_capabilities_h_ */
 
@@ -0,0 +1,442 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+#ifdef __LINUX__
+
+#include "SDL_inputthread.h"
+
+#if !SDL_THREADS_DISABLED
+
+/* A single thread that waits on an epoll set of input device descriptors
+   and drains their kernel buffers as soon as data arrives, so idle devices
+   cost nothing and the kernel never drops input between two calls to pump
+   events.
+
+   The thread only buffers the raw records. They are interpreted by whoever
+   calls SDL_InputThread_Read(), so device, mouse, keyboard and joystick
+   state is still only touched by the thread pumping events, and events are
+   delivered no sooner than without the thread. HIDAPI devices are polled
+   by their drivers and aren't handled here.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "SDL_hints.h"
+#include "SDL_atomic.h"
+#include "SDL_mutex.h"
+#include "SDL_thread.h"
+#include "../../thread/SDL_systhread.h"
+
+/* How many records are buffered for each descriptor before the thread
+   stops reading it, and leaves the rest in the kernel until there's room */
+#define INPUT_THREAD_BUFFERED_RECORDS   256
+
+typedef struct SDL_InputThreadSource
+{
+    int fd;
+    size_t record_size;
+    Uint8 *data;
+    size_t size;
+    size_t max_size;
+    SDL_bool watched;   /* SDL_FALSE while the buffer is full or the device is gone */
+    SDL_bool hangup;    /* Set when a read failed or hit the end of the device */
+    int error;          /* errno of the failed read, or 0 at the end of the device */
+} SDL_InputThreadSource;
+
+static SDL_SpinLock input_init_lock;
+static int input_refcount = 0;
+static SDL_Thread *input_thread = NULL;
+static SDL_mutex *input_lock = NULL;
+static SDL_atomic_t input_quit;
+static int input_epoll_fd = -1;
+static int input_wake_fd = -1;
+static SDL_InputThreadSource *input_sources = NULL;
+static int input_num_sources = 0;
+static int input_max_sources = 0;
+
+static SDL_InputThreadSource *
+SDL_InputThread_FindSource(int fd)
+{
+    int i;
+
+    for (i = 0; i < input_num_sources; ++i) {
+        if (input_sources[i].fd == fd) {
+            return &input_sources[i];
+        }
+    }
+    return NULL;
+}
+
+static int
+SDL_InputThread_Watch(SDL_InputThreadSource *source)
+{
+    struct epoll_event event;
+
+    SDL_zero(event);
+    event.events = EPOLLIN;
+    event.data.fd = source->fd;
+    if (epoll_ctl(input_epoll_fd, EPOLL_CTL_ADD, source->fd, &event) < 0) {
+        return -1;
+    }
+    source->watched = SDL_TRUE;
+    return 0;
+}
+
+static void
+SDL_InputThread_Unwatch(SDL_InputThreadSource *source)
+{
+    if (source->watched) {
+        epoll_ctl(input_epoll_fd, EPOLL_CTL_DEL, source->fd, NULL);
+        source->watched = SDL_FALSE;
+    }
+}
+
+/* Called with the input lock held */
+static void
+SDL_InputThread_Fill(SDL_InputThreadSource *source)
+{
+    size_t space;
+    ssize_t len;
+
+    if (!source->watched) {
+        return;
+    }
+
+    /* Devices only return whole records */
+    space = source->max_size - source->size;
+    space -= (space % source->record_size);
+
+    if (space > 0) {
+        len = read(source->fd, source->data + source->size, space);
+        if (len > 0) {
+            source->size += len;
+        } else if (len == 0 || (errno != EAGAIN && errno != EINTR)) {
+            /* The device is gone, report it once the data is used up */
+            source->hangup = SDL_TRUE;
+            source->error = (len < 0) ? errno : 0;
+            SDL_InputThread_Unwatch(source);
+            return;
+        }
+    }
+
+    if ((source->max_size - source->size) < source->record_size) {
+        /* Full, epoll is level triggered so this is resumed by reading */
+        SDL_InputThread_Unwatch(source);
+    }
+}
+
+static int SDLCALL
+SDL_InputThread_Run(void *data)
+{
+    struct epoll_event events[16];
+    SDL_InputThreadSource *source;
+    int i, count;
+
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
+    while (!SDL_AtomicGet(&input_quit)) {
+        count = epoll_wait(input_epoll_fd, events, SDL_arraysize(events), -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        for (i = 0; i < count; ++i) {
+            const int fd = events[i].data.fd;
+
+            if (fd == input_wake_fd) {
+                eventfd_t value;
+                eventfd_read(input_wake_fd, &value);
+                continue;
+            }
+
+            /* The lock keeps the descriptor from being closed while it's read */
+            SDL_LockMutex(input_lock);
+            source = SDL_InputThread_FindSource(fd);
+            if (source) {
+                SDL_InputThread_Fill(source);
+            }
+            SDL_UnlockMutex(input_lock);
+        }
+    }
+    return 0;
+}
+
+static void
+SDL_InputThread_Stop(void)
+{
+    int i;
+
+    if (input_thread) {
+        SDL_AtomicSet(&input_quit, 1);
+        eventfd_write(input_wake_fd, 1);
+        SDL_WaitThread(input_thread, NULL);
+        input_thread = NULL;
+    }
+    if (input_wake_fd >= 0) {
+        close(input_wake_fd);
+        input_wake_fd = -1;
+    }
+    if (input_epoll_fd >= 0) {
+        close(input_epoll_fd);
+        input_epoll_fd = -1;
+    }
+    if (input_lock) {
+        SDL_DestroyMutex(input_lock);
+        input_lock = NULL;
+    }
+    for (i = 0; i < input_num_sources; ++i) {
+        SDL_free(input_sources[i].data);
+    }
+    SDL_free(input_sources);
+    input_sources = NULL;
+    input_num_sources = 0;
+    input_max_sources = 0;
+}
+
+static int
+SDL_InputThread_Start(void)
+{
+    struct epoll_event event;
+
+    SDL_AtomicSet(&input_quit, 0);
+
+    input_lock = SDL_CreateMutex();
+    if (!input_lock) {
+        return -1;
+    }
+
+    input_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (input_epoll_fd < 0) {
+        SDL_InputThread_Stop();
+        return SDL_SetError("Couldn't create epoll instance: %s", strerror(errno));
+    }
+
+    input_wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (input_wake_fd < 0) {
+        SDL_InputThread_Stop();
+        return SDL_SetError("Couldn't create eventfd: %s", strerror(errno));
+    }
+
+    SDL_zero(event);
+    event.events = EPOLLIN;
+    event.data.fd = input_wake_fd;
+    if (epoll_ctl(input_epoll_fd, EPOLL_CTL_ADD, input_wake_fd, &event) < 0) {
+        SDL_InputThread_Stop();
+        return SDL_SetError("Couldn't watch eventfd: %s", strerror(errno));
+    }
+
+    input_thread = SDL_CreateThreadInternal(SDL_InputThread_Run, "SDLInput", 64 * 1024, NULL);
+    if (!input_thread) {
+        SDL_InputThread_Stop();
+        return -1;
+    }
+    return 0;
+}
+
+SDL_bool
+SDL_InputThread_Init(void)
+{
+    SDL_bool retval = SDL_FALSE;
+
+    SDL_AtomicLock(&input_init_lock);
+    if (input_refcount > 0) {
+        ++input_refcount;
+        retval = SDL_TRUE;
+    } else if (SDL_GetHintBoolean(SDL_HINT_LINUX_INPUT_THREAD, SDL_FALSE)) {
+        if (SDL_InputThread_Start() == 0) {
+            input_refcount = 1;
+            retval = SDL_TRUE;
+        }
+    }
+    SDL_AtomicUnlock(&input_init_lock);
+
+    return retval;
+}
+
+void
+SDL_InputThread_Quit(void)
+{
+    SDL_AtomicLock(&input_init_lock);
+    if (input_refcount > 0 && --input_refcount == 0) {
+        SDL_InputThread_Stop();
+    }
+    SDL_AtomicUnlock(&input_init_lock);
+}
+
+int
+SDL_InputThread_AddFd(int fd, size_t record_size)
+{
+    SDL_InputThreadSource *source;
+    Uint8 *data;
+
+    if (!input_thread) {
+        return SDL_SetError("Input thread isn't running");
+    }
+
+    data = (Uint8 *)SDL_malloc(record_size * INPUT_THREAD_BUFFERED_RECORDS);
+    if (!data) {
+        return SDL_OutOfMemory();
+    }
+
+    SDL_LockMutex(input_lock);
+    if (SDL_InputThread_FindSource(fd)) {
+        SDL_UnlockMutex(input_lock);
+        SDL_free(data);
+        return SDL_SetError("Descriptor %d is already registered", fd);
+    }
+
+    if (input_num_sources == input_max_sources) {
+        const int max_sources = input_max_sources + 8;
+        SDL_InputThreadSource *sources = (SDL_InputThreadSource *)SDL_realloc(input_sources, max_sources * sizeof(*sources));
+        if (!sources) {
+            SDL_UnlockMutex(input_lock);
+            SDL_free(data);
+            return SDL_OutOfMemory();
+        }
+        input_sources = sources;
+        input_max_sources = max_sources;
+    }
+
+    source = &input_sources[input_num_sources];
+    SDL_zerop(source);
+    source->fd = fd;
+    source->record_size = record_size;
+    source->data = data;
+    source->max_size = record_size * INPUT_THREAD_BUFFERED_RECORDS;
+    if (SDL_InputThread_Watch(source) < 0) {
+        SDL_UnlockMutex(input_lock);
+        SDL_free(data);
+        return SDL_SetError("Couldn't watch descriptor %d: %s", fd, strerror(errno));
+    }
+    ++input_num_sources;
+    SDL_UnlockMutex(input_lock);
+
+    return 0;
+}
+
+void
+SDL_InputThread_RemoveFd(int fd)
+{
+    SDL_InputThreadSource *source;
+
+    if (!input_thread) {
+        return;
+    }
+
+    SDL_LockMutex(input_lock);
+    source = SDL_InputThread_FindSource(fd);
+    if (source) {
+        SDL_InputThread_Unwatch(source);
+        SDL_free(source->data);
+        *source = input_sources[--input_num_sources];
+    }
+    SDL_UnlockMutex(input_lock);
+}
+
+int
+SDL_InputThread_Read(int fd, void *buf, size_t len)
+{
+    SDL_InputThreadSource *source;
+    int retval;
+
+    if (!input_thread) {
+        errno = EBADF;
+        return -1;
+    }
+
+    SDL_LockMutex(input_lock);
+    source = SDL_InputThread_FindSource(fd);
+    if (!source) {
+        errno = EBADF;
+        retval = -1;
+    } else if (source->size > 0) {
+        len -= (len % source->record_size);
+        len = SDL_min(len, source->size);
+        SDL_memcpy(buf, source->data, len);
+        source->size -= len;
+        SDL_memmove(source->data, source->data + len, source->size);
+        retval = (int)len;
+
+        if (!source->watched && !source->hangup) {
+            /* There's room again, anything left in the kernel is reported right away */
+            if (SDL_InputThread_Watch(source) < 0) {
+                source->hangup = SDL_TRUE;
+                source->error = errno;
+            }
+        }
+    } else if (source->hangup) {
+        errno = source->error;
+        retval = source->error ? -1 : 0;
+    } else {
+        errno = EAGAIN;
+        retval = -1;
+    }
+    SDL_UnlockMutex(input_lock);
+
+    return retval;
+}
+
+#else
+
+#include <errno.h>
+
+SDL_bool
+SDL_InputThread_Init(void)
+{
+    return SDL_FALSE;
+}
+
+void
+SDL_InputThread_Quit(void)
+{
+}
+
+int
+SDL_InputThread_AddFd(int fd, size_t record_size)
+{
+    return SDL_Unsupported();
+}
+
+void
+SDL_InputThread_RemoveFd(int fd)
+{
+}
+
+int
+SDL_InputThread_Read(int fd, void *buf, size_t len)
+{
+    errno = EBADF;
+    return -1;
+}
+
+#endif /* !SDL_THREADS_DISABLED */
+
+#endif /* __LINUX__ */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,58 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "../../SDL_internal.h"
+
+#ifndef SDL_inputthread_h_
+#define SDL_inputthread_h_
+
+#ifdef __LINUX__
+
+#include "SDL_stdinc.h"
+
+/* Returns SDL_TRUE if the input thread is enabled and running.
+   Each successful call must be balanced by SDL_InputThread_Quit().
+ */
+extern SDL_bool SDL_InputThread_Init(void);
+extern void SDL_InputThread_Quit(void);
+
+/* Starts reading a non-blocking descriptor on the input thread. The device
+   must return whole records of record_size bytes, which are buffered until
+   they're taken with SDL_InputThread_Read(). The thread never interprets
+   them, so all input state stays with the thread that reads them, and the
+   only thing gained is that the kernel buffer never overflows.
+
+   Once SDL_InputThread_RemoveFd() returns, the descriptor may be closed.
+ */
+extern int SDL_InputThread_AddFd(int fd, size_t record_size);
+extern void SDL_InputThread_RemoveFd(int fd);
+
+/* Works like read() on the descriptor: returns the number of bytes, 0 at the
+   end of the device, or -1 with errno set to EAGAIN if nothing is buffered
+   or to the error reading the device failed with.
+ */
+extern int SDL_InputThread_Read(int fd, void *buf, size_t len);
+
+#endif /* __LINUX__ */
+
+#endif /* SDL_inputthread_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
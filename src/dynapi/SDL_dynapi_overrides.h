@@ -855,3 +855,37 @@
 #define SDL_GameControllerHasRumbleTriggers SDL_GameControllerHasRumbleTriggers_REAL
 #define SDL_hid_ble_scan SDL_hid_ble_scan_REAL
 #define SDL_PremultiplyAlpha SDL_PremultiplyAlpha_REAL
+#define SDL_AtomicGetSpinLockStats SDL_AtomicGetSpinLockStats_REAL
+#define SDL_AtomicResetSpinLockStats SDL_AtomicResetSpinLockStats_REAL
+#define SDL_UnpremultiplyAlpha SDL_UnpremultiplyAlpha_REAL
+#define SDL_CreateTextureAtlas SDL_CreateTextureAtlas_REAL
+#define SDL_CreateAtlasTexture SDL_CreateAtlasTexture_REAL
+#define SDL_CreateAtlasTextureFromSurface SDL_CreateAtlasTextureFromSurface_REAL
+#define SDL_DestroyTextureAtlas SDL_DestroyTextureAtlas_REAL
+#define SDL_GameControllerAddMappingsFromCacheRW SDL_GameControllerAddMappingsFromCacheRW_REAL
+#define SDL_GameControllerSaveMappingCacheRW SDL_GameControllerSaveMappingCacheRW_REAL
+#define SDL_GetTicksNS SDL_GetTicksNS_REAL
+#define SDL_GetEventTimestampNS SDL_GetEventTimestampNS_REAL
+#define SDL_GetMotionHistory SDL_GetMotionHistory_REAL
+#define SDL_PollEvents SDL_PollEvents_REAL
+#define SDL_OpenAudioDevicePull SDL_OpenAudioDevicePull_REAL
+#define SDL_GetAudioDeviceBuffer SDL_GetAudioDeviceBuffer_REAL
+#define SDL_PlayAudioDeviceBuffer SDL_PlayAudioDeviceBuffer_REAL
+#define SDL_GetAudioDeviceDelay SDL_GetAudioDeviceDelay_REAL
+#define SDL_GetAudioDeviceTimeNS SDL_GetAudioDeviceTimeNS_REAL
+#define SDL_OpenWAVDecoder_RW SDL_OpenWAVDecoder_RW_REAL
+#define SDL_WAVDecoderRead SDL_WAVDecoderRead_REAL
+#define SDL_WAVDecoderPutStream SDL_WAVDecoderPutStream_REAL
+#define SDL_WAVDecoderSeek SDL_WAVDecoderSeek_REAL
+#define SDL_WAVDecoderTell SDL_WAVDecoderTell_REAL
+#define SDL_WAVDecoderLength SDL_WAVDecoderLength_REAL
+#define SDL_CloseWAVDecoder SDL_CloseWAVDecoder_REAL
+#define SDL_RenderBeginCommandList SDL_RenderBeginCommandList_REAL
+#define SDL_RenderEndCommandList SDL_RenderEndCommandList_REAL
+#define SDL_RenderReplayCommandList SDL_RenderReplayCommandList_REAL
+#define SDL_DestroyRenderCommandList SDL_DestroyRenderCommandList_REAL
+#define SDL_RenderGetStats SDL_RenderGetStats_REAL
+#define SDL_RenderResetStats SDL_RenderResetStats_REAL
+#define SDL_RenderReadPixelsAsync SDL_RenderReadPixelsAsync_REAL
+#define SDL_RenderGetReadbackPixels SDL_RenderGetReadbackPixels_REAL
+#define SDL_DestroyRenderReadback SDL_DestroyRenderReadback_REAL
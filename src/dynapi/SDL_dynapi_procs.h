@@ -924,3 +924,37 @@ SDL_DYNAPI_PROC(SDL_bool,SDL_GameControllerHasRumble,(SDL_GameController *a),(a)
 SDL_DYNAPI_PROC(SDL_bool,SDL_GameControllerHasRumbleTriggers,(SDL_GameController *a),(a),return)
 SDL_DYNAPI_PROC(void,SDL_hid_ble_scan,(SDL_bool a),(a),)
 SDL_DYNAPI_PROC(int,SDL_PremultiplyAlpha,(int a, int b, Uint32 c, const void *d, int e, Uint32 f, void *g, int h),(a,b,c,d,e,f,g,h),return)
+SDL_DYNAPI_PROC(void,SDL_AtomicGetSpinLockStats,(SDL_SpinLockStats *a),(a),)
+SDL_DYNAPI_PROC(void,SDL_AtomicResetSpinLockStats,(void),(),)
+SDL_DYNAPI_PROC(int,SDL_UnpremultiplyAlpha,(int a, int b, Uint32 c, const void *d, int e, Uint32 f, void *g, int h),(a,b,c,d,e,f,g,h),return)
+SDL_DYNAPI_PROC(SDL_TextureAtlas*,SDL_CreateTextureAtlas,(SDL_Renderer *a, Uint32 b, int c, int d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(SDL_Texture*,SDL_CreateAtlasTexture,(SDL_TextureAtlas *a, int b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(SDL_Texture*,SDL_CreateAtlasTextureFromSurface,(SDL_TextureAtlas *a, SDL_Surface *b),(a,b),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyTextureAtlas,(SDL_TextureAtlas *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_GameControllerAddMappingsFromCacheRW,(SDL_RWops *a, int b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_GameControllerSaveMappingCacheRW,(SDL_RWops *a, int b),(a,b),return)
+SDL_DYNAPI_PROC(Uint64,SDL_GetTicksNS,(void),(),return)
+SDL_DYNAPI_PROC(Uint64,SDL_GetEventTimestampNS,(const SDL_Event *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_GetMotionHistory,(SDL_Event *a, int b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_PollEvents,(SDL_Event *a, int b, Uint32 c, Uint32 d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(SDL_AudioDeviceID,SDL_OpenAudioDevicePull,(const char *a, const SDL_AudioSpec *b, SDL_AudioSpec *c),(a,b,c),return)
+SDL_DYNAPI_PROC(Uint8*,SDL_GetAudioDeviceBuffer,(SDL_AudioDeviceID a, int *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_PlayAudioDeviceBuffer,(SDL_AudioDeviceID a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_GetAudioDeviceDelay,(SDL_AudioDeviceID a),(a),return)
+SDL_DYNAPI_PROC(Uint64,SDL_GetAudioDeviceTimeNS,(SDL_AudioDeviceID a),(a),return)
+SDL_DYNAPI_PROC(SDL_WAVDecoder*,SDL_OpenWAVDecoder_RW,(SDL_RWops *a, int b, SDL_AudioSpec *c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_WAVDecoderRead,(SDL_WAVDecoder *a, void *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_WAVDecoderPutStream,(SDL_WAVDecoder *a, SDL_AudioStream *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_WAVDecoderSeek,(SDL_WAVDecoder *a, Sint64 b),(a,b),return)
+SDL_DYNAPI_PROC(Sint64,SDL_WAVDecoderTell,(SDL_WAVDecoder *a),(a),return)
+SDL_DYNAPI_PROC(Sint64,SDL_WAVDecoderLength,(SDL_WAVDecoder *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_CloseWAVDecoder,(SDL_WAVDecoder *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_RenderBeginCommandList,(SDL_Renderer *a),(a),return)
+SDL_DYNAPI_PROC(SDL_RenderCommandList*,SDL_RenderEndCommandList,(SDL_Renderer *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_RenderReplayCommandList,(SDL_Renderer *a, SDL_RenderCommandList *b, const SDL_Point *c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyRenderCommandList,(SDL_RenderCommandList *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_RenderGetStats,(SDL_Renderer *a, SDL_RenderStats *b, SDL_RenderStats *c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_RenderResetStats,(SDL_Renderer *a),(a),)
+SDL_DYNAPI_PROC(SDL_RenderReadback*,SDL_RenderReadPixelsAsync,(SDL_Renderer *a, const SDL_Rect *b, Uint32 c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_RenderGetReadbackPixels,(SDL_RenderReadback *a, void *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyRenderReadback,(SDL_RenderReadback *a),(a),)
@@ -27,6 +27,7 @@
 #include "SDL_thread.h"
 #include "SDL_events_c.h"
 #include "../SDL_hints_c.h"
+#include "../thread/SDL_thread_c.h"
 #include "../timer/SDL_timer_c.h"
 #if !SDL_JOYSTICK_DISABLED
 #include "../joystick/SDL_joystick_c.h"
@@ -50,15 +51,51 @@
 typedef struct SDL_EventWatcher {
     SDL_EventFilter callback;
     void *userdata;
-    SDL_bool removed;
+    SDL_atomic_t removed;
 } SDL_EventWatcher;
 
+/* The event filter and watchers are published as an immutable list, so
+   dispatching an event only needs an atomic load when nothing is watching,
+   and never takes a lock. Changes are made to a copy under
+   SDL_event_watchers_lock, and replaced lists are retired until the last
+   dispatch that can still be reading them is done. */
+typedef struct SDL_EventWatcherList {
+    SDL_EventWatcher filter;
+    int count;
+    struct SDL_EventWatcherList *next_retired;
+    SDL_EventWatcher watchers[1];
+} SDL_EventWatcherList;
+
+/* Dispatching threads count themselves in a stripe picked by thread ID,
+   so concurrent dispatches don't all write to the same cache line. */
+#define SDL_EVENT_WATCHER_STRIPES   32
+#define SDL_EVENT_WATCHER_SHIFT     59
+SDL_COMPILE_TIME_ASSERT(event_watcher_stripes, SDL_EVENT_WATCHER_STRIPES == (1 << (64 - SDL_EVENT_WATCHER_SHIFT)));
+
+typedef struct SDL_EventWatcherReaders {
+    SDL_atomic_t count;
+    Uint8 padding[64 - sizeof(SDL_atomic_t)];
+} SDL_EventWatcherReaders;
+
 static SDL_mutex *SDL_event_watchers_lock;
-static SDL_EventWatcher SDL_EventOK;
-static SDL_EventWatcher *SDL_event_watchers = NULL;
-static int SDL_event_watchers_count = 0;
-static SDL_bool SDL_event_watchers_dispatching = SDL_FALSE;
-static SDL_bool SDL_event_watchers_removed = SDL_FALSE;
+static SDL_cond *SDL_event_watchers_cond;
+static void *SDL_event_watchers = NULL;
+static void *SDL_event_watchers_retired = NULL;
+static SDL_EventWatcherReaders SDL_event_watchers_readers[SDL_EVENT_WATCHER_STRIPES];
+static SDL_atomic_t SDL_event_watchers_waiters;
+/* Dispatches on threads blocked in SDL_DelEventWatch(), they can't be running a watcher */
+static SDL_atomic_t SDL_event_watchers_parked;
+
+/* How many dispatches the current thread is in, nested through callbacks */
+#ifdef SDL_THREAD_LOCAL
+static SDL_THREAD_LOCAL int SDL_event_watchers_depth;
+#define SDL_GetEventWatchersDepth()         SDL_event_watchers_depth
+#define SDL_SetEventWatchersDepth(depth)    (SDL_event_watchers_depth = (depth))
+#else
+static SDL_TLSID SDL_event_watchers_depth_tls;
+#define SDL_GetEventWatchersDepth()         ((int)(uintptr_t)SDL_TLSGet(SDL_event_watchers_depth_tls))
+#define SDL_SetEventWatchersDepth(depth)    SDL_TLSSet(SDL_event_watchers_depth_tls, (void *)(uintptr_t)(depth), NULL)
+#endif
 
 typedef struct {
     Uint32 bits[8];
@@ -67,15 +104,60 @@ typedef struct {
 static SDL_DisabledEventBlock *SDL_disabled_events[256];
 static Uint32 SDL_userevents = SDL_USEREVENT;
 
+/* High resolution timestamps are kept with the queued events. Events copied
+   out to the application carry them in the tail of SDL_Event, which every
+   event structure except SDL_TextEditingEvent leaves unused, along with a
+   check value so bytes that SDL didn't write there aren't mistaken for one. */
+#define SDL_EVENT_TIMESTAMP_OFFSET  (sizeof(SDL_Event) - sizeof(Uint64))
+SDL_COMPILE_TIME_ASSERT(event_timestamp_key, sizeof(SDL_KeyboardEvent) <= SDL_EVENT_TIMESTAMP_OFFSET);
+SDL_COMPILE_TIME_ASSERT(event_timestamp_text, sizeof(SDL_TextInputEvent) <= SDL_EVENT_TIMESTAMP_OFFSET);
+SDL_COMPILE_TIME_ASSERT(event_timestamp_wheel, sizeof(SDL_MouseWheelEvent) <= SDL_EVENT_TIMESTAMP_OFFSET);
+SDL_COMPILE_TIME_ASSERT(event_timestamp_touch, sizeof(SDL_TouchFingerEvent) <= SDL_EVENT_TIMESTAMP_OFFSET);
+SDL_COMPILE_TIME_ASSERT(event_timestamp_gesture, sizeof(SDL_MultiGestureEvent) <= SDL_EVENT_TIMESTAMP_OFFSET);
+SDL_COMPILE_TIME_ASSERT(event_timestamp_sensor, sizeof(SDL_SensorEvent) <= SDL_EVENT_TIMESTAMP_OFFSET);
+SDL_COMPILE_TIME_ASSERT(event_timestamp_csensor, sizeof(SDL_ControllerSensorEvent) <= SDL_EVENT_TIMESTAMP_OFFSET);
+
+static Uint64 SDL_event_timestamp_key;
+
+#ifdef SDL_THREAD_LOCAL
+static SDL_THREAD_LOCAL Uint64 SDL_event_source_timestamp;
+/* The event being pushed on this thread, so filters and watchers can get its timestamp */
+static SDL_THREAD_LOCAL const SDL_Event *SDL_dispatching_event;
+static SDL_THREAD_LOCAL Uint64 SDL_dispatching_timestamp;
+#endif
+
 /* Private data -- event queue */
 typedef struct _SDL_EventEntry
 {
     SDL_Event event;
+    Uint64 timestamp_ns;
     SDL_SysWMmsg msg;
     struct _SDL_EventEntry *prev;
     struct _SDL_EventEntry *next;
+    /* Events in the same bucket are also linked together, in queue order */
+    struct _SDL_EventEntry *bucket_prev;
+    struct _SDL_EventEntry *bucket_next;
 } SDL_EventEntry;
 
+/* Events are bucketed by the high byte of their type, which groups them by
+   category, so lookups for a type range only visit events of that range. */
+#define SDL_EVENT_BUCKETS   256
+#define SDL_EventBucket(type)   ((type) > SDL_LASTEVENT ? (SDL_EVENT_BUCKETS - 1) : ((type) >> 8))
+
+typedef struct
+{
+    SDL_EventEntry *head;
+    SDL_EventEntry *tail;
+    int count;
+    int *type_counts;   /* Queued events of each type in the bucket, allocated when first used */
+} SDL_EventBucketList;
+
+typedef struct
+{
+    SDL_Event event;
+    Uint64 timestamp_ns;
+} SDL_MotionSample;
+
 typedef struct _SDL_SysWMEntry
 {
     SDL_SysWMmsg msg;
@@ -93,7 +175,14 @@ static struct
     SDL_EventEntry *free;
     SDL_SysWMEntry *wmmsg_used;
     SDL_SysWMEntry *wmmsg_free;
-} SDL_EventQ = { NULL, { 1 }, { 0 }, 0, NULL, NULL, NULL, NULL, NULL };
+    SDL_MotionSample *motion_history;
+    int motion_history_head;
+    int motion_history_count;
+    SDL_EventBucketList buckets[SDL_EVENT_BUCKETS];
+} SDL_EventQ = { NULL, { 1 }, { 0 }, 0, NULL, NULL, NULL, NULL, NULL, NULL, 0, 0 };
+
+/* The number of raw motion samples kept while coalescing with history */
+#define SDL_MOTION_HISTORY_SIZE 1024
 
 
 #if !SDL_JOYSTICK_DISABLED
@@ -149,6 +238,15 @@ SDL_PollSentinelChanged(void *userdata, const char *name, const char *oldValue,
     SDL_EventState(SDL_POLLSENTINEL, SDL_GetStringBoolean(hint, SDL_TRUE) ? SDL_ENABLE : SDL_DISABLE);
 }
 
+/* 0 (default) means no coalescing, 1 means coalescing, 2 means coalescing and keeping the raw samples */
+static int SDL_DoEventCoalescing = 0;
+
+static void SDLCALL
+SDL_EventCoalescingChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    SDL_DoEventCoalescing = (hint && *hint) ? SDL_clamp(SDL_atoi(hint), 0, 2) : 0;
+}
+
 /* 0 (default) means no logging, 1 means logging, 2 means logging with mouse and finger motion */
 static int SDL_DoEventLogging = 0;
 
@@ -472,10 +570,20 @@ SDL_StopEventLoop(void)
         wmmsg = next;
     }
 
+    SDL_free(SDL_EventQ.motion_history);
+    SDL_EventQ.motion_history = NULL;
+    SDL_EventQ.motion_history_head = 0;
+    SDL_EventQ.motion_history_count = 0;
+
+    for (i = 0; i < SDL_arraysize(SDL_EventQ.buckets); ++i) {
+        SDL_free(SDL_EventQ.buckets[i].type_counts);
+    }
+
     SDL_AtomicSet(&SDL_EventQ.count, 0);
     SDL_EventQ.max_events_seen = 0;
     SDL_EventQ.head = NULL;
     SDL_EventQ.tail = NULL;
+    SDL_zeroa(SDL_EventQ.buckets);
     SDL_EventQ.free = NULL;
     SDL_EventQ.wmmsg_used = NULL;
     SDL_EventQ.wmmsg_free = NULL;
@@ -486,16 +594,21 @@ SDL_StopEventLoop(void)
         SDL_disabled_events[i] = NULL;
     }
 
+    if (SDL_event_watchers_cond) {
+        SDL_DestroyCond(SDL_event_watchers_cond);
+        SDL_event_watchers_cond = NULL;
+    }
     if (SDL_event_watchers_lock) {
         SDL_DestroyMutex(SDL_event_watchers_lock);
         SDL_event_watchers_lock = NULL;
     }
-    if (SDL_event_watchers) {
-        SDL_free(SDL_event_watchers);
-        SDL_event_watchers = NULL;
-        SDL_event_watchers_count = 0;
+    SDL_free(SDL_AtomicGetPtr(&SDL_event_watchers));
+    SDL_AtomicSetPtr(&SDL_event_watchers, NULL);
+    while (SDL_AtomicGetPtr(&SDL_event_watchers_retired)) {
+        SDL_EventWatcherList *list = (SDL_EventWatcherList *)SDL_AtomicGetPtr(&SDL_event_watchers_retired);
+        SDL_AtomicSetPtr(&SDL_event_watchers_retired, list->next_retired);
+        SDL_free(list);
     }
-    SDL_zero(SDL_EventOK);
 
     if (SDL_EventQ.lock) {
         SDL_UnlockMutex(SDL_EventQ.lock);
@@ -514,6 +627,10 @@ SDL_StartEventLoop(void)
        FIXME: Does this introduce any other bugs with events at startup?
      */
 
+    if (!SDL_event_timestamp_key) {
+        SDL_event_timestamp_key = SDL_GetPerformanceCounter() ^ ((Uint64) (uintptr_t) &SDL_EventQ << 16) ^ 0x5DEECE66DULL;
+    }
+
     /* Create the lock and set ourselves active */
 #if !SDL_THREADS_DISABLED
     if (!SDL_EventQ.lock) {
@@ -529,8 +646,21 @@ SDL_StartEventLoop(void)
             return -1;
         }
     }
+
+    if (!SDL_event_watchers_cond) {
+        SDL_event_watchers_cond = SDL_CreateCond();
+        if (SDL_event_watchers_cond == NULL) {
+            return -1;
+        }
+    }
 #endif /* !SDL_THREADS_DISABLED */
 
+#ifndef SDL_THREAD_LOCAL
+    if (!SDL_event_watchers_depth_tls) {
+        SDL_event_watchers_depth_tls = SDL_TLSCreate();
+    }
+#endif
+
     /* Process most event types */
     SDL_EventState(SDL_TEXTINPUT, SDL_DISABLE);
     SDL_EventState(SDL_TEXTEDITING, SDL_DISABLE);
@@ -546,19 +676,171 @@ SDL_StartEventLoop(void)
 }
 
 
-/* Add an event to the event queue -- called with the queue locked */
+static SDL_bool
+SDL_IsMotionEvent(Uint32 type)
+{
+    switch (type) {
+    case SDL_MOUSEMOTION:
+    case SDL_FINGERMOTION:
+    case SDL_SENSORUPDATE:
+    case SDL_CONTROLLERSENSORUPDATE:
+        return SDL_TRUE;
+    default:
+        return SDL_FALSE;
+    }
+}
+
+/* Record a raw motion sample -- called with the queue locked */
+static void
+SDL_AddMotionHistory(const SDL_Event *event, Uint64 timestamp_ns)
+{
+    int index;
+
+    if (!SDL_EventQ.motion_history) {
+        SDL_EventQ.motion_history = (SDL_MotionSample *)SDL_malloc(SDL_MOTION_HISTORY_SIZE * sizeof(*SDL_EventQ.motion_history));
+        if (!SDL_EventQ.motion_history) {
+            return;
+        }
+    }
+
+    index = (SDL_EventQ.motion_history_head + SDL_EventQ.motion_history_count) % SDL_MOTION_HISTORY_SIZE;
+    SDL_EventQ.motion_history[index].event = *event;
+    SDL_EventQ.motion_history[index].timestamp_ns = timestamp_ns;
+    if (SDL_EventQ.motion_history_count < SDL_MOTION_HISTORY_SIZE) {
+        ++SDL_EventQ.motion_history_count;
+    } else {
+        /* Drop the oldest sample */
+        SDL_EventQ.motion_history_head = (SDL_EventQ.motion_history_head + 1) % SDL_MOTION_HISTORY_SIZE;
+    }
+}
+
+/* Merge a motion event into the same kind of event at the end of the queue,
+   returns SDL_FALSE if they're for different devices -- called with the queue locked */
+static SDL_bool
+SDL_CoalesceEvent(SDL_Event *last, const SDL_Event *event)
+{
+    if (last->type != event->type) {
+        return SDL_FALSE;
+    }
+
+    switch (event->type) {
+    case SDL_MOUSEMOTION:
+        if (last->motion.windowID != event->motion.windowID ||
+            last->motion.which != event->motion.which ||
+            last->motion.state != event->motion.state) {
+            return SDL_FALSE;
+        }
+        last->motion.x = event->motion.x;
+        last->motion.y = event->motion.y;
+        last->motion.xrel += event->motion.xrel;
+        last->motion.yrel += event->motion.yrel;
+        break;
+    case SDL_FINGERMOTION:
+        if (last->tfinger.touchId != event->tfinger.touchId ||
+            last->tfinger.fingerId != event->tfinger.fingerId ||
+            last->tfinger.windowID != event->tfinger.windowID) {
+            return SDL_FALSE;
+        }
+        last->tfinger.x = event->tfinger.x;
+        last->tfinger.y = event->tfinger.y;
+        last->tfinger.dx += event->tfinger.dx;
+        last->tfinger.dy += event->tfinger.dy;
+        last->tfinger.pressure = event->tfinger.pressure;
+        break;
+    case SDL_SENSORUPDATE:
+        if (last->sensor.which != event->sensor.which) {
+            return SDL_FALSE;
+        }
+        SDL_memcpy(last->sensor.data, event->sensor.data, sizeof(last->sensor.data));
+        break;
+    case SDL_CONTROLLERSENSORUPDATE:
+        if (last->csensor.which != event->csensor.which ||
+            last->csensor.sensor != event->csensor.sensor) {
+            return SDL_FALSE;
+        }
+        SDL_memcpy(last->csensor.data, event->csensor.data, sizeof(last->csensor.data));
+        break;
+    default:
+        return SDL_FALSE;
+    }
+
+    /* The merged event takes the time of the latest sample */
+    last->common.timestamp = event->common.timestamp;
+    return SDL_TRUE;
+}
+
+static Uint32
+SDL_EventTimestampCheck(const SDL_Event *event, Uint32 extra)
+{
+    Uint64 x = (((Uint64) event->type << 32) | event->common.timestamp) ^ SDL_event_timestamp_key;
+
+    x ^= (Uint64) extra * 0x9E3779B97F4A7C15ULL;
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    x ^= x >> 33;
+    return (Uint32) x;
+}
+
+/* Store the high resolution timestamp in an event copied out to the
+   application. The millisecond timestamp already has most of it, so only
+   the sub-millisecond part and how often the milliseconds wrapped are kept. */
+static void
+SDL_StoreEventTimestampNS(SDL_Event *event, Uint64 timestamp_ns)
+{
+    Uint32 extra, check;
+
+    if (event->type == SDL_TEXTEDITING) {
+        return;
+    }
+    extra = (Uint32) (timestamp_ns % 1000000) | ((Uint32) ((timestamp_ns / 1000000) >> 32) << 20);
+    check = SDL_EventTimestampCheck(event, extra);
+    SDL_memcpy(&event->padding[SDL_EVENT_TIMESTAMP_OFFSET], &extra, sizeof(extra));
+    SDL_memcpy(&event->padding[SDL_EVENT_TIMESTAMP_OFFSET + sizeof(extra)], &check, sizeof(check));
+}
+
+/* Add an event to the event queue, timestamp_ns is 0 if it doesn't have
+   one besides the millisecond timestamp -- called with the queue locked */
 static int
-SDL_AddEvent(SDL_Event * event)
+SDL_AddEvent(SDL_Event * event, Uint64 timestamp_ns)
 {
     SDL_EventEntry *entry;
+    SDL_EventBucketList *bucket;
     const int initial_count = SDL_AtomicGet(&SDL_EventQ.count);
     int final_count;
 
+    if (!timestamp_ns) {
+        timestamp_ns = (Uint64) event->common.timestamp * 1000000;
+    }
+
+    if (SDL_DoEventCoalescing && SDL_IsMotionEvent(event->type)) {
+        if (SDL_DoEventCoalescing > 1) {
+            SDL_AddMotionHistory(event, timestamp_ns);
+        }
+        if (SDL_EventQ.tail && SDL_CoalesceEvent(&SDL_EventQ.tail->event, event)) {
+            SDL_EventQ.tail->timestamp_ns = timestamp_ns;
+            if (SDL_DoEventLogging) {
+                SDL_LogEvent(event);
+            }
+            return 1;
+        }
+    }
+
     if (initial_count >= SDL_MAX_QUEUED_EVENTS) {
         SDL_SetError("Event queue is full (%d events)", initial_count);
         return 0;
     }
 
+    bucket = &SDL_EventQ.buckets[SDL_EventBucket(event->type)];
+    if (!bucket->type_counts) {
+        bucket->type_counts = (int *)SDL_calloc(256, sizeof(*bucket->type_counts));
+        if (!bucket->type_counts) {
+            SDL_OutOfMemory();
+            return 0;
+        }
+    }
+
     if (SDL_EventQ.free == NULL) {
         entry = (SDL_EventEntry *)SDL_malloc(sizeof(*entry));
         if (!entry) {
@@ -574,6 +856,7 @@ SDL_AddEvent(SDL_Event * event)
     }
 
     entry->event = *event;
+    entry->timestamp_ns = timestamp_ns;
     if (event->type == SDL_SYSWMEVENT) {
         entry->msg = *event->syswm.msg;
         entry->event.syswm.msg = &entry->msg;
@@ -592,6 +875,21 @@ SDL_AddEvent(SDL_Event * event)
         entry->next = NULL;
     }
 
+    if (bucket->tail) {
+        bucket->tail->bucket_next = entry;
+        entry->bucket_prev = bucket->tail;
+    } else {
+        SDL_assert(!bucket->head);
+        bucket->head = entry;
+        entry->bucket_prev = NULL;
+    }
+    bucket->tail = entry;
+    entry->bucket_next = NULL;
+    ++bucket->count;
+    if (entry->event.type <= SDL_LASTEVENT) {
+        ++bucket->type_counts[entry->event.type & 0xFF];
+    }
+
     final_count = SDL_AtomicAdd(&SDL_EventQ.count, 1) + 1;
     if (final_count > SDL_EventQ.max_events_seen) {
         SDL_EventQ.max_events_seen = final_count;
@@ -604,6 +902,8 @@ SDL_AddEvent(SDL_Event * event)
 static void
 SDL_CutEvent(SDL_EventEntry *entry)
 {
+    SDL_EventBucketList *bucket;
+
     if (entry->prev) {
         entry->prev->next = entry->next;
     }
@@ -620,6 +920,24 @@ SDL_CutEvent(SDL_EventEntry *entry)
         SDL_EventQ.tail = entry->prev;
     }
 
+    bucket = &SDL_EventQ.buckets[SDL_EventBucket(entry->event.type)];
+    if (entry->bucket_prev) {
+        entry->bucket_prev->bucket_next = entry->bucket_next;
+    } else {
+        SDL_assert(bucket->head == entry);
+        bucket->head = entry->bucket_next;
+    }
+    if (entry->bucket_next) {
+        entry->bucket_next->bucket_prev = entry->bucket_prev;
+    } else {
+        SDL_assert(bucket->tail == entry);
+        bucket->tail = entry->bucket_prev;
+    }
+    --bucket->count;
+    if (entry->event.type <= SDL_LASTEVENT) {
+        --bucket->type_counts[entry->event.type & 0xFF];
+    }
+
     entry->next = SDL_EventQ.free;
     SDL_EventQ.free = entry;
     SDL_assert(SDL_AtomicGet(&SDL_EventQ.count) > 0);
@@ -648,9 +966,9 @@ SDL_SendWakeupEvent()
 }
 
 /* Lock the event queue, take a peep at it, and unlock it */
-int
-SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
-               Uint32 minType, Uint32 maxType)
+static int
+SDL_PeepEventsInternal(SDL_Event * events, int numevents, SDL_eventaction action,
+                       Uint32 minType, Uint32 maxType, Uint64 timestamp_ns)
 {
     int i, used;
 
@@ -667,12 +985,13 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
         if (action == SDL_ADDEVENT) {
             for (i = 0; i < numevents; ++i) {
-                used += SDL_AddEvent(&events[i]);
+                used += SDL_AddEvent(&events[i], timestamp_ns);
             }
         } else {
             SDL_EventEntry *entry, *next;
             SDL_SysWMEntry *wmmsg, *wmmsg_next;
             Uint32 type;
+            SDL_bool one_bucket;
 
             if (action == SDL_GETEVENT) {
                 /* Clean out any used wmmsg data
@@ -686,12 +1005,17 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
                 SDL_EventQ.wmmsg_used = NULL;
             }
 
-            for (entry = SDL_EventQ.head; entry && (!events || used < numevents); entry = next) {
-                next = entry->next;
+            /* A range within one category only needs to visit that bucket */
+            one_bucket = (minType <= maxType && SDL_EventBucket(minType) == SDL_EventBucket(maxType));
+
+            entry = one_bucket ? SDL_EventQ.buckets[SDL_EventBucket(minType)].head : SDL_EventQ.head;
+            for ( ; entry && (!events || used < numevents); entry = next) {
+                next = one_bucket ? entry->bucket_next : entry->next;
                 type = entry->event.type;
                 if (minType <= type && type <= maxType) {
                     if (events) {
                         events[used] = entry->event;
+                        SDL_StoreEventTimestampNS(&events[used], entry->timestamp_ns);
                         if (entry->event.type == SDL_SYSWMEVENT) {
                             /* We need to copy the wmmsg somewhere safe.
                                For now we'll guarantee it's valid at least until
@@ -731,16 +1055,66 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
     return (used);
 }
 
+int
+SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
+               Uint32 minType, Uint32 maxType)
+{
+    return SDL_PeepEventsInternal(events, numevents, action, minType, maxType, 0);
+}
+
 SDL_bool
 SDL_HasEvent(Uint32 type)
 {
-    return (SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, type, type) > 0);
+    return SDL_HasEvents(type, type);
 }
 
 SDL_bool
 SDL_HasEvents(Uint32 minType, Uint32 maxType)
 {
-    return (SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, minType, maxType) > 0);
+    SDL_bool found = SDL_FALSE;
+
+    /* Don't look after we've quit */
+    if (!SDL_AtomicGet(&SDL_EventQ.active) || minType > maxType) {
+        return SDL_FALSE;
+    }
+
+    if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
+        const Uint32 last_bucket = SDL_EventBucket(maxType);
+        Uint32 i, type;
+
+        /* The per-type counts answer this without looking at any events */
+        for (i = SDL_EventBucket(minType); i <= last_bucket && !found; ++i) {
+            const SDL_EventBucketList *bucket = &SDL_EventQ.buckets[i];
+            const Uint32 first_type = SDL_max(minType, i << 8);
+            const Uint32 last_type = SDL_min(maxType, (i << 8) | 0xFF);
+
+            if (!bucket->count) {
+                continue;
+            }
+            for (type = first_type; type <= last_type; ++type) {
+                if (bucket->type_counts[type & 0xFF]) {
+                    found = SDL_TRUE;
+                    break;
+                }
+            }
+        }
+
+        if (!found && maxType > SDL_LASTEVENT) {
+            /* Invalid types share the last bucket and aren't counted by type */
+            SDL_EventEntry *entry;
+
+            for (entry = SDL_EventQ.buckets[SDL_EVENT_BUCKETS - 1].head; entry; entry = entry->bucket_next) {
+                if (entry->event.type > SDL_LASTEVENT && minType <= entry->event.type && entry->event.type <= maxType) {
+                    found = SDL_TRUE;
+                    break;
+                }
+            }
+        }
+        if (SDL_EventQ.lock) {
+            SDL_UnlockMutex(SDL_EventQ.lock);
+        }
+    }
+    return found;
 }
 
 void
@@ -769,15 +1143,24 @@ SDL_FlushEvents(Uint32 minType, Uint32 maxType)
     SDL_PumpEvents();
 #endif
 
+    if (minType > maxType) {
+        return;
+    }
+
     /* Lock the event queue */
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
+        const Uint32 last_bucket = SDL_EventBucket(maxType);
         SDL_EventEntry *entry, *next;
-        Uint32 type;
-        for (entry = SDL_EventQ.head; entry; entry = next) {
-            next = entry->next;
-            type = entry->event.type;
-            if (minType <= type && type <= maxType) {
-                SDL_CutEvent(entry);
+        Uint32 i, type;
+
+        /* Only the categories in the range are visited */
+        for (i = SDL_EventBucket(minType); i <= last_bucket; ++i) {
+            for (entry = SDL_EventQ.buckets[i].head; entry; entry = next) {
+                next = entry->bucket_next;
+                type = entry->event.type;
+                if (minType <= type && type <= maxType) {
+                    SDL_CutEvent(entry);
+                }
             }
         }
         if (SDL_EventQ.lock) {
@@ -825,6 +1208,21 @@ SDL_PollEvent(SDL_Event * event)
     return SDL_WaitEventTimeout(event, 0);
 }
 
+int
+SDL_PollEvents(SDL_Event * events, int numevents, Uint32 minType, Uint32 maxType)
+{
+    if (!events || numevents <= 0) {
+        return SDL_InvalidParamError("events");
+    }
+
+    SDL_PumpEvents();
+
+    /* The whole batch is drained at once, so there is no poll cycle to mark */
+    SDL_FlushEvent(SDL_POLLSENTINEL);
+
+    return SDL_PeepEvents(events, numevents, SDL_GETEVENT, minType, maxType);
+}
+
 static SDL_bool
 SDL_events_need_periodic_poll() {
     SDL_bool need_periodic_poll = SDL_FALSE;
@@ -1017,52 +1415,212 @@ SDL_WaitEventTimeout(SDL_Event * event, int timeout)
     }
 }
 
+void
+SDL_SetEventSourceTimestampNS(Uint64 timestamp_ns)
+{
+#ifdef SDL_THREAD_LOCAL
+    SDL_event_source_timestamp = timestamp_ns;
+#endif
+}
+
 int
-SDL_PushEvent(SDL_Event * event)
+SDL_GetMotionHistory(SDL_Event * events, int numevents)
 {
-    event->common.timestamp = SDL_GetTicks();
+    int used = 0;
 
-    if (SDL_EventOK.callback || SDL_event_watchers_count > 0) {
-        if (!SDL_event_watchers_lock || SDL_LockMutex(SDL_event_watchers_lock) == 0) {
-            if (SDL_EventOK.callback && !SDL_EventOK.callback(SDL_EventOK.userdata, event)) {
-                if (SDL_event_watchers_lock) {
-                    SDL_UnlockMutex(SDL_event_watchers_lock);
-                }
-                return 0;
+    if (!events || numevents < 0) {
+        return SDL_InvalidParamError("events");
+    }
+
+    /* Don't look after we've quit */
+    if (!SDL_AtomicGet(&SDL_EventQ.active)) {
+        return SDL_SetError("The event system has been shut down");
+    }
+
+    if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
+        while (used < numevents && SDL_EventQ.motion_history_count > 0) {
+            const SDL_MotionSample *sample = &SDL_EventQ.motion_history[SDL_EventQ.motion_history_head];
+            events[used] = sample->event;
+            SDL_StoreEventTimestampNS(&events[used], sample->timestamp_ns);
+            ++used;
+            SDL_EventQ.motion_history_head = (SDL_EventQ.motion_history_head + 1) % SDL_MOTION_HISTORY_SIZE;
+            --SDL_EventQ.motion_history_count;
+        }
+        if (SDL_EventQ.lock) {
+            SDL_UnlockMutex(SDL_EventQ.lock);
+        }
+    }
+    return used;
+}
+
+Uint64
+SDL_GetEventTimestampNS(const SDL_Event * event)
+{
+    if (!event) {
+        SDL_InvalidParamError("event");
+        return 0;
+    }
+
+#ifdef SDL_THREAD_LOCAL
+    if (event == SDL_dispatching_event) {
+        return SDL_dispatching_timestamp;
+    }
+#endif
+
+    if (event->type != SDL_TEXTEDITING) {
+        Uint32 extra, check;
+
+        SDL_memcpy(&extra, &event->padding[SDL_EVENT_TIMESTAMP_OFFSET], sizeof(extra));
+        SDL_memcpy(&check, &event->padding[SDL_EVENT_TIMESTAMP_OFFSET + sizeof(extra)], sizeof(check));
+        if (check == SDL_EventTimestampCheck(event, extra)) {
+            const Uint64 ms = ((Uint64) (extra >> 20) << 32) | event->common.timestamp;
+            return ms * 1000000 + (extra & 0xFFFFF);
+        }
+    }
+    return (Uint64) event->common.timestamp * 1000000;
+}
+
+static int
+SDL_CountEventWatchersReaders(void)
+{
+    int i, count = 0;
+
+    for (i = 0; i < SDL_arraysize(SDL_event_watchers_readers); ++i) {
+        count += SDL_AtomicGet(&SDL_event_watchers_readers[i].count);
+    }
+    return count;
+}
+
+/* Free retired lists if no dispatch is using any list -- called with SDL_event_watchers_lock held */
+static void
+SDL_ReclaimEventWatchers(void)
+{
+    SDL_EventWatcherList *retired = (SDL_EventWatcherList *)SDL_AtomicGetPtr(&SDL_event_watchers_retired);
+
+    /* Dispatches that start from now on can only load the published list */
+    if (retired && SDL_CountEventWatchersReaders() == 0) {
+        SDL_AtomicSetPtr(&SDL_event_watchers_retired, NULL);
+        while (retired) {
+            SDL_EventWatcherList *next = retired->next_retired;
+            SDL_free(retired);
+            retired = next;
+        }
+    }
+}
+
+static SDL_atomic_t *
+SDL_EnterEventWatchers(void)
+{
+    const Uint64 id = (Uint64)SDL_ThreadID();
+    const int stripe = (int)((((id >> 12) ^ id) * 0x9E3779B97F4A7C15ULL) >> SDL_EVENT_WATCHER_SHIFT);
+    SDL_atomic_t *readers = &SDL_event_watchers_readers[stripe].count;
+
+    SDL_AtomicIncRef(readers);
+    SDL_SetEventWatchersDepth(SDL_GetEventWatchersDepth() + 1);
+    return readers;
+}
+
+static void
+SDL_LeaveEventWatchers(SDL_atomic_t *readers)
+{
+    SDL_SetEventWatchersDepth(SDL_GetEventWatchersDepth() - 1);
+    SDL_AtomicAdd(readers, -1);
+
+    /* The last reader frees retired lists, and wakes up waiting removals */
+    if (SDL_AtomicGetPtr(&SDL_event_watchers_retired) || SDL_AtomicGet(&SDL_event_watchers_waiters)) {
+        if (SDL_event_watchers_lock && SDL_LockMutex(SDL_event_watchers_lock) == 0) {
+            SDL_ReclaimEventWatchers();
+            if (SDL_AtomicGet(&SDL_event_watchers_waiters)) {
+                SDL_CondBroadcast(SDL_event_watchers_cond);
             }
+            SDL_UnlockMutex(SDL_event_watchers_lock);
+        }
+    }
+}
 
-            if (SDL_event_watchers_count > 0) {
-                /* Make sure we only dispatch the current watcher list */
-                int i, event_watchers_count = SDL_event_watchers_count;
+/* Wait until no other thread is dispatching with a list published before
+   now -- called with SDL_event_watchers_lock held, which is released while
+   waiting so watchers can still change the list. Dispatches on this thread
+   and on threads waiting here too are in callbacks that called
+   SDL_DelEventWatch(), so they aren't waited for. */
+static void
+SDL_WaitForEventWatchers(void)
+{
+    const int depth = SDL_GetEventWatchersDepth();
 
-                SDL_event_watchers_dispatching = SDL_TRUE;
-                for (i = 0; i < event_watchers_count; ++i) {
-                    if (!SDL_event_watchers[i].removed) {
-                        SDL_event_watchers[i].callback(SDL_event_watchers[i].userdata, event);
-                    }
-                }
-                SDL_event_watchers_dispatching = SDL_FALSE;
-
-                if (SDL_event_watchers_removed) {
-                    for (i = SDL_event_watchers_count; i--; ) {
-                        if (SDL_event_watchers[i].removed) {
-                            --SDL_event_watchers_count;
-                            if (i < SDL_event_watchers_count) {
-                                SDL_memmove(&SDL_event_watchers[i], &SDL_event_watchers[i+1], (SDL_event_watchers_count - i) * sizeof(SDL_event_watchers[i]));
-                            }
-                        }
+    if (!SDL_event_watchers_lock || !SDL_event_watchers_cond) {
+        return;
+    }
+
+    SDL_AtomicAdd(&SDL_event_watchers_parked, depth);
+    SDL_AtomicIncRef(&SDL_event_watchers_waiters);
+    if (depth > 0) {
+        /* Other waiters may only have been waiting for this thread */
+        SDL_CondBroadcast(SDL_event_watchers_cond);
+    }
+    while (SDL_CountEventWatchersReaders() > SDL_AtomicGet(&SDL_event_watchers_parked)) {
+        SDL_CondWait(SDL_event_watchers_cond, SDL_event_watchers_lock);
+    }
+    SDL_AtomicAdd(&SDL_event_watchers_waiters, -1);
+    SDL_AtomicAdd(&SDL_event_watchers_parked, -depth);
+}
+
+int
+SDL_PushEvent(SDL_Event * event)
+{
+    Uint64 timestamp_ns = 0;
+
+#ifdef SDL_THREAD_LOCAL
+    timestamp_ns = SDL_event_source_timestamp;
+#endif
+    if (!timestamp_ns) {
+        timestamp_ns = SDL_GetTicksNS();
+    }
+    /* Only the common fields can be written, the event may be a smaller structure */
+    event->common.timestamp = (Uint32) (timestamp_ns / 1000000);
+
+    if (SDL_AtomicGetPtr(&SDL_event_watchers)) {
+        SDL_EventWatcherList *list;
+        SDL_bool filtered = SDL_FALSE;
+#ifdef SDL_THREAD_LOCAL
+        const SDL_Event *outer_event = SDL_dispatching_event;
+        const Uint64 outer_timestamp = SDL_dispatching_timestamp;
+#endif
+
+        /* Register as a reader before loading the list, so it isn't freed under us */
+        SDL_atomic_t *readers = SDL_EnterEventWatchers();
+#ifdef SDL_THREAD_LOCAL
+        SDL_dispatching_event = event;
+        SDL_dispatching_timestamp = timestamp_ns;
+#endif
+        list = (SDL_EventWatcherList *)SDL_AtomicGetPtr(&SDL_event_watchers);
+        if (list) {
+            int i;
+
+            if (list->filter.callback && !list->filter.callback(list->filter.userdata, event)) {
+                filtered = SDL_TRUE;
+            } else {
+                for (i = 0; i < list->count; ++i) {
+                    SDL_EventWatcher *watcher = &list->watchers[i];
+
+                    if (!SDL_AtomicGet(&watcher->removed)) {
+                        watcher->callback(watcher->userdata, event);
                     }
-                    SDL_event_watchers_removed = SDL_FALSE;
                 }
             }
+        }
+#ifdef SDL_THREAD_LOCAL
+        SDL_dispatching_event = outer_event;
+        SDL_dispatching_timestamp = outer_timestamp;
+#endif
+        SDL_LeaveEventWatchers(readers);
 
-            if (SDL_event_watchers_lock) {
-                SDL_UnlockMutex(SDL_event_watchers_lock);
-            }
+        if (filtered) {
+            return 0;
         }
     }
 
-    if (SDL_PeepEvents(event, 1, SDL_ADDEVENT, 0, 0) <= 0) {
+    if (SDL_PeepEventsInternal(event, 1, SDL_ADDEVENT, 0, 0, timestamp_ns) <= 0) {
         return -1;
     }
 
@@ -1071,14 +1629,79 @@ SDL_PushEvent(SDL_Event * event)
     return 1;
 }
 
+/* These must be called with SDL_event_watchers_lock held */
+static SDL_EventWatcherList *
+SDL_CopyEventWatchers(int extra)
+{
+    const SDL_EventWatcherList *current = (const SDL_EventWatcherList *)SDL_AtomicGetPtr(&SDL_event_watchers);
+    const int count = current ? current->count : 0;
+    SDL_EventWatcherList *list;
+    int i;
+
+    list = (SDL_EventWatcherList *)SDL_calloc(1, sizeof(*list) + (count + extra) * sizeof(list->watchers[0]));
+    if (!list) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    if (current) {
+        list->filter = current->filter;
+        for (i = 0; i < count; ++i) {
+            if (!SDL_AtomicGet((SDL_atomic_t *)&current->watchers[i].removed)) {
+                list->watchers[list->count++] = current->watchers[i];
+            }
+        }
+    }
+    return list;
+}
+
+static void
+SDL_PublishEventWatchers(SDL_EventWatcherList *list)
+{
+    SDL_EventWatcherList *old = (SDL_EventWatcherList *)SDL_AtomicGetPtr(&SDL_event_watchers);
+
+    if (!list->filter.callback && list->count == 0) {
+        /* Nothing to dispatch, keep the fast path in SDL_PushEvent() */
+        SDL_free(list);
+        list = NULL;
+    }
+    SDL_AtomicSetPtr(&SDL_event_watchers, list);
+
+    if (old) {
+        old->next_retired = (SDL_EventWatcherList *)SDL_AtomicGetPtr(&SDL_event_watchers_retired);
+        SDL_AtomicSetPtr(&SDL_event_watchers_retired, old);
+    }
+    SDL_ReclaimEventWatchers();
+}
+
+static void
+SDL_MarkEventWatcherRemoved(SDL_EventWatcherList *list, SDL_EventFilter filter, void *userdata)
+{
+    int i;
+
+    for (i = 0; i < list->count; ++i) {
+        SDL_EventWatcher *watcher = &list->watchers[i];
+
+        if (watcher->callback == filter && watcher->userdata == userdata && !SDL_AtomicGet(&watcher->removed)) {
+            SDL_AtomicSet(&watcher->removed, 1);
+            break;
+        }
+    }
+}
+
 void
 SDL_SetEventFilter(SDL_EventFilter filter, void *userdata)
 {
     if (!SDL_event_watchers_lock || SDL_LockMutex(SDL_event_watchers_lock) == 0) {
-        /* Set filter and discard pending events */
-        SDL_EventOK.callback = filter;
-        SDL_EventOK.userdata = userdata;
-        SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+        SDL_EventWatcherList *list = SDL_CopyEventWatchers(0);
+
+        if (list) {
+            /* Set filter and discard pending events */
+            list->filter.callback = filter;
+            list->filter.userdata = userdata;
+            SDL_PublishEventWatchers(list);
+            SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+        }
 
         if (SDL_event_watchers_lock) {
             SDL_UnlockMutex(SDL_event_watchers_lock);
@@ -1091,14 +1714,17 @@ SDL_GetEventFilter(SDL_EventFilter * filter, void **userdata)
 {
     SDL_EventWatcher event_ok;
 
+    SDL_zero(event_ok);
     if (!SDL_event_watchers_lock || SDL_LockMutex(SDL_event_watchers_lock) == 0) {
-        event_ok = SDL_EventOK;
+        const SDL_EventWatcherList *list = (const SDL_EventWatcherList *)SDL_AtomicGetPtr(&SDL_event_watchers);
+
+        if (list) {
+            event_ok = list->filter;
+        }
 
         if (SDL_event_watchers_lock) {
             SDL_UnlockMutex(SDL_event_watchers_lock);
         }
-    } else {
-        SDL_zero(event_ok);
     }
 
     if (filter) {
@@ -1114,18 +1740,14 @@ void
 SDL_AddEventWatch(SDL_EventFilter filter, void *userdata)
 {
     if (!SDL_event_watchers_lock || SDL_LockMutex(SDL_event_watchers_lock) == 0) {
-        SDL_EventWatcher *event_watchers;
+        SDL_EventWatcherList *list = SDL_CopyEventWatchers(1);
 
-        event_watchers = SDL_realloc(SDL_event_watchers, (SDL_event_watchers_count + 1) * sizeof(*event_watchers));
-        if (event_watchers) {
-            SDL_EventWatcher *watcher;
+        if (list) {
+            SDL_EventWatcher *watcher = &list->watchers[list->count++];
 
-            SDL_event_watchers = event_watchers;
-            watcher = &SDL_event_watchers[SDL_event_watchers_count];
             watcher->callback = filter;
             watcher->userdata = userdata;
-            watcher->removed = SDL_FALSE;
-            ++SDL_event_watchers_count;
+            SDL_PublishEventWatchers(list);
         }
 
         if (SDL_event_watchers_lock) {
@@ -1138,21 +1760,27 @@ void
 SDL_DelEventWatch(SDL_EventFilter filter, void *userdata)
 {
     if (!SDL_event_watchers_lock || SDL_LockMutex(SDL_event_watchers_lock) == 0) {
-        int i;
+        SDL_EventWatcherList *list = (SDL_EventWatcherList *)SDL_AtomicGetPtr(&SDL_event_watchers);
 
-        for (i = 0; i < SDL_event_watchers_count; ++i) {
-            if (SDL_event_watchers[i].callback == filter && SDL_event_watchers[i].userdata == userdata) {
-                if (SDL_event_watchers_dispatching) {
-                    SDL_event_watchers[i].removed = SDL_TRUE;
-                    SDL_event_watchers_removed = SDL_TRUE;
-                } else {
-                    --SDL_event_watchers_count;
-                    if (i < SDL_event_watchers_count) {
-                        SDL_memmove(&SDL_event_watchers[i], &SDL_event_watchers[i+1], (SDL_event_watchers_count - i) * sizeof(SDL_event_watchers[i]));
-                    }
-                }
-                break;
+        if (list) {
+            SDL_EventWatcherList *retired;
+
+            /* Events being dispatched right now shouldn't reach the watcher
+               anymore, whichever list they are using. */
+            SDL_MarkEventWatcherRemoved(list, filter, userdata);
+            for (retired = (SDL_EventWatcherList *)SDL_AtomicGetPtr(&SDL_event_watchers_retired); retired; retired = retired->next_retired) {
+                SDL_MarkEventWatcherRemoved(retired, filter, userdata);
+            }
+
+            list = SDL_CopyEventWatchers(0);
+            if (list) {
+                SDL_PublishEventWatchers(list);
             }
+
+            /* The watcher may be called until dispatches already in progress are
+               done, and its userdata is often freed right after this returns */
+            SDL_WaitForEventWatchers();
+            SDL_ReclaimEventWatchers();
         }
 
         if (SDL_event_watchers_lock) {
@@ -1305,8 +1933,10 @@ SDL_EventsInit(void)
     SDL_AddHintCallback(SDL_HINT_AUTO_UPDATE_SENSORS, SDL_AutoUpdateSensorsChanged, NULL);
 #endif
     SDL_AddHintCallback(SDL_HINT_EVENT_LOGGING, SDL_EventLoggingChanged, NULL);
+    SDL_AddHintCallback(SDL_HINT_EVENT_COALESCING, SDL_EventCoalescingChanged, NULL);
     SDL_AddHintCallback(SDL_HINT_POLL_SENTINEL, SDL_PollSentinelChanged, NULL);
     if (SDL_StartEventLoop() < 0) {
+        SDL_DelHintCallback(SDL_HINT_EVENT_COALESCING, SDL_EventCoalescingChanged, NULL);
         SDL_DelHintCallback(SDL_HINT_EVENT_LOGGING, SDL_EventLoggingChanged, NULL);
         return -1;
     }
@@ -1322,6 +1952,7 @@ SDL_EventsQuit(void)
     SDL_QuitQuit();
     SDL_StopEventLoop();
     SDL_DelHintCallback(SDL_HINT_POLL_SENTINEL, SDL_PollSentinelChanged, NULL);
+    SDL_DelHintCallback(SDL_HINT_EVENT_COALESCING, SDL_EventCoalescingChanged, NULL);
     SDL_DelHintCallback(SDL_HINT_EVENT_LOGGING, SDL_EventLoggingChanged, NULL);
 #if !SDL_JOYSTICK_DISABLED
     SDL_DelHintCallback(SDL_HINT_AUTO_UPDATE_JOYSTICKS, SDL_AutoUpdateJoysticksChanged, NULL);
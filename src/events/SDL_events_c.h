@@ -55,6 +55,10 @@ extern void SDL_EventsQuit(void);
 
 extern void SDL_SendPendingSignalEvents(void);
 
+/* Set the time, from SDL_GetTicksNS(), that input pushed by the calling
+   thread was generated at, or 0 to timestamp events when they're queued */
+extern void SDL_SetEventSourceTimestampNS(Uint64 timestamp_ns);
+
 extern int SDL_QuitInit(void);
 extern void SDL_QuitQuit(void);
 
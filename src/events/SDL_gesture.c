@@ -25,8 +25,20 @@
 
 #include "SDL_events.h"
 #include "SDL_endian.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_hints.h"
 #include "SDL_events_c.h"
 #include "SDL_gesture_c.h"
+#include "../thread/SDL_systhread.h"
+
+#ifdef __SSE__
+#define HAVE_SSE_INTRINSICS 1
+#endif
+
+/* vsqrtq_f32() is only available on AArch64 */
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#define HAVE_NEON_INTRINSICS 1
+#endif
 
 /*
 #include <stdio.h>
@@ -56,9 +68,19 @@ typedef struct {
     SDL_FloatPoint p[MAXPATHSIZE];
 } SDL_DollarPath;
 
+/* A normalized path laid out for the recognizer: the coordinates are split
+   so they can be processed several points at a time, and the distance of
+   each point from the centroid is kept to bound the match error cheaply. */
+typedef struct {
+    float x[DOLLARNPOINTS];
+    float y[DOLLARNPOINTS];
+    float radius[DOLLARNPOINTS];
+} SDL_DollarPoints;
+
 typedef struct {
     SDL_FloatPoint path[DOLLARNPOINTS];
     unsigned long hash;
+    SDL_DollarPoints points;
 } SDL_DollarTemplate;
 
 typedef struct {
@@ -77,6 +99,43 @@ static SDL_GestureTouch *SDL_gestureTouch;
 static int SDL_numGestureTouches = 0;
 static SDL_bool recordAll;
 
+#if defined(ENABLE_DOLLAR) && !SDL_THREADS_DISABLED
+/* A gesture waiting to be recognized on the gesture thread */
+typedef struct SDL_DollarJob {
+    SDL_TouchID touchId;
+    SDL_FloatPoint centroid;
+    Uint16 numFingers;
+    SDL_DollarPoints points;
+    struct SDL_DollarJob *next;
+} SDL_DollarJob;
+
+/* Held by the gesture thread while it reads the templates, and by anything
+   changing the touches or their templates while the thread is running. */
+static SDL_mutex *SDL_gesture_lock;
+static SDL_cond *SDL_gesture_cond;
+static SDL_Thread *SDL_gesture_thread;
+static SDL_DollarJob *SDL_gesture_jobs;
+static SDL_bool SDL_gesture_thread_quit;
+#endif
+
+static void SDL_LockGestures(void)
+{
+#if defined(ENABLE_DOLLAR) && !SDL_THREADS_DISABLED
+    if (SDL_gesture_lock) {
+        SDL_LockMutex(SDL_gesture_lock);
+    }
+#endif
+}
+
+static void SDL_UnlockGestures(void)
+{
+#if defined(ENABLE_DOLLAR) && !SDL_THREADS_DISABLED
+    if (SDL_gesture_lock) {
+        SDL_UnlockMutex(SDL_gesture_lock);
+    }
+#endif
+}
+
 #if 0
 static void PrintPath(SDL_FloatPoint *path)
 {
@@ -89,6 +148,17 @@ static void PrintPath(SDL_FloatPoint *path)
 }
 #endif
 
+/* Lay out a normalized path for the recognizer */
+static void dollarCompile(const SDL_FloatPoint *path, SDL_DollarPoints *points)
+{
+    int i;
+    for (i = 0; i < DOLLARNPOINTS; i++) {
+        points->x[i] = path[i].x;
+        points->y[i] = path[i].y;
+        points->radius[i] = SDL_sqrtf(path[i].x*path[i].x + path[i].y*path[i].y);
+    }
+}
+
 int SDL_RecordGesture(SDL_TouchID touchId)
 {
     int i;
@@ -103,8 +173,11 @@ int SDL_RecordGesture(SDL_TouchID touchId)
     return (touchId < 0);
 }
 
+static void SDL_StopGestureThread(void);
+
 void SDL_GestureQuit()
 {
+    SDL_StopGestureThread();
     SDL_free(SDL_gestureTouch);
     SDL_gestureTouch = NULL;
 }
@@ -203,6 +276,7 @@ static int SDL_AddDollarGesture_one(SDL_GestureTouch* inTouch, SDL_FloatPoint* p
     templ = &inTouch->dollarTemplate[index];
     SDL_memcpy(templ->path, path, DOLLARNPOINTS*sizeof(SDL_FloatPoint));
     templ->hash = SDL_HashDollar(templ->path);
+    dollarCompile(templ->path, &templ->points);
     inTouch->numDollarTemplates++;
 
     return index;
@@ -214,16 +288,21 @@ static int SDL_AddDollarGesture(SDL_GestureTouch* inTouch, SDL_FloatPoint* path)
     int i = 0;
     if (inTouch == NULL) {
         if (SDL_numGestureTouches == 0) return SDL_SetError("no gesture touch devices registered");
+        SDL_LockGestures();
         for (i = 0; i < SDL_numGestureTouches; i++) {
             inTouch = &SDL_gestureTouch[i];
             index = SDL_AddDollarGesture_one(inTouch, path);
             if (index < 0)
-                return -1;
+                break;
         }
+        SDL_UnlockGestures();
         /* Use the index of the last one added. */
         return index;
     }
-    return SDL_AddDollarGesture_one(inTouch, path);
+    SDL_LockGestures();
+    index = SDL_AddDollarGesture_one(inTouch, path);
+    SDL_UnlockGestures();
+    return index;
 }
 
 int SDL_LoadDollarTemplates(SDL_TouchID touchId, SDL_RWops *src)
@@ -282,23 +361,126 @@ int SDL_LoadDollarTemplates(SDL_TouchID touchId, SDL_RWops *src)
 
 
 #if defined(ENABLE_DOLLAR)
-static float dollarDifference(SDL_FloatPoint* points,SDL_FloatPoint* templ,float ang)
+/* Average distance between the points rotated by an angle and a template */
+static float dollarDifference(const SDL_DollarPoints *points, const SDL_DollarPoints *templ, float c, float s)
+{
+    float dist = 0;
+    int i;
+    for (i = 0; i < DOLLARNPOINTS; i++) {
+        const float dx = points->x[i] * c - points->y[i] * s - templ->x[i];
+        const float dy = points->x[i] * s + points->y[i] * c - templ->y[i];
+        dist += SDL_sqrtf(dx*dx + dy*dy);
+    }
+    return dist/DOLLARNPOINTS;
+}
+
+/* Rotating about the centroid doesn't change how far a point is from it, so
+   this is a lower bound of dollarDifference() for any angle. */
+static float dollarLowerBound(const SDL_DollarPoints *points, const SDL_DollarPoints *templ)
 {
-    /*  SDL_FloatPoint p[DOLLARNPOINTS]; */
     float dist = 0;
-    SDL_FloatPoint p;
     int i;
     for (i = 0; i < DOLLARNPOINTS; i++) {
-        p.x = (float)(points[i].x * SDL_cos(ang) - points[i].y * SDL_sin(ang));
-        p.y = (float)(points[i].x * SDL_sin(ang) + points[i].y * SDL_cos(ang));
-        dist += (float)(SDL_sqrt((p.x-templ[i].x)*(p.x-templ[i].x)+
-                                 (p.y-templ[i].y)*(p.y-templ[i].y)));
+        dist += SDL_fabsf(points->radius[i] - templ->radius[i]);
     }
     return dist/DOLLARNPOINTS;
+}
+
+#if HAVE_SSE_INTRINSICS
+static float dollarDifference_SSE(const SDL_DollarPoints *points, const SDL_DollarPoints *templ, float c, float s)
+{
+    const __m128 vc = _mm_set1_ps(c);
+    const __m128 vs = _mm_set1_ps(s);
+    __m128 sum = _mm_setzero_ps();
+    float dist[4];
+    int i;
+    for (i = 0; i < DOLLARNPOINTS; i += 4) {
+        const __m128 x = _mm_loadu_ps(&points->x[i]);
+        const __m128 y = _mm_loadu_ps(&points->y[i]);
+        const __m128 dx = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(x, vc), _mm_mul_ps(y, vs)), _mm_loadu_ps(&templ->x[i]));
+        const __m128 dy = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(x, vs), _mm_mul_ps(y, vc)), _mm_loadu_ps(&templ->y[i]));
+        sum = _mm_add_ps(sum, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy))));
+    }
+    _mm_storeu_ps(dist, sum);
+    return (dist[0] + dist[1] + dist[2] + dist[3])/DOLLARNPOINTS;
+}
+
+static float dollarLowerBound_SSE(const SDL_DollarPoints *points, const SDL_DollarPoints *templ)
+{
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 sum = _mm_setzero_ps();
+    float dist[4];
+    int i;
+    for (i = 0; i < DOLLARNPOINTS; i += 4) {
+        const __m128 d = _mm_sub_ps(_mm_loadu_ps(&points->radius[i]), _mm_loadu_ps(&templ->radius[i]));
+        sum = _mm_add_ps(sum, _mm_andnot_ps(sign, d));
+    }
+    _mm_storeu_ps(dist, sum);
+    return (dist[0] + dist[1] + dist[2] + dist[3])/DOLLARNPOINTS;
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+static float dollarDifference_NEON(const SDL_DollarPoints *points, const SDL_DollarPoints *templ, float c, float s)
+{
+    const float32x4_t vc = vdupq_n_f32(c);
+    const float32x4_t vs = vdupq_n_f32(s);
+    float32x4_t sum = vdupq_n_f32(0.0f);
+    int i;
+    for (i = 0; i < DOLLARNPOINTS; i += 4) {
+        const float32x4_t x = vld1q_f32(&points->x[i]);
+        const float32x4_t y = vld1q_f32(&points->y[i]);
+        const float32x4_t dx = vsubq_f32(vmlsq_f32(vmulq_f32(x, vc), y, vs), vld1q_f32(&templ->x[i]));
+        const float32x4_t dy = vsubq_f32(vmlaq_f32(vmulq_f32(x, vs), y, vc), vld1q_f32(&templ->y[i]));
+        sum = vaddq_f32(sum, vsqrtq_f32(vmlaq_f32(vmulq_f32(dx, dx), dy, dy)));
+    }
+    return vaddvq_f32(sum)/DOLLARNPOINTS;
+}
+
+static float dollarLowerBound_NEON(const SDL_DollarPoints *points, const SDL_DollarPoints *templ)
+{
+    float32x4_t sum = vdupq_n_f32(0.0f);
+    int i;
+    for (i = 0; i < DOLLARNPOINTS; i += 4) {
+        sum = vaddq_f32(sum, vabdq_f32(vld1q_f32(&points->radius[i]), vld1q_f32(&templ->radius[i])));
+    }
+    return vaddvq_f32(sum)/DOLLARNPOINTS;
+}
+#endif
+
+static float (*dollarDifferenceFunc)(const SDL_DollarPoints *, const SDL_DollarPoints *, float, float);
+static float (*dollarLowerBoundFunc)(const SDL_DollarPoints *, const SDL_DollarPoints *);
+
+static void dollarChooseKernels(void)
+{
+    if (dollarDifferenceFunc) {
+        return;
+    }
 
+#if HAVE_SSE_INTRINSICS
+    if (SDL_HasSSE()) {
+        dollarLowerBoundFunc = dollarLowerBound_SSE;
+        dollarDifferenceFunc = dollarDifference_SSE;
+        return;
+    }
+#endif
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        dollarLowerBoundFunc = dollarLowerBound_NEON;
+        dollarDifferenceFunc = dollarDifference_NEON;
+        return;
+    }
+#endif
+    dollarLowerBoundFunc = dollarLowerBound;
+    dollarDifferenceFunc = dollarDifference;
 }
 
-static float bestDollarDifference(SDL_FloatPoint* points,SDL_FloatPoint* templ)
+static float dollarDifferenceAt(const SDL_DollarPoints *points, const SDL_DollarPoints *templ, float ang)
+{
+    return dollarDifferenceFunc(points, templ, SDL_cosf(ang), SDL_sinf(ang));
+}
+
+static float bestDollarDifference(const SDL_DollarPoints *points, const SDL_DollarPoints *templ)
 {
     /*------------BEGIN DOLLAR BLACKBOX------------------
       -TRANSLATED DIRECTLY FROM PSUDEO-CODE AVAILABLE AT-
@@ -308,23 +490,23 @@ static float bestDollarDifference(SDL_FloatPoint* points,SDL_FloatPoint* templ)
     double tb = M_PI/4;
     double dt = M_PI/90;
     float x1 = (float)(PHI*ta + (1-PHI)*tb);
-    float f1 = dollarDifference(points,templ,x1);
+    float f1 = dollarDifferenceAt(points,templ,x1);
     float x2 = (float)((1-PHI)*ta + PHI*tb);
-    float f2 = dollarDifference(points,templ,x2);
+    float f2 = dollarDifferenceAt(points,templ,x2);
     while (SDL_fabs(ta-tb) > dt) {
         if (f1 < f2) {
             tb = x2;
             x2 = x1;
             f2 = f1;
             x1 = (float)(PHI*ta + (1-PHI)*tb);
-            f1 = dollarDifference(points,templ,x1);
+            f1 = dollarDifferenceAt(points,templ,x1);
         }
         else {
             ta = x1;
             x1 = x2;
             f1 = f2;
             x2 = (float)((1-PHI)*ta + PHI*tb);
-            f2 = dollarDifference(points,templ,x2);
+            f2 = dollarDifferenceAt(points,templ,x2);
         }
     }
     /*
@@ -431,21 +613,47 @@ static int dollarNormalize(const SDL_DollarPath *path,SDL_FloatPoint *points, SD
     return numPoints;
 }
 
-static float dollarRecognize(const SDL_DollarPath *path,int *bestTempl,SDL_GestureTouch* touch)
+static void dollarPreparePath(const SDL_DollarPath *path, SDL_DollarPoints *points)
+{
+    SDL_FloatPoint normalized[DOLLARNPOINTS];
+
+    SDL_memset(normalized, 0, sizeof(normalized));
+
+    dollarNormalize(path, normalized, SDL_FALSE);
+
+    /* PrintPath(normalized); */
+    dollarCompile(normalized, points);
+}
+
+static float dollarRecognize(const SDL_DollarPoints *points,int *bestTempl,const SDL_GestureTouch* touch)
 {
-    SDL_FloatPoint points[DOLLARNPOINTS];
     int i;
+    int seed = -1;
+    float seedBound = 0;
     float bestDiff = 10000;
 
-    SDL_memset(points, 0, sizeof(points));
+    dollarChooseKernels();
 
-    dollarNormalize(path, points, SDL_FALSE);
+    /* Start with the template that looks closest, so most of the others
+       can be ruled out by their lower bound without searching rotations. */
+    for (i = 0; i < touch->numDollarTemplates; i++) {
+        float bound = dollarLowerBoundFunc(points,&touch->dollarTemplate[i].points);
+        if (seed < 0 || bound < seedBound) {seedBound = bound; seed = i;}
+    }
 
-    /* PrintPath(points); */
     *bestTempl = -1;
+    if (seed >= 0) {
+        float diff = bestDollarDifference(points,&touch->dollarTemplate[seed].points);
+        if (diff < bestDiff) {bestDiff = diff; *bestTempl = seed;}
+    }
     for (i = 0; i < touch->numDollarTemplates; i++) {
-        float diff = bestDollarDifference(points,touch->dollarTemplate[i].path);
-        if (diff < bestDiff) {bestDiff = diff; *bestTempl = i;}
+        float diff;
+        if (i == seed || dollarLowerBoundFunc(points,&touch->dollarTemplate[i].points) > bestDiff) {
+            continue;
+        }
+        diff = bestDollarDifference(points,&touch->dollarTemplate[i].points);
+        /* Ties go to the first template, as if they were checked in order */
+        if (diff < bestDiff || (diff == bestDiff && i < *bestTempl)) {bestDiff = diff; *bestTempl = i;}
     }
     return bestDiff;
 }
@@ -453,11 +661,15 @@ static float dollarRecognize(const SDL_DollarPath *path,int *bestTempl,SDL_Gestu
 
 int SDL_GestureAddTouch(SDL_TouchID touchId)
 {
-    SDL_GestureTouch *gestureTouch = (SDL_GestureTouch *)SDL_realloc(SDL_gestureTouch,
-                                                                     (SDL_numGestureTouches + 1) *
-                                                                     sizeof(SDL_GestureTouch));
+    SDL_GestureTouch *gestureTouch;
+
+    SDL_LockGestures();
+    gestureTouch = (SDL_GestureTouch *)SDL_realloc(SDL_gestureTouch,
+                                                   (SDL_numGestureTouches + 1) *
+                                                   sizeof(SDL_GestureTouch));
 
     if (!gestureTouch) {
+        SDL_UnlockGestures();
         return SDL_OutOfMemory();
     }
 
@@ -466,6 +678,7 @@ int SDL_GestureAddTouch(SDL_TouchID touchId)
     SDL_zero(SDL_gestureTouch[SDL_numGestureTouches]);
     SDL_gestureTouch[SDL_numGestureTouches].id = touchId;
     SDL_numGestureTouches++;
+    SDL_UnlockGestures();
     return 0;
 }
 
@@ -483,6 +696,7 @@ int SDL_GestureDelTouch(SDL_TouchID touchId)
         return -1;
     }
 
+    SDL_LockGestures();
     SDL_free(SDL_gestureTouch[i].dollarTemplate);
     SDL_zero(SDL_gestureTouch[i]);
 
@@ -490,6 +704,7 @@ int SDL_GestureDelTouch(SDL_TouchID touchId)
     if (i != SDL_numGestureTouches) {
         SDL_memcpy(&SDL_gestureTouch[i], &SDL_gestureTouch[SDL_numGestureTouches], sizeof(SDL_gestureTouch[i]));
     }
+    SDL_UnlockGestures();
     return 0;
 }
 
@@ -520,23 +735,111 @@ static void SDL_SendGestureMulti(SDL_GestureTouch* touch,float dTheta,float dDis
 }
 
 #if defined(ENABLE_DOLLAR)
-static void SDL_SendGestureDollar(SDL_GestureTouch* touch,
-                          SDL_GestureID gestureId,float error)
+static void SDL_SendGestureDollar(SDL_TouchID touchId, const SDL_FloatPoint *centroid,
+                          Uint16 numFingers, SDL_GestureID gestureId,float error)
 {
     if (SDL_GetEventState(SDL_DOLLARGESTURE) == SDL_ENABLE) {
         SDL_Event event;
         event.dgesture.type = SDL_DOLLARGESTURE;
-        event.dgesture.touchId = touch->id;
-        event.dgesture.x = touch->centroid.x;
-        event.dgesture.y = touch->centroid.y;
+        event.dgesture.touchId = touchId;
+        event.dgesture.x = centroid->x;
+        event.dgesture.y = centroid->y;
         event.dgesture.gestureId = gestureId;
         event.dgesture.error = error;
-        /* A finger came up to trigger this event. */
-        event.dgesture.numFingers = touch->numDownFingers + 1;
+        event.dgesture.numFingers = numFingers;
         SDL_PushEvent(&event);
     }
 }
 
+#if !SDL_THREADS_DISABLED
+static int SDLCALL SDL_GestureThread(void *data)
+{
+    SDL_LockMutex(SDL_gesture_lock);
+    while (!SDL_gesture_thread_quit) {
+        SDL_DollarJob *job = SDL_gesture_jobs;
+        SDL_GestureTouch *touch;
+        SDL_GestureID gestureId = 0;
+        int bestTempl = -1;
+        float error = 0;
+
+        if (!job) {
+            SDL_CondWait(SDL_gesture_cond, SDL_gesture_lock);
+            continue;
+        }
+        SDL_gesture_jobs = job->next;
+
+        /* The touch may have gone away since the gesture was queued */
+        touch = SDL_GetGestureTouch(job->touchId);
+        if (touch) {
+            error = dollarRecognize(&job->points, &bestTempl, touch);
+            if (bestTempl >= 0) {
+                gestureId = touch->dollarTemplate[bestTempl].hash;
+            }
+        }
+
+        SDL_UnlockMutex(SDL_gesture_lock);
+        if (bestTempl >= 0) {
+            SDL_SendGestureDollar(job->touchId, &job->centroid, job->numFingers, gestureId, error);
+        }
+        SDL_free(job);
+        SDL_LockMutex(SDL_gesture_lock);
+    }
+    SDL_UnlockMutex(SDL_gesture_lock);
+    return 0;
+}
+
+static int SDL_StartGestureThread(void)
+{
+    if (SDL_gesture_thread) {
+        return 0;
+    }
+
+    SDL_gesture_lock = SDL_CreateMutex();
+    SDL_gesture_cond = SDL_CreateCond();
+    if (!SDL_gesture_lock || !SDL_gesture_cond) {
+        SDL_StopGestureThread();
+        return -1;
+    }
+
+    SDL_gesture_thread_quit = SDL_FALSE;
+    SDL_gesture_thread = SDL_CreateThreadInternal(SDL_GestureThread, "SDLGesture", 0, NULL);
+    if (!SDL_gesture_thread) {
+        SDL_StopGestureThread();
+        return -1;
+    }
+    return 0;
+}
+
+static int SDL_QueueDollarJob(SDL_GestureTouch *touch)
+{
+    SDL_DollarJob *job, **tail;
+
+    if (SDL_StartGestureThread() < 0) {
+        return -1;
+    }
+
+    job = (SDL_DollarJob *)SDL_malloc(sizeof(*job));
+    if (!job) {
+        return SDL_OutOfMemory();
+    }
+    job->touchId = touch->id;
+    job->centroid = touch->centroid;
+    /* A finger came up to trigger this event. */
+    job->numFingers = touch->numDownFingers + 1;
+    job->next = NULL;
+    dollarPreparePath(&touch->dollarPath, &job->points);
+
+    SDL_LockMutex(SDL_gesture_lock);
+    for (tail = &SDL_gesture_jobs; *tail; tail = &(*tail)->next) {
+        continue;
+    }
+    *tail = job;
+    SDL_CondSignal(SDL_gesture_cond);
+    SDL_UnlockMutex(SDL_gesture_lock);
+    return 0;
+}
+#endif /* !SDL_THREADS_DISABLED */
+
 static void SDL_SendDollarRecord(SDL_GestureTouch* touch,SDL_GestureID gestureId)
 {
     if (SDL_GetEventState(SDL_DOLLARRECORD) == SDL_ENABLE) {
@@ -549,6 +852,33 @@ static void SDL_SendDollarRecord(SDL_GestureTouch* touch,SDL_GestureID gestureId
 }
 #endif
 
+static void SDL_StopGestureThread(void)
+{
+#if defined(ENABLE_DOLLAR) && !SDL_THREADS_DISABLED
+    if (SDL_gesture_thread) {
+        SDL_LockMutex(SDL_gesture_lock);
+        SDL_gesture_thread_quit = SDL_TRUE;
+        SDL_CondSignal(SDL_gesture_cond);
+        SDL_UnlockMutex(SDL_gesture_lock);
+        SDL_WaitThread(SDL_gesture_thread, NULL);
+        SDL_gesture_thread = NULL;
+    }
+    while (SDL_gesture_jobs) {
+        SDL_DollarJob *job = SDL_gesture_jobs;
+        SDL_gesture_jobs = job->next;
+        SDL_free(job);
+    }
+    if (SDL_gesture_cond) {
+        SDL_DestroyCond(SDL_gesture_cond);
+        SDL_gesture_cond = NULL;
+    }
+    if (SDL_gesture_lock) {
+        SDL_DestroyMutex(SDL_gesture_lock);
+        SDL_gesture_lock = NULL;
+    }
+#endif
+}
+
 
 void SDL_GestureProcessEvent(SDL_Event* event)
 {
@@ -605,16 +935,26 @@ void SDL_GestureProcessEvent(SDL_Event* event)
                     SDL_SendDollarRecord(inTouch,-1);
                 }
             }
-            else {
-                int bestTempl;
-                float error;
-                error = dollarRecognize(&inTouch->dollarPath,
-                                        &bestTempl,inTouch);
-                if (bestTempl >= 0){
-                    /* Send Event */
-                    unsigned long gestureId = inTouch->dollarTemplate[bestTempl].hash;
-                    SDL_SendGestureDollar(inTouch,gestureId,error);
-                    /* printf ("%s\n",);("Dollar error: %f\n",error); */
+            else if (SDL_GetEventState(SDL_DOLLARGESTURE) == SDL_ENABLE) {
+#if !SDL_THREADS_DISABLED
+                if (SDL_GetHintBoolean(SDL_HINT_DOLLAR_GESTURE_THREAD, SDL_FALSE) &&
+                    SDL_QueueDollarJob(inTouch) == 0) {
+                    /* The gesture thread will send the event */
+                } else
+#endif
+                {
+                    SDL_DollarPoints points;
+                    int bestTempl;
+                    float error;
+                    dollarPreparePath(&inTouch->dollarPath, &points);
+                    error = dollarRecognize(&points,&bestTempl,inTouch);
+                    if (bestTempl >= 0){
+                        /* Send Event */
+                        unsigned long gestureId = inTouch->dollarTemplate[bestTempl].hash;
+                        /* A finger came up to trigger this event. */
+                        SDL_SendGestureDollar(inTouch->id,&inTouch->centroid,inTouch->numDownFingers + 1,gestureId,error);
+                        /* printf ("%s\n",);("Dollar error: %f\n",error); */
+                    }
                 }
             }
 #endif
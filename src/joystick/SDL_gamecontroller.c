@@ -93,20 +93,50 @@ typedef enum
     SDL_CONTROLLER_MAPPING_PRIORITY_USER,
 } SDL_ControllerMappingPriority;
 
+/* Memory holding the source strings of mappings that are parsed on demand */
+typedef struct _ControllerMappingBuffer_t
+{
+    void *data;
+    int refcount;   /* mappings whose source is still in data, plus one while loading */
+    struct _ControllerMappingBuffer_t *next;
+} ControllerMappingBuffer_t;
+
 typedef struct _ControllerMapping_t
 {
     SDL_JoystickGUID guid;
+    const char *source; /* "name,mapping" string that name and mapping haven't been extracted from yet */
+    ControllerMappingBuffer_t *buffer;  /* where source is kept, or NULL for built-in mappings */
     char *name;
     char *mapping;
     SDL_ControllerMappingPriority priority;
     struct _ControllerMapping_t *next;
+    struct _ControllerMapping_t *hash_next;
 } ControllerMapping_t;
 
 static SDL_JoystickGUID s_zeroGUID;
 static ControllerMapping_t *s_pSupportedControllers = NULL;
+static ControllerMapping_t *s_pSupportedControllersTail = NULL;
+static ControllerMapping_t **s_pMappingHash = NULL;
+static int s_nMappingHashSize = 0;
+static int s_nMappings = 0;
+static ControllerMappingBuffer_t *s_pMappingBuffers = NULL;
 static ControllerMapping_t *s_pDefaultMapping = NULL;
 static ControllerMapping_t *s_pXInputMapping = NULL;
 
+/* The binary mapping cache format, all values are little endian:
+    char magic[8], Uint32 version, Uint32 num_entries, char platform[32],
+    num_entries * { Uint8 guid[16], Uint32 flags, Uint32 string offset },
+    NUL terminated "name,mapping" strings
+ */
+#define SDL_CONTROLLER_CACHE_MAGIC          "SDLGCMAP"
+#define SDL_CONTROLLER_CACHE_VERSION        1
+#define SDL_CONTROLLER_CACHE_PLATFORM_SIZE  32
+#define SDL_CONTROLLER_CACHE_HEADER_SIZE    (8 + 4 + 4 + SDL_CONTROLLER_CACHE_PLATFORM_SIZE)
+#define SDL_CONTROLLER_CACHE_ENTRY_SIZE     (16 + 4 + 4)
+#define SDL_CONTROLLER_CACHE_FLAG_DEFAULT   0x01    /* a built-in mapping */
+#define SDL_CONTROLLER_CACHE_FLAG_FALLBACK  0x02    /* the "default" mapping */
+#define SDL_CONTROLLER_CACHE_FLAG_XINPUT    0x04    /* the "xinput" mapping */
+
 /* The SDL game controller structure */
 struct _SDL_GameController
 {
@@ -192,7 +222,8 @@ SDL_GameControllerIgnoreDevicesExceptChanged(void *userdata, const char *name, c
     SDL_LoadVIDPIDListFromHint(hint, &SDL_allowed_controllers);
 }
 
-static ControllerMapping_t *SDL_PrivateAddMappingForGUID(SDL_JoystickGUID jGUID, const char *mappingString, SDL_bool *existing, SDL_ControllerMappingPriority priority);
+static ControllerMapping_t *SDL_PrivateAddMappingForGUID(SDL_JoystickGUID jGUID, const char *mappingString, SDL_bool *existing, SDL_ControllerMappingPriority priority, SDL_bool persistent, ControllerMappingBuffer_t *buffer);
+static int SDL_PrivateGameControllerAddMapping(const char *mappingString, SDL_ControllerMappingPriority priority, SDL_bool persistent, ControllerMappingBuffer_t *buffer);
 static int SDL_PrivateGameControllerAxis(SDL_GameController *gamecontroller, SDL_GameControllerAxis axis, Sint16 value);
 static int SDL_PrivateGameControllerButton(SDL_GameController *gamecontroller, SDL_GameControllerButton button, Uint8 state);
 
@@ -564,7 +595,7 @@ static ControllerMapping_t *SDL_CreateMappingForAndroidController(SDL_JoystickGU
     }
 
     return SDL_PrivateAddMappingForGUID(guid, mapping_string,
-                      &existing, SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT);
+                      &existing, SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT, SDL_FALSE, NULL);
 }
 #endif /* __ANDROID__ */
 
@@ -638,7 +669,7 @@ static ControllerMapping_t *SDL_CreateMappingForHIDAPIController(SDL_JoystickGUI
     }
 
     return SDL_PrivateAddMappingForGUID(guid, mapping_string,
-                      &existing, SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT);
+                      &existing, SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT, SDL_FALSE, NULL);
 }
 
 /*
@@ -653,7 +684,7 @@ static ControllerMapping_t *SDL_CreateMappingForRAWINPUTController(SDL_JoystickG
     SDL_strlcat(mapping_string, "a:b0,b:b1,x:b2,y:b3,back:b6,guide:b10,start:b7,leftstick:b8,rightstick:b9,leftshoulder:b4,rightshoulder:b5,dpup:h0.1,dpdown:h0.4,dpleft:h0.8,dpright:h0.2,leftx:a0,lefty:a1,rightx:a2,righty:a3,lefttrigger:a4,righttrigger:a5,", sizeof(mapping_string));
 
     return SDL_PrivateAddMappingForGUID(guid, mapping_string,
-                      &existing, SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT);
+                      &existing, SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT, SDL_FALSE, NULL);
 }
 
 /*
@@ -672,27 +703,194 @@ static ControllerMapping_t *SDL_CreateMappingForWGIController(SDL_JoystickGUID g
     SDL_strlcat(mapping_string, "a:b0,b:b1,x:b2,y:b3,back:b6,start:b7,leftstick:b8,rightstick:b9,leftshoulder:b4,rightshoulder:b5,dpup:b10,dpdown:b12,dpleft:b13,dpright:b11,leftx:a1,lefty:a0~,rightx:a3,righty:a2~,lefttrigger:a4,righttrigger:a5,", sizeof(mapping_string));
 
     return SDL_PrivateAddMappingForGUID(guid, mapping_string,
-                      &existing, SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT);
+                      &existing, SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT, SDL_FALSE, NULL);
 }
 
 /*
- * Helper function to scan the mappings database for a controller with the specified GUID
+ * Hash a GUID for the mappings database index (FNV-1a)
  */
-static ControllerMapping_t *SDL_PrivateGetControllerMappingForGUID(SDL_JoystickGUID guid, SDL_bool exact_match)
+static Uint32 SDL_PrivateHashControllerGUID(SDL_JoystickGUID guid)
+{
+    Uint32 hash = 2166136261u;
+    int i;
+
+    for (i = 0; i < (int)sizeof(guid.data); ++i) {
+        hash ^= guid.data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/*
+ * Add a mapping to the end of the mappings database, growing the GUID index as needed
+ */
+static SDL_bool SDL_PrivateInsertControllerMapping(ControllerMapping_t *pControllerMapping)
 {
-    ControllerMapping_t *mapping = s_pSupportedControllers;
+    Uint32 bucket;
+
+    if (s_nMappings >= s_nMappingHashSize) {
+        const int new_size = s_nMappingHashSize ? (s_nMappingHashSize * 2) : 1024;
+        ControllerMapping_t **new_hash = (ControllerMapping_t **)SDL_calloc(new_size, sizeof(*new_hash));
+        int i;
+
+        if (!new_hash) {
+            SDL_OutOfMemory();
+            return SDL_FALSE;
+        }
+        for (i = 0; i < s_nMappingHashSize; ++i) {
+            while (s_pMappingHash[i]) {
+                ControllerMapping_t *mapping = s_pMappingHash[i];
+                s_pMappingHash[i] = mapping->hash_next;
+
+                bucket = SDL_PrivateHashControllerGUID(mapping->guid) & (new_size - 1);
+                mapping->hash_next = new_hash[bucket];
+                new_hash[bucket] = mapping;
+            }
+        }
+        SDL_free(s_pMappingHash);
+        s_pMappingHash = new_hash;
+        s_nMappingHashSize = new_size;
+    }
+
+    bucket = SDL_PrivateHashControllerGUID(pControllerMapping->guid) & (s_nMappingHashSize - 1);
+    pControllerMapping->hash_next = s_pMappingHash[bucket];
+    s_pMappingHash[bucket] = pControllerMapping;
+    ++s_nMappings;
 
+    pControllerMapping->next = NULL;
+    if (s_pSupportedControllersTail) {
+        s_pSupportedControllersTail->next = pControllerMapping;
+    } else {
+        s_pSupportedControllers = pControllerMapping;
+    }
+    s_pSupportedControllersTail = pControllerMapping;
+    return SDL_TRUE;
+}
+
+/*
+ * Look up a mapping in the GUID index of the mappings database
+ */
+static ControllerMapping_t *SDL_PrivateFindControllerMappingForGUID(SDL_JoystickGUID guid)
+{
+    ControllerMapping_t *mapping;
+
+    if (!s_pMappingHash) {
+        return NULL;
+    }
+    mapping = s_pMappingHash[SDL_PrivateHashControllerGUID(guid) & (s_nMappingHashSize - 1)];
     while (mapping) {
         if (SDL_memcmp(&guid, &mapping->guid, sizeof(guid)) == 0) {
             return mapping;
         }
-        mapping = mapping->next;
+        mapping = mapping->hash_next;
+    }
+    return NULL;
+}
+
+/*
+ * Drop a reference to a mapping buffer, freeing it once no mapping uses its strings
+ */
+static void SDL_PrivateReleaseControllerMappingBuffer(ControllerMappingBuffer_t *buffer)
+{
+    ControllerMappingBuffer_t **prev;
+
+    if (!buffer || --buffer->refcount > 0) {
+        return;
+    }
+    for (prev = &s_pMappingBuffers; *prev; prev = &(*prev)->next) {
+        if (*prev == buffer) {
+            *prev = buffer->next;
+            break;
+        }
+    }
+    SDL_free(buffer->data);
+    SDL_free(buffer);
+}
+
+/*
+ * Create a buffer for the source strings of mappings, taking ownership of data
+ */
+static ControllerMappingBuffer_t *SDL_PrivateCreateControllerMappingBuffer(void *data)
+{
+    ControllerMappingBuffer_t *buffer = (ControllerMappingBuffer_t *)SDL_malloc(sizeof(*buffer));
+
+    if (!buffer) {
+        SDL_free(data);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    buffer->data = data;
+    buffer->refcount = 1;
+    buffer->next = s_pMappingBuffers;
+    s_pMappingBuffers = buffer;
+    return buffer;
+}
+
+/*
+ * Forget the unparsed source string of a mapping
+ */
+static void SDL_PrivateReleaseControllerMappingSource(ControllerMapping_t *pControllerMapping)
+{
+    ControllerMappingBuffer_t *buffer = pControllerMapping->buffer;
+
+    pControllerMapping->source = NULL;
+    pControllerMapping->buffer = NULL;
+    SDL_PrivateReleaseControllerMappingBuffer(buffer);
+}
+
+/*
+ * Extract the name and mapping of a mapping that was added without parsing them
+ */
+static SDL_bool SDL_PrivateParseControllerMapping(ControllerMapping_t *pControllerMapping)
+{
+    const char *pchSource = pControllerMapping->source;
+    const char *pComma;
+    char *pchName, *pchMapping;
+
+    if (!pchSource) {
+        return SDL_TRUE;
+    }
+
+    pComma = SDL_strchr(pchSource, ',');
+    if (!pComma) {
+        SDL_SetError("Couldn't parse %s", pchSource);
+        return SDL_FALSE;
+    }
+    pchName = SDL_malloc(pComma - pchSource + 1);
+    pchMapping = SDL_strdup(pComma + 1);
+    if (!pchName || !pchMapping) {
+        SDL_free(pchName);
+        SDL_free(pchMapping);
+        SDL_OutOfMemory();
+        return SDL_FALSE;
+    }
+    SDL_memcpy(pchName, pchSource, pComma - pchSource);
+    pchName[pComma - pchSource] = '\0';
+
+    pControllerMapping->name = pchName;
+    pControllerMapping->mapping = pchMapping;
+    SDL_PrivateReleaseControllerMappingSource(pControllerMapping);
+    return SDL_TRUE;
+}
+
+/*
+ * Helper function to scan the mappings database for a controller with the specified GUID
+ */
+static ControllerMapping_t *SDL_PrivateGetControllerMappingForGUID(SDL_JoystickGUID guid, SDL_bool exact_match)
+{
+    ControllerMapping_t *mapping = SDL_PrivateFindControllerMappingForGUID(guid);
+
+    if (mapping) {
+        return SDL_PrivateParseControllerMapping(mapping) ? mapping : NULL;
     }
 
     if (!exact_match) {
 #if SDL_JOYSTICK_XINPUT
         if (SDL_IsJoystickXInput(guid)) {
             /* This is an XInput device */
+            if (s_pXInputMapping && !SDL_PrivateParseControllerMapping(s_pXInputMapping)) {
+                return NULL;
+            }
             return s_pXInputMapping;
         }
 #endif
@@ -1079,6 +1277,10 @@ static void SDL_PrivateGameControllerRefreshMapping(ControllerMapping_t *pContro
     SDL_GameController *gamecontrollerlist = SDL_gamecontrollers;
     while (gamecontrollerlist) {
         if (!SDL_memcmp(&gamecontrollerlist->joystick->guid, &pControllerMapping->guid, sizeof(pControllerMapping->guid))) {
+            if (!SDL_PrivateParseControllerMapping(pControllerMapping)) {
+                return;
+            }
+
             /* Not really threadsafe.  Should this lock access within SDL_GameControllerEventWatcher? */
             SDL_PrivateLoadButtonMapping(gamecontrollerlist, pControllerMapping->name, pControllerMapping->mapping);
 
@@ -1096,32 +1298,54 @@ static void SDL_PrivateGameControllerRefreshMapping(ControllerMapping_t *pContro
 
 /*
  * Helper function to add a mapping for a guid
+ *
+ * If the mapping string is persistent, i.e. it outlives the mappings database,
+ * extracting the name and mapping from it is deferred until they are needed.
+ * Persistent strings kept in a mapping buffer hold a reference to it until then.
  */
 static ControllerMapping_t *
-SDL_PrivateAddMappingForGUID(SDL_JoystickGUID jGUID, const char *mappingString, SDL_bool *existing, SDL_ControllerMappingPriority priority)
+SDL_PrivateAddMappingForGUID(SDL_JoystickGUID jGUID, const char *mappingString, SDL_bool *existing, SDL_ControllerMappingPriority priority, SDL_bool persistent, ControllerMappingBuffer_t *buffer)
 {
-    char *pchName;
-    char *pchMapping;
+    const char *pchSource = NULL;
+    char *pchName = NULL;
+    char *pchMapping = NULL;
     ControllerMapping_t *pControllerMapping;
 
-    pchName = SDL_PrivateGetControllerNameFromMappingString(mappingString);
-    if (!pchName) {
-        SDL_SetError("Couldn't parse name from %s", mappingString);
-        return NULL;
-    }
+    if (persistent) {
+        const char *pFirstComma = SDL_strchr(mappingString, ',');
+        if (!pFirstComma || !SDL_strchr(pFirstComma + 1, ',')) {
+            SDL_SetError("Couldn't parse %s", mappingString);
+            return NULL;
+        }
+        pchSource = pFirstComma + 1;
+    } else {
+        pchName = SDL_PrivateGetControllerNameFromMappingString(mappingString);
+        if (!pchName) {
+            SDL_SetError("Couldn't parse name from %s", mappingString);
+            return NULL;
+        }
 
-    pchMapping = SDL_PrivateGetControllerMappingFromMappingString(mappingString);
-    if (!pchMapping) {
-        SDL_free(pchName);
-        SDL_SetError("Couldn't parse %s", mappingString);
-        return NULL;
+        pchMapping = SDL_PrivateGetControllerMappingFromMappingString(mappingString);
+        if (!pchMapping) {
+            SDL_free(pchName);
+            SDL_SetError("Couldn't parse %s", mappingString);
+            return NULL;
+        }
     }
 
-    pControllerMapping = SDL_PrivateGetControllerMappingForGUID(jGUID, SDL_TRUE);
+    pControllerMapping = SDL_PrivateFindControllerMappingForGUID(jGUID);
     if (pControllerMapping) {
         /* Only overwrite the mapping if the priority is the same or higher. */
         if (pControllerMapping->priority <= priority) {
             /* Update existing mapping */
+            SDL_PrivateReleaseControllerMappingSource(pControllerMapping);
+            if (pchSource) {
+                pControllerMapping->source = pchSource;
+                pControllerMapping->buffer = buffer;
+                if (buffer) {
+                    ++buffer->refcount;
+                }
+            }
             SDL_free(pControllerMapping->name);
             pControllerMapping->name = pchName;
             SDL_free(pControllerMapping->mapping);
@@ -1143,23 +1367,20 @@ SDL_PrivateAddMappingForGUID(SDL_JoystickGUID jGUID, const char *mappingString,
             return NULL;
         }
         pControllerMapping->guid = jGUID;
+        pControllerMapping->source = pchSource;
+        pControllerMapping->buffer = pchSource ? buffer : NULL;
         pControllerMapping->name = pchName;
         pControllerMapping->mapping = pchMapping;
-        pControllerMapping->next = NULL;
         pControllerMapping->priority = priority;
 
-        if (s_pSupportedControllers) {
-            /* Add the mapping to the end of the list */
-            ControllerMapping_t *pCurrMapping, *pPrevMapping;
-
-            for ( pPrevMapping = s_pSupportedControllers, pCurrMapping = pPrevMapping->next;
-                  pCurrMapping; 
-                  pPrevMapping = pCurrMapping, pCurrMapping = pCurrMapping->next ) {
-                /* continue; */
-            }
-            pPrevMapping->next = pControllerMapping;
-        } else {
-            s_pSupportedControllers = pControllerMapping;
+        if (!SDL_PrivateInsertControllerMapping(pControllerMapping)) {
+            SDL_free(pchName);
+            SDL_free(pchMapping);
+            SDL_free(pControllerMapping);
+            return NULL;
+        }
+        if (pControllerMapping->buffer) {
+            ++pControllerMapping->buffer->refcount;
         }
         *existing = SDL_FALSE;
     }
@@ -1181,7 +1402,7 @@ static ControllerMapping_t *SDL_PrivateGetControllerMappingForNameAndGUID(const
             SDL_bool existing;
             mapping = SDL_PrivateAddMappingForGUID(guid,
 "none,X360 Wireless Controller,a:b0,b:b1,back:b6,dpdown:b14,dpleft:b11,dpright:b12,dpup:b13,guide:b8,leftshoulder:b4,leftstick:b9,lefttrigger:a2,leftx:a0,lefty:a1,rightshoulder:b5,rightstick:b10,righttrigger:a5,rightx:a3,righty:a4,start:b7,x:b2,y:b3",
-                          &existing, SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT);
+                          &existing, SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT, SDL_FALSE, NULL);
         } else if (SDL_strstr(name, "Xbox") || SDL_strstr(name, "X-Box") || SDL_strstr(name, "XBOX")) {
             mapping = s_pXInputMapping;
         }
@@ -1191,6 +1412,9 @@ static ControllerMapping_t *SDL_PrivateGetControllerMappingForNameAndGUID(const
     if (!mapping) {
         mapping = s_pDefaultMapping;
     }
+    if (mapping && !SDL_PrivateParseControllerMapping(mapping)) {
+        mapping = NULL;
+    }
     return mapping;
 }
 
@@ -1276,7 +1500,7 @@ static ControllerMapping_t *SDL_PrivateGenerateAutomaticControllerMapping(const
     }
 
     return SDL_PrivateAddMappingForGUID(guid, mapping,
-                      &existing, SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT);
+                      &existing, SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT, SDL_FALSE, NULL);
 }
 
 static ControllerMapping_t *SDL_PrivateGetControllerMapping(int device_index)
@@ -1317,8 +1541,9 @@ SDL_GameControllerAddMappingsFromRW(SDL_RWops * rw, int freerw)
 {
     const char *platform = SDL_GetPlatform();
     int controllers = 0;
-    char *buf, *line, *line_end, *tmp, *comma, line_platform[64];
+    char *buf, *line, *line_end, *kept_end, *tmp, *comma, line_platform[64];
     size_t db_size, platform_len;
+    ControllerMappingBuffer_t *buffer;
     
     if (rw == NULL) {
         return SDL_SetError("Invalid RWops");
@@ -1347,7 +1572,9 @@ SDL_GameControllerAddMappingsFromRW(SDL_RWops * rw, int freerw)
     
     buf[db_size] = '\0';
     line = buf;
+    kept_end = buf;
     
+    /* Keep only the lines for this platform, packed at the start of the buffer */
     while (line < buf + db_size) {
         line_end = SDL_strchr(line, '\n');
         if (line_end != NULL) {
@@ -1365,9 +1592,11 @@ SDL_GameControllerAddMappingsFromRW(SDL_RWops * rw, int freerw)
                 platform_len = comma - tmp + 1;
                 if (platform_len + 1 < SDL_arraysize(line_platform)) {
                     SDL_strlcpy(line_platform, tmp, platform_len);
-                    if (SDL_strncasecmp(line_platform, platform, platform_len) == 0 &&
-                        SDL_GameControllerAddMapping(line) > 0) {
-                        controllers++;
+                    if (SDL_strncasecmp(line_platform, platform, platform_len) == 0) {
+                        const size_t line_len = line_end - line;
+                        SDL_memmove(kept_end, line, line_len);
+                        kept_end[line_len] = '\0';
+                        kept_end += line_len + 1;
                     }
                 }
             }
@@ -1376,27 +1605,40 @@ SDL_GameControllerAddMappingsFromRW(SDL_RWops * rw, int freerw)
         line = line_end + 1;
     }
 
-    SDL_free(buf);
+    if (kept_end == buf) {
+        SDL_free(buf);
+        return 0;
+    }
+
+    /* The mappings are parsed when a controller uses them, so the lines stay
+       around for as long as the mappings database */
+    db_size = kept_end - buf;
+    tmp = (char *)SDL_realloc(buf, db_size);
+    if (tmp) {
+        buf = tmp;
+    }
+    buffer = SDL_PrivateCreateControllerMappingBuffer(buf);
+    if (!buffer) {
+        return -1;
+    }
+
+    for (line = buf; line < buf + db_size; line += SDL_strlen(line) + 1) {
+        if (SDL_PrivateGameControllerAddMapping(line, SDL_CONTROLLER_MAPPING_PRIORITY_API, SDL_TRUE, buffer) > 0) {
+            controllers++;
+        }
+    }
+    /* Done loading, the buffer is freed here if no mapping ended up using it */
+    SDL_PrivateReleaseControllerMappingBuffer(buffer);
     return controllers;
 }
 
 /*
- * Add or update an entry into the Mappings Database with a priority
+ * Check the hint and SDK version conditions of a mapping string
+ * Returns 1 if the mapping applies, 0 if it doesn't, or -1 on error
  */
 static int
-SDL_PrivateGameControllerAddMapping(const char *mappingString, SDL_ControllerMappingPriority priority)
+SDL_PrivateGameControllerMappingEnabled(const char *mappingString)
 {
-    char *pchGUID;
-    SDL_JoystickGUID jGUID;
-    SDL_bool is_default_mapping = SDL_FALSE;
-    SDL_bool is_xinput_mapping = SDL_FALSE;
-    SDL_bool existing = SDL_FALSE;
-    ControllerMapping_t *pControllerMapping;
-
-    if (!mappingString) {
-        return SDL_InvalidParamError("mappingString");
-    }
-
     { /* Extract and verify the hint field */
         const char *tmp;
 
@@ -1458,6 +1700,217 @@ SDL_PrivateGameControllerAddMapping(const char *mappingString, SDL_ControllerMap
         }
     }
 #endif
+    return 1;
+}
+
+static Uint32
+SDL_PrivateReadLE32(const Uint8 *data)
+{
+    return ((Uint32)data[0]) | ((Uint32)data[1] << 8) | ((Uint32)data[2] << 16) | ((Uint32)data[3] << 24);
+}
+
+static void
+SDL_PrivateWriteLE32(Uint8 *data, Uint32 value)
+{
+    data[0] = (Uint8)value;
+    data[1] = (Uint8)(value >> 8);
+    data[2] = (Uint8)(value >> 16);
+    data[3] = (Uint8)(value >> 24);
+}
+
+/*
+ * Add or update entries from a binary mapping cache into the Mappings Database
+ */
+int
+SDL_GameControllerAddMappingsFromCacheRW(SDL_RWops * rw, int freerw)
+{
+    char platform[SDL_CONTROLLER_CACHE_PLATFORM_SIZE + 1];
+    ControllerMappingBuffer_t *buffer;
+    Uint8 *buf, *entry;
+    const char *strings;
+    size_t size, strings_size;
+    Uint32 i, num_entries;
+    int controllers = 0;
+
+    if (rw == NULL) {
+        return SDL_SetError("Invalid RWops");
+    }
+    buf = (Uint8 *)SDL_LoadFile_RW(rw, &size, freerw);
+    if (buf == NULL) {
+        return -1;
+    }
+
+    if (size < SDL_CONTROLLER_CACHE_HEADER_SIZE ||
+        SDL_memcmp(buf, SDL_CONTROLLER_CACHE_MAGIC, 8) != 0 ||
+        SDL_PrivateReadLE32(buf + 8) != SDL_CONTROLLER_CACHE_VERSION) {
+        SDL_free(buf);
+        return SDL_SetError("Not a controller mapping cache");
+    }
+    num_entries = SDL_PrivateReadLE32(buf + 12);
+    SDL_memcpy(platform, buf + 16, SDL_CONTROLLER_CACHE_PLATFORM_SIZE);
+    platform[SDL_CONTROLLER_CACHE_PLATFORM_SIZE] = '\0';
+    if (SDL_strcmp(platform, SDL_GetPlatform()) != 0) {
+        SDL_free(buf);
+        return SDL_SetError("Controller mapping cache is for %s", platform);
+    }
+    if (num_entries > (size - SDL_CONTROLLER_CACHE_HEADER_SIZE) / SDL_CONTROLLER_CACHE_ENTRY_SIZE) {
+        SDL_free(buf);
+        return SDL_SetError("Controller mapping cache is truncated");
+    }
+    strings = (const char *)buf + SDL_CONTROLLER_CACHE_HEADER_SIZE + num_entries * SDL_CONTROLLER_CACHE_ENTRY_SIZE;
+    strings_size = size - (SDL_CONTROLLER_CACHE_HEADER_SIZE + num_entries * SDL_CONTROLLER_CACHE_ENTRY_SIZE);
+    if (num_entries == 0 || strings_size == 0 || strings[strings_size - 1] != '\0') {
+        SDL_free(buf);
+        return num_entries ? SDL_SetError("Controller mapping cache is truncated") : 0;
+    }
+
+    /* The mapping strings are used in place, so the cache stays loaded until they are parsed */
+    buffer = SDL_PrivateCreateControllerMappingBuffer(buf);
+    if (!buffer) {
+        return -1;
+    }
+
+    entry = buf + SDL_CONTROLLER_CACHE_HEADER_SIZE;
+    for (i = 0; i < num_entries; ++i, entry += SDL_CONTROLLER_CACHE_ENTRY_SIZE) {
+        const Uint32 flags = SDL_PrivateReadLE32(entry + 16);
+        const Uint32 offset = SDL_PrivateReadLE32(entry + 20);
+        SDL_ControllerMappingPriority priority;
+        ControllerMapping_t *pControllerMapping;
+        SDL_JoystickGUID jGUID;
+        SDL_bool existing;
+
+        if (offset >= strings_size ||
+            SDL_PrivateGameControllerMappingEnabled(&strings[offset]) <= 0) {
+            continue;
+        }
+
+        SDL_memcpy(jGUID.data, entry, sizeof(jGUID.data));
+        if (flags & SDL_CONTROLLER_CACHE_FLAG_DEFAULT) {
+            priority = SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT;
+        } else {
+            priority = SDL_CONTROLLER_MAPPING_PRIORITY_API;
+        }
+        pControllerMapping = SDL_PrivateAddMappingForGUID(jGUID, &strings[offset], &existing, priority, SDL_TRUE, buffer);
+        if (pControllerMapping && !existing) {
+            if (flags & SDL_CONTROLLER_CACHE_FLAG_FALLBACK) {
+                s_pDefaultMapping = pControllerMapping;
+            } else if (flags & SDL_CONTROLLER_CACHE_FLAG_XINPUT) {
+                s_pXInputMapping = pControllerMapping;
+            }
+            ++controllers;
+        }
+    }
+    SDL_PrivateReleaseControllerMappingBuffer(buffer);
+    return controllers;
+}
+
+/*
+ * Write the Mappings Database as a binary mapping cache
+ */
+int
+SDL_GameControllerSaveMappingCacheRW(SDL_RWops * rw, int freerw)
+{
+    ControllerMapping_t *mapping;
+    Uint8 *buf, *entry;
+    char *strings;
+    char pchGUID[33];
+    size_t size, strings_size = 0;
+    Uint32 num_entries = 0;
+    int retval;
+
+    if (rw == NULL) {
+        return SDL_SetError("Invalid RWops");
+    }
+
+    /* Each string is "GUID,name,mapping", the same format as the text database */
+    for (mapping = s_pSupportedControllers; mapping; mapping = mapping->next) {
+        strings_size += 32 + 1;
+        if (mapping->source) {
+            strings_size += SDL_strlen(mapping->source) + 1;
+        } else {
+            strings_size += SDL_strlen(mapping->name) + 1 + SDL_strlen(mapping->mapping) + 1;
+        }
+        ++num_entries;
+    }
+
+    size = SDL_CONTROLLER_CACHE_HEADER_SIZE + num_entries * SDL_CONTROLLER_CACHE_ENTRY_SIZE + strings_size;
+    buf = (Uint8 *)SDL_calloc(1, size);
+    if (buf == NULL) {
+        if (freerw) {
+            SDL_RWclose(rw);
+        }
+        return SDL_OutOfMemory();
+    }
+
+    SDL_memcpy(buf, SDL_CONTROLLER_CACHE_MAGIC, 8);
+    SDL_PrivateWriteLE32(buf + 8, SDL_CONTROLLER_CACHE_VERSION);
+    SDL_PrivateWriteLE32(buf + 12, num_entries);
+    SDL_strlcpy((char *)buf + 16, SDL_GetPlatform(), SDL_CONTROLLER_CACHE_PLATFORM_SIZE);
+
+    entry = buf + SDL_CONTROLLER_CACHE_HEADER_SIZE;
+    strings = (char *)entry + num_entries * SDL_CONTROLLER_CACHE_ENTRY_SIZE;
+    strings_size = 0;
+    for (mapping = s_pSupportedControllers; mapping; mapping = mapping->next) {
+        Uint32 flags = 0;
+        char *string = strings + strings_size;
+
+        if (mapping->priority == SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT) {
+            flags |= SDL_CONTROLLER_CACHE_FLAG_DEFAULT;
+        }
+        if (mapping == s_pDefaultMapping) {
+            flags |= SDL_CONTROLLER_CACHE_FLAG_FALLBACK;
+        } else if (mapping == s_pXInputMapping) {
+            flags |= SDL_CONTROLLER_CACHE_FLAG_XINPUT;
+        }
+        SDL_memcpy(entry, mapping->guid.data, sizeof(mapping->guid.data));
+        SDL_PrivateWriteLE32(entry + 16, flags);
+        SDL_PrivateWriteLE32(entry + 20, (Uint32)strings_size);
+        entry += SDL_CONTROLLER_CACHE_ENTRY_SIZE;
+
+        SDL_JoystickGetGUIDString(mapping->guid, pchGUID, sizeof(pchGUID));
+        if (mapping->source) {
+            strings_size += SDL_snprintf(string, size - (string - (char *)buf), "%s,%s", pchGUID, mapping->source) + 1;
+        } else {
+            strings_size += SDL_snprintf(string, size - (string - (char *)buf), "%s,%s,%s", pchGUID, mapping->name, mapping->mapping) + 1;
+        }
+    }
+    size = SDL_CONTROLLER_CACHE_HEADER_SIZE + num_entries * SDL_CONTROLLER_CACHE_ENTRY_SIZE + strings_size;
+
+    if (SDL_RWwrite(rw, buf, size, 1) != 1) {
+        retval = SDL_SetError("Couldn't write controller mapping cache");
+    } else {
+        retval = (int)num_entries;
+    }
+    SDL_free(buf);
+
+    if (freerw) {
+        SDL_RWclose(rw);
+    }
+    return retval;
+}
+
+/*
+ * Add or update an entry into the Mappings Database with a priority
+ */
+static int
+SDL_PrivateGameControllerAddMapping(const char *mappingString, SDL_ControllerMappingPriority priority, SDL_bool persistent, ControllerMappingBuffer_t *buffer)
+{
+    char *pchGUID;
+    SDL_JoystickGUID jGUID;
+    SDL_bool is_default_mapping = SDL_FALSE;
+    SDL_bool is_xinput_mapping = SDL_FALSE;
+    SDL_bool existing = SDL_FALSE;
+    ControllerMapping_t *pControllerMapping;
+    int enabled;
+
+    if (!mappingString) {
+        return SDL_InvalidParamError("mappingString");
+    }
+
+    enabled = SDL_PrivateGameControllerMappingEnabled(mappingString);
+    if (enabled <= 0) {
+        return enabled;
+    }
 
     pchGUID = SDL_PrivateGetControllerGUIDFromMappingString(mappingString);
     if (!pchGUID) {
@@ -1471,7 +1924,7 @@ SDL_PrivateGameControllerAddMapping(const char *mappingString, SDL_ControllerMap
     jGUID = SDL_JoystickGetGUIDFromString(pchGUID);
     SDL_free(pchGUID);
 
-    pControllerMapping = SDL_PrivateAddMappingForGUID(jGUID, mappingString, &existing, priority);
+    pControllerMapping = SDL_PrivateAddMappingForGUID(jGUID, mappingString, &existing, priority, persistent, buffer);
     if (!pControllerMapping) {
         return -1;
     }
@@ -1494,7 +1947,7 @@ SDL_PrivateGameControllerAddMapping(const char *mappingString, SDL_ControllerMap
 int
 SDL_GameControllerAddMapping(const char *mappingString)
 {
-    return SDL_PrivateGameControllerAddMapping(mappingString, SDL_CONTROLLER_MAPPING_PRIORITY_API);
+    return SDL_PrivateGameControllerAddMapping(mappingString, SDL_CONTROLLER_MAPPING_PRIORITY_API, SDL_FALSE, NULL);
 }
 
 /*
@@ -1526,6 +1979,10 @@ CreateMappingString(ControllerMapping_t *mapping, SDL_JoystickGUID guid)
     size_t needed;
     const char *platform = SDL_GetPlatform();
 
+    if (!SDL_PrivateParseControllerMapping(mapping)) {
+        return NULL;
+    }
+
     SDL_JoystickGetGUIDString(guid, pchGUID, sizeof(pchGUID));
 
     /* allocate enough memory for GUID + ',' + name + ',' + mapping + \0 */
@@ -1629,7 +2086,7 @@ SDL_GameControllerLoadHints()
             if (pchNewLine)
                 *pchNewLine = '\0';
 
-            SDL_PrivateGameControllerAddMapping(pUserMappings, SDL_CONTROLLER_MAPPING_PRIORITY_USER);
+            SDL_PrivateGameControllerAddMapping(pUserMappings, SDL_CONTROLLER_MAPPING_PRIORITY_USER, SDL_FALSE, NULL);
 
             if (pchNewLine) {
                 pUserMappings = pchNewLine + 1;
@@ -1669,14 +2126,20 @@ SDL_GameControllerInitMappings(void)
     char szControllerMapPath[1024];
     int i = 0;
     const char *pMappingString = NULL;
+    const char *hint;
     pMappingString = s_ControllerMappings[i];
     while (pMappingString) {
-        SDL_PrivateGameControllerAddMapping(pMappingString, SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT);
+        SDL_PrivateGameControllerAddMapping(pMappingString, SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT, SDL_TRUE, NULL);
 
         i++;
         pMappingString = s_ControllerMappings[i];
     }
 
+    hint = SDL_GetHint(SDL_HINT_GAMECONTROLLERCONFIG_CACHE_FILE);
+    if (hint && *hint) {
+        SDL_GameControllerAddMappingsFromCacheFile(hint);
+    }
+
     if (SDL_GetControllerMappingFilePath(szControllerMapPath, sizeof(szControllerMapPath))) {
         SDL_GameControllerAddMappingsFromFile(szControllerMapPath);        
     }
@@ -2574,6 +3037,21 @@ SDL_GameControllerQuitMappings(void)
         SDL_free(pControllerMap->mapping);
         SDL_free(pControllerMap);
     }
+    s_pSupportedControllersTail = NULL;
+    s_pDefaultMapping = NULL;
+    s_pXInputMapping = NULL;
+
+    SDL_free(s_pMappingHash);
+    s_pMappingHash = NULL;
+    s_nMappingHashSize = 0;
+    s_nMappings = 0;
+
+    while (s_pMappingBuffers) {
+        ControllerMappingBuffer_t *buffer = s_pMappingBuffers;
+        s_pMappingBuffers = buffer->next;
+        SDL_free(buffer->data);
+        SDL_free(buffer);
+    }
 
     SDL_DelEventWatch(SDL_GameControllerEventWatcher, NULL);
 
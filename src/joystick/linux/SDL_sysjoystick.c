@@ -77,6 +77,7 @@
 
 #include "../../core/linux/SDL_evdev_capabilities.h"
 #include "../../core/linux/SDL_udev.h"
+#include "../../core/linux/SDL_inputthread.h"
 
 #if 0
 #define DEBUG_INPUT_EVENTS 1
@@ -113,6 +114,7 @@ typedef struct SDL_joylist_item
 } SDL_joylist_item;
 
 static SDL_bool SDL_classic_joysticks = SDL_FALSE;
+static SDL_bool SDL_joystick_input_thread = SDL_FALSE;
 static SDL_joylist_item *SDL_joylist = NULL;
 static SDL_joylist_item *SDL_joylist_tail = NULL;
 static int numjoysticks = 0;
@@ -682,6 +684,7 @@ LINUX_JoystickInit(void)
     const char *devices = SDL_GetHint(SDL_HINT_JOYSTICK_DEVICE);
 
     SDL_classic_joysticks = SDL_GetHintBoolean(SDL_HINT_LINUX_JOYSTICK_CLASSIC, SDL_FALSE);
+    SDL_joystick_input_thread = SDL_InputThread_Init();
 
 #if SDL_USE_LIBUDEV
     if (enumeration_method == ENUMERATION_UNSET) {
@@ -974,6 +977,8 @@ ConfigJoystick(SDL_Joystick *joystick, int fd)
             ++joystick->nballs;
         }
 
+        joystick->hwdata->monotonic_timestamps = SDL_EVDEV_SetMonotonicTimestamps(fd);
+
     } else if ((ioctl(fd, JSIOCGBUTTONS, &key_pam_size, sizeof(key_pam_size)) >= 0) &&
                (ioctl(fd, JSIOCGAXES, &abs_pam_size, sizeof(abs_pam_size)) >= 0)) {
         size_t len;
@@ -1139,6 +1144,11 @@ LINUX_JoystickOpen(SDL_Joystick *joystick, int device_index)
     /* mark joystick as fresh and ready */
     joystick->hwdata->fresh = SDL_TRUE;
 
+    if (SDL_joystick_input_thread && joystick->hwdata->fd >= 0) {
+        const size_t record_size = joystick->hwdata->classic ? sizeof(struct js_event) : sizeof(struct input_event);
+        joystick->hwdata->threaded = (SDL_InputThread_AddFd(joystick->hwdata->fd, record_size) == 0);
+    }
+
     return 0;
 }
 
@@ -1346,6 +1356,16 @@ PollAllValues(SDL_Joystick *joystick)
     /* Joyballs are relative input, so there's no poll state. Events only! */
 }
 
+static int
+ReadJoystick(SDL_Joystick *joystick, void *events, size_t size)
+{
+    if (joystick->hwdata->threaded) {
+        /* Already read from the device by the input thread */
+        return SDL_InputThread_Read(joystick->hwdata->fd, events, size);
+    }
+    return read(joystick->hwdata->fd, events, size);
+}
+
 static void
 HandleInputEvents(SDL_Joystick *joystick)
 {
@@ -1357,11 +1377,15 @@ HandleInputEvents(SDL_Joystick *joystick)
         joystick->hwdata->fresh = SDL_FALSE;
     }
 
-    while ((len = read(joystick->hwdata->fd, events, (sizeof events))) > 0) {
+    while ((len = ReadJoystick(joystick, events, (sizeof events))) > 0) {
         len /= sizeof(events[0]);
         for (i = 0; i < len; ++i) {
             code = events[i].code;
 
+            if (joystick->hwdata->monotonic_timestamps) {
+                SDL_SetEventSourceTimestampNS(SDL_EVDEV_GetEventTimestampNS(&events[i]));
+            }
+
             /* If the kernel sent a SYN_DROPPED, we are supposed to ignore the
                rest of the packet (the end of it signified by a SYN_REPORT) */
             if ( joystick->hwdata->recovering_from_dropped &&
@@ -1430,6 +1454,8 @@ HandleInputEvents(SDL_Joystick *joystick)
         }
     }
 
+    SDL_SetEventSourceTimestampNS(0);
+
     if (errno == ENODEV) {
         /* We have to wait until the JoystickDetect callback to remove this */
         joystick->hwdata->gone = SDL_TRUE;
@@ -1443,7 +1469,7 @@ HandleClassicEvents(SDL_Joystick *joystick)
     int i, len, code;
 
     joystick->hwdata->fresh = SDL_FALSE;
-    while ((len = read(joystick->hwdata->fd, events, (sizeof events))) > 0) {
+    while ((len = ReadJoystick(joystick, events, (sizeof events))) > 0) {
         len /= sizeof(events[0]);
         for (i = 0; i < len; ++i) {
             switch (events[i].type) {
@@ -1513,6 +1539,9 @@ static void
 LINUX_JoystickClose(SDL_Joystick *joystick)
 {
     if (joystick->hwdata) {
+        if (joystick->hwdata->threaded) {
+            SDL_InputThread_RemoveFd(joystick->hwdata->fd);
+        }
         if (joystick->hwdata->effect.id >= 0) {
             ioctl(joystick->hwdata->fd, EVIOCRMFF, joystick->hwdata->effect.id);
             joystick->hwdata->effect.id = -1;
@@ -1561,6 +1590,11 @@ LINUX_JoystickQuit(void)
 #endif
 
     SDL_QuitSteamControllers();
+
+    if (SDL_joystick_input_thread) {
+        SDL_InputThread_Quit();
+        SDL_joystick_input_thread = SDL_FALSE;
+    }
 }
 
 /*
@@ -86,6 +86,12 @@ struct joystick_hwdata
 
     /* Set when gamepad is pending removal due to ENODEV read error */
     SDL_bool gone;
+
+    /* Set when the device is read by the input thread */
+    SDL_bool threaded;
+
+    /* Set when the kernel timestamps events with CLOCK_MONOTONIC */
+    SDL_bool monotonic_timestamps;
 };
 
 #endif /* SDL_sysjoystick_c_h_ */
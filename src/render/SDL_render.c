@@ -24,9 +24,11 @@
 
 #include "SDL_hints.h"
 #include "SDL_render.h"
+#include "SDL_timer.h"
 #include "SDL_sysrender.h"
 #include "software/SDL_render_sw_c.h"
 #include "../video/SDL_pixels_c.h"
+#include "../thread/SDL_systhread.h"
 
 #if defined(__ANDROID__)
 #  include "../core/android/SDL_android.h"
@@ -227,6 +229,450 @@ DebugLogRenderCommands(const SDL_RenderCommand *cmd)
 #endif
 }
 
+/* Count the commands about to be run for SDL_RenderGetStats() */
+static void
+CountRenderCommands(SDL_Renderer *renderer, const SDL_RenderCommand *cmd, size_t vertsize)
+{
+    SDL_RenderStats *stats = &renderer->stats;
+
+    stats->flushes++;
+    stats->vertex_bytes += vertsize;
+    for ( ; cmd; cmd = cmd->next) {
+        switch (cmd->command) {
+            case SDL_RENDERCMD_SETVIEWPORT:
+                stats->viewport_commands++;
+                break;
+            case SDL_RENDERCMD_SETCLIPRECT:
+                stats->cliprect_commands++;
+                break;
+            case SDL_RENDERCMD_SETDRAWCOLOR:
+                stats->color_commands++;
+                break;
+            case SDL_RENDERCMD_CLEAR:
+                stats->clear_commands++;
+                break;
+            case SDL_RENDERCMD_DRAW_POINTS:
+                stats->point_commands++;
+                stats->vertices += cmd->data.draw.count;
+                break;
+            case SDL_RENDERCMD_DRAW_LINES:
+                stats->line_commands++;
+                stats->vertices += cmd->data.draw.count;
+                break;
+            case SDL_RENDERCMD_FILL_RECTS:
+                stats->rect_commands++;
+                stats->vertices += cmd->data.draw.count * 4;
+                break;
+            case SDL_RENDERCMD_COPY:
+                stats->copy_commands++;
+                stats->vertices += cmd->data.draw.count * 4;
+                break;
+            case SDL_RENDERCMD_COPY_EX:
+                stats->copy_ex_commands++;
+                stats->vertices += 4;
+                break;
+            case SDL_RENDERCMD_GEOMETRY:
+                stats->geometry_commands++;
+                stats->vertices += cmd->data.draw.count;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/* Add what the backend reported for a finished RunCommandQueue call */
+static void
+CountRenderRun(SDL_Renderer *renderer, Uint64 ticks)
+{
+    renderer->stats.draw_calls += renderer->run_draw_calls;
+    renderer->stats.run_time_ns += ticks;
+    renderer->run_draw_calls = 0;
+}
+
+static int
+RunRenderCommands(SDL_Renderer *renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
+{
+    Uint64 start;
+    int retval;
+
+    DebugLogRenderCommands(cmd);
+    CountRenderCommands(renderer, cmd, vertsize);
+
+    start = SDL_GetPerformanceCounter();
+    retval = renderer->RunCommandQueue(renderer, cmd, vertices, vertsize);
+    CountRenderRun(renderer, SDL_GetPerformanceCounter() - start);
+    return retval;
+}
+
+/* How many batches back a draw may move, to bound the cost of sorting */
+#define SORT_DRAWS_MAX_BATCHES  64
+
+/* Draws with the same state that are run together, see SortRenderCommands() */
+typedef struct SDL_RenderDrawBatch
+{
+    SDL_RenderCommand *first;
+    SDL_RenderCommand *last;
+    float x1, y1, x2, y2;
+    size_t size;
+} SDL_RenderDrawBatch;
+
+static SDL_bool
+CanSortRenderCommand(SDL_Renderer *renderer, const SDL_RenderCommand *cmd)
+{
+    if (cmd->command == SDL_RENDERCMD_COPY) {
+        return (renderer->merge_copies && cmd->data.draw.size > 0);
+    }
+    if (cmd->command == SDL_RENDERCMD_GEOMETRY) {
+        return (renderer->merge_geometry && cmd->data.draw.size > 0);
+    }
+    return SDL_FALSE;
+}
+
+static SDL_bool
+SameDrawState(const SDL_RenderCommand *a, const SDL_RenderCommand *b)
+{
+    /* The scale mode belongs to the texture, so it is the same as well */
+    return (a->command == b->command &&
+            a->data.draw.texture == b->data.draw.texture &&
+            a->data.draw.blend == b->data.draw.blend &&
+            a->data.draw.r == b->data.draw.r &&
+            a->data.draw.g == b->data.draw.g &&
+            a->data.draw.b == b->data.draw.b &&
+            a->data.draw.a == b->data.draw.a);
+}
+
+static SDL_bool
+DrawBoundsOverlap(const SDL_RenderDrawBatch *batch, const SDL_RenderCommand *cmd)
+{
+    /* Written so that NaN coordinates count as overlapping */
+    return !(cmd->data.draw.bounds.x2 < batch->x1 || cmd->data.draw.bounds.x1 > batch->x2 ||
+             cmd->data.draw.bounds.y2 < batch->y1 || cmd->data.draw.bounds.y1 > batch->y2);
+}
+
+/* Sort the draws from *link up to end, which are all sortable or SETDRAWCOLOR
+   commands, and return the link after the last of them. */
+static SDL_RenderCommand **
+SortRenderSegment(SDL_Renderer *renderer, SDL_RenderCommand **link, SDL_RenderCommand *end, int count, size_t size)
+{
+    SDL_RenderDrawBatch *batches;
+    SDL_RenderCommand *colors = NULL;
+    SDL_RenderCommand **colors_tail = &colors;
+    SDL_RenderCommand *last = NULL;
+    SDL_RenderCommand *cmd;
+    SDL_RenderCommand *next;
+    SDL_bool isstack;
+    size_t offset;
+    size_t used = 0;
+    int numbatches = 0;
+    int i;
+
+    /* Merged vertices are copied to the end of the buffer, reserve the most
+       they can take up front so that failing leaves the queue as it was. */
+    batches = SDL_small_alloc(SDL_RenderDrawBatch, count, &isstack);
+    if (!batches || !SDL_AllocateRenderVertices(renderer, size, 0, &offset)) {
+        if (batches) {
+            SDL_small_free(batches, isstack);
+        }
+        while (*link != end) {
+            link = &(*link)->next;
+        }
+        return link;
+    }
+
+    for (cmd = *link; cmd != end; cmd = next) {
+        SDL_RenderDrawBatch *batch = NULL;
+
+        next = cmd->next;
+        cmd->next = NULL;
+
+        /* None of the sortable draws depend on the draw color state, so
+           these can all go first as long as their order is kept. */
+        if (cmd->command == SDL_RENDERCMD_SETDRAWCOLOR) {
+            *colors_tail = cmd;
+            colors_tail = &cmd->next;
+            last = cmd;
+            continue;
+        }
+
+        /* Join the latest batch with the same state, unless the draw would
+           move past something it overlaps. */
+        for (i = numbatches - 1; i >= 0 && numbatches - i <= SORT_DRAWS_MAX_BATCHES; --i) {
+            if (SameDrawState(batches[i].first, cmd)) {
+                batch = &batches[i];
+                break;
+            }
+            if (DrawBoundsOverlap(&batches[i], cmd)) {
+                break;
+            }
+        }
+
+        if (batch) {
+            batch->last->next = cmd;
+            batch->last = cmd;
+            batch->x1 = SDL_min(batch->x1, cmd->data.draw.bounds.x1);
+            batch->y1 = SDL_min(batch->y1, cmd->data.draw.bounds.y1);
+            batch->x2 = SDL_max(batch->x2, cmd->data.draw.bounds.x2);
+            batch->y2 = SDL_max(batch->y2, cmd->data.draw.bounds.y2);
+            batch->size += cmd->data.draw.size;
+        } else {
+            batch = &batches[numbatches++];
+            batch->first = cmd;
+            batch->last = cmd;
+            batch->x1 = cmd->data.draw.bounds.x1;
+            batch->y1 = cmd->data.draw.bounds.y1;
+            batch->x2 = cmd->data.draw.bounds.x2;
+            batch->y2 = cmd->data.draw.bounds.y2;
+            batch->size = cmd->data.draw.size;
+        }
+    }
+
+    if (colors) {
+        *link = colors;
+        link = colors_tail;
+    }
+
+    for (i = 0; i < numbatches; ++i) {
+        SDL_RenderDrawBatch *batch = &batches[i];
+        SDL_RenderCommand *first = batch->first;
+
+        if (first != batch->last) {
+            /* Merge the batch into its first command */
+            Uint8 *vertices = (Uint8 *)renderer->vertex_data + offset + used;
+            size_t pos = 0;
+
+            for (cmd = first; cmd; cmd = cmd->next) {
+                SDL_memcpy(vertices + pos, (Uint8 *)renderer->vertex_data + cmd->data.draw.first, cmd->data.draw.size);
+                pos += cmd->data.draw.size;
+                if (cmd != first) {
+                    first->data.draw.count += cmd->data.draw.count;
+                }
+            }
+            first->data.draw.first = offset + used;
+            first->data.draw.size = batch->size;
+            first->data.draw.bounds.x1 = batch->x1;
+            first->data.draw.bounds.y1 = batch->y1;
+            first->data.draw.bounds.x2 = batch->x2;
+            first->data.draw.bounds.y2 = batch->y2;
+            used += batch->size;
+
+            /* Return the merged commands to the pool */
+            batch->last->next = renderer->render_commands_pool;
+            renderer->render_commands_pool = first->next;
+            first->next = NULL;
+        }
+
+        *link = first;
+        link = &first->next;
+        last = first;
+    }
+    SDL_small_free(batches, isstack);
+
+    /* Give back the vertex space that wasn't needed */
+    renderer->vertex_data_used = offset + used;
+
+    *link = end;
+    if (!end) {
+        renderer->render_commands_tail = last;
+    }
+    return link;
+}
+
+/* Reorder queued draws that don't overlap so that draws with the same state
+   run together, and merge those into single commands, see SDL_HINT_RENDER_SORT_DRAWS */
+static void
+SortRenderCommands(SDL_Renderer *renderer)
+{
+    SDL_RenderCommand **link = &renderer->render_commands;
+
+    if (!renderer->sort_draws) {
+        return;
+    }
+
+    while (*link) {
+        SDL_RenderCommand *cmd = *link;
+        size_t size = 0;
+        int count = 0;
+
+        /* Find the next run of sortable draws, everything else is a barrier */
+        while (cmd && (cmd->command == SDL_RENDERCMD_SETDRAWCOLOR || CanSortRenderCommand(renderer, cmd))) {
+            if (cmd->command != SDL_RENDERCMD_SETDRAWCOLOR) {
+                size += cmd->data.draw.size;
+                ++count;
+            }
+            cmd = cmd->next;
+        }
+
+        if (count > 1) {
+            link = SortRenderSegment(renderer, link, cmd, count, size);
+        } else {
+            while (*link != cmd) {
+                link = &(*link)->next;
+            }
+        }
+        if (*link) {
+            link = &(*link)->next;
+        }
+    }
+}
+
+static int SDLCALL
+SDL_RenderThread(void *data)
+{
+    SDL_Renderer *renderer = (SDL_Renderer *)data;
+
+    for ( ; ; ) {
+        Uint64 start;
+
+        SDL_SemWait(renderer->render_thread_work);
+        if (SDL_AtomicGet(&renderer->render_thread_quit)) {
+            break;
+        }
+        start = SDL_GetPerformanceCounter();
+        renderer->RunCommandQueue(renderer, renderer->render_thread_commands,
+                                  renderer->render_thread_vertex_data,
+                                  renderer->render_thread_vertex_data_used);
+        renderer->render_thread_run_time = SDL_GetPerformanceCounter() - start;
+        SDL_SemPost(renderer->render_thread_done);
+    }
+    return 0;
+}
+
+static void
+StartRenderThread(SDL_Renderer *renderer)
+{
+    renderer->render_thread_lock = SDL_CreateMutex();
+    renderer->render_thread_work = SDL_CreateSemaphore(0);
+    renderer->render_thread_done = SDL_CreateSemaphore(0);
+    if (renderer->render_thread_lock && renderer->render_thread_work && renderer->render_thread_done) {
+        renderer->render_thread = SDL_CreateThreadInternal(SDL_RenderThread, "SDLRender", 0, renderer);
+    }
+    if (!renderer->render_thread) {
+        /* Not fatal, everything is rendered on the calling thread instead */
+        if (renderer->render_thread_lock) {
+            SDL_DestroyMutex(renderer->render_thread_lock);
+            renderer->render_thread_lock = NULL;
+        }
+        if (renderer->render_thread_work) {
+            SDL_DestroySemaphore(renderer->render_thread_work);
+            renderer->render_thread_work = NULL;
+        }
+        if (renderer->render_thread_done) {
+            SDL_DestroySemaphore(renderer->render_thread_done);
+            renderer->render_thread_done = NULL;
+        }
+    }
+}
+
+/* Wait for the render thread to finish its frame. This is safe to call from
+   any thread, its commands are taken back by RecycleRenderThreadCommands()
+   on the thread that queues them. */
+static void
+WaitRenderThread(SDL_Renderer *renderer)
+{
+    if (!SDL_AtomicGet(&renderer->render_thread_busy)) {
+        return;
+    }
+
+    SDL_LockMutex(renderer->render_thread_lock);
+    if (SDL_AtomicGet(&renderer->render_thread_busy)) {
+        SDL_SemWait(renderer->render_thread_done);
+        SDL_AtomicSet(&renderer->render_thread_busy, SDL_FALSE);
+    }
+    SDL_UnlockMutex(renderer->render_thread_lock);
+}
+
+/* Put the commands of the finished frame back into the pool */
+static void
+RecycleRenderThreadCommands(SDL_Renderer *renderer)
+{
+    SDL_assert(!SDL_AtomicGet(&renderer->render_thread_busy));
+
+    if (renderer->render_thread_commands == NULL) {
+        return;
+    }
+
+    CountRenderRun(renderer, renderer->render_thread_run_time);
+
+    renderer->render_thread_commands_tail->next = renderer->render_commands_pool;
+    renderer->render_commands_pool = renderer->render_thread_commands;
+    renderer->render_thread_commands = NULL;
+    renderer->render_thread_commands_tail = NULL;
+    renderer->render_thread_vertex_data_used = 0;
+}
+
+static void
+StopRenderThread(SDL_Renderer *renderer)
+{
+    if (!renderer->render_thread) {
+        return;
+    }
+
+    WaitRenderThread(renderer);
+    RecycleRenderThreadCommands(renderer);
+    SDL_AtomicSet(&renderer->render_thread_quit, SDL_TRUE);
+    SDL_SemPost(renderer->render_thread_work);
+    SDL_WaitThread(renderer->render_thread, NULL);
+    renderer->render_thread = NULL;
+
+    SDL_DestroyMutex(renderer->render_thread_lock);
+    renderer->render_thread_lock = NULL;
+    SDL_DestroySemaphore(renderer->render_thread_work);
+    renderer->render_thread_work = NULL;
+    SDL_DestroySemaphore(renderer->render_thread_done);
+    renderer->render_thread_done = NULL;
+    SDL_free(renderer->render_thread_vertex_data);
+    renderer->render_thread_vertex_data = NULL;
+    renderer->render_thread_vertex_data_allocation = 0;
+}
+
+/* Hand the queued commands to the render thread, the previous frame must be done */
+static void
+KickRenderThread(SDL_Renderer *renderer)
+{
+    void *vertex_data;
+    size_t vertex_data_allocation;
+
+    /* Don't take the queue while an event watcher is handling a window event */
+    SDL_LockMutex(renderer->render_thread_lock);
+
+    RecycleRenderThreadCommands(renderer);
+
+    if (renderer->render_commands == NULL) {  /* nothing to do! */
+        SDL_UnlockMutex(renderer->render_thread_lock);
+        return;
+    }
+
+    SortRenderCommands(renderer);
+    DebugLogRenderCommands(renderer->render_commands);
+    CountRenderCommands(renderer, renderer->render_commands, renderer->vertex_data_used);
+
+    renderer->render_thread_commands = renderer->render_commands;
+    renderer->render_thread_commands_tail = renderer->render_commands_tail;
+    renderer->render_thread_generation = renderer->render_command_generation;
+    renderer->render_commands = NULL;
+    renderer->render_commands_tail = NULL;
+
+    /* Swap vertex buffers, the next frame is queued into the spare one */
+    vertex_data = renderer->render_thread_vertex_data;
+    vertex_data_allocation = renderer->render_thread_vertex_data_allocation;
+    renderer->render_thread_vertex_data = renderer->vertex_data;
+    renderer->render_thread_vertex_data_allocation = renderer->vertex_data_allocation;
+    renderer->render_thread_vertex_data_used = renderer->vertex_data_used;
+    renderer->vertex_data = vertex_data;
+    renderer->vertex_data_allocation = vertex_data_allocation;
+    renderer->vertex_data_used = 0;
+
+    renderer->render_command_generation++;
+    renderer->color_queued = SDL_FALSE;
+    renderer->viewport_queued = SDL_FALSE;
+    renderer->cliprect_queued = SDL_FALSE;
+
+    SDL_AtomicSet(&renderer->render_thread_busy, SDL_TRUE);
+    SDL_SemPost(renderer->render_thread_work);
+    SDL_UnlockMutex(renderer->render_thread_lock);
+}
+
 static int
 FlushRenderCommands(SDL_Renderer *renderer)
 {
@@ -234,14 +680,19 @@ FlushRenderCommands(SDL_Renderer *renderer)
 
     SDL_assert((renderer->render_commands == NULL) == (renderer->render_commands_tail == NULL));
 
+    if (renderer->recording) {  /* the queue is being kept for a command list */
+        return 0;
+    }
+
+    WaitRenderThread(renderer);
+
     if (renderer->render_commands == NULL) {  /* nothing to do! */
         SDL_assert(renderer->vertex_data_used == 0);
         return 0;
     }
 
-    DebugLogRenderCommands(renderer->render_commands);
-
-    retval = renderer->RunCommandQueue(renderer, renderer->render_commands, renderer->vertex_data, renderer->vertex_data_used);
+    SortRenderCommands(renderer);
+    retval = RunRenderCommands(renderer, renderer->render_commands, renderer->vertex_data, renderer->vertex_data_used);
 
     /* Move the whole render command queue to the unused pool so we can reuse them next time. */
     if (renderer->render_commands_tail != NULL) {
@@ -263,12 +714,39 @@ FlushRenderCommandsIfTextureNeeded(SDL_Texture *texture)
 {
     SDL_Renderer *renderer = texture->renderer;
     if (texture->last_command_generation == renderer->render_command_generation) {
+        if (renderer->recording) {
+            /* the recorded commands would draw with the new contents, the list can't be used */
+            renderer->recording_invalid = SDL_TRUE;
+            return 0;
+        }
         /* the current command queue depends on this texture, flush the queue now before it changes */
+        renderer->stats.forced_flushes++;
         return FlushRenderCommands(renderer);
     }
+    if (SDL_AtomicGet(&renderer->render_thread_busy) && texture->last_command_generation == renderer->render_thread_generation) {
+        /* only the frame on the render thread uses it, let that finish */
+        renderer->stats.forced_flushes++;
+        WaitRenderThread(renderer);
+    }
     return 0;
 }
 
+static void
+CountTextureUpload(SDL_Renderer *renderer, Uint64 bytes)
+{
+    renderer->stats.texture_uploads++;
+    renderer->stats.texture_upload_bytes += bytes;
+}
+
+#if SDL_HAVE_YUV
+/* Bytes in a 4:2:0 image, planar or NV */
+static Uint64
+YUVSize(const SDL_Rect *rect)
+{
+    return (Uint64)rect->w * rect->h + 2 * (Uint64)((rect->w + 1) / 2) * ((rect->h + 1) / 2);
+}
+#endif
+
 static SDL_INLINE int
 FlushRenderCommandsIfNotBatching(SDL_Renderer *renderer)
 {
@@ -278,6 +756,9 @@ FlushRenderCommandsIfNotBatching(SDL_Renderer *renderer)
 int
 SDL_RenderFlush(SDL_Renderer * renderer)
 {
+    if (renderer->recording) {
+        return SDL_SetError("Can't flush while recording a command list");
+    }
     return FlushRenderCommands(renderer);
 }
 
@@ -487,6 +968,7 @@ PrepQueueCmdDraw(SDL_Renderer *renderer, const SDL_RenderCommandType cmdtype, SD
             cmd->data.draw.a = color->a;
             cmd->data.draw.blend = blendMode;
             cmd->data.draw.texture = texture;
+            cmd->data.draw.size = 0;  /* only set when sorting draws. */
         }
     }
     return cmd;
@@ -520,6 +1002,50 @@ QueueCmdDrawLines(SDL_Renderer *renderer, const SDL_FPoint * points, const int c
     return retval;
 }
 
+/* Remember the vertex bytes and the area of a queued draw, padded by a pixel
+   for the rounding done by the backends, see SortRenderCommands() */
+static void
+SetCmdDrawBounds(SDL_Renderer *renderer, SDL_RenderCommand *cmd, float x1, float y1, float x2, float y2)
+{
+    if (!(x1 == x1 && y1 == y1 && x2 == x2 && y2 == y2)) {
+        return;  /* NaN, this draw can't be moved */
+    }
+    cmd->data.draw.size = renderer->vertex_data_used - cmd->data.draw.first;
+    cmd->data.draw.bounds.x1 = SDL_min(x1, x2) - 1.0f;
+    cmd->data.draw.bounds.y1 = SDL_min(y1, y2) - 1.0f;
+    cmd->data.draw.bounds.x2 = SDL_max(x1, x2) + 1.0f;
+    cmd->data.draw.bounds.y2 = SDL_max(y1, y2) + 1.0f;
+}
+
+static void
+SetCmdGeometryBounds(SDL_Renderer *renderer, SDL_RenderCommand *cmd,
+        const float *xy, int xy_stride, int num_vertices,
+        float scale_x, float scale_y)
+{
+    float x1 = 0.0f, y1 = 0.0f, x2 = 0.0f, y2 = 0.0f;
+    int i;
+
+    for (i = 0; i < num_vertices; ++i) {
+        const float *v = (const float *)((const Uint8 *)xy + i * xy_stride);
+        const float x = v[0] * scale_x;
+        const float y = v[1] * scale_y;
+
+        if (!(x == x && y == y)) {
+            return;  /* NaN, this draw can't be moved */
+        }
+        if (i == 0) {
+            x1 = x2 = x;
+            y1 = y2 = y;
+        } else {
+            x1 = SDL_min(x1, x);
+            y1 = SDL_min(y1, y);
+            x2 = SDL_max(x2, x);
+            y2 = SDL_max(y2, y);
+        }
+    }
+    SetCmdDrawBounds(renderer, cmd, x1, y1, x2, y2);
+}
+
 static int
 QueueCmdFillRects(SDL_Renderer *renderer, const SDL_FRect * rects, const int count)
 {
@@ -579,6 +1105,8 @@ QueueCmdFillRects(SDL_Renderer *renderer, const SDL_FRect * rects, const int cou
 
                 if (retval < 0) {
                     cmd->command = SDL_RENDERCMD_NO_OP;
+                } else if (renderer->sort_draws) {
+                    SetCmdGeometryBounds(renderer, cmd, xy, xy_stride, num_vertices, 1.0f, 1.0f);
                 }
 
                 SDL_small_free(xy, isstack1);
@@ -594,15 +1122,64 @@ QueueCmdFillRects(SDL_Renderer *renderer, const SDL_FRect * rects, const int cou
     return retval;
 }
 
+/* Fold a just queued copy into the previous command if that is a copy of the
+   same texture with the same state, whose vertex data it directly follows. */
+static void
+MergeCmdCopy(SDL_Renderer *renderer, SDL_RenderCommand *prev, SDL_RenderCommand *cmd)
+{
+    const size_t size = renderer->vertex_data_used - cmd->data.draw.first;
+
+    if (!prev || prev->next != cmd || prev->command != SDL_RENDERCMD_COPY) {
+        return;
+    }
+    if (prev->data.draw.texture != cmd->data.draw.texture ||
+        prev->data.draw.blend != cmd->data.draw.blend ||
+        prev->data.draw.r != cmd->data.draw.r ||
+        prev->data.draw.g != cmd->data.draw.g ||
+        prev->data.draw.b != cmd->data.draw.b ||
+        prev->data.draw.a != cmd->data.draw.a) {
+        return;
+    }
+    if (prev->data.draw.first + prev->data.draw.count * size != cmd->data.draw.first) {
+        return;
+    }
+
+    prev->data.draw.count += cmd->data.draw.count;
+    if (prev->data.draw.size && cmd->data.draw.size) {
+        prev->data.draw.size += cmd->data.draw.size;
+        prev->data.draw.bounds.x1 = SDL_min(prev->data.draw.bounds.x1, cmd->data.draw.bounds.x1);
+        prev->data.draw.bounds.y1 = SDL_min(prev->data.draw.bounds.y1, cmd->data.draw.bounds.y1);
+        prev->data.draw.bounds.x2 = SDL_max(prev->data.draw.bounds.x2, cmd->data.draw.bounds.x2);
+        prev->data.draw.bounds.y2 = SDL_max(prev->data.draw.bounds.y2, cmd->data.draw.bounds.y2);
+    } else {
+        prev->data.draw.size = 0;
+    }
+
+    /* Return the merged command to the pool */
+    prev->next = NULL;
+    renderer->render_commands_tail = prev;
+    cmd->next = renderer->render_commands_pool;
+    renderer->render_commands_pool = cmd;
+}
+
 static int
 QueueCmdCopy(SDL_Renderer *renderer, SDL_Texture * texture, const SDL_Rect * srcrect, const SDL_FRect * dstrect)
 {
+    SDL_RenderCommand *prev = renderer->render_commands_tail;
     SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_COPY, texture);
     int retval = -1;
     if (cmd != NULL) {
         retval = renderer->QueueCopy(renderer, cmd, texture, srcrect, dstrect);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
+        } else {
+            if (renderer->sort_draws) {
+                SetCmdDrawBounds(renderer, cmd, dstrect->x, dstrect->y,
+                                 dstrect->x + dstrect->w, dstrect->y + dstrect->h);
+            }
+            if (renderer->merge_copies) {
+                MergeCmdCopy(renderer, prev, cmd);
+            }
         }
     }
     return retval;
@@ -644,6 +1221,8 @@ QueueCmdGeometry(SDL_Renderer *renderer, SDL_Texture *texture,
                 scale_x, scale_y);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
+        } else if (renderer->sort_draws) {
+            SetCmdGeometryBounds(renderer, cmd, xy, xy_stride, num_vertices, scale_x, scale_y);
         }
     }
     return retval;
@@ -694,6 +1273,13 @@ SDL_RendererEventWatch(void *userdata, SDL_Event *event)
     if (event->type == SDL_WINDOWEVENT) {
         SDL_Window *window = SDL_GetWindowFromID(event->window.windowID);
         if (window == renderer->window) {
+            /* Watchers can run on any thread, keep the render thread idle
+               while the backend and the viewport are updated */
+            if (renderer->render_thread_lock) {
+                SDL_LockMutex(renderer->render_thread_lock);
+            }
+            WaitRenderThread(renderer);
+
             if (renderer->WindowEvent) {
                 renderer->WindowEvent(renderer, &event->window);
             }
@@ -760,6 +1346,10 @@ SDL_RendererEventWatch(void *userdata, SDL_Event *event)
                     renderer->hidden = SDL_FALSE;
                 }
             }
+
+            if (renderer->render_thread_lock) {
+                SDL_UnlockMutex(renderer->render_thread_lock);
+            }
         }
     } else if (event->type == SDL_MOUSEMOTION) {
         SDL_Window *window = SDL_GetWindowFromID(event->motion.windowID);
@@ -988,6 +1578,15 @@ SDL_CreateRenderer(SDL_Window * window, int index, Uint32 flags)
     }
 
     renderer->batching = batching;
+    if (renderer->run_on_render_thread && SDL_GetHintBoolean(SDL_HINT_RENDER_THREAD, SDL_FALSE)) {
+        StartRenderThread(renderer);
+        if (renderer->render_thread) {
+            /* Frames can only overlap if they are queued whole */
+            renderer->batching = SDL_TRUE;
+        }
+    }
+    renderer->log_stats = SDL_GetHintBoolean(SDL_HINT_RENDER_STATS_LOG, SDL_FALSE);
+    renderer->sort_draws = SDL_GetHintBoolean(SDL_HINT_RENDER_SORT_DRAWS, SDL_FALSE);
     renderer->magic = &renderer_magic;
     renderer->window = window;
     renderer->target_mutex = SDL_CreateMutex();
@@ -1054,6 +1653,8 @@ SDL_CreateSoftwareRenderer(SDL_Surface * surface)
 
     if (renderer) {
         VerifyDrawQueueFunctions(renderer);
+        renderer->log_stats = SDL_GetHintBoolean(SDL_HINT_RENDER_STATS_LOG, SDL_FALSE);
+        renderer->sort_draws = SDL_GetHintBoolean(SDL_HINT_RENDER_SORT_DRAWS, SDL_FALSE);
         renderer->magic = &renderer_magic;
         renderer->target_mutex = SDL_CreateMutex();
         renderer->scale.x = 1.0f;
@@ -1444,14 +2045,413 @@ SDL_CreateTextureFromSurface(SDL_Renderer * renderer, SDL_Surface * surface)
     return texture;
 }
 
-int
-SDL_QueryTexture(SDL_Texture * texture, Uint32 * format, int *access,
-                 int *w, int *h)
+/* Padding kept between the textures of an atlas, so linear filtering of
+   one doesn't bleed in texels from its neighbors */
+#define ATLAS_PADDING   1
+
+/* A segment of the skyline tracing the top of the area used on a page */
+typedef struct SDL_AtlasSkyline
 {
-    CHECK_TEXTURE_MAGIC(texture, -1);
+    int x, y, w;
+} SDL_AtlasSkyline;
 
-    if (format) {
-        *format = texture->format;
+typedef struct SDL_TextureAtlasPage
+{
+    SDL_Texture *texture;
+    SDL_AtlasSkyline *skyline;
+    int num_segments;
+    int max_segments;
+    struct SDL_TextureAtlasPage *next;
+} SDL_TextureAtlasPage;
+
+struct SDL_TextureAtlas
+{
+    SDL_Renderer *renderer;
+    Uint32 format;
+    int page_w;
+    int page_h;
+    SDL_TextureAtlasPage *pages;
+    SDL_Texture *textures;
+
+    SDL_TextureAtlas *prev;
+    SDL_TextureAtlas *next;
+};
+
+/* Find how high a w x h rectangle would rest if its left edge was placed
+   on skyline segment i, or -1 if it doesn't fit there. */
+static int
+SkylineFit(const SDL_TextureAtlasPage *page, int i, int w, int h, int page_w, int page_h)
+{
+    const SDL_AtlasSkyline *skyline = page->skyline;
+    int width_left = w;
+    int y = 0;
+
+    if (skyline[i].x + w > page_w) {
+        return -1;
+    }
+    while (width_left > 0 && i < page->num_segments) {
+        y = SDL_max(y, skyline[i].y);
+        if (y + h > page_h) {
+            return -1;
+        }
+        width_left -= skyline[i].w;
+        ++i;
+    }
+    return y;
+}
+
+/* Place a rectangle on a page using the bottom-left skyline heuristic */
+static SDL_bool
+SkylinePack(SDL_TextureAtlasPage *page, int w, int h, int page_w, int page_h, SDL_Rect *rect)
+{
+    SDL_AtlasSkyline *skyline;
+    int best = -1, best_y = 0, best_top = page_h + 1, best_w = page_w + 1;
+    int i;
+
+    for (i = 0; i < page->num_segments; ++i) {
+        const int y = SkylineFit(page, i, w, h, page_w, page_h);
+        if (y >= 0) {
+            /* Prefer the lowest placement, then the narrowest segment */
+            if (y + h < best_top || (y + h == best_top && page->skyline[i].w < best_w)) {
+                best = i;
+                best_y = y;
+                best_top = y + h;
+                best_w = page->skyline[i].w;
+            }
+        }
+    }
+    if (best < 0) {
+        return SDL_FALSE;
+    }
+
+    if (page->num_segments == page->max_segments) {
+        const int max_segments = page->max_segments * 2;
+        skyline = (SDL_AtlasSkyline *) SDL_realloc(page->skyline, max_segments * sizeof (*skyline));
+        if (!skyline) {
+            SDL_OutOfMemory();
+            return SDL_FALSE;
+        }
+        page->skyline = skyline;
+        page->max_segments = max_segments;
+    }
+    skyline = page->skyline;
+
+    rect->x = skyline[best].x;
+    rect->y = best_y;
+    rect->w = w;
+    rect->h = h;
+
+    /* Insert the top of the new rectangle into the skyline ... */
+    SDL_memmove(&skyline[best + 1], &skyline[best], (page->num_segments - best) * sizeof (*skyline));
+    ++page->num_segments;
+    skyline[best].x = rect->x;
+    skyline[best].y = rect->y + h;
+    skyline[best].w = w;
+
+    /* ... trim the segments it now covers ... */
+    i = best + 1;
+    while (i < page->num_segments) {
+        const int covered = (skyline[i - 1].x + skyline[i - 1].w) - skyline[i].x;
+        if (covered <= 0) {
+            break;
+        }
+        skyline[i].x += covered;
+        skyline[i].w -= covered;
+        if (skyline[i].w > 0) {
+            break;
+        }
+        SDL_memmove(&skyline[i], &skyline[i + 1], (page->num_segments - i - 1) * sizeof (*skyline));
+        --page->num_segments;
+    }
+
+    /* ... and merge neighbors at the same height */
+    i = 0;
+    while (i < page->num_segments - 1) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].w += skyline[i + 1].w;
+            SDL_memmove(&skyline[i + 1], &skyline[i + 2], (page->num_segments - i - 2) * sizeof (*skyline));
+            --page->num_segments;
+        } else {
+            ++i;
+        }
+    }
+    return SDL_TRUE;
+}
+
+static SDL_TextureAtlasPage *
+AddTextureAtlasPage(SDL_TextureAtlas *atlas)
+{
+    SDL_TextureAtlasPage *page, *last;
+
+    page = (SDL_TextureAtlasPage *) SDL_calloc(1, sizeof (*page));
+    if (!page) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    page->max_segments = 16;
+    page->skyline = (SDL_AtlasSkyline *) SDL_malloc(page->max_segments * sizeof (*page->skyline));
+    if (!page->skyline) {
+        SDL_free(page);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    page->num_segments = 1;
+    page->skyline[0].x = 0;
+    page->skyline[0].y = 0;
+    page->skyline[0].w = atlas->page_w;
+
+    page->texture = SDL_CreateTexture(atlas->renderer, atlas->format, SDL_TEXTUREACCESS_STATIC, atlas->page_w, atlas->page_h);
+    if (!page->texture) {
+        SDL_free(page->skyline);
+        SDL_free(page);
+        return NULL;
+    }
+
+    /* Keep the pages in creation order, so earlier pages fill up first */
+    if (atlas->pages) {
+        for (last = atlas->pages; last->next; last = last->next) {
+            continue;
+        }
+        last->next = page;
+    } else {
+        atlas->pages = page;
+    }
+    return page;
+}
+
+SDL_TextureAtlas *
+SDL_CreateTextureAtlas(SDL_Renderer * renderer, Uint32 format, int page_w, int page_h)
+{
+    SDL_TextureAtlas *atlas;
+
+    CHECK_RENDERER_MAGIC(renderer, NULL);
+
+    if (!format) {
+        Uint32 i;
+
+        format = renderer->info.texture_formats[0];
+        for (i = 0; i < renderer->info.num_texture_formats; ++i) {
+            if (!SDL_ISPIXELFORMAT_FOURCC(renderer->info.texture_formats[i]) &&
+                SDL_ISPIXELFORMAT_ALPHA(renderer->info.texture_formats[i])) {
+                format = renderer->info.texture_formats[i];
+                break;
+            }
+        }
+    }
+    if (SDL_ISPIXELFORMAT_FOURCC(format)) {
+        SDL_SetError("Texture atlases don't support FOURCC formats");
+        return NULL;
+    }
+    if (page_w <= 0 || page_h <= 0) {
+        SDL_SetError("Texture dimensions can't be 0");
+        return NULL;
+    }
+
+    atlas = (SDL_TextureAtlas *) SDL_calloc(1, sizeof (*atlas));
+    if (!atlas) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    atlas->renderer = renderer;
+    atlas->format = format;
+    atlas->page_w = page_w;
+    atlas->page_h = page_h;
+
+    /* Create the first page up front to catch unsupported formats and sizes */
+    if (!AddTextureAtlasPage(atlas)) {
+        SDL_free(atlas);
+        return NULL;
+    }
+
+    atlas->next = renderer->atlases;
+    if (renderer->atlases) {
+        renderer->atlases->prev = atlas;
+    }
+    renderer->atlases = atlas;
+
+    return atlas;
+}
+
+SDL_Texture *
+SDL_CreateAtlasTexture(SDL_TextureAtlas * atlas, int w, int h)
+{
+    SDL_TextureAtlasPage *page;
+    SDL_Texture *texture;
+    SDL_Rect rect;
+    int padded_w, padded_h;
+
+    if (!atlas) {
+        SDL_InvalidParamError("atlas");
+        return NULL;
+    }
+    if (w <= 0 || h <= 0) {
+        SDL_SetError("Texture dimensions can't be 0");
+        return NULL;
+    }
+    if (w > atlas->page_w || h > atlas->page_h) {
+        SDL_SetError("Texture dimensions are limited to %dx%d in this atlas", atlas->page_w, atlas->page_h);
+        return NULL;
+    }
+
+    /* Textures touching the right or bottom edge of a page don't need padding there */
+    padded_w = SDL_min(w + ATLAS_PADDING, atlas->page_w);
+    padded_h = SDL_min(h + ATLAS_PADDING, atlas->page_h);
+    for (page = atlas->pages; page; page = page->next) {
+        if (SkylinePack(page, padded_w, padded_h, atlas->page_w, atlas->page_h, &rect)) {
+            break;
+        }
+    }
+    if (!page) {
+        page = AddTextureAtlasPage(atlas);
+        if (!page) {
+            return NULL;
+        }
+        if (!SkylinePack(page, padded_w, padded_h, atlas->page_w, atlas->page_h, &rect)) {
+            return NULL;
+        }
+    }
+
+    texture = (SDL_Texture *) SDL_calloc(1, sizeof(*texture));
+    if (!texture) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    texture->magic = &texture_magic;
+    texture->format = atlas->format;
+    texture->access = SDL_TEXTUREACCESS_STATIC;
+    texture->w = w;
+    texture->h = h;
+    texture->color.r = 255;
+    texture->color.g = 255;
+    texture->color.b = 255;
+    texture->color.a = 255;
+    texture->scaleMode = page->texture->scaleMode;
+    texture->renderer = atlas->renderer;
+    texture->atlas = atlas;
+    texture->atlas_page = page->texture;
+    texture->atlas_rect.x = rect.x;
+    texture->atlas_rect.y = rect.y;
+    texture->atlas_rect.w = w;
+    texture->atlas_rect.h = h;
+
+    texture->next = atlas->textures;
+    if (atlas->textures) {
+        atlas->textures->prev = texture;
+    }
+    atlas->textures = texture;
+
+    return texture;
+}
+
+SDL_Texture *
+SDL_CreateAtlasTextureFromSurface(SDL_TextureAtlas * atlas, SDL_Surface * surface)
+{
+    SDL_Texture *texture;
+    SDL_Surface *temp;
+
+    if (!atlas) {
+        SDL_InvalidParamError("atlas");
+        return NULL;
+    }
+    if (!surface) {
+        SDL_SetError("SDL_CreateAtlasTextureFromSurface() passed NULL surface");
+        return NULL;
+    }
+
+    temp = SDL_ConvertSurfaceFormat(surface, atlas->format, 0);
+    if (!temp) {
+        return NULL;
+    }
+    texture = SDL_CreateAtlasTexture(atlas, surface->w, surface->h);
+    if (texture) {
+        SDL_UpdateTexture(texture, NULL, temp->pixels, temp->pitch);
+    }
+    SDL_FreeSurface(temp);
+    if (!texture) {
+        return NULL;
+    }
+
+    {
+        Uint8 r, g, b, a;
+        SDL_BlendMode blendMode;
+
+        SDL_GetSurfaceColorMod(surface, &r, &g, &b);
+        SDL_SetTextureColorMod(texture, r, g, b);
+
+        SDL_GetSurfaceAlphaMod(surface, &a);
+        SDL_SetTextureAlphaMod(texture, a);
+
+        if (SDL_HasColorKey(surface)) {
+            /* We converted to a texture with alpha format */
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        } else {
+            SDL_GetSurfaceBlendMode(surface, &blendMode);
+            SDL_SetTextureBlendMode(texture, blendMode);
+        }
+    }
+    return texture;
+}
+
+void
+SDL_DestroyTextureAtlas(SDL_TextureAtlas * atlas)
+{
+    SDL_Renderer *renderer;
+
+    if (!atlas) {
+        return;
+    }
+
+    while (atlas->textures) {
+        SDL_DestroyTexture(atlas->textures);
+    }
+    while (atlas->pages) {
+        SDL_TextureAtlasPage *page = atlas->pages;
+        atlas->pages = page->next;
+        SDL_DestroyTexture(page->texture);
+        SDL_free(page->skyline);
+        SDL_free(page);
+    }
+
+    renderer = atlas->renderer;
+    if (atlas->next) {
+        atlas->next->prev = atlas->prev;
+    }
+    if (atlas->prev) {
+        atlas->prev->next = atlas->next;
+    } else {
+        renderer->atlases = atlas->next;
+    }
+    SDL_free(atlas);
+}
+
+/* Redirect a copy from an atlas texture to the page holding its pixels */
+static SDL_Texture *
+ResolveAtlasTexture(SDL_Texture *texture, SDL_Rect *srcrect)
+{
+    SDL_Texture *page = texture->atlas_page;
+
+    srcrect->x += texture->atlas_rect.x;
+    srcrect->y += texture->atlas_rect.y;
+
+    /* The page stands in for the texture in the command queue, which takes
+       the modulation and blend mode from it */
+    page->color = texture->color;
+    page->blendMode = texture->blendMode;
+    if (page->native) {
+        page->native->color = texture->color;
+        page->native->blendMode = texture->blendMode;
+    }
+    return page;
+}
+
+int
+SDL_QueryTexture(SDL_Texture * texture, Uint32 * format, int *access,
+                 int *w, int *h)
+{
+    CHECK_TEXTURE_MAGIC(texture, -1);
+
+    if (format) {
+        *format = texture->format;
     }
     if (access) {
         *access = texture->access;
@@ -1566,6 +2566,18 @@ SDL_SetTextureScaleMode(SDL_Texture * texture, SDL_ScaleMode scaleMode)
 
     CHECK_TEXTURE_MAGIC(texture, -1);
 
+    if (texture->atlas_page) {
+        /* The scale mode is shared by every texture on the page */
+        SDL_Texture *other;
+
+        for (other = texture->atlas->textures; other; other = other->next) {
+            if (other->atlas_page == texture->atlas_page) {
+                other->scaleMode = scaleMode;
+            }
+        }
+        return SDL_SetTextureScaleMode(texture->atlas_page, scaleMode);
+    }
+
     renderer = texture->renderer;
     renderer->SetTextureScaleMode(renderer, texture, scaleMode);
     texture->scaleMode = scaleMode;
@@ -1719,6 +2731,10 @@ SDL_UpdateTexture(SDL_Texture * texture, const SDL_Rect * rect,
 
     if (real_rect.w == 0 || real_rect.h == 0) {
         return 0;  /* nothing to do. */
+    } else if (texture->atlas_page) {
+        real_rect.x += texture->atlas_rect.x;
+        real_rect.y += texture->atlas_rect.y;
+        return SDL_UpdateTexture(texture->atlas_page, &real_rect, pixels, pitch);
 #if SDL_HAVE_YUV
     } else if (texture->yuv) {
         return SDL_UpdateTextureYUV(texture, &real_rect, pixels, pitch);
@@ -1730,6 +2746,7 @@ SDL_UpdateTexture(SDL_Texture * texture, const SDL_Rect * rect,
         if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
             return -1;
         }
+        CountTextureUpload(renderer, (Uint64)real_rect.w * real_rect.h * SDL_BYTESPERPIXEL(texture->format));
         return renderer->UpdateTexture(renderer, texture, &real_rect, pixels, pitch);
     }
 }
@@ -1898,6 +2915,7 @@ int SDL_UpdateYUVTexture(SDL_Texture * texture, const SDL_Rect * rect,
             if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
                 return -1;
             }
+            CountTextureUpload(renderer, YUVSize(&real_rect));
             return renderer->UpdateTextureYUV(renderer, texture, &real_rect, Yplane, Ypitch, Uplane, Upitch, Vplane, Vpitch);
         } else {
             return SDL_Unsupported();
@@ -1958,6 +2976,7 @@ int SDL_UpdateNVTexture(SDL_Texture * texture, const SDL_Rect * rect,
             if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
                 return -1;
             }
+            CountTextureUpload(renderer, YUVSize(&real_rect));
             return renderer->UpdateTextureNV(renderer, texture, &real_rect, Yplane, Ypitch, UVplane, UVpitch);
         } else {
             return SDL_Unsupported();
@@ -2027,6 +3046,7 @@ SDL_LockTexture(SDL_Texture * texture, const SDL_Rect * rect,
         if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
             return -1;
         }
+        CountTextureUpload(renderer, (Uint64)rect->w * rect->h * SDL_BYTESPERPIXEL(texture->format));
         return renderer->LockTexture(renderer, texture, rect, pixels, pitch);
     }
 }
@@ -2166,11 +3186,17 @@ SDL_SetRenderTarget(SDL_Renderer *renderer, SDL_Texture *texture)
         }
     }
 
+    if (renderer->recording) {
+        return SDL_SetError("Can't change the render target while recording a command list");
+    }
+
     if (texture == renderer->target) {
         /* Nothing to do! */
         return 0;
     }
 
+    renderer->stats.target_switches++;
+
     FlushRenderCommands(renderer);  /* time to send everything to the GPU! */
 
     SDL_LockMutex(renderer->target_mutex);
@@ -3327,6 +4353,9 @@ SDL_RenderCopyF(SDL_Renderer * renderer, SDL_Texture * texture,
         real_dstrect = *dstrect;
     }
 
+    if (texture->atlas_page) {
+        texture = ResolveAtlasTexture(texture, &real_srcrect);
+    }
     if (texture->native) {
         texture = texture->native;
     }
@@ -3468,6 +4497,9 @@ SDL_RenderCopyExF(SDL_Renderer * renderer, SDL_Texture * texture,
         RenderGetViewportSize(renderer, &real_dstrect);
     }
 
+    if (texture->atlas_page) {
+        texture = ResolveAtlasTexture(texture, &real_srcrect);
+    }
     if (texture->native) {
         texture = texture->native;
     }
@@ -3953,6 +4985,8 @@ SDL_RenderGeometryRaw(SDL_Renderer *renderer,
     int i;
     int retval = 0;
     int count = indices ? num_indices : num_vertices;
+    float *page_uv = NULL;
+    SDL_bool page_uv_isstack = SDL_FALSE;
 
     CHECK_RENDERER_MAGIC(renderer, -1);
 
@@ -4003,10 +5037,6 @@ SDL_RenderGeometryRaw(SDL_Renderer *renderer,
         return 0;
     }
 
-    if (texture && texture->native) {
-        texture = texture->native;
-    }
-
     if (texture) {
         for (i = 0; i < num_vertices; ++i) {
             const float *uv_ = (const float *)((const char*)uv + i * uv_stride);
@@ -4018,6 +5048,32 @@ SDL_RenderGeometryRaw(SDL_Renderer *renderer,
         }
     }
 
+    if (texture && texture->atlas_page) {
+        /* Map the texture coordinates onto the page holding the texture */
+        SDL_Rect srcrect = { 0, 0, 0, 0 };
+        SDL_Texture *page = ResolveAtlasTexture(texture, &srcrect);
+        const float scale_u = (float) texture->w / page->w;
+        const float scale_v = (float) texture->h / page->h;
+        const float offset_u = (float) srcrect.x / page->w;
+        const float offset_v = (float) srcrect.y / page->h;
+
+        page_uv = SDL_small_alloc(float, num_vertices * 2, &page_uv_isstack);
+        if (!page_uv) {
+            return SDL_OutOfMemory();
+        }
+        for (i = 0; i < num_vertices; ++i) {
+            const float *uv_ = (const float *)((const char*)uv + i * uv_stride);
+            page_uv[i * 2 + 0] = offset_u + uv_[0] * scale_u;
+            page_uv[i * 2 + 1] = offset_v + uv_[1] * scale_v;
+        }
+        uv = page_uv;
+        uv_stride = 2 * sizeof (float);
+        texture = page;
+    }
+    if (texture && texture->native) {
+        texture = texture->native;
+    }
+
     if (indices) {
         for (i = 0; i < num_indices; ++i) {
             int j;
@@ -4040,21 +5096,41 @@ SDL_RenderGeometryRaw(SDL_Renderer *renderer,
 
     /* For the software renderer, try to reinterpret triangles as SDL_Rect */
     if (renderer->info.flags & SDL_RENDERER_SOFTWARE) {
-        return SDL_SW_RenderGeometryRaw(renderer, texture,
+        retval = SDL_SW_RenderGeometryRaw(renderer, texture,
                 xy, xy_stride, color, color_stride, uv, uv_stride, num_vertices,
                 indices, num_indices, size_indices);
+    } else {
+        retval = QueueCmdGeometry(renderer, texture,
+                xy, xy_stride, color, color_stride, uv, uv_stride,
+                num_vertices,
+                indices, num_indices, size_indices,
+                renderer->scale.x, renderer->scale.y);
+        if (retval == 0) {
+            retval = FlushRenderCommandsIfNotBatching(renderer);
+        }
     }
 
-    retval = QueueCmdGeometry(renderer, texture,
-            xy, xy_stride, color, color_stride, uv, uv_stride,
-            num_vertices,
-            indices, num_indices, size_indices,
-            renderer->scale.x, renderer->scale.y);
-
-    return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
+    if (page_uv) {
+        SDL_small_free(page_uv, page_uv_isstack);
+    }
+    return retval;
 }
 
 
+/* The part of rect inside the viewport, returns SDL_FALSE if there is none */
+static SDL_bool
+GetReadPixelsRect(SDL_Renderer * renderer, const SDL_Rect * rect, SDL_Rect * real_rect)
+{
+    real_rect->x = (int)SDL_floor(renderer->viewport.x);
+    real_rect->y = (int)SDL_floor(renderer->viewport.y);
+    real_rect->w = (int)SDL_floor(renderer->viewport.w);
+    real_rect->h = (int)SDL_floor(renderer->viewport.h);
+    if (rect) {
+        return SDL_IntersectRect(rect, real_rect, real_rect);
+    }
+    return SDL_TRUE;
+}
+
 int
 SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                      Uint32 format, void * pixels, int pitch)
@@ -4066,6 +5142,9 @@ SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
     if (!renderer->RenderReadPixels) {
         return SDL_Unsupported();
     }
+    if (renderer->recording) {
+        return SDL_SetError("Can't read pixels while recording a command list");
+    }
 
     FlushRenderCommands(renderer);  /* we need to render before we read the results. */
 
@@ -4073,14 +5152,10 @@ SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
         format = SDL_GetWindowPixelFormat(renderer->window);
     }
 
-    real_rect.x = (int)SDL_floor(renderer->viewport.x);
-    real_rect.y = (int)SDL_floor(renderer->viewport.y);
-    real_rect.w = (int)SDL_floor(renderer->viewport.w);
-    real_rect.h = (int)SDL_floor(renderer->viewport.h);
+    if (!GetReadPixelsRect(renderer, rect, &real_rect)) {
+        return 0;
+    }
     if (rect) {
-        if (!SDL_IntersectRect(rect, &real_rect, &real_rect)) {
-            return 0;
-        }
         if (real_rect.y > rect->y) {
             pixels = (Uint8 *)pixels + pitch * (real_rect.y - rect->y);
         }
@@ -4094,12 +5169,213 @@ SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                                       format, pixels, pitch);
 }
 
+SDL_RenderReadback *
+SDL_RenderReadPixelsAsync(SDL_Renderer * renderer, const SDL_Rect * rect, Uint32 format)
+{
+    SDL_RenderReadback *readback;
+
+    CHECK_RENDERER_MAGIC(renderer, NULL);
+
+    if (!renderer->RenderReadPixels) {
+        SDL_Unsupported();
+        return NULL;
+    }
+    if (renderer->recording) {
+        SDL_SetError("Can't read pixels while recording a command list");
+        return NULL;
+    }
+
+    FlushRenderCommands(renderer);  /* we need to render before we read the results. */
+
+    if (!format) {
+        format = SDL_GetWindowPixelFormat(renderer->window);
+    }
+
+    readback = (SDL_RenderReadback *)SDL_calloc(1, sizeof(*readback));
+    if (!readback) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    readback->renderer = renderer;
+    readback->format = format;
+    if (GetReadPixelsRect(renderer, rect, &readback->rect)) {
+        if (rect) {
+            readback->x = readback->rect.x - rect->x;
+            readback->y = readback->rect.y - rect->y;
+        }
+    } else {
+        SDL_zero(readback->rect);  /* there is nothing to read */
+    }
+
+    if (readback->rect.w > 0 && readback->rect.h > 0) {
+        int retval;
+
+        if (renderer->RenderReadPixelsAsync) {
+            retval = renderer->RenderReadPixelsAsync(renderer, readback);
+        } else {
+            /* Read them now, they're ready whenever they're asked for */
+            readback->pitch = readback->rect.w * SDL_BYTESPERPIXEL(format);
+            readback->pixels = SDL_malloc(readback->rect.h * readback->pitch);
+            if (!readback->pixels) {
+                retval = SDL_OutOfMemory();
+            } else {
+                retval = renderer->RenderReadPixels(renderer, &readback->rect, format, readback->pixels, readback->pitch);
+            }
+        }
+        if (retval < 0) {
+            SDL_free(readback->pixels);
+            SDL_free(readback);
+            return NULL;
+        }
+    }
+
+    readback->next = renderer->readbacks;
+    if (readback->next) {
+        readback->next->prev = readback;
+    }
+    renderer->readbacks = readback;
+
+    return readback;
+}
+
+int
+SDL_RenderGetReadbackPixels(SDL_RenderReadback * readback, void * pixels, int pitch)
+{
+    SDL_Renderer *renderer;
+
+    if (!readback) {
+        return SDL_InvalidParamError("readback");
+    }
+    if (!pixels) {
+        return SDL_InvalidParamError("pixels");
+    }
+
+    renderer = readback->renderer;
+    if (readback->rect.w <= 0 || readback->rect.h <= 0) {
+        return 0;
+    }
+
+    pixels = (Uint8 *)pixels + readback->y * pitch + readback->x * SDL_BYTESPERPIXEL(readback->format);
+    if (readback->pixels) {
+        return SDL_ConvertPixels(readback->rect.w, readback->rect.h,
+                                 readback->format, readback->pixels, readback->pitch,
+                                 readback->format, pixels, pitch);
+    }
+    return renderer->GetReadbackPixels(renderer, readback, pixels, pitch);
+}
+
+void
+SDL_DestroyRenderReadback(SDL_RenderReadback * readback)
+{
+    SDL_Renderer *renderer;
+
+    if (!readback) {
+        return;
+    }
+
+    renderer = readback->renderer;
+    if (readback->driverdata && renderer->DestroyReadback) {
+        renderer->DestroyReadback(renderer, readback);
+    }
+    SDL_free(readback->pixels);
+
+    if (readback->next) {
+        readback->next->prev = readback->prev;
+    }
+    if (readback->prev) {
+        readback->prev->next = readback->next;
+    } else {
+        renderer->readbacks = readback->next;
+    }
+    SDL_free(readback);
+}
+
+static void
+AddRenderStats(SDL_RenderStats *dst, const SDL_RenderStats *src)
+{
+    dst->frames += src->frames;
+    dst->flushes += src->flushes;
+    dst->forced_flushes += src->forced_flushes;
+    dst->target_switches += src->target_switches;
+    dst->viewport_commands += src->viewport_commands;
+    dst->cliprect_commands += src->cliprect_commands;
+    dst->color_commands += src->color_commands;
+    dst->clear_commands += src->clear_commands;
+    dst->point_commands += src->point_commands;
+    dst->line_commands += src->line_commands;
+    dst->rect_commands += src->rect_commands;
+    dst->copy_commands += src->copy_commands;
+    dst->copy_ex_commands += src->copy_ex_commands;
+    dst->geometry_commands += src->geometry_commands;
+    dst->draw_calls += src->draw_calls;
+    dst->texture_uploads += src->texture_uploads;
+    dst->vertices += src->vertices;
+    dst->vertex_bytes += src->vertex_bytes;
+    dst->texture_upload_bytes += src->texture_upload_bytes;
+    dst->run_time_ns += src->run_time_ns;
+}
+
+/* The stats keep performance counter ticks until they're reported */
+static Uint64
+TicksToNS(Uint64 ticks)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    return (ticks / freq) * 1000000000 + ((ticks % freq) * 1000000000) / freq;
+}
+
+static void
+FinishFrameStats(SDL_Renderer *renderer)
+{
+    SDL_RenderStats *stats = &renderer->stats;
+
+    stats->frames = 1;
+    if (renderer->log_stats) {
+        SDL_LogDebug(SDL_LOG_CATEGORY_RENDER,
+                     "Frame %u: %u flushes (%u forced), %u target switches, %u commands, %u draw calls, "
+                     "%" SDL_PRIu64 " vertices (%" SDL_PRIu64 " bytes), %u texture uploads (%" SDL_PRIu64 " bytes), %.3f ms",
+                     renderer->total_stats.frames + 1,
+                     stats->flushes, stats->forced_flushes, stats->target_switches,
+                     stats->viewport_commands + stats->cliprect_commands + stats->color_commands +
+                     stats->clear_commands + stats->point_commands + stats->line_commands +
+                     stats->rect_commands + stats->copy_commands + stats->copy_ex_commands +
+                     stats->geometry_commands,
+                     stats->draw_calls, stats->vertices, stats->vertex_bytes,
+                     stats->texture_uploads, stats->texture_upload_bytes,
+                     TicksToNS(stats->run_time_ns) / 1000000.0);
+    }
+    AddRenderStats(&renderer->total_stats, stats);
+    renderer->last_frame_stats = *stats;
+    SDL_zerop(stats);
+}
+
 void
 SDL_RenderPresent(SDL_Renderer * renderer)
 {
     CHECK_RENDERER_MAGIC(renderer, );
 
+    if (renderer->recording) {
+        /* Nothing was drawn, the commands are kept for the command list */
+        SDL_SetError("Can't present while recording a command list");
+        return;
+    }
+
+    if (renderer->render_thread) {
+        /* Show the frame the render thread finished and give it this one */
+        WaitRenderThread(renderer);
+#if DONT_DRAW_WHILE_HIDDEN
+        if (!renderer->hidden) {
+            renderer->RenderPresent(renderer);
+        }
+#else
+        renderer->RenderPresent(renderer);
+#endif
+        KickRenderThread(renderer);
+        FinishFrameStats(renderer);
+        return;
+    }
+
     FlushRenderCommands(renderer);  /* time to send everything to the GPU! */
+    FinishFrameStats(renderer);
 
 #if DONT_DRAW_WHILE_HIDDEN
     /* Don't present while we're hidden */
@@ -4111,6 +5387,225 @@ SDL_RenderPresent(SDL_Renderer * renderer)
     renderer->RenderPresent(renderer);
 }
 
+struct SDL_RenderCommandList
+{
+    SDL_Renderer *renderer;
+    SDL_RenderCommand *commands;
+    void *vertex_data;
+    size_t vertex_data_used;
+    SDL_bool invalid;           /* a texture it draws with was destroyed or changed while recording */
+
+    SDL_RenderCommandList *prev;
+    SDL_RenderCommandList *next;
+};
+
+int
+SDL_RenderBeginCommandList(SDL_Renderer * renderer)
+{
+    int retval;
+
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (renderer->no_command_lists) {
+        return SDL_Unsupported();
+    }
+    if (renderer->recording) {
+        return SDL_SetError("The renderer is already recording a command list");
+    }
+
+    /* The list starts from an empty queue, with all the state queued again */
+    retval = FlushRenderCommands(renderer);
+    renderer->color_queued = SDL_FALSE;
+    renderer->viewport_queued = SDL_FALSE;
+    renderer->cliprect_queued = SDL_FALSE;
+    renderer->recording = SDL_TRUE;
+    return retval;
+}
+
+SDL_RenderCommandList *
+SDL_RenderEndCommandList(SDL_Renderer * renderer)
+{
+    SDL_RenderCommandList *list;
+
+    CHECK_RENDERER_MAGIC(renderer, NULL);
+
+    if (!renderer->recording) {
+        SDL_SetError("The renderer isn't recording a command list");
+        return NULL;
+    }
+
+    list = (SDL_RenderCommandList *)SDL_calloc(1, sizeof(*list));
+    if (!list) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    SortRenderCommands(renderer);
+    if (renderer->vertex_data_used > 0) {
+        list->vertex_data = SDL_malloc(renderer->vertex_data_used);
+        if (!list->vertex_data) {
+            SDL_free(list);
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        SDL_memcpy(list->vertex_data, renderer->vertex_data, renderer->vertex_data_used);
+        list->vertex_data_used = renderer->vertex_data_used;
+    }
+    list->renderer = renderer;
+    list->commands = renderer->render_commands;
+    list->invalid = renderer->recording_invalid;
+
+    /* The commands now belong to the list, start over as if they were flushed */
+    renderer->recording = SDL_FALSE;
+    renderer->recording_invalid = SDL_FALSE;
+    renderer->render_commands = NULL;
+    renderer->render_commands_tail = NULL;
+    renderer->vertex_data_used = 0;
+    renderer->render_command_generation++;
+    renderer->color_queued = SDL_FALSE;
+    renderer->viewport_queued = SDL_FALSE;
+    renderer->cliprect_queued = SDL_FALSE;
+
+    list->next = renderer->command_lists;
+    if (list->next) {
+        list->next->prev = list;
+    }
+    renderer->command_lists = list;
+
+    return list;
+}
+
+/* Clip rectangles are relative to the viewport in every backend, so they move with it */
+static void
+OffsetCommandListViewports(SDL_RenderCommandList *list, int x, int y)
+{
+    SDL_RenderCommand *cmd;
+
+    for (cmd = list->commands; cmd; cmd = cmd->next) {
+        if (cmd->command == SDL_RENDERCMD_SETVIEWPORT) {
+            cmd->data.viewport.rect.x += x;
+            cmd->data.viewport.rect.y += y;
+        }
+    }
+}
+
+int
+SDL_RenderReplayCommandList(SDL_Renderer * renderer, SDL_RenderCommandList * list, const SDL_Point * offset)
+{
+    void *vertices;
+    int retval;
+
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (!list) {
+        return SDL_InvalidParamError("list");
+    }
+    if (list->renderer != renderer) {
+        return SDL_SetError("Command list was not recorded with this renderer");
+    }
+    if (list->invalid) {
+        return SDL_SetError("Command list uses a texture that was destroyed or changed while recording");
+    }
+    if (renderer->recording) {
+        return SDL_SetError("Can't replay a command list while recording one");
+    }
+
+    retval = FlushRenderCommands(renderer);
+    if (retval < 0 || !list->commands) {
+        return retval;
+    }
+
+    vertices = list->vertex_data;
+    if (renderer->run_modifies_vertices && list->vertex_data_used > 0) {
+        /* The renderer's vertex buffer is empty after the flush, borrow it */
+        if (renderer->vertex_data_allocation < list->vertex_data_used) {
+            void *ptr = SDL_realloc(renderer->vertex_data, list->vertex_data_used);
+            if (!ptr) {
+                return SDL_OutOfMemory();
+            }
+            renderer->vertex_data = ptr;
+            renderer->vertex_data_allocation = list->vertex_data_used;
+        }
+        SDL_memcpy(renderer->vertex_data, list->vertex_data, list->vertex_data_used);
+        vertices = renderer->vertex_data;
+    }
+
+    if (offset) {
+        OffsetCommandListViewports(list, offset->x, offset->y);
+    }
+
+    retval = RunRenderCommands(renderer, list->commands, vertices, list->vertex_data_used);
+
+    if (offset) {
+        OffsetCommandListViewports(list, -offset->x, -offset->y);
+    }
+    return retval;
+}
+
+void
+SDL_DestroyRenderCommandList(SDL_RenderCommandList * list)
+{
+    SDL_Renderer *renderer;
+    SDL_RenderCommand *cmd;
+
+    if (!list) {
+        return;
+    }
+
+    renderer = list->renderer;
+
+    /* Hand the commands back to the renderer's pool for reuse */
+    cmd = list->commands;
+    while (cmd) {
+        SDL_RenderCommand *next = cmd->next;
+        cmd->next = renderer->render_commands_pool;
+        renderer->render_commands_pool = cmd;
+        cmd = next;
+    }
+    SDL_free(list->vertex_data);
+
+    if (list->next) {
+        list->next->prev = list->prev;
+    }
+    if (list->prev) {
+        list->prev->next = list->next;
+    } else {
+        renderer->command_lists = list->next;
+    }
+    SDL_free(list);
+}
+
+/* Command lists can't be replayed once a texture they draw with is gone */
+static void
+InvalidateCommandLists(SDL_Renderer *renderer, SDL_Texture *texture)
+{
+    SDL_RenderCommandList *list;
+
+    if (renderer->recording && texture->last_command_generation == renderer->render_command_generation) {
+        renderer->recording_invalid = SDL_TRUE;
+    }
+
+    for (list = renderer->command_lists; list; list = list->next) {
+        SDL_RenderCommand *cmd;
+
+        for (cmd = list->commands; cmd && !list->invalid; cmd = cmd->next) {
+            switch (cmd->command) {
+            case SDL_RENDERCMD_DRAW_POINTS:
+            case SDL_RENDERCMD_DRAW_LINES:
+            case SDL_RENDERCMD_FILL_RECTS:
+            case SDL_RENDERCMD_COPY:
+            case SDL_RENDERCMD_COPY_EX:
+            case SDL_RENDERCMD_GEOMETRY:
+                if (cmd->data.draw.texture == texture) {
+                    list->invalid = SDL_TRUE;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
 void
 SDL_DestroyTexture(SDL_Texture * texture)
 {
@@ -4118,13 +5613,37 @@ SDL_DestroyTexture(SDL_Texture * texture)
 
     CHECK_TEXTURE_MAGIC(texture, );
 
+    if (texture->atlas_page) {
+        /* The pixels belong to the atlas page, just drop the handle */
+        SDL_TextureAtlas *atlas = texture->atlas;
+
+        texture->magic = NULL;
+        if (texture->next) {
+            texture->next->prev = texture->prev;
+        }
+        if (texture->prev) {
+            texture->prev->next = texture->next;
+        } else {
+            atlas->textures = texture->next;
+        }
+        SDL_free(texture);
+        return;
+    }
+
     renderer = texture->renderer;
     if (texture == renderer->target) {
+        if (renderer->recording) {
+            /* The recorded commands draw to this target, run them while it still exists */
+            renderer->recording = SDL_FALSE;
+            renderer->recording_invalid = SDL_FALSE;
+        }
         SDL_SetRenderTarget(renderer, NULL);  /* implies command queue flush */
     } else {
         FlushRenderCommandsIfTextureNeeded(texture);
     }
 
+    InvalidateCommandLists(renderer, texture);
+
     texture->magic = NULL;
 
     if (texture->next) {
@@ -4163,6 +5682,15 @@ SDL_DestroyRenderer(SDL_Renderer * renderer)
 
     SDL_DelEventWatch(SDL_RendererEventWatch, renderer);
 
+    StopRenderThread(renderer);
+
+    while (renderer->command_lists) {
+        SDL_DestroyRenderCommandList(renderer->command_lists);
+    }
+    while (renderer->readbacks) {
+        SDL_DestroyRenderReadback(renderer->readbacks);
+    }
+
     if (renderer->render_commands_tail != NULL) {
         renderer->render_commands_tail->next = renderer->render_commands_pool;
         cmd = renderer->render_commands;
@@ -4182,7 +5710,10 @@ SDL_DestroyRenderer(SDL_Renderer * renderer)
 
     SDL_free(renderer->vertex_data);
 
-    /* Free existing textures for this renderer */
+    /* Free existing atlases and textures for this renderer */
+    while (renderer->atlases) {
+        SDL_DestroyTextureAtlas(renderer->atlases);
+    }
     while (renderer->textures) {
         SDL_Texture *tex = renderer->textures; (void) tex;
         SDL_DestroyTexture(renderer->textures);
@@ -4210,7 +5741,9 @@ int SDL_GL_BindTexture(SDL_Texture *texture, float *texw, float *texh)
 
     CHECK_TEXTURE_MAGIC(texture, -1);
     renderer = texture->renderer;
-    if (texture->native) {
+    if (texture->atlas_page) {
+        return SDL_SetError("Textures in an atlas can't be bound directly");
+    } else if (texture->native) {
         return SDL_GL_BindTexture(texture->native, texw, texh);
     } else if (renderer && renderer->GL_BindTexture) {
         FlushRenderCommandsIfTextureNeeded(texture);  /* in case the app is going to mess with it. */
@@ -4226,7 +5759,9 @@ int SDL_GL_UnbindTexture(SDL_Texture *texture)
 
     CHECK_TEXTURE_MAGIC(texture, -1);
     renderer = texture->renderer;
-    if (texture->native) {
+    if (texture->atlas_page) {
+        return SDL_SetError("Textures in an atlas can't be bound directly");
+    } else if (texture->native) {
         return SDL_GL_UnbindTexture(texture->native);
     } else if (renderer && renderer->GL_UnbindTexture) {
         FlushRenderCommandsIfTextureNeeded(texture);  /* in case the app messed with it. */
@@ -4370,4 +5905,31 @@ SDL_RenderSetVSync(SDL_Renderer * renderer, int vsync)
     return SDL_Unsupported();
 }
 
+int
+SDL_RenderGetStats(SDL_Renderer * renderer, SDL_RenderStats * total, SDL_RenderStats * frame)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (total) {
+        *total = renderer->total_stats;
+        AddRenderStats(total, &renderer->stats);
+        total->run_time_ns = TicksToNS(total->run_time_ns);
+    }
+    if (frame) {
+        *frame = renderer->last_frame_stats;
+        frame->run_time_ns = TicksToNS(frame->run_time_ns);
+    }
+    return 0;
+}
+
+void
+SDL_RenderResetStats(SDL_Renderer * renderer)
+{
+    CHECK_RENDERER_MAGIC(renderer, );
+
+    SDL_zero(renderer->stats);
+    SDL_zero(renderer->last_frame_stats);
+    SDL_zero(renderer->total_stats);
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
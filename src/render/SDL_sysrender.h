@@ -26,6 +26,7 @@
 #include "SDL_render.h"
 #include "SDL_events.h"
 #include "SDL_mutex.h"
+#include "SDL_thread.h"
 #include "SDL_yuv_sw_c.h"
 
 /* The SDL 2D rendering system */
@@ -57,6 +58,11 @@ struct SDL_Texture
 
     Uint32 last_command_generation; /* last command queue generation this texture was in. */
 
+    /* Support for textures packed into an SDL_TextureAtlas */
+    SDL_TextureAtlas *atlas;
+    SDL_Texture *atlas_page;    /**< The shared texture holding the pixels */
+    SDL_Rect atlas_rect;        /**< The area of atlas_page used by this texture */
+
     void *driverdata;           /**< Driver specific texture representation */
     void *userdata;
 
@@ -64,6 +70,22 @@ struct SDL_Texture
     SDL_Texture *next;
 };
 
+/* Define the SDL render readback structure, see SDL_RenderReadPixelsAsync() */
+struct SDL_RenderReadback
+{
+    SDL_Renderer *renderer;
+    SDL_Rect rect;              /**< The area read, clipped to the viewport */
+    int x, y;                   /**< Where rect starts in the area asked for */
+    Uint32 format;              /**< The pixel format asked for */
+    void *pixels;               /**< The pixels, if the backend read them right away */
+    int pitch;
+
+    void *driverdata;           /**< Driver specific readback representation */
+
+    SDL_RenderReadback *prev;
+    SDL_RenderReadback *next;
+};
+
 typedef enum
 {
     SDL_RENDERCMD_NO_OP,
@@ -97,6 +119,10 @@ typedef struct SDL_RenderCommand
             Uint8 r, g, b, a;
             SDL_BlendMode blend;
             SDL_Texture *texture;
+            size_t size;        /* vertex bytes, only kept when sorting draws */
+            struct {
+                float x1, y1, x2, y2;
+            } bounds;           /* area drawn to, only kept when sorting draws */
         } draw;
         struct {
             size_t first;
@@ -156,6 +182,12 @@ struct SDL_Renderer
     int (*SetRenderTarget) (SDL_Renderer * renderer, SDL_Texture * texture);
     int (*RenderReadPixels) (SDL_Renderer * renderer, const SDL_Rect * rect,
                              Uint32 format, void * pixels, int pitch);
+    /* Starts reading readback->rect, returns before the pixels are read.
+       GetReadbackPixels returns 1 while they aren't ready. */
+    int (*RenderReadPixelsAsync) (SDL_Renderer * renderer, SDL_RenderReadback * readback);
+    int (*GetReadbackPixels) (SDL_Renderer * renderer, SDL_RenderReadback * readback,
+                              void * pixels, int pitch);
+    void (*DestroyReadback) (SDL_Renderer * renderer, SDL_RenderReadback * readback);
     void (*RenderPresent) (SDL_Renderer * renderer);
     void (*DestroyTexture) (SDL_Renderer * renderer, SDL_Texture * texture);
 
@@ -213,6 +245,9 @@ struct SDL_Renderer
 
     /* The list of textures */
     SDL_Texture *textures;
+    SDL_TextureAtlas *atlases;
+    SDL_RenderCommandList *command_lists;
+    SDL_RenderReadback *readbacks;
     SDL_Texture *target;
     SDL_mutex *target_mutex;
 
@@ -221,6 +256,28 @@ struct SDL_Renderer
 
     SDL_bool always_batch;
     SDL_bool batching;
+
+    /* Set by backends whose SDL_RENDERCMD_COPY handler draws every one of
+       cmd->data.draw.count copies, so consecutive copies of a texture with
+       the same state can be merged into a single command. */
+    SDL_bool merge_copies;
+    /* Set by backends whose SDL_RENDERCMD_GEOMETRY handler draws a plain
+       triangle list of cmd->data.draw.count vertices stored from
+       cmd->data.draw.first, so geometry with the same state can be merged.
+       Copies and geometry that can be merged must not depend on the
+       SDL_RENDERCMD_SETDRAWCOLOR state, see SDL_HINT_RENDER_SORT_DRAWS. */
+    SDL_bool merge_geometry;
+    /* Set by backends whose RunCommandQueue changes the vertex data, so
+       command lists are replayed from a scratch copy of their vertices. */
+    SDL_bool run_modifies_vertices;
+    /* Set by backends that can't run the same commands more than once. */
+    SDL_bool no_command_lists;
+    /* Set by backends whose RunCommandQueue may be called from a thread
+       other than the one using the renderer, see SDL_HINT_RENDER_THREAD. */
+    SDL_bool run_on_render_thread;
+    SDL_bool sort_draws;                /**< Reorder draws by state, see SDL_HINT_RENDER_SORT_DRAWS */
+    SDL_bool recording;                 /**< Commands are kept for a command list */
+    SDL_bool recording_invalid;         /**< A texture used while recording was destroyed or changed */
     SDL_RenderCommand *render_commands;
     SDL_RenderCommand *render_commands_tail;
     SDL_RenderCommand *render_commands_pool;
@@ -237,6 +294,33 @@ struct SDL_Renderer
     size_t vertex_data_used;
     size_t vertex_data_allocation;
 
+    /* Counters for SDL_RenderGetStats(). The run_time_ns fields hold
+       performance counter ticks, they are converted when reported. */
+    SDL_RenderStats stats;              /**< The frame being drawn */
+    SDL_RenderStats last_frame_stats;
+    SDL_RenderStats total_stats;        /**< Everything before the frame being drawn */
+    SDL_bool log_stats;
+    /* Draw calls issued by the running RunCommandQueue, counted by the backends */
+    Uint32 run_draw_calls;
+
+    /* The render thread runs one frame while the next one is queued. It
+       owns the commands and vertex data below while it's busy. Event
+       watchers may wait for it from any thread, so handing it a frame and
+       waiting for it are done under render_thread_lock. */
+    SDL_Thread *render_thread;
+    SDL_mutex *render_thread_lock;
+    SDL_sem *render_thread_work;
+    SDL_sem *render_thread_done;
+    SDL_atomic_t render_thread_quit;
+    SDL_atomic_t render_thread_busy;
+    Uint64 render_thread_run_time;
+    Uint32 render_thread_generation;
+    SDL_RenderCommand *render_thread_commands;
+    SDL_RenderCommand *render_thread_commands_tail;
+    void *render_thread_vertex_data;
+    size_t render_thread_vertex_data_used;
+    size_t render_thread_vertex_data_allocation;
+
     void *driverdata;
 };
 
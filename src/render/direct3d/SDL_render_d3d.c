@@ -1204,6 +1204,7 @@ D3D_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *verti
                     const Vertex *verts = (Vertex *) (((Uint8 *) vertices) + first);
                     IDirect3DDevice9_DrawPrimitiveUP(data->device, D3DPT_POINTLIST, (UINT) count, verts, sizeof (Vertex));
                 }
+                renderer->run_draw_calls++;
                 break;
             }
 
@@ -1229,6 +1230,7 @@ D3D_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *verti
                         IDirect3DDevice9_DrawPrimitiveUP(data->device, D3DPT_POINTLIST, 1, &verts[count-1], sizeof (Vertex));
                     }
                 }
+                renderer->run_draw_calls += close_endpoint ? 2 : 1;
                 break;
             }
 
@@ -1251,6 +1253,7 @@ D3D_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *verti
                     const Vertex* verts = (Vertex*)(((Uint8*)vertices) + first);
                     IDirect3DDevice9_DrawPrimitiveUP(data->device, D3DPT_TRIANGLELIST, (UINT) count / 3, verts, sizeof(Vertex));
                 }
+                renderer->run_draw_calls++;
                 break;
             }
 
@@ -2057,6 +2057,7 @@ D3D11_DrawPrimitives(SDL_Renderer * renderer, D3D11_PRIMITIVE_TOPOLOGY primitive
     D3D11_RenderData *rendererData = (D3D11_RenderData *) renderer->driverdata;
     ID3D11DeviceContext_IASetPrimitiveTopology(rendererData->d3dContext, primitiveTopology);
     ID3D11DeviceContext_Draw(rendererData->d3dContext, (UINT) vertexCount, (UINT) vertexStart);
+    renderer->run_draw_calls++;
 }
 
 static int
@@ -110,6 +110,17 @@ typedef struct
     PFNGLBINDFRAMEBUFFEREXTPROC glBindFramebufferEXT;
     PFNGLCHECKFRAMEBUFFERSTATUSEXTPROC glCheckFramebufferStatusEXT;
 
+    /* Asynchronous readback support */
+    PFNGLGENBUFFERSARBPROC glGenBuffersARB;
+    PFNGLDELETEBUFFERSARBPROC glDeleteBuffersARB;
+    PFNGLBINDBUFFERARBPROC glBindBufferARB;
+    PFNGLBUFFERDATAARBPROC glBufferDataARB;
+    PFNGLMAPBUFFERARBPROC glMapBufferARB;
+    PFNGLUNMAPBUFFERARBPROC glUnmapBufferARB;
+    PFNGLFENCESYNCPROC glFenceSync;
+    PFNGLDELETESYNCPROC glDeleteSync;
+    PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
+
     /* Shader support */
     GL_ShaderContext *shaders;
 
@@ -139,6 +150,15 @@ typedef struct
     GL_FBOList *fbo;
 } GL_TextureData;
 
+typedef struct
+{
+    GLuint buffer;
+    GLsync fence;
+    Uint32 format;              /* the format of the pixels in the buffer */
+    int pitch;
+    SDL_bool flipped;           /* the rows are bottom-up */
+} GL_ReadbackData;
+
 SDL_FORCE_INLINE const char*
 GL_TranslateError (GLenum error)
 {
@@ -1250,6 +1270,7 @@ GL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                     data->glVertex2f(verts[0], verts[1]);
                 }
                 data->glEnd();
+                renderer->run_draw_calls++;
                 break;
             }
 
@@ -1263,6 +1284,7 @@ GL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                     data->glVertex2f(verts[0], verts[1]);
                 }
                 data->glEnd();
+                renderer->run_draw_calls++;
                 break;
             }
 
@@ -1313,6 +1335,7 @@ GL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                     data->glEnd();
                     data->glColor4f(currentColor[0], currentColor[1], currentColor[2], currentColor[3]);
                 }
+                renderer->run_draw_calls++;
                 break;
            }
 
@@ -1398,6 +1421,154 @@ GL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
     return status;
 }
 
+static void
+GL_DestroyReadback(SDL_Renderer * renderer, SDL_RenderReadback * readback)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_ReadbackData *rdata = (GL_ReadbackData *) readback->driverdata;
+
+    GL_ActivateRenderer(renderer);
+
+    if (rdata->fence) {
+        data->glDeleteSync(rdata->fence);
+    }
+    if (rdata->buffer) {
+        data->glDeleteBuffersARB(1, &rdata->buffer);
+    }
+    SDL_free(rdata);
+    readback->driverdata = NULL;
+}
+
+static int
+GL_RenderReadPixelsAsync(SDL_Renderer * renderer, SDL_RenderReadback * readback)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    const SDL_Rect *rect = &readback->rect;
+    Uint32 temp_format = renderer->target ? renderer->target->format : SDL_PIXELFORMAT_ARGB8888;
+    GL_ReadbackData *rdata;
+    GLint internalFormat;
+    GLenum format, type;
+    int w, h;
+
+    GL_ActivateRenderer(renderer);
+
+    /* Let OpenGL pack the pixels in the format asked for, if it can */
+    switch (readback->format) {
+    case SDL_PIXELFORMAT_ARGB8888:
+    case SDL_PIXELFORMAT_RGB888:
+    case SDL_PIXELFORMAT_ABGR8888:
+    case SDL_PIXELFORMAT_BGR888:
+        temp_format = readback->format;
+        break;
+    default:
+        break;
+    }
+    if (!convert_format(data, temp_format, &internalFormat, &format, &type)) {
+        return SDL_SetError("Texture format %s not supported by OpenGL",
+                            SDL_GetPixelFormatName(temp_format));
+    }
+
+    rdata = (GL_ReadbackData *) SDL_calloc(1, sizeof(*rdata));
+    if (!rdata) {
+        return SDL_OutOfMemory();
+    }
+    readback->driverdata = rdata;
+    rdata->format = temp_format;
+    rdata->pitch = rect->w * SDL_BYTESPERPIXEL(temp_format);
+    rdata->flipped = renderer->target ? SDL_FALSE : SDL_TRUE;
+
+    SDL_GetRendererOutputSize(renderer, &w, &h);
+
+    /* Read into a pixel buffer object, the fence tells when it's filled */
+    data->glGenBuffersARB(1, &rdata->buffer);
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, rdata->buffer);
+    data->glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, rect->h * rdata->pitch, NULL, GL_STREAM_READ_ARB);
+
+    data->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    data->glPixelStorei(GL_PACK_ROW_LENGTH, rect->w);
+
+    data->glReadPixels(rect->x, renderer->target ? rect->y : (h-rect->y)-rect->h,
+                       rect->w, rect->h, format, type, NULL);
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+    if (GL_CheckError("glReadPixels()", renderer) < 0) {
+        GL_DestroyReadback(renderer, readback);
+        return -1;
+    }
+
+    rdata->fence = data->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    return 0;
+}
+
+static int
+GL_GetReadbackPixels(SDL_Renderer * renderer, SDL_RenderReadback * readback,
+                     void * pixels, int pitch)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_ReadbackData *rdata = (GL_ReadbackData *) readback->driverdata;
+    const SDL_Rect *rect = &readback->rect;
+    const Uint8 *src;
+    int status;
+
+    GL_ActivateRenderer(renderer);
+
+    if (rdata->fence) {
+        /* Flushing makes sure the fence is signaled eventually */
+        switch (data->glClientWaitSync(rdata->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0)) {
+        case GL_ALREADY_SIGNALED:
+        case GL_CONDITION_SATISFIED:
+            data->glDeleteSync(rdata->fence);
+            rdata->fence = NULL;
+            break;
+        case GL_TIMEOUT_EXPIRED:
+            return 1;
+        default:
+            return SDL_SetError("glClientWaitSync() failed");
+        }
+    }
+
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, rdata->buffer);
+    src = (const Uint8 *) data->glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB);
+    if (!src) {
+        data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+        return SDL_SetError("glMapBufferARB() failed");
+    }
+
+    if (rdata->flipped && rdata->format == readback->format) {
+        /* Copy the rows top-down as we go */
+        int row;
+        for (row = 0; row < rect->h; ++row) {
+            SDL_memcpy((Uint8 *) pixels + row * pitch, src + (rect->h - 1 - row) * rdata->pitch, rdata->pitch);
+        }
+        status = 0;
+    } else {
+        status = SDL_ConvertPixels(rect->w, rect->h,
+                                   rdata->format, src, rdata->pitch,
+                                   readback->format, pixels, pitch);
+        if (status == 0 && rdata->flipped) {
+            const int length = rect->w * SDL_BYTESPERPIXEL(readback->format);
+            Uint8 *top = (Uint8 *) pixels;
+            Uint8 *bottom = (Uint8 *) pixels + (rect->h - 1) * pitch;
+            int rows = rect->h / 2;
+            SDL_bool isstack;
+            Uint8 *tmp = SDL_small_alloc(Uint8, length, &isstack);
+
+            while (rows--) {
+                SDL_memcpy(tmp, top, length);
+                SDL_memcpy(top, bottom, length);
+                SDL_memcpy(bottom, tmp, length);
+                top += pitch;
+                bottom -= pitch;
+            }
+            SDL_small_free(tmp, isstack);
+        }
+    }
+
+    data->glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+    return status;
+}
+
 static void
 GL_RenderPresent(SDL_Renderer * renderer)
 {
@@ -1665,6 +1836,7 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->info = GL_RenderDriver.info;
     renderer->info.flags = SDL_RENDERER_ACCELERATED;
     renderer->driverdata = data;
+    renderer->merge_geometry = SDL_TRUE;
     renderer->window = window;
 
     data->context = SDL_GL_CreateContext(window);
@@ -1782,6 +1954,29 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     }
     data->framebuffers = NULL;
 
+    /* Check for asynchronous readback support */
+    if ((SDL_GL_ExtensionSupported("GL_ARB_pixel_buffer_object") ||
+         SDL_GL_ExtensionSupported("GL_EXT_pixel_buffer_object")) &&
+        SDL_GL_ExtensionSupported("GL_ARB_vertex_buffer_object") &&
+        SDL_GL_ExtensionSupported("GL_ARB_sync")) {
+        data->glGenBuffersARB = (PFNGLGENBUFFERSARBPROC) SDL_GL_GetProcAddress("glGenBuffersARB");
+        data->glDeleteBuffersARB = (PFNGLDELETEBUFFERSARBPROC) SDL_GL_GetProcAddress("glDeleteBuffersARB");
+        data->glBindBufferARB = (PFNGLBINDBUFFERARBPROC) SDL_GL_GetProcAddress("glBindBufferARB");
+        data->glBufferDataARB = (PFNGLBUFFERDATAARBPROC) SDL_GL_GetProcAddress("glBufferDataARB");
+        data->glMapBufferARB = (PFNGLMAPBUFFERARBPROC) SDL_GL_GetProcAddress("glMapBufferARB");
+        data->glUnmapBufferARB = (PFNGLUNMAPBUFFERARBPROC) SDL_GL_GetProcAddress("glUnmapBufferARB");
+        data->glFenceSync = (PFNGLFENCESYNCPROC) SDL_GL_GetProcAddress("glFenceSync");
+        data->glDeleteSync = (PFNGLDELETESYNCPROC) SDL_GL_GetProcAddress("glDeleteSync");
+        data->glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC) SDL_GL_GetProcAddress("glClientWaitSync");
+        if (data->glGenBuffersARB && data->glDeleteBuffersARB && data->glBindBufferARB &&
+            data->glBufferDataARB && data->glMapBufferARB && data->glUnmapBufferARB &&
+            data->glFenceSync && data->glDeleteSync && data->glClientWaitSync) {
+            renderer->RenderReadPixelsAsync = GL_RenderReadPixelsAsync;
+            renderer->GetReadbackPixels = GL_GetReadbackPixels;
+            renderer->DestroyReadback = GL_DestroyReadback;
+        }
+    }
+
     /* Set up parameters for rendering */
     data->glMatrixMode(GL_MODELVIEW);
     data->glLoadIdentity();
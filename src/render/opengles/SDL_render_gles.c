@@ -847,6 +847,7 @@ GLES_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vert
                 SetDrawState(data, cmd);
                 data->glVertexPointer(2, GL_FLOAT, 0, verts);
                 data->glDrawArrays(GL_POINTS, 0, (GLsizei) count);
+                renderer->run_draw_calls++;
                 break;
             }
 
@@ -857,6 +858,7 @@ GLES_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vert
                 SetDrawState(data, cmd);
                 data->glVertexPointer(2, GL_FLOAT, 0, verts);
                 data->glDrawArrays(GL_LINE_STRIP, 0, (GLsizei) count);
+                renderer->run_draw_calls++;
                 break;
             }
 
@@ -890,6 +892,7 @@ GLES_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vert
                 }
 
                 data->glDrawArrays(GL_TRIANGLES, 0, (GLsizei) count);
+                renderer->run_draw_calls++;
 
                 data->glDisableClientState(GL_COLOR_ARRAY);
                 break;
@@ -1135,6 +1138,7 @@ GLES_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->info = GLES_RenderDriver.info;
     renderer->info.flags = SDL_RENDERER_ACCELERATED;
     renderer->driverdata = data;
+    renderer->merge_geometry = SDL_TRUE;
     renderer->window = window;
 
     data->context = SDL_GL_CreateContext(window);
@@ -134,6 +134,46 @@ typedef struct
     GLfloat projection[4][4];
 } GLES2_DrawStateCache;
 
+/* OpenGL ES 3.0 entry points used for asynchronous readback */
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER            0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ                  0x88E1
+#endif
+#ifndef GL_PACK_ROW_LENGTH
+#define GL_PACK_ROW_LENGTH              0x0D02
+#endif
+#ifndef GL_MAP_READ_BIT
+#define GL_MAP_READ_BIT                 0x0001
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE   0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT      0x00000001
+#endif
+#ifndef GL_ALREADY_SIGNALED
+#define GL_ALREADY_SIGNALED             0x911A
+#endif
+#ifndef GL_TIMEOUT_EXPIRED
+#define GL_TIMEOUT_EXPIRED              0x911B
+#endif
+#ifndef GL_CONDITION_SATISFIED
+#define GL_CONDITION_SATISFIED          0x911C
+#endif
+
+typedef struct GLES2_Sync *GLES2_Sync;
+
+typedef struct
+{
+    GLuint buffer;
+    GLES2_Sync fence;
+    Uint32 format;              /* the format of the pixels in the buffer */
+    int pitch;
+    SDL_bool flipped;           /* the rows are bottom-up */
+} GLES2_ReadbackData;
+
 typedef struct GLES2_RenderData
 {
     SDL_GLContext *context;
@@ -155,6 +195,13 @@ typedef struct GLES2_RenderData
     size_t vertex_buffer_size[8];
     int current_vertex_buffer;
     GLES2_DrawStateCache drawstate;
+
+    /* Asynchronous readback support, OpenGL ES 3.0 and later */
+    void *(APIENTRY *glMapBufferRange)(GLenum, GLintptr, GLsizeiptr, GLbitfield);
+    GLboolean (APIENTRY *glUnmapBuffer)(GLenum);
+    GLES2_Sync (APIENTRY *glFenceSync)(GLenum, GLbitfield);
+    void (APIENTRY *glDeleteSync)(GLES2_Sync);
+    GLenum (APIENTRY *glClientWaitSync)(GLES2_Sync, GLbitfield, Uint64);
 } GLES2_RenderData;
 
 #define GLES2_MAX_CACHED_PROGRAMS 8
@@ -1145,6 +1192,7 @@ GLES2_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *ver
                     if (count > 2) {
                         /* joined lines cannot be grouped */
                         data->glDrawArrays(GL_LINE_STRIP, 0, (GLsizei)count);
+                        renderer->run_draw_calls++;
                     } else {
                         /* let's group non joined lines */
                         SDL_RenderCommand *finalcmd = cmd;
@@ -1167,6 +1215,7 @@ GLES2_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *ver
                         }
 
                         data->glDrawArrays(GL_LINES, 0, (GLsizei)count);
+                        renderer->run_draw_calls++;
                         cmd = finalcmd;  /* skip any copy commands we just combined in here. */
                     }
                 }
@@ -1209,6 +1258,7 @@ GLES2_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *ver
                         op = GL_POINTS; 
                     }
                     data->glDrawArrays(op, 0, (GLsizei) count);
+                    renderer->run_draw_calls++;
                 }
 
                 cmd = finalcmd;  /* skip any copy commands we just combined in here. */
@@ -1825,6 +1875,139 @@ GLES2_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
     return status;
 }
 
+static void
+GLES2_DestroyReadback(SDL_Renderer * renderer, SDL_RenderReadback * readback)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    GLES2_ReadbackData *rdata = (GLES2_ReadbackData *)readback->driverdata;
+
+    GLES2_ActivateRenderer(renderer);
+
+    if (rdata->fence) {
+        data->glDeleteSync(rdata->fence);
+    }
+    if (rdata->buffer) {
+        data->glDeleteBuffers(1, &rdata->buffer);
+    }
+    SDL_free(rdata);
+    readback->driverdata = NULL;
+}
+
+static int
+GLES2_RenderReadPixelsAsync(SDL_Renderer * renderer, SDL_RenderReadback * readback)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    const SDL_Rect *rect = &readback->rect;
+    Uint32 temp_format = renderer->target ? renderer->target->format : SDL_PIXELFORMAT_ABGR8888;
+    GLES2_ReadbackData *rdata;
+    int w, h;
+
+    if (GLES2_ActivateRenderer(renderer) < 0) {
+        return -1;
+    }
+
+    rdata = (GLES2_ReadbackData *)SDL_calloc(1, sizeof(*rdata));
+    if (!rdata) {
+        return SDL_OutOfMemory();
+    }
+    readback->driverdata = rdata;
+    rdata->format = temp_format;
+    rdata->pitch = rect->w * SDL_BYTESPERPIXEL(temp_format);
+    rdata->flipped = renderer->target ? SDL_FALSE : SDL_TRUE;
+
+    SDL_GetRendererOutputSize(renderer, &w, &h);
+
+    /* Read into a pixel buffer object, the fence tells when it's filled */
+    data->glGenBuffers(1, &rdata->buffer);
+    data->glBindBuffer(GL_PIXEL_PACK_BUFFER, rdata->buffer);
+    data->glBufferData(GL_PIXEL_PACK_BUFFER, rect->h * rdata->pitch, NULL, GL_STREAM_READ);
+
+    data->glPixelStorei(GL_PACK_ROW_LENGTH, rect->w);
+    data->glReadPixels(rect->x, renderer->target ? rect->y : (h-rect->y)-rect->h,
+                       rect->w, rect->h, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    data->glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    data->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (GL_CheckError("glReadPixels()", renderer) < 0) {
+        GLES2_DestroyReadback(renderer, readback);
+        return -1;
+    }
+
+    rdata->fence = data->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    return 0;
+}
+
+static int
+GLES2_GetReadbackPixels(SDL_Renderer * renderer, SDL_RenderReadback * readback,
+                        void * pixels, int pitch)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    GLES2_ReadbackData *rdata = (GLES2_ReadbackData *)readback->driverdata;
+    const SDL_Rect *rect = &readback->rect;
+    const Uint8 *src;
+    int status;
+
+    if (GLES2_ActivateRenderer(renderer) < 0) {
+        return -1;
+    }
+
+    if (rdata->fence) {
+        /* Flushing makes sure the fence is signaled eventually */
+        switch (data->glClientWaitSync(rdata->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0)) {
+        case GL_ALREADY_SIGNALED:
+        case GL_CONDITION_SATISFIED:
+            data->glDeleteSync(rdata->fence);
+            rdata->fence = NULL;
+            break;
+        case GL_TIMEOUT_EXPIRED:
+            return 1;
+        default:
+            return SDL_SetError("glClientWaitSync() failed");
+        }
+    }
+
+    data->glBindBuffer(GL_PIXEL_PACK_BUFFER, rdata->buffer);
+    src = (const Uint8 *)data->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, rect->h * rdata->pitch, GL_MAP_READ_BIT);
+    if (!src) {
+        data->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return SDL_SetError("glMapBufferRange() failed");
+    }
+
+    if (rdata->flipped && rdata->format == readback->format) {
+        /* Copy the rows top-down as we go */
+        int row;
+        for (row = 0; row < rect->h; ++row) {
+            SDL_memcpy((Uint8 *)pixels + row * pitch, src + (rect->h - 1 - row) * rdata->pitch, rdata->pitch);
+        }
+        status = 0;
+    } else {
+        status = SDL_ConvertPixels(rect->w, rect->h,
+                                   rdata->format, src, rdata->pitch,
+                                   readback->format, pixels, pitch);
+        if (status == 0 && rdata->flipped) {
+            const int length = rect->w * SDL_BYTESPERPIXEL(readback->format);
+            Uint8 *top = (Uint8 *)pixels;
+            Uint8 *bottom = (Uint8 *)pixels + (rect->h - 1) * pitch;
+            int rows = rect->h / 2;
+            SDL_bool isstack;
+            Uint8 *tmp = SDL_small_alloc(Uint8, length, &isstack);
+
+            while (rows--) {
+                SDL_memcpy(tmp, top, length);
+                SDL_memcpy(top, bottom, length);
+                SDL_memcpy(bottom, tmp, length);
+                top += pitch;
+                bottom -= pitch;
+            }
+            SDL_small_free(tmp, isstack);
+        }
+    }
+
+    data->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    data->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return status;
+}
+
 static void
 GLES2_RenderPresent(SDL_Renderer *renderer)
 {
@@ -1948,6 +2131,7 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     renderer->info = GLES2_RenderDriver.info;
     renderer->info.flags = (SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
     renderer->driverdata = data;
+    renderer->merge_geometry = SDL_TRUE;
     renderer->window = window;
 
     /* Create an OpenGL ES 2.0 context */
@@ -2008,6 +2192,21 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     data->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &window_framebuffer);
     data->window_framebuffer = (GLuint)window_framebuffer;
 
+#ifndef __SDL_NOGETPROCADDR__
+    /* Pixel buffer objects and fences need an OpenGL ES 3.0 context */
+    {
+        const char *version = (const char *)data->glGetString(GL_VERSION);
+        int es_major = 0;
+        if (version && SDL_sscanf(version, "OpenGL ES %d.", &es_major) == 1 && es_major >= 3) {
+            data->glMapBufferRange = SDL_GL_GetProcAddress("glMapBufferRange");
+            data->glUnmapBuffer = SDL_GL_GetProcAddress("glUnmapBuffer");
+            data->glFenceSync = SDL_GL_GetProcAddress("glFenceSync");
+            data->glDeleteSync = SDL_GL_GetProcAddress("glDeleteSync");
+            data->glClientWaitSync = SDL_GL_GetProcAddress("glClientWaitSync");
+        }
+    }
+#endif
+
     /* Populate the function pointers for the module */
     renderer->WindowEvent         = GLES2_WindowEvent;
     renderer->GetOutputSize       = GLES2_GetOutputSize;
@@ -2029,6 +2228,12 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     renderer->QueueGeometry       = GLES2_QueueGeometry;
     renderer->RunCommandQueue     = GLES2_RunCommandQueue;
     renderer->RenderReadPixels    = GLES2_RenderReadPixels;
+    if (data->glMapBufferRange && data->glUnmapBuffer &&
+        data->glFenceSync && data->glDeleteSync && data->glClientWaitSync) {
+        renderer->RenderReadPixelsAsync = GLES2_RenderReadPixelsAsync;
+        renderer->GetReadbackPixels   = GLES2_GetReadbackPixels;
+        renderer->DestroyReadback     = GLES2_DestroyReadback;
+    }
     renderer->RenderPresent       = GLES2_RenderPresent;
     renderer->DestroyTexture      = GLES2_DestroyTexture;
     renderer->DestroyRenderer     = GLES2_DestroyRenderer;
@@ -876,6 +876,7 @@ PSP_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *verti
                 sceGuDisable(GU_TEXTURE_2D);
                 sceGuShadeModel(GU_FLAT);
                 sceGuDrawArray(GU_POINTS, GU_VERTEX_32BITF|GU_TRANSFORM_2D, count, 0, verts);
+                renderer->run_draw_calls++;
                 sceGuShadeModel(GU_SMOOTH);
                 sceGuEnable(GU_TEXTURE_2D);
                 break;
@@ -894,6 +895,7 @@ PSP_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *verti
                 sceGuDisable(GU_TEXTURE_2D);
                 sceGuShadeModel(GU_FLAT);
                 sceGuDrawArray(GU_LINE_STRIP, GU_VERTEX_32BITF|GU_TRANSFORM_2D, count, 0, verts);
+                renderer->run_draw_calls++;
                 sceGuShadeModel(GU_SMOOTH);
                 sceGuEnable(GU_TEXTURE_2D);
                 break;
@@ -912,6 +914,7 @@ PSP_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *verti
                 sceGuDisable(GU_TEXTURE_2D);
                 sceGuShadeModel(GU_FLAT);
                 sceGuDrawArray(GU_SPRITES, GU_VERTEX_32BITF|GU_TRANSFORM_2D, 2 * count, 0, verts);
+                renderer->run_draw_calls++;
                 sceGuShadeModel(GU_SMOOTH);
                 sceGuEnable(GU_TEXTURE_2D);
                 break;
@@ -933,6 +936,7 @@ PSP_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *verti
                 }
 
                 sceGuDrawArray(GU_SPRITES, GU_TEXTURE_32BITF|GU_VERTEX_32BITF|GU_TRANSFORM_2D, 2 * count, 0, verts);
+                renderer->run_draw_calls++;
 
                 if(alpha != 255) {
                     sceGuTexFunc(GU_TFX_REPLACE, GU_TCC_RGBA);
@@ -955,6 +959,7 @@ PSP_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *verti
                 }
 
                 sceGuDrawArray(GU_TRIANGLE_FAN, GU_TEXTURE_32BITF|GU_VERTEX_32BITF|GU_TRANSFORM_2D, 4, 0, verts);
+                renderer->run_draw_calls++;
 
                 if(alpha != 255) {
                     sceGuTexFunc(GU_TFX_REPLACE, GU_TCC_RGBA);
@@ -969,6 +974,7 @@ PSP_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *verti
                     sceGuDisable(GU_TEXTURE_2D);
                     /* In GU_SMOOTH mode */
                     sceGuDrawArray(GU_TRIANGLES, GU_COLOR_8888|GU_VERTEX_32BITF|GU_TRANSFORM_2D, count, 0, verts);
+                    renderer->run_draw_calls++;
                     sceGuEnable(GU_TEXTURE_2D);
                 } else {
                     const VertTCV *verts = (VertTCV *) (gpumem + cmd->data.draw.first);
@@ -977,6 +983,7 @@ PSP_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *verti
                     PSP_SetBlendMode(renderer, SDL_BLENDMODE_INVALID);
                     PSP_SetBlendMode(renderer, cmd->data.draw.blend);
                     sceGuDrawArray(GU_TRIANGLES, GU_TEXTURE_32BITF|GU_COLOR_8888|GU_VERTEX_32BITF|GU_TRANSFORM_2D, count, 0, verts);
+                    renderer->run_draw_calls++;
                 }
                 break;
             }
@@ -213,11 +213,500 @@ SDL_BlendFillRect_RGBA(SDL_Surface * dst, const SDL_Rect * rect,
     }
 }
 
+/*
+ * Span kernels for the blended fills, lines and points.
+ *
+ * Each destination channel d is combined with a per-channel constant c,
+ * exactly as the DRAW_SETPIXEL_* macros do:
+ *   BLEND: d * inva / 255 + c
+ *   ADD:   min(d + c, 255)
+ *   MOD:   d * c / 255
+ *   MUL:   min(d * c / 255 + d * inva / 255, 255)
+ * where each division truncates. x / 255 is computed as
+ * (x + 1 + (x >> 8)) >> 8, which is exact for every x <= 255 * 255.
+ *
+ * 8888 destinations are handled one byte per channel, the alpha byte uses
+ * a constant that reproduces what the macros do with it and the unused
+ * byte of formats without alpha is cleared. RGB565 channels are expanded
+ * to 8 bits the same way SDL_expand_byte does and truncated back.
+ */
+
+#if defined(__SSE2__)
+#define HAVE_SSE2_BLEND_SPANS 1
+#endif
+#if defined(HAVE_AVX2_INTRINSICS)
+#define HAVE_AVX2_BLEND_SPANS 1
+#endif
+#if defined(__ARM_NEON)
+#define HAVE_NEON_BLEND_SPANS 1
+#endif
+
+/* The kernels address channels by byte, which requires a little endian layout */
+#if SDL_BYTEORDER != SDL_LIL_ENDIAN
+#undef HAVE_SSE2_BLEND_SPANS
+#undef HAVE_AVX2_BLEND_SPANS
+#undef HAVE_NEON_BLEND_SPANS
+#endif
+
+#define DIV255(x)   (((x) + 1 + ((x) >> 8)) >> 8)
+
+#if HAVE_SSE2_BLEND_SPANS || HAVE_AVX2_BLEND_SPANS || HAVE_NEON_BLEND_SPANS
+
+static SDL_INLINE Uint32
+BlendSpanChannel(SDL_BlendMode blendMode, Uint32 d, Uint32 c, Uint32 inva)
+{
+    Uint32 v;
+
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        return DIV255(d * inva) + c;
+    case SDL_BLENDMODE_ADD:
+        v = d + c;
+        break;
+    case SDL_BLENDMODE_MOD:
+        return DIV255(d * c);
+    default:
+        v = DIV255(d * c) + DIV255(d * inva);
+        break;
+    }
+    return (v > 0xFF) ? 0xFF : v;
+}
+
+/* Scalar versions, used for the pixels left over by the SIMD loops */
+static void
+BlendSpanRow8888(Uint32 * pixel, int width, const SDL_BlendSpanInfo * info)
+{
+    int i, shift;
+
+    for (i = 0; i < width; ++i) {
+        const Uint32 d = pixel[i];
+        Uint32 out = 0;
+
+        for (shift = 0; shift < 32; shift += 8) {
+            out |= BlendSpanChannel(info->blendMode, (d >> shift) & 0xFF,
+                                    (info->color >> shift) & 0xFF, info->inva) << shift;
+        }
+        pixel[i] = out & info->mask;
+    }
+}
+
+static void
+BlendSpanRow565(Uint16 * pixel, int width, const SDL_BlendSpanInfo * info)
+{
+    int i;
+
+    for (i = 0; i < width; ++i) {
+        const Uint32 d = pixel[i];
+        const Uint32 lo = BlendSpanChannel(info->blendMode, SDL_expand_byte[3][d & 0x1F],
+                                           info->color & 0xFF, info->inva);
+        const Uint32 mid = BlendSpanChannel(info->blendMode, SDL_expand_byte[2][(d >> 5) & 0x3F],
+                                            (info->color >> 8) & 0xFF, info->inva);
+        const Uint32 hi = BlendSpanChannel(info->blendMode, SDL_expand_byte[3][d >> 11],
+                                           (info->color >> 16) & 0xFF, info->inva);
+
+        pixel[i] = (Uint16)(((hi >> 3) << 11) | ((mid >> 2) << 5) | (lo >> 3));
+    }
+}
+
+#if HAVE_SSE2_BLEND_SPANS
+static SDL_INLINE __m128i
+Div255_SSE2(__m128i x, __m128i one)
+{
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, one), _mm_srli_epi16(x, 8)), 8);
+}
+
+/* Blend channels held in 16-bit lanes */
+static SDL_INLINE __m128i
+BlendSpanChannels_SSE2(SDL_BlendMode blendMode, __m128i d, __m128i c, __m128i inva, __m128i one, __m128i full)
+{
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        return _mm_add_epi16(Div255_SSE2(_mm_mullo_epi16(d, inva), one), c);
+    case SDL_BLENDMODE_ADD:
+        return _mm_min_epi16(_mm_add_epi16(d, c), full);
+    case SDL_BLENDMODE_MOD:
+        return Div255_SSE2(_mm_mullo_epi16(d, c), one);
+    default:
+        return _mm_min_epi16(_mm_add_epi16(Div255_SSE2(_mm_mullo_epi16(d, c), one),
+                                           Div255_SSE2(_mm_mullo_epi16(d, inva), one)), full);
+    }
+}
+
+/* Expand 5 or 6 bit channels to 8 bits, x * 255 / 31 or x * 255 / 63 */
+static SDL_INLINE __m128i
+Expand_SSE2(__m128i x, __m128i full, __m128i magic)
+{
+    return _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(x, full), magic), 4);
+}
+
+static void
+BlendSpan8888_SSE2(void *pixels, int width, const SDL_BlendSpanInfo * info)
+{
+    Uint32 *pixel = (Uint32 *)pixels;
+    const SDL_BlendMode blendMode = info->blendMode;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i full = _mm_set1_epi16(0xFF);
+    const __m128i color8 = _mm_set1_epi32((int)info->color);
+    const __m128i color = _mm_unpacklo_epi8(color8, zero);
+    const __m128i inva = _mm_set1_epi16((short)info->inva);
+    const __m128i mask = _mm_set1_epi32((int)info->mask);
+    int i = 0;
+
+    for (; i + 4 <= width; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i *)(pixel + i));
+
+        if (blendMode == SDL_BLENDMODE_ADD) {
+            d = _mm_adds_epu8(d, color8);
+        } else {
+            d = _mm_packus_epi16(BlendSpanChannels_SSE2(blendMode, _mm_unpacklo_epi8(d, zero), color, inva, one, full),
+                                 BlendSpanChannels_SSE2(blendMode, _mm_unpackhi_epi8(d, zero), color, inva, one, full));
+        }
+        _mm_storeu_si128((__m128i *)(pixel + i), _mm_and_si128(d, mask));
+    }
+    BlendSpanRow8888(pixel + i, width - i, info);
+}
+
+static void
+BlendSpan565_SSE2(void *pixels, int width, const SDL_BlendSpanInfo * info)
+{
+    Uint16 *pixel = (Uint16 *)pixels;
+    const SDL_BlendMode blendMode = info->blendMode;
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i full = _mm_set1_epi16(0xFF);
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+    const __m128i magic5 = _mm_set1_epi16((short)33826);
+    const __m128i magic6 = _mm_set1_epi16((short)16645);
+    const __m128i lo = _mm_set1_epi16((short)(info->color & 0xFF));
+    const __m128i mid = _mm_set1_epi16((short)((info->color >> 8) & 0xFF));
+    const __m128i hi = _mm_set1_epi16((short)((info->color >> 16) & 0xFF));
+    const __m128i inva = _mm_set1_epi16((short)info->inva);
+    int i = 0;
+
+    for (; i + 8 <= width; i += 8) {
+        const __m128i d = _mm_loadu_si128((const __m128i *)(pixel + i));
+        const __m128i l = BlendSpanChannels_SSE2(blendMode, Expand_SSE2(_mm_and_si128(d, mask5), full, magic5),
+                                                 lo, inva, one, full);
+        const __m128i m = BlendSpanChannels_SSE2(blendMode, Expand_SSE2(_mm_and_si128(_mm_srli_epi16(d, 5), mask6), full, magic6),
+                                                 mid, inva, one, full);
+        const __m128i h = BlendSpanChannels_SSE2(blendMode, Expand_SSE2(_mm_srli_epi16(d, 11), full, magic5),
+                                                 hi, inva, one, full);
+
+        _mm_storeu_si128((__m128i *)(pixel + i),
+                         _mm_or_si128(_mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(h, 3), 11),
+                                                   _mm_slli_epi16(_mm_srli_epi16(m, 2), 5)),
+                                      _mm_srli_epi16(l, 3)));
+    }
+    BlendSpanRow565(pixel + i, width - i, info);
+}
+#endif /* HAVE_SSE2_BLEND_SPANS */
+
+#if HAVE_AVX2_BLEND_SPANS
+static SDL_INLINE __m256i SDL_TARGETING("avx2")
+Div255_AVX2(__m256i x, __m256i one)
+{
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, one), _mm256_srli_epi16(x, 8)), 8);
+}
+
+static SDL_INLINE __m256i SDL_TARGETING("avx2")
+BlendSpanChannels_AVX2(SDL_BlendMode blendMode, __m256i d, __m256i c, __m256i inva, __m256i one, __m256i full)
+{
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        return _mm256_add_epi16(Div255_AVX2(_mm256_mullo_epi16(d, inva), one), c);
+    case SDL_BLENDMODE_ADD:
+        return _mm256_min_epi16(_mm256_add_epi16(d, c), full);
+    case SDL_BLENDMODE_MOD:
+        return Div255_AVX2(_mm256_mullo_epi16(d, c), one);
+    default:
+        return _mm256_min_epi16(_mm256_add_epi16(Div255_AVX2(_mm256_mullo_epi16(d, c), one),
+                                                 Div255_AVX2(_mm256_mullo_epi16(d, inva), one)), full);
+    }
+}
+
+static SDL_INLINE __m256i SDL_TARGETING("avx2")
+Expand_AVX2(__m256i x, __m256i full, __m256i magic)
+{
+    return _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(x, full), magic), 4);
+}
+
+static void SDL_TARGETING("avx2")
+BlendSpan8888_AVX2(void *pixels, int width, const SDL_BlendSpanInfo * info)
+{
+    Uint32 *pixel = (Uint32 *)pixels;
+    const SDL_BlendMode blendMode = info->blendMode;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i full = _mm256_set1_epi16(0xFF);
+    const __m256i color8 = _mm256_set1_epi32((int)info->color);
+    const __m256i color = _mm256_unpacklo_epi8(color8, zero);
+    const __m256i inva = _mm256_set1_epi16((short)info->inva);
+    const __m256i mask = _mm256_set1_epi32((int)info->mask);
+    int i = 0;
+
+    for (; i + 8 <= width; i += 8) {
+        __m256i d = _mm256_loadu_si256((const __m256i *)(pixel + i));
+
+        if (blendMode == SDL_BLENDMODE_ADD) {
+            d = _mm256_adds_epu8(d, color8);
+        } else {
+            d = _mm256_packus_epi16(BlendSpanChannels_AVX2(blendMode, _mm256_unpacklo_epi8(d, zero), color, inva, one, full),
+                                    BlendSpanChannels_AVX2(blendMode, _mm256_unpackhi_epi8(d, zero), color, inva, one, full));
+        }
+        _mm256_storeu_si256((__m256i *)(pixel + i), _mm256_and_si256(d, mask));
+    }
+    BlendSpanRow8888(pixel + i, width - i, info);
+}
+
+static void SDL_TARGETING("avx2")
+BlendSpan565_AVX2(void *pixels, int width, const SDL_BlendSpanInfo * info)
+{
+    Uint16 *pixel = (Uint16 *)pixels;
+    const SDL_BlendMode blendMode = info->blendMode;
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i full = _mm256_set1_epi16(0xFF);
+    const __m256i mask5 = _mm256_set1_epi16(0x1F);
+    const __m256i mask6 = _mm256_set1_epi16(0x3F);
+    const __m256i magic5 = _mm256_set1_epi16((short)33826);
+    const __m256i magic6 = _mm256_set1_epi16((short)16645);
+    const __m256i lo = _mm256_set1_epi16((short)(info->color & 0xFF));
+    const __m256i mid = _mm256_set1_epi16((short)((info->color >> 8) & 0xFF));
+    const __m256i hi = _mm256_set1_epi16((short)((info->color >> 16) & 0xFF));
+    const __m256i inva = _mm256_set1_epi16((short)info->inva);
+    int i = 0;
+
+    for (; i + 16 <= width; i += 16) {
+        const __m256i d = _mm256_loadu_si256((const __m256i *)(pixel + i));
+        const __m256i l = BlendSpanChannels_AVX2(blendMode, Expand_AVX2(_mm256_and_si256(d, mask5), full, magic5),
+                                                 lo, inva, one, full);
+        const __m256i m = BlendSpanChannels_AVX2(blendMode, Expand_AVX2(_mm256_and_si256(_mm256_srli_epi16(d, 5), mask6), full, magic6),
+                                                 mid, inva, one, full);
+        const __m256i h = BlendSpanChannels_AVX2(blendMode, Expand_AVX2(_mm256_srli_epi16(d, 11), full, magic5),
+                                                 hi, inva, one, full);
+
+        _mm256_storeu_si256((__m256i *)(pixel + i),
+                            _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(_mm256_srli_epi16(h, 3), 11),
+                                                            _mm256_slli_epi16(_mm256_srli_epi16(m, 2), 5)),
+                                            _mm256_srli_epi16(l, 3)));
+    }
+    BlendSpanRow565(pixel + i, width - i, info);
+}
+#endif /* HAVE_AVX2_BLEND_SPANS */
+
+#if HAVE_NEON_BLEND_SPANS
+static SDL_INLINE uint16x8_t
+Div255_NEON(uint16x8_t x)
+{
+    return vshrq_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+}
+
+static SDL_INLINE uint16x8_t
+BlendSpanChannels_NEON(SDL_BlendMode blendMode, uint16x8_t d, uint16x8_t c, uint16x8_t inva)
+{
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        return vaddq_u16(Div255_NEON(vmulq_u16(d, inva)), c);
+    case SDL_BLENDMODE_ADD:
+        return vminq_u16(vaddq_u16(d, c), vdupq_n_u16(0xFF));
+    case SDL_BLENDMODE_MOD:
+        return Div255_NEON(vmulq_u16(d, c));
+    default:
+        return vminq_u16(vaddq_u16(Div255_NEON(vmulq_u16(d, c)), Div255_NEON(vmulq_u16(d, inva))),
+                         vdupq_n_u16(0xFF));
+    }
+}
+
+/* Expand 5 or 6 bit channels to 8 bits, x * 255 / 31 or x * 255 / 63 */
+static SDL_INLINE uint16x8_t
+Expand_NEON(uint16x8_t x, uint16x4_t magic)
+{
+    const uint16x8_t t = vmulq_n_u16(x, 255);
+    const uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(t), magic), 16);
+    const uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(t), magic), 16);
+    return vshrq_n_u16(vcombine_u16(lo, hi), 4);
+}
+
+static void
+BlendSpan8888_NEON(void *pixels, int width, const SDL_BlendSpanInfo * info)
+{
+    Uint32 *pixel = (Uint32 *)pixels;
+    const SDL_BlendMode blendMode = info->blendMode;
+    const uint8x16_t color8 = vreinterpretq_u8_u32(vdupq_n_u32(info->color));
+    const uint16x8_t color = vmovl_u8(vget_low_u8(color8));
+    const uint16x8_t inva = vdupq_n_u16(info->inva);
+    const uint8x16_t mask = vreinterpretq_u8_u32(vdupq_n_u32(info->mask));
+    int i = 0;
+
+    for (; i + 4 <= width; i += 4) {
+        uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(pixel + i));
+
+        if (blendMode == SDL_BLENDMODE_ADD) {
+            d = vqaddq_u8(d, color8);
+        } else {
+            d = vcombine_u8(vmovn_u16(BlendSpanChannels_NEON(blendMode, vmovl_u8(vget_low_u8(d)), color, inva)),
+                            vmovn_u16(BlendSpanChannels_NEON(blendMode, vmovl_u8(vget_high_u8(d)), color, inva)));
+        }
+        vst1q_u32(pixel + i, vreinterpretq_u32_u8(vandq_u8(d, mask)));
+    }
+    BlendSpanRow8888(pixel + i, width - i, info);
+}
+
+static void
+BlendSpan565_NEON(void *pixels, int width, const SDL_BlendSpanInfo * info)
+{
+    Uint16 *pixel = (Uint16 *)pixels;
+    const SDL_BlendMode blendMode = info->blendMode;
+    const uint16x4_t magic5 = vdup_n_u16(33826);
+    const uint16x4_t magic6 = vdup_n_u16(16645);
+    const uint16x8_t mask5 = vdupq_n_u16(0x1F);
+    const uint16x8_t mask6 = vdupq_n_u16(0x3F);
+    const uint16x8_t lo = vdupq_n_u16((uint16_t)(info->color & 0xFF));
+    const uint16x8_t mid = vdupq_n_u16((uint16_t)((info->color >> 8) & 0xFF));
+    const uint16x8_t hi = vdupq_n_u16((uint16_t)((info->color >> 16) & 0xFF));
+    const uint16x8_t inva = vdupq_n_u16(info->inva);
+    int i = 0;
+
+    for (; i + 8 <= width; i += 8) {
+        const uint16x8_t d = vld1q_u16(pixel + i);
+        const uint16x8_t l = BlendSpanChannels_NEON(blendMode, Expand_NEON(vandq_u16(d, mask5), magic5), lo, inva);
+        const uint16x8_t m = BlendSpanChannels_NEON(blendMode, Expand_NEON(vandq_u16(vshrq_n_u16(d, 5), mask6), magic6), mid, inva);
+        const uint16x8_t h = BlendSpanChannels_NEON(blendMode, Expand_NEON(vshrq_n_u16(d, 11), magic5), hi, inva);
+
+        vst1q_u16(pixel + i, vorrq_u16(vorrq_u16(vshlq_n_u16(vshrq_n_u16(h, 3), 11),
+                                                 vshlq_n_u16(vshrq_n_u16(m, 2), 5)),
+                                       vshrq_n_u16(l, 3)));
+    }
+    BlendSpanRow565(pixel + i, width - i, info);
+}
+#endif /* HAVE_NEON_BLEND_SPANS */
+
+/* Whether a format holds its channels in whole bytes of a 32-bit pixel */
+static SDL_bool
+IsByteAligned8888(const SDL_PixelFormat * fmt)
+{
+    if (fmt->BytesPerPixel != 4) {
+        return SDL_FALSE;
+    }
+    if ((fmt->Rmask >> fmt->Rshift) != 0xFF || (fmt->Rshift % 8) != 0 ||
+        (fmt->Gmask >> fmt->Gshift) != 0xFF || (fmt->Gshift % 8) != 0 ||
+        (fmt->Bmask >> fmt->Bshift) != 0xFF || (fmt->Bshift % 8) != 0) {
+        return SDL_FALSE;
+    }
+    if (fmt->Amask && ((fmt->Amask >> fmt->Ashift) != 0xFF || (fmt->Ashift % 8) != 0)) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+#endif /* HAVE_SSE2_BLEND_SPANS || HAVE_AVX2_BLEND_SPANS || HAVE_NEON_BLEND_SPANS */
+
+#undef DIV255
+
+SDL_bool
+SDL_PrepareBlendSpans(SDL_BlendSpanInfo * info, SDL_Surface * dst,
+                      SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+#if HAVE_SSE2_BLEND_SPANS || HAVE_AVX2_BLEND_SPANS || HAVE_NEON_BLEND_SPANS
+    const SDL_PixelFormat *fmt = dst->format;
+    Uint32 alpha;
+
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+    case SDL_BLENDMODE_MUL:
+        alpha = a;
+        break;
+    case SDL_BLENDMODE_ADD:
+        /* Leaves destination alpha untouched */
+        alpha = 0;
+        break;
+    case SDL_BLENDMODE_MOD:
+        /* Leaves destination alpha untouched, d * 255 / 255 == d */
+        alpha = 0xFF;
+        break;
+    default:
+        return SDL_FALSE;
+    }
+
+    info->func = NULL;
+    if (IsByteAligned8888(fmt)) {
+        info->color = ((Uint32)r << fmt->Rshift) | ((Uint32)g << fmt->Gshift) | ((Uint32)b << fmt->Bshift);
+        if (fmt->Amask) {
+            info->color |= alpha << fmt->Ashift;
+            info->mask = 0xFFFFFFFF;
+        } else {
+            /* The macros write 0 to the unused byte */
+            info->mask = fmt->Rmask | fmt->Gmask | fmt->Bmask;
+        }
+#if HAVE_AVX2_BLEND_SPANS
+        if (!info->func && SDL_HasAVX2()) {
+            info->func = BlendSpan8888_AVX2;
+        }
+#endif
+#if HAVE_SSE2_BLEND_SPANS
+        if (!info->func && SDL_HasSSE2()) {
+            info->func = BlendSpan8888_SSE2;
+        }
+#endif
+#if HAVE_NEON_BLEND_SPANS
+        if (!info->func && SDL_HasNEON()) {
+            info->func = BlendSpan8888_NEON;
+        }
+#endif
+    } else if (fmt->BytesPerPixel == 2 && fmt->Amask == 0 && fmt->Gmask == 0x07E0 &&
+               ((fmt->Rmask == 0xF800 && fmt->Bmask == 0x001F) ||
+                (fmt->Rmask == 0x001F && fmt->Bmask == 0xF800))) {
+        /* Colors of the low, middle and high channels */
+        if (fmt->Rmask == 0xF800) {
+            info->color = ((Uint32)r << 16) | ((Uint32)g << 8) | b;
+        } else {
+            info->color = ((Uint32)b << 16) | ((Uint32)g << 8) | r;
+        }
+        info->mask = 0xFFFF;
+#if HAVE_AVX2_BLEND_SPANS
+        if (!info->func && SDL_HasAVX2()) {
+            info->func = BlendSpan565_AVX2;
+        }
+#endif
+#if HAVE_SSE2_BLEND_SPANS
+        if (!info->func && SDL_HasSSE2()) {
+            info->func = BlendSpan565_SSE2;
+        }
+#endif
+#if HAVE_NEON_BLEND_SPANS
+        if (!info->func && SDL_HasNEON()) {
+            info->func = BlendSpan565_NEON;
+        }
+#endif
+    }
+    if (!info->func) {
+        return SDL_FALSE;
+    }
+
+    info->dst = dst;
+    info->blendMode = blendMode;
+    info->inva = a ^ 0xFF;
+    return SDL_TRUE;
+#else
+    return SDL_FALSE;
+#endif
+}
+
+void
+SDL_BlendFillSpan(const SDL_BlendSpanInfo * info, int x, int y, int width)
+{
+    SDL_Surface *dst = info->dst;
+
+    info->func((Uint8 *)dst->pixels + y * dst->pitch + x * dst->format->BytesPerPixel, width, info);
+}
+
 int
 SDL_BlendFillRect(SDL_Surface * dst, const SDL_Rect * rect,
                   SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
     SDL_Rect clipped;
+    SDL_BlendSpanInfo spans;
+    int y;
 
     if (!dst) {
         return SDL_SetError("Passed NULL destination surface");
@@ -245,6 +734,13 @@ SDL_BlendFillRect(SDL_Surface * dst, const SDL_Rect * rect,
         b = DRAW_MUL(b, a);
     }
 
+    if (SDL_PrepareBlendSpans(&spans, dst, blendMode, r, g, b, a)) {
+        for (y = 0; y < rect->h; ++y) {
+            SDL_BlendFillSpan(&spans, rect->x, rect->y + y, rect->w);
+        }
+        return 0;
+    }
+
     switch (dst->format->BitsPerPixel) {
     case 15:
         switch (dst->format->Rmask) {
@@ -289,6 +785,8 @@ SDL_BlendFillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
     int (*func)(SDL_Surface * dst, const SDL_Rect * rect,
                 SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a) = NULL;
     int status = 0;
+    SDL_BlendSpanInfo spans;
+    int y;
 
     if (!dst) {
         return SDL_SetError("Passed NULL destination surface");
@@ -305,6 +803,19 @@ SDL_BlendFillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
         b = DRAW_MUL(b, a);
     }
 
+    if (SDL_PrepareBlendSpans(&spans, dst, blendMode, r, g, b, a)) {
+        for (i = 0; i < count; ++i) {
+            /* Perform clipping */
+            if (!SDL_IntersectRect(&rects[i], &dst->clip_rect, &rect)) {
+                continue;
+            }
+            for (y = 0; y < rect.h; ++y) {
+                SDL_BlendFillSpan(&spans, rect.x, rect.y + y, rect.w);
+            }
+        }
+        return 0;
+    }
+
     /* FIXME: Does this function pointer slow things down significantly? */
     switch (dst->format->BitsPerPixel) {
     case 15:
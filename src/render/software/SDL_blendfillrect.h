@@ -24,6 +24,22 @@
 
 #include "../../SDL_internal.h"
 
+/* A blend mode and color prepared for filling many spans of one surface */
+typedef struct SDL_BlendSpanInfo
+{
+    SDL_Surface *dst;
+    SDL_BlendMode blendMode;
+    Uint32 color;       /* per channel constants, laid out like the destination channels */
+    Uint32 mask;        /* destination bits that are kept */
+    Uint8 inva;
+    void (*func)(void *pixels, int width, const struct SDL_BlendSpanInfo * info);
+} SDL_BlendSpanInfo;
+
+/* r, g and b are premultiplied by a for SDL_BLENDMODE_BLEND and SDL_BLENDMODE_ADD.
+   Returns SDL_FALSE if there is no span kernel for the blend mode, format or CPU */
+extern SDL_bool SDL_PrepareBlendSpans(SDL_BlendSpanInfo * info, SDL_Surface * dst, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+/* Blends 'width' pixels starting at (x, y), which must be inside the clip rectangle */
+extern void SDL_BlendFillSpan(const SDL_BlendSpanInfo * info, int x, int y, int width);
 
 extern int SDL_BlendFillRect(SDL_Surface * dst, const SDL_Rect * rect, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 extern int SDL_BlendFillRects(SDL_Surface * dst, const SDL_Rect * rects, int count, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
@@ -23,6 +23,7 @@
 #if SDL_VIDEO_RENDER_SW && !SDL_RENDER_DISABLED
 
 #include "SDL_draw.h"
+#include "SDL_blendfillrect.h"
 #include "SDL_blendline.h"
 #include "SDL_blendpoint.h"
 
@@ -802,11 +803,101 @@ SDL_CalculateBlendLineFunc(const SDL_PixelFormat * fmt)
     return NULL;
 }
 
+/* The per pixel functions premultiply the color themselves, spans take it premultiplied */
+static SDL_bool
+SDL_PrepareBlendLineSpans(SDL_BlendSpanInfo * spans, SDL_Surface * dst,
+                          SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    if (blendMode == SDL_BLENDMODE_BLEND || blendMode == SDL_BLENDMODE_ADD) {
+        r = DRAW_MUL(r, a);
+        g = DRAW_MUL(g, a);
+        b = DRAW_MUL(b, a);
+    }
+    return SDL_PrepareBlendSpans(spans, dst, blendMode, r, g, b, a);
+}
+
+/* Draws horizontal and vertical lines, and the horizontal runs of X-major
+   lines, as span fills. Returns SDL_FALSE for lines left to the per pixel code */
+static SDL_bool
+SDL_BlendLineSpans(const SDL_BlendSpanInfo * spans, int x1, int y1, int x2, int y2,
+                   SDL_bool draw_end)
+{
+    int i, length;
+
+    if (y1 == y2) {
+        if (x1 <= x2) {
+            length = draw_end ? (x2-x1+1) : (x2-x1);
+            SDL_BlendFillSpan(spans, x1, y1, length);
+        } else {
+            length = draw_end ? (x1-x2+1) : (x1-x2);
+            SDL_BlendFillSpan(spans, draw_end ? x2 : x2 + 1, y1, length);
+        }
+        return SDL_TRUE;
+    } else if (x1 == x2) {
+        int y;
+        if (y1 <= y2) {
+            y = y1;
+            length = draw_end ? (y2-y1+1) : (y2-y1);
+        } else {
+            y = draw_end ? y2 : y2 + 1;
+            length = draw_end ? (y1-y2+1) : (y1-y2);
+        }
+        for (i = 0; i < length; ++i) {
+            SDL_BlendFillSpan(spans, x1, y + i, 1);
+        }
+        return SDL_TRUE;
+    }
+#ifndef AA_LINES
+    {
+        /* Walk the same pixels as BLINE and fill each row they cover at once */
+        const int deltax = ABS(x2 - x1);
+        const int deltay = ABS(y2 - y1);
+        const int xinc = (x1 > x2) ? -1 : 1;
+        const int yinc = (y1 > y2) ? -1 : 1;
+        const int dinc1 = deltay * 2;
+        const int dinc2 = (deltay - deltax) * 2;
+        int d = (2 * deltay) - deltax;
+        int numpixels = deltax + 1;
+        int x = x1, y = y1;
+        int runx = x1;
+
+        /* Diagonal and Y-major lines only have one pixel per row */
+        if (deltax <= deltay) {
+            return SDL_FALSE;
+        }
+        if (!draw_end) {
+            --numpixels;
+        }
+        length = 0;
+        for (i = 0; i < numpixels; ++i) {
+            ++length;
+            x += xinc;
+            if (d < 0) {
+                d += dinc1;
+            } else {
+                d += dinc2;
+                SDL_BlendFillSpan(spans, (xinc > 0) ? runx : x + 1, y, length);
+                y += yinc;
+                runx = x;
+                length = 0;
+            }
+        }
+        if (length) {
+            SDL_BlendFillSpan(spans, (xinc > 0) ? runx : x + 1, y, length);
+        }
+        return SDL_TRUE;
+    }
+#else
+    return SDL_FALSE;
+#endif
+}
+
 int
 SDL_BlendLine(SDL_Surface * dst, int x1, int y1, int x2, int y2,
               SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
     BlendLineFunc func;
+    SDL_BlendSpanInfo spans;
 
     if (!dst) {
         return SDL_SetError("SDL_BlendLine(): Passed NULL destination surface");
@@ -823,6 +914,11 @@ SDL_BlendLine(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         return 0;
     }
 
+    if (SDL_PrepareBlendLineSpans(&spans, dst, blendMode, r, g, b, a) &&
+        SDL_BlendLineSpans(&spans, x1, y1, x2, y2, SDL_TRUE)) {
+        return 0;
+    }
+
     func(dst, x1, y1, x2, y2, blendMode, r, g, b, a, SDL_TRUE);
     return 0;
 }
@@ -836,6 +932,8 @@ SDL_BlendLines(SDL_Surface * dst, const SDL_Point * points, int count,
     int x2, y2;
     SDL_bool draw_end;
     BlendLineFunc func;
+    SDL_BlendSpanInfo spans;
+    SDL_bool has_spans;
 
     if (!dst) {
         return SDL_SetError("SDL_BlendLines(): Passed NULL destination surface");
@@ -846,6 +944,8 @@ SDL_BlendLines(SDL_Surface * dst, const SDL_Point * points, int count,
         return SDL_SetError("SDL_BlendLines(): Unsupported surface format");
     }
 
+    has_spans = SDL_PrepareBlendLineSpans(&spans, dst, blendMode, r, g, b, a);
+
     for (i = 1; i < count; ++i) {
         x1 = points[i-1].x;
         y1 = points[i-1].y;
@@ -861,6 +961,9 @@ SDL_BlendLines(SDL_Surface * dst, const SDL_Point * points, int count,
         /* Draw the end if it was clipped */
         draw_end = (x2 != points[i].x || y2 != points[i].y);
 
+        if (has_spans && SDL_BlendLineSpans(&spans, x1, y1, x2, y2, draw_end)) {
+            continue;
+        }
         func(dst, x1, y1, x2, y2, blendMode, r, g, b, a, draw_end);
     }
     if (points[0].x != points[count-1].x || points[0].y != points[count-1].y) {
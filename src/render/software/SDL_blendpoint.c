@@ -23,6 +23,7 @@
 #if SDL_VIDEO_RENDER_SW && !SDL_RENDER_DISABLED
 
 #include "SDL_draw.h"
+#include "SDL_blendfillrect.h"
 #include "SDL_blendpoint.h"
 
 
@@ -285,6 +286,9 @@ SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count,
     int (*func)(SDL_Surface * dst, int x, int y,
                 SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a) = NULL;
     int status = 0;
+    SDL_BlendSpanInfo spans;
+    SDL_bool has_spans;
+    int length;
 
     if (!dst) {
         return SDL_SetError("Passed NULL destination surface");
@@ -340,6 +344,8 @@ SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count,
         }
     }
 
+    has_spans = SDL_PrepareBlendSpans(&spans, dst, blendMode, r, g, b, a);
+
     minx = dst->clip_rect.x;
     maxx = dst->clip_rect.x + dst->clip_rect.w - 1;
     miny = dst->clip_rect.y;
@@ -352,6 +358,21 @@ SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count,
         if (x < minx || x > maxx || y < miny || y > maxy) {
             continue;
         }
+
+        /* Points that continue a row left to right are filled as one span,
+           they are all distinct so the order they are blended in doesn't matter */
+        if (has_spans) {
+            length = 1;
+            while (i + length < count && points[i + length].y == y &&
+                   points[i + length].x == x + length && x + length <= maxx) {
+                ++length;
+            }
+            if (length > 1) {
+                SDL_BlendFillSpan(&spans, x, y, length);
+                i += length - 1;
+                continue;
+            }
+        }
         status = func(dst, x, y, blendMode, r, g, b, a);
     }
     return status;
@@ -34,6 +34,7 @@
 #include "SDL_drawpoint.h"
 #include "SDL_rotate.h"
 #include "SDL_triangle.h"
+#include "../../thread/SDL_systhread.h"
 
 /* SDL surface based renderer implementation */
 
@@ -44,10 +45,20 @@ typedef struct
     SDL_bool surface_cliprect_dirty;
 } SW_DrawStateCache;
 
+typedef struct SW_ReadbackData SW_ReadbackData;
+
 typedef struct
 {
     SDL_Surface *surface;
     SDL_Surface *window;
+
+    /* Converts readbacks in the background, started by the first one */
+    SDL_Thread *readback_thread;
+    SDL_mutex *readback_lock;
+    SDL_cond *readback_cond;
+    SW_ReadbackData *readback_queue;
+    SW_ReadbackData *readback_queue_tail;
+    SDL_bool readback_quit;
 } SW_RenderData;
 
 
@@ -76,6 +87,10 @@ SW_WindowEvent(SDL_Renderer * renderer, const SDL_WindowEvent *event)
     if (event->event == SDL_WINDOWEVENT_SIZE_CHANGED) {
         data->surface = NULL;
         data->window = NULL;
+        if (renderer->render_thread) {
+            /* The render thread can't get the new window surface itself */
+            SW_ActivateRenderer(renderer);
+        }
     }
 }
 
@@ -742,6 +757,7 @@ SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                 } else {
                     SDL_BlendPoints(surface, verts, count, blend, r, g, b, a);
                 }
+                renderer->run_draw_calls++;
                 break;
             }
 
@@ -769,6 +785,7 @@ SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                 } else {
                     SDL_BlendLines(surface, verts, count, blend, r, g, b, a);
                 }
+                renderer->run_draw_calls++;
                 break;
             }
 
@@ -796,35 +813,43 @@ SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                 } else {
                     SDL_BlendFillRects(surface, verts, count, blend, r, g, b, a);
                 }
+                renderer->run_draw_calls++;
                 break;
             }
 
             case SDL_RENDERCMD_COPY: {
                 SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const SDL_Rect *srcrect = verts;
-                SDL_Rect *dstrect = verts + 1;
+                const size_t count = cmd->data.draw.count;
                 SDL_Texture *texture = cmd->data.draw.texture;
                 SDL_Surface *src = (SDL_Surface *) texture->driverdata;
+                size_t i;
 
                 SetDrawState(surface, &drawstate);
 
                 PrepTextureForCopy(cmd);
 
-                /* Apply viewport */
-                if (drawstate.viewport->x || drawstate.viewport->y) {
-                    dstrect->x += drawstate.viewport->x;
-                    dstrect->y += drawstate.viewport->y;
-                }
+                /* Consecutive copies of the same texture are merged into one command */
+                for (i = 0; i < count; ++i, verts += 2) {
+                    const SDL_Rect *srcrect = verts;
+                    SDL_Rect *dstrect = verts + 1;
 
-                if ( srcrect->w == dstrect->w && srcrect->h == dstrect->h ) {
-                    SDL_BlitSurface(src, srcrect, surface, dstrect);
-                } else {
-                    /* If scaling is ever done, permanently disable RLE (which doesn't support scaling)
-                     * to avoid potentially frequent RLE encoding/decoding.
-                     */
-                    SDL_SetSurfaceRLE(surface, 0);
-                    SDL_PrivateUpperBlitScaled(src, srcrect, surface, dstrect, texture->scaleMode);
+                    /* Apply viewport */
+                    if (drawstate.viewport->x || drawstate.viewport->y) {
+                        dstrect->x += drawstate.viewport->x;
+                        dstrect->y += drawstate.viewport->y;
+                    }
+
+                    if ( srcrect->w == dstrect->w && srcrect->h == dstrect->h ) {
+                        SDL_BlitSurface(src, srcrect, surface, dstrect);
+                    } else {
+                        /* If scaling is ever done, permanently disable RLE (which doesn't support scaling)
+                         * to avoid potentially frequent RLE encoding/decoding.
+                         */
+                        SDL_SetSurfaceRLE(surface, 0);
+                        SDL_PrivateUpperBlitScaled(src, srcrect, surface, dstrect, texture->scaleMode);
+                    }
                 }
+                renderer->run_draw_calls += (Uint32) count;
                 break;
             }
 
@@ -841,6 +866,7 @@ SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
 
                 SW_RenderCopyEx(renderer, surface, cmd->data.draw.texture, &copydata->srcrect,
                                 &copydata->dstrect, copydata->angle, &copydata->center, copydata->flip);
+                renderer->run_draw_calls++;
                 break;
             }
 
@@ -899,6 +925,7 @@ SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                         SDL_SW_FillTriangle(surface, &(ptr[0].dst), &(ptr[1].dst), &(ptr[2].dst), blend, ptr[0].color, ptr[1].color, ptr[2].color);
                     }
                 }
+                renderer->run_draw_calls += (Uint32) (count / 3);
                 break;
             }
 
@@ -943,6 +970,230 @@ SW_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                              format, pixels, pitch);
 }
 
+/* The pixels of an SDL_RenderReadback, converted on the readback thread */
+struct SW_ReadbackData
+{
+    SDL_atomic_t done;
+    int status;
+    Uint32 src_format;
+    void *src_pixels;       /* a copy of the area read, in the surface format */
+    int src_pitch;
+    Uint32 format;
+    void *pixels;           /* the area read, in the format asked for */
+    int pitch;
+    int w, h;
+    SW_ReadbackData *next;  /* in the queue of the readback thread */
+};
+
+/* Copy rows of pixels that are already in the right format */
+static void
+SW_CopyRows(int row_bytes, int h, const void *src, int src_pitch, void *dst, int dst_pitch)
+{
+    const Uint8 *srcrow = (const Uint8 *) src;
+    Uint8 *dstrow = (Uint8 *) dst;
+
+    if (src_pitch == row_bytes && dst_pitch == row_bytes) {
+        SDL_memcpy(dstrow, srcrow, (size_t) row_bytes * h);
+        return;
+    }
+    while (h--) {
+        SDL_memcpy(dstrow, srcrow, row_bytes);
+        srcrow += src_pitch;
+        dstrow += dst_pitch;
+    }
+}
+
+static void
+SW_ConvertReadback(SW_ReadbackData *data)
+{
+    data->status = SDL_ConvertPixels(data->w, data->h,
+                                     data->src_format, data->src_pixels, data->src_pitch,
+                                     data->format, data->pixels, data->pitch);
+    SDL_AtomicSet(&data->done, 1);
+}
+
+static int SDLCALL
+SW_ReadbackThread(void *userdata)
+{
+    SW_RenderData *renderdata = (SW_RenderData *) userdata;
+
+    SDL_LockMutex(renderdata->readback_lock);
+    for ( ; ; ) {
+        SW_ReadbackData *data;
+
+        while (!renderdata->readback_queue && !renderdata->readback_quit) {
+            SDL_CondWait(renderdata->readback_cond, renderdata->readback_lock);
+        }
+        data = renderdata->readback_queue;
+        if (!data) {
+            break;
+        }
+        renderdata->readback_queue = data->next;
+        if (!renderdata->readback_queue) {
+            renderdata->readback_queue_tail = NULL;
+        }
+        data->next = NULL;
+
+        SDL_UnlockMutex(renderdata->readback_lock);
+        SW_ConvertReadback(data);
+        SDL_LockMutex(renderdata->readback_lock);
+
+        /* Wake up anybody destroying it */
+        SDL_CondBroadcast(renderdata->readback_cond);
+    }
+    SDL_UnlockMutex(renderdata->readback_lock);
+    return 0;
+}
+
+/* Queue a readback for the readback thread, returns -1 if there is no thread */
+static int
+SW_QueueReadback(SW_RenderData *renderdata, SW_ReadbackData *data)
+{
+    if (!renderdata->readback_thread) {
+        if (!renderdata->readback_lock) {
+            renderdata->readback_lock = SDL_CreateMutex();
+        }
+        if (!renderdata->readback_cond) {
+            renderdata->readback_cond = SDL_CreateCond();
+        }
+        if (!renderdata->readback_lock || !renderdata->readback_cond) {
+            return -1;
+        }
+        renderdata->readback_thread = SDL_CreateThreadInternal(SW_ReadbackThread, "SDLReadback", 0, renderdata);
+        if (!renderdata->readback_thread) {
+            return -1;
+        }
+    }
+
+    SDL_LockMutex(renderdata->readback_lock);
+    if (renderdata->readback_queue_tail) {
+        renderdata->readback_queue_tail->next = data;
+    } else {
+        renderdata->readback_queue = data;
+    }
+    renderdata->readback_queue_tail = data;
+    SDL_CondSignal(renderdata->readback_cond);
+    SDL_UnlockMutex(renderdata->readback_lock);
+    return 0;
+}
+
+/* Make sure the readback thread is done with a readback */
+static void
+SW_UnqueueReadback(SW_RenderData *renderdata, SW_ReadbackData *data)
+{
+    SW_ReadbackData *prev = NULL, *queued;
+
+    SDL_LockMutex(renderdata->readback_lock);
+    for (queued = renderdata->readback_queue; queued; prev = queued, queued = queued->next) {
+        if (queued == data) {
+            /* Not started yet, just take it out */
+            if (prev) {
+                prev->next = data->next;
+            } else {
+                renderdata->readback_queue = data->next;
+            }
+            if (renderdata->readback_queue_tail == data) {
+                renderdata->readback_queue_tail = prev;
+            }
+            SDL_UnlockMutex(renderdata->readback_lock);
+            return;
+        }
+    }
+    while (!SDL_AtomicGet(&data->done)) {
+        SDL_CondWait(renderdata->readback_cond, renderdata->readback_lock);
+    }
+    SDL_UnlockMutex(renderdata->readback_lock);
+}
+
+static void
+SW_DestroyReadback(SDL_Renderer * renderer, SDL_RenderReadback * readback)
+{
+    SW_ReadbackData *data = (SW_ReadbackData *) readback->driverdata;
+
+    if (!SDL_AtomicGet(&data->done)) {
+        SW_UnqueueReadback((SW_RenderData *) renderer->driverdata, data);
+    }
+    if (data->pixels != data->src_pixels) {
+        SDL_free(data->pixels);
+    }
+    SDL_free(data->src_pixels);
+    SDL_free(data);
+    readback->driverdata = NULL;
+}
+
+static int
+SW_RenderReadPixelsAsync(SDL_Renderer * renderer, SDL_RenderReadback * readback)
+{
+    SDL_Surface *surface = SW_ActivateRenderer(renderer);
+    const SDL_Rect *rect = &readback->rect;
+    SW_ReadbackData *data;
+
+    if (!surface) {
+        return -1;
+    }
+
+    if (rect->x < 0 || rect->x+rect->w > surface->w ||
+        rect->y < 0 || rect->y+rect->h > surface->h) {
+        return SDL_SetError("Tried to read outside of surface bounds");
+    }
+
+    data = (SW_ReadbackData *) SDL_calloc(1, sizeof(*data));
+    if (!data) {
+        return SDL_OutOfMemory();
+    }
+    readback->driverdata = data;
+    data->w = rect->w;
+    data->h = rect->h;
+
+    /* Only the copy of the area is done here, the surface keeps being drawn to */
+    data->src_format = surface->format->format;
+    data->src_pitch = rect->w * surface->format->BytesPerPixel;
+    data->src_pixels = SDL_malloc(rect->h * data->src_pitch);
+    if (!data->src_pixels) {
+        SW_DestroyReadback(renderer, readback);
+        return SDL_OutOfMemory();
+    }
+    SW_CopyRows(data->src_pitch, rect->h,
+                (Uint8 *) surface->pixels + rect->y * surface->pitch + rect->x * surface->format->BytesPerPixel,
+                surface->pitch, data->src_pixels, data->src_pitch);
+
+    data->format = readback->format;
+    if (data->format == data->src_format) {
+        data->pixels = data->src_pixels;
+        data->pitch = data->src_pitch;
+        SDL_AtomicSet(&data->done, 1);
+        return 0;
+    }
+
+    data->pitch = rect->w * SDL_BYTESPERPIXEL(data->format);
+    data->pixels = SDL_malloc(rect->h * data->pitch);
+    if (!data->pixels) {
+        SW_DestroyReadback(renderer, readback);
+        return SDL_OutOfMemory();
+    }
+    if (SW_QueueReadback((SW_RenderData *) renderer->driverdata, data) < 0) {
+        /* No readback thread, convert them now */
+        SW_ConvertReadback(data);
+    }
+    return 0;
+}
+
+static int
+SW_GetReadbackPixels(SDL_Renderer * renderer, SDL_RenderReadback * readback,
+                     void * pixels, int pitch)
+{
+    SW_ReadbackData *data = (SW_ReadbackData *) readback->driverdata;
+
+    if (!SDL_AtomicGet(&data->done)) {
+        return 1;
+    }
+    if (data->status < 0) {
+        return SDL_SetError("Couldn't convert the pixels to %s", SDL_GetPixelFormatName(data->format));
+    }
+    SW_CopyRows(data->w * SDL_BYTESPERPIXEL(data->format), data->h, data->pixels, data->pitch, pixels, pitch);
+    return 0;
+}
+
 static void
 SW_RenderPresent(SDL_Renderer * renderer)
 {
@@ -966,6 +1217,21 @@ SW_DestroyRenderer(SDL_Renderer * renderer)
 {
     SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
 
+    if (data) {
+        if (data->readback_thread) {
+            SDL_LockMutex(data->readback_lock);
+            data->readback_quit = SDL_TRUE;
+            SDL_CondSignal(data->readback_cond);
+            SDL_UnlockMutex(data->readback_lock);
+            SDL_WaitThread(data->readback_thread, NULL);
+        }
+        if (data->readback_cond) {
+            SDL_DestroyCond(data->readback_cond);
+        }
+        if (data->readback_lock) {
+            SDL_DestroyMutex(data->readback_lock);
+        }
+    }
     SDL_free(data);
     SDL_free(renderer);
 }
@@ -1014,11 +1280,18 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     renderer->QueueGeometry = SW_QueueGeometry;
     renderer->RunCommandQueue = SW_RunCommandQueue;
     renderer->RenderReadPixels = SW_RenderReadPixels;
+    renderer->RenderReadPixelsAsync = SW_RenderReadPixelsAsync;
+    renderer->GetReadbackPixels = SW_GetReadbackPixels;
+    renderer->DestroyReadback = SW_DestroyReadback;
     renderer->RenderPresent = SW_RenderPresent;
     renderer->DestroyTexture = SW_DestroyTexture;
     renderer->DestroyRenderer = SW_DestroyRenderer;
     renderer->info = SW_RenderDriver.info;
     renderer->driverdata = data;
+    renderer->merge_copies = SDL_TRUE;
+    renderer->merge_geometry = SDL_TRUE;
+    renderer->run_modifies_vertices = SDL_TRUE;
+    renderer->run_on_render_thread = SDL_TRUE;
 
     SW_ActivateRenderer(renderer);
 
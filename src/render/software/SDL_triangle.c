@@ -24,6 +24,7 @@
 
 #include "SDL_surface.h"
 #include "SDL_triangle.h"
+#include "SDL_blendfillrect.h"
 
 #include "../../video/SDL_blit.h"
 
@@ -188,6 +189,481 @@ static void bounding_rect(const SDL_Point *a, const SDL_Point *b, const SDL_Poin
         }                                                                                               \
     }                                                                                                   \
 
+/* Span rasterization
+ *
+ * Instead of testing the edge functions at every pixel of the bounding
+ * rect, the span paths work out where each row enters and leaves the
+ * triangle, which gives exactly the pixels the loops above accept.
+ * Texture coordinates and colors are the same truncated quotients
+ * (w0 * v0 + w1 * v1 + w2 * v2) / area, stepped along the span as an
+ * integer quotient and remainder instead of a 64 bits division per pixel,
+ * so they are unchanged as well.
+ *
+ * Texels and colors are gathered into a small buffer laid out like the
+ * destination, with alpha in the destination alpha byte or in its unused
+ * byte, and then modulated and blended in one go, SSE2 when available.
+ * The arithmetic is that of SDL_BlitTriangle_Slow().
+ */
+
+#if defined(__SSE2__) && SDL_BYTEORDER == SDL_LIL_ENDIAN
+#define HAVE_SSE2_TRIANGLE_SPANS 1
+#endif
+
+#define TRIANGLE_SPAN_CHUNK 64
+
+/* Edge functions over the clipped bounding rect, advanced row by row */
+typedef struct
+{
+    SDL_Rect dstrect;
+    int area;
+    int bias[3];
+    int step[3];        /* change of w0, w1, w2 for x += 1 */
+    int row_step[3];    /* change of w0, w1, w2 for y += 1 */
+    int row[3];         /* w0, w1, w2 at the start of the current row */
+} TriangleEdges;
+
+/* trunc(n / area) along a span, where n grows by the same amount per pixel */
+typedef struct
+{
+    int q;
+    Sint64 r;
+    int dq;
+    Sint64 dr;
+} TriangleLerp;
+
+/* Layout of the span buffers and destination pixels */
+typedef struct
+{
+    SDL_BlendMode blend;
+    int rshift, gshift, bshift, ashift;
+    SDL_bool dst_alpha;
+} TriangleSpanFormat;
+
+static Sint64 floor_div(Sint64 n, Sint64 d)
+{
+    Sint64 q = n / d;
+    if ((n % d) != 0 && n < 0) {
+        q--;
+    }
+    return q;
+}
+
+static void lerp_init(TriangleLerp *l, Sint64 n, Sint64 dn, int area)
+{
+    const Sint64 q = floor_div(n, area);
+    const Sint64 dq = floor_div(dn, area);
+    l->q = (int)q;
+    l->r = n - q * area;
+    l->dq = (int)dq;
+    l->dr = dn - dq * area;
+}
+
+/* Rounded toward zero, like the division in TRIANGLE_GET_TEXTCOORD */
+#define LERP_VALUE(l)           ((l).q + ((l).q < 0 && (l).r != 0))
+
+#define LERP_STEP(l, area)                                                                              \
+    (l).q += (l).dq;                                                                                    \
+    (l).r += (l).dr;                                                                                    \
+    if ((l).r >= (area)) {                                                                              \
+        (l).r -= (area);                                                                                \
+        (l).q++;                                                                                        \
+    }
+
+/* Set up the lerp of v0, v1, v2 at pixel x of the current row */
+static void lerp_init_row(TriangleLerp *l, const TriangleEdges *e, int x, int v0, int v1, int v2, Sint64 bias)
+{
+    const Sint64 w0 = e->row[0] + (Sint64)x * e->step[0];
+    const Sint64 w1 = e->row[1] + (Sint64)x * e->step[1];
+    const Sint64 w2 = e->row[2] + (Sint64)x * e->step[2];
+    lerp_init(l, w0 * v0 + w1 * v1 + w2 * v2 + bias,
+              (Sint64)e->step[0] * v0 + (Sint64)e->step[1] * v1 + (Sint64)e->step[2] * v2, e->area);
+}
+
+/* Pixels [*x0, *x1) of the current row for which every w + bias >= 0 */
+static void row_span(const TriangleEdges *e, int *x0, int *x1)
+{
+    Sint64 lo = 0;
+    Sint64 hi = e->dstrect.w;
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        const Sint64 v = (Sint64)e->row[i] + e->bias[i];
+        const Sint64 step = e->step[i];
+        if (step > 0) {
+            if (v < 0) {
+                lo = SDL_max(lo, (-v + step - 1) / step);
+            }
+        } else if (v < 0) {
+            hi = 0;
+        } else if (step < 0) {
+            hi = SDL_min(hi, v / -step + 1);
+        }
+    }
+    lo = SDL_min(lo, e->dstrect.w);
+    *x0 = (int)lo;
+    *x1 = (int)SDL_max(lo, SDL_min(hi, e->dstrect.w));
+}
+
+static void set_edges(TriangleEdges *e, const SDL_Rect *dstrect, int area, int bias_w0, int bias_w1, int bias_w2,
+        int d2d1_y, int d1d2_x, int d0d2_y, int d2d0_x, int d1d0_y, int d0d1_x, int w0_row, int w1_row, int w2_row)
+{
+    e->dstrect = *dstrect;
+    e->area = area;
+    e->bias[0] = bias_w0;
+    e->bias[1] = bias_w1;
+    e->bias[2] = bias_w2;
+    e->step[0] = d2d1_y;
+    e->step[1] = d0d2_y;
+    e->step[2] = d1d0_y;
+    e->row_step[0] = d1d2_x;
+    e->row_step[1] = d2d0_x;
+    e->row_step[2] = d0d1_x;
+    e->row[0] = w0_row;
+    e->row[1] = w1_row;
+    e->row[2] = w2_row;
+}
+
+static void next_row(TriangleEdges *e)
+{
+    e->row[0] += e->row_step[0];
+    e->row[1] += e->row_step[1];
+    e->row[2] += e->row_step[2];
+}
+
+/* 8888 formats with byte aligned channels, whatever their order */
+static SDL_bool is_8888(const SDL_PixelFormat *fmt)
+{
+    if (fmt->BytesPerPixel != 4 || fmt->Rloss || fmt->Gloss || fmt->Bloss ||
+        (fmt->Rshift | fmt->Gshift | fmt->Bshift) & 7) {
+        return SDL_FALSE;
+    }
+    if (fmt->Amask && (fmt->Aloss || (fmt->Ashift & 7))) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static void span_format(TriangleSpanFormat *f, const SDL_PixelFormat *fmt, SDL_BlendMode blend)
+{
+    f->blend = blend;
+    f->rshift = fmt->Rshift;
+    f->gshift = fmt->Gshift;
+    f->bshift = fmt->Bshift;
+    /* Without alpha, the unused byte carries it */
+    f->ashift = fmt->Amask ? fmt->Ashift : 48 - fmt->Rshift - fmt->Gshift - fmt->Bshift;
+    f->dst_alpha = fmt->Amask ? SDL_TRUE : SDL_FALSE;
+}
+
+#define SPAN_PACK(f, r, g, b, a) \
+    (((Uint32)(r) << (f)->rshift) | ((Uint32)(g) << (f)->gshift) | ((Uint32)(b) << (f)->bshift) | ((Uint32)(a) << (f)->ashift))
+
+#if HAVE_SSE2_TRIANGLE_SPANS
+/* x / 255, exact for every 16 bits x */
+static SDL_INLINE __m128i Div255_SSE2(__m128i x)
+{
+    return _mm_srli_epi16(_mm_mulhi_epu16(x, _mm_set1_epi16((short)0x8081)), 7);
+}
+
+/* Handles alpha in the top byte and the blend modes that fit 16 bits lanes,
+   returns how many pixels were done */
+static int combine_span_SSE2(Uint32 *dst, const Uint32 *src, const Uint32 *mod, int mod_step,
+                             int width, const TriangleSpanFormat *f)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i amask = _mm_set1_epi32((int)0xFF000000);
+    const __m128i rgb16 = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    const __m128i alpha16 = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    const __m128i c255 = _mm_set1_epi16(255);
+    const __m128i mconst = mod ? _mm_set1_epi32((int)mod[0]) : zero;
+    int i;
+
+    if (f->ashift != 24 || f->blend == SDL_BLENDMODE_MUL) {
+        return 0;
+    }
+
+    for (i = 0; i + 4 <= width; i += 4) {
+        const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        __m128i slo = _mm_unpacklo_epi8(s, zero);
+        __m128i shi = _mm_unpackhi_epi8(s, zero);
+        __m128i out;
+
+        if (mod) {
+            const __m128i m = mod_step ? _mm_loadu_si128((const __m128i *)(mod + i)) : mconst;
+            slo = Div255_SSE2(_mm_mullo_epi16(slo, _mm_unpacklo_epi8(m, zero)));
+            shi = Div255_SSE2(_mm_mullo_epi16(shi, _mm_unpackhi_epi8(m, zero)));
+        }
+        if (!f->dst_alpha) {
+            d = _mm_or_si128(d, amask);  /* read as opaque */
+        }
+
+        if (f->blend == SDL_BLENDMODE_BLEND || f->blend == SDL_BLENDMODE_ADD) {
+            /* Premultiply, the alpha lane is multiplied by 255 */
+            const __m128i alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(slo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            const __m128i ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(shi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            slo = Div255_SSE2(_mm_mullo_epi16(slo, _mm_or_si128(_mm_and_si128(alo, rgb16), alpha16)));
+            shi = Div255_SSE2(_mm_mullo_epi16(shi, _mm_or_si128(_mm_and_si128(ahi, rgb16), alpha16)));
+
+            if (f->blend == SDL_BLENDMODE_BLEND) {
+                const __m128i dlo = _mm_unpacklo_epi8(d, zero);
+                const __m128i dhi = _mm_unpackhi_epi8(d, zero);
+                slo = _mm_add_epi16(slo, Div255_SSE2(_mm_mullo_epi16(dlo, _mm_sub_epi16(c255, alo))));
+                shi = _mm_add_epi16(shi, Div255_SSE2(_mm_mullo_epi16(dhi, _mm_sub_epi16(c255, ahi))));
+                out = _mm_packus_epi16(slo, shi);
+            } else {
+                /* Destination alpha is kept */
+                out = _mm_adds_epu8(_mm_packus_epi16(slo, shi), d);
+                out = _mm_or_si128(_mm_andnot_si128(amask, out), _mm_and_si128(d, amask));
+            }
+        } else if (f->blend == SDL_BLENDMODE_MOD) {
+            const __m128i dlo = _mm_unpacklo_epi8(d, zero);
+            const __m128i dhi = _mm_unpackhi_epi8(d, zero);
+            out = _mm_packus_epi16(Div255_SSE2(_mm_mullo_epi16(slo, dlo)), Div255_SSE2(_mm_mullo_epi16(shi, dhi)));
+            out = _mm_or_si128(_mm_andnot_si128(amask, out), _mm_and_si128(d, amask));
+        } else {
+            out = _mm_packus_epi16(slo, shi);
+        }
+
+        if (!f->dst_alpha) {
+            out = _mm_andnot_si128(amask, out);
+        }
+        _mm_storeu_si128((__m128i *)(dst + i), out);
+    }
+    return i;
+}
+#endif /* HAVE_SSE2_TRIANGLE_SPANS */
+
+/* Modulate src by mod, if any, and blend it into width pixels of dst.
+   mod_step is 0 for a constant modulation and 1 for one per pixel. */
+static void combine_span(Uint32 *dst, const Uint32 *src, const Uint32 *mod, int mod_step,
+                         int width, const TriangleSpanFormat *f)
+{
+    const int rs = f->rshift, gs = f->gshift, bs = f->bshift, as = f->ashift;
+    int i = 0;
+
+#if HAVE_SSE2_TRIANGLE_SPANS
+    i = combine_span_SSE2(dst, src, mod, mod_step, width, f);
+#endif
+
+    for (; i < width; i++) {
+        const Uint32 s = src[i];
+        const Uint32 d = dst[i];
+        Uint32 srcR = (s >> rs) & 0xFF, srcG = (s >> gs) & 0xFF, srcB = (s >> bs) & 0xFF, srcA = (s >> as) & 0xFF;
+        Uint32 dstR = (d >> rs) & 0xFF, dstG = (d >> gs) & 0xFF, dstB = (d >> bs) & 0xFF;
+        Uint32 dstA = f->dst_alpha ? (d >> as) & 0xFF : 0xFF;
+
+        if (mod) {
+            const Uint32 m = mod[i * mod_step];
+            srcR = (srcR * ((m >> rs) & 0xFF)) / 255;
+            srcG = (srcG * ((m >> gs) & 0xFF)) / 255;
+            srcB = (srcB * ((m >> bs) & 0xFF)) / 255;
+            srcA = (srcA * ((m >> as) & 0xFF)) / 255;
+        }
+        if (f->blend == SDL_BLENDMODE_BLEND || f->blend == SDL_BLENDMODE_ADD) {
+            srcR = (srcR * srcA) / 255;
+            srcG = (srcG * srcA) / 255;
+            srcB = (srcB * srcA) / 255;
+        }
+        switch (f->blend) {
+        case SDL_BLENDMODE_BLEND:
+            dstR = srcR + ((255 - srcA) * dstR) / 255;
+            dstG = srcG + ((255 - srcA) * dstG) / 255;
+            dstB = srcB + ((255 - srcA) * dstB) / 255;
+            dstA = srcA + ((255 - srcA) * dstA) / 255;
+            break;
+        case SDL_BLENDMODE_ADD:
+            dstR = SDL_min(srcR + dstR, 255);
+            dstG = SDL_min(srcG + dstG, 255);
+            dstB = SDL_min(srcB + dstB, 255);
+            break;
+        case SDL_BLENDMODE_MOD:
+            dstR = (srcR * dstR) / 255;
+            dstG = (srcG * dstG) / 255;
+            dstB = (srcB * dstB) / 255;
+            break;
+        case SDL_BLENDMODE_MUL:
+            dstR = SDL_min(((srcR * dstR) + (dstR * (255 - srcA))) / 255, 255);
+            dstG = SDL_min(((srcG * dstG) + (dstG * (255 - srcA))) / 255, 255);
+            dstB = SDL_min(((srcB * dstB) + (dstB * (255 - srcA))) / 255, 255);
+            dstA = SDL_min(((srcA * dstA) + (dstA * (255 - srcA))) / 255, 255);
+            break;
+        default:
+            dstR = srcR;
+            dstG = srcG;
+            dstB = srcB;
+            dstA = srcA;
+            break;
+        }
+        dst[i] = (dstR << rs) | (dstG << gs) | (dstB << bs) | (f->dst_alpha ? dstA << as : 0);
+    }
+}
+
+/* Interpolate the vertex colors over a span, packed like the span buffers */
+static void lerp_colors(Uint32 *out, int width, const TriangleEdges *e, int x,
+                        SDL_Color c0, SDL_Color c1, SDL_Color c2, const TriangleSpanFormat *f)
+{
+    const int area = e->area;
+    TriangleLerp r, g, b, a;
+    int i;
+
+    lerp_init_row(&r, e, x, c0.r, c1.r, c2.r, 0);
+    lerp_init_row(&g, e, x, c0.g, c1.g, c2.g, 0);
+    lerp_init_row(&b, e, x, c0.b, c1.b, c2.b, 0);
+    lerp_init_row(&a, e, x, c0.a, c1.a, c2.a, 0);
+    for (i = 0; i < width; i++) {
+        out[i] = SPAN_PACK(f, LERP_VALUE(r), LERP_VALUE(g), LERP_VALUE(b), LERP_VALUE(a));
+        LERP_STEP(r, area);
+        LERP_STEP(g, area);
+        LERP_STEP(b, area);
+        LERP_STEP(a, area);
+    }
+}
+
+/* Span path of SDL_SW_FillTriangle(), returns SDL_FALSE if there is none for this case */
+static SDL_bool fill_triangle_spans(SDL_Surface *dst, TriangleEdges *e, SDL_BlendMode blend,
+                                    SDL_Color c0, SDL_Color c1, SDL_Color c2, int is_uniform)
+{
+    Uint8 *dst_row = (Uint8 *)dst->pixels + e->dstrect.y * dst->pitch + e->dstrect.x * 4;
+    TriangleSpanFormat f;
+    int y, x0, x1;
+
+    if (is_uniform) {
+        if (blend == SDL_BLENDMODE_NONE) {
+            const Uint32 color = SDL_MapRGBA(dst->format, c0.r, c0.g, c0.b, c0.a);
+            if (dst->format->BytesPerPixel != 4) {
+                return SDL_FALSE;
+            }
+            for (y = 0; y < e->dstrect.h; y++, dst_row += dst->pitch) {
+                row_span(e, &x0, &x1);
+                if (x0 < x1) {
+                    SDL_memset4(dst_row + x0 * 4, color, x1 - x0);
+                }
+                next_row(e);
+            }
+        } else {
+            SDL_BlendSpanInfo spans;
+            Uint8 r = c0.r, g = c0.g, b = c0.b;
+            if (blend == SDL_BLENDMODE_BLEND || blend == SDL_BLENDMODE_ADD) {
+                r = (Uint8)(((unsigned)r * c0.a) / 255);
+                g = (Uint8)(((unsigned)g * c0.a) / 255);
+                b = (Uint8)(((unsigned)b * c0.a) / 255);
+            }
+            if (!SDL_PrepareBlendSpans(&spans, dst, blend, r, g, b, c0.a)) {
+                return SDL_FALSE;
+            }
+            for (y = 0; y < e->dstrect.h; y++) {
+                row_span(e, &x0, &x1);
+                if (x0 < x1) {
+                    SDL_BlendFillSpan(&spans, e->dstrect.x + x0, e->dstrect.y + y, x1 - x0);
+                }
+                next_row(e);
+            }
+        }
+        return SDL_TRUE;
+    }
+
+    /* Gouraud shading */
+    if (!is_8888(dst->format)) {
+        return SDL_FALSE;
+    }
+    span_format(&f, dst->format, blend);
+    for (y = 0; y < e->dstrect.h; y++, dst_row += dst->pitch) {
+        row_span(e, &x0, &x1);
+        while (x0 < x1) {
+            const int n = SDL_min(x1 - x0, TRIANGLE_SPAN_CHUNK);
+            Uint32 *pixels = (Uint32 *)dst_row + x0;
+            if (blend == SDL_BLENDMODE_NONE) {
+                int i;
+                lerp_colors(pixels, n, e, x0, c0, c1, c2, &f);
+                if (!f.dst_alpha) {
+                    const Uint32 rgbmask = dst->format->Rmask | dst->format->Gmask | dst->format->Bmask;
+                    for (i = 0; i < n; i++) {
+                        pixels[i] &= rgbmask;
+                    }
+                }
+            } else {
+                Uint32 colors[TRIANGLE_SPAN_CHUNK];
+                lerp_colors(colors, n, e, x0, c0, c1, c2, &f);
+                combine_span(pixels, colors, NULL, 0, n, &f);
+            }
+            x0 += n;
+        }
+        next_row(e);
+    }
+    return SDL_TRUE;
+}
+
+/* Span path of SDL_SW_BlitTriangle(), returns SDL_FALSE if there is none for this case */
+static SDL_bool blit_triangle_spans(SDL_Surface *src, SDL_Surface *dst, TriangleEdges *e,
+                                    SDL_BlendMode blend, const SDL_Point *s0, const SDL_Point *s1, const SDL_Point *s2,
+                                    SDL_Point s2_x_area, SDL_Color c0, SDL_Color c1, SDL_Color c2,
+                                    int is_uniform, int has_modulation)
+{
+    const SDL_PixelFormat *sfmt = src->format;
+    const int area = e->area;
+    const int s2s0_x = s0->x - s2->x, s2s1_x = s1->x - s2->x;
+    const int s2s0_y = s0->y - s2->y, s2s1_y = s1->y - s2->y;
+    Uint8 *dst_row = (Uint8 *)dst->pixels + e->dstrect.y * dst->pitch + e->dstrect.x * 4;
+    const Uint8 *src_pixels = (const Uint8 *)src->pixels;
+    const int src_pitch = src->pitch;
+    TriangleSpanFormat f;
+    SDL_bool raw, convert;
+    Uint32 modconst;
+    int y, x0, x1;
+
+    if (!is_8888(sfmt) || !is_8888(dst->format) || (src->map->info.flags & SDL_COPY_COLORKEY)) {
+        return SDL_FALSE;
+    }
+    span_format(&f, dst->format, blend);
+
+    /* Texels go straight to the destination when there is nothing to do with them */
+    raw = (blend == SDL_BLENDMODE_NONE && !has_modulation && sfmt->format == dst->format->format);
+    /* Otherwise they are converted to the span layout, unless they already are */
+    convert = !(sfmt->Rshift == f.rshift && sfmt->Gshift == f.gshift && sfmt->Bshift == f.bshift &&
+                sfmt->Amask && sfmt->Ashift == f.ashift);
+    modconst = SPAN_PACK(&f, c0.r, c0.g, c0.b, c0.a);
+
+    for (y = 0; y < e->dstrect.h; y++, dst_row += dst->pitch) {
+        row_span(e, &x0, &x1);
+        while (x0 < x1) {
+            const int n = SDL_min(x1 - x0, TRIANGLE_SPAN_CHUNK);
+            Uint32 *pixels = (Uint32 *)dst_row + x0;
+            Uint32 texels[TRIANGLE_SPAN_CHUNK];
+            Uint32 *out = raw ? pixels : texels;
+            TriangleLerp u, v;
+            int i;
+
+            lerp_init_row(&u, e, x0, s2s0_x, s2s1_x, 0, s2_x_area.x);
+            lerp_init_row(&v, e, x0, s2s0_y, s2s1_y, 0, s2_x_area.y);
+            for (i = 0; i < n; i++) {
+                out[i] = *(const Uint32 *)(src_pixels + LERP_VALUE(v) * src_pitch + LERP_VALUE(u) * 4);
+                LERP_STEP(u, area);
+                LERP_STEP(v, area);
+            }
+
+            if (!raw) {
+                if (convert) {
+                    for (i = 0; i < n; i++) {
+                        const Uint32 t = texels[i];
+                        texels[i] = SPAN_PACK(&f, (t >> sfmt->Rshift) & 0xFF, (t >> sfmt->Gshift) & 0xFF,
+                                              (t >> sfmt->Bshift) & 0xFF, sfmt->Amask ? (t >> sfmt->Ashift) & 0xFF : 0xFF);
+                    }
+                }
+                if (!is_uniform) {
+                    Uint32 colors[TRIANGLE_SPAN_CHUNK];
+                    lerp_colors(colors, n, e, x0, c0, c1, c2, &f);
+                    combine_span(pixels, texels, colors, 1, n, &f);
+                } else {
+                    combine_span(pixels, texels, has_modulation ? &modconst : NULL, 0, n, &f);
+                }
+            }
+            x0 += n;
+        }
+        next_row(e);
+    }
+    return SDL_TRUE;
+}
+
 int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Point *d2, SDL_BlendMode blend, SDL_Color c0, SDL_Color c1, SDL_Color c2)
 {
     int ret = 0;
@@ -209,6 +685,8 @@ int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poin
 
     SDL_Surface *tmp = NULL;
 
+    TriangleEdges edges;
+
     if (dst == NULL) {
         return -1;
     }
@@ -252,39 +730,6 @@ int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poin
     }
 
 
-    if (blend != SDL_BLENDMODE_NONE) {
-        int format = dst->format->format;
-
-        /* need an alpha format */
-        if (! dst->format->Amask) {
-            format = SDL_PIXELFORMAT_ARGB8888;
-        }
-
-        /* Use an intermediate surface */
-        tmp = SDL_CreateRGBSurfaceWithFormat(0, dstrect.w, dstrect.h, 0, format);
-        if (tmp == NULL) {
-            ret = -1;
-            goto end;
-        }
-
-        if (blend == SDL_BLENDMODE_MOD) {
-            Uint32 c = SDL_MapRGBA(tmp->format, 255, 255, 255, 255);
-            SDL_FillRect(tmp, NULL, c);
-        }
-
-        SDL_SetSurfaceBlendMode(tmp, blend);
-
-        dstbpp = tmp->format->BytesPerPixel;
-        dst_ptr = tmp->pixels;
-        dst_pitch = tmp->pitch;
-
-    } else {
-        /* Write directly to destination surface */
-        dstbpp = dst->format->BytesPerPixel;
-        dst_ptr = (Uint8 *)dst->pixels + dstrect.x * dstbpp + dstrect.y * dst->pitch;
-        dst_pitch = dst->pitch;
-    }
-
     is_clockwise = area > 0;
     area = SDL_abs(area);
 
@@ -326,6 +771,45 @@ int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poin
     bias_w1 = (is_top_left(d2, d0, is_clockwise) ? 0 : -1);
     bias_w2 = (is_top_left(d0, d1, is_clockwise) ? 0 : -1);
 
+    set_edges(&edges, &dstrect, area, bias_w0, bias_w1, bias_w2,
+            d2d1_y, d1d2_x, d0d2_y, d2d0_x, d1d0_y, d0d1_x, w0_row, w1_row, w2_row);
+    if (fill_triangle_spans(dst, &edges, blend, c0, c1, c2, is_uniform)) {
+        goto end;
+    }
+
+    if (blend != SDL_BLENDMODE_NONE) {
+        int format = dst->format->format;
+
+        /* need an alpha format */
+        if (! dst->format->Amask) {
+            format = SDL_PIXELFORMAT_ARGB8888;
+        }
+
+        /* Use an intermediate surface */
+        tmp = SDL_CreateRGBSurfaceWithFormat(0, dstrect.w, dstrect.h, 0, format);
+        if (tmp == NULL) {
+            ret = -1;
+            goto end;
+        }
+
+        if (blend == SDL_BLENDMODE_MOD) {
+            Uint32 c = SDL_MapRGBA(tmp->format, 255, 255, 255, 255);
+            SDL_FillRect(tmp, NULL, c);
+        }
+
+        SDL_SetSurfaceBlendMode(tmp, blend);
+
+        dstbpp = tmp->format->BytesPerPixel;
+        dst_ptr = tmp->pixels;
+        dst_pitch = tmp->pitch;
+
+    } else {
+        /* Write directly to destination surface */
+        dstbpp = dst->format->BytesPerPixel;
+        dst_ptr = (Uint8 *)dst->pixels + dstrect.x * dstbpp + dstrect.y * dst->pitch;
+        dst_pitch = dst->pitch;
+    }
+
     if (is_uniform) {
         Uint32 color;
         if (tmp) {
@@ -462,6 +946,8 @@ int SDL_SW_BlitTriangle(
 
     int has_modulation;
 
+    TriangleEdges edges;
+
     if (src == NULL || dst == NULL) {
         return -1;
     }
@@ -586,6 +1072,12 @@ int SDL_SW_BlitTriangle(
     s2_x_area.x = s2->x * area;
     s2_x_area.y = s2->y * area;
 
+    set_edges(&edges, &dstrect, area, bias_w0, bias_w1, bias_w2,
+            d2d1_y, d1d2_x, d0d2_y, d2d0_x, d1d0_y, d0d1_x, w0_row, w1_row, w2_row);
+    if (blit_triangle_spans(src, dst, &edges, blend, s0, s1, s2, s2_x_area, c0, c1, c2, is_uniform, has_modulation)) {
+        goto end;
+    }
+
     if (blend != SDL_BLENDMODE_NONE || src->format->format != dst->format->format || has_modulation || ! is_uniform) {
         /* Use SDL_BlitTriangle_Slow */
 
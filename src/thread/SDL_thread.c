@@ -29,6 +29,17 @@
 #include "../SDL_error_c.h"
 
 
+#ifdef SDL_THREAD_LOCAL
+/* The TLS array lives in compiler-provided thread-local storage, so looking
+   it up is a plain memory access instead of a call into the OS. */
+static SDL_THREAD_LOCAL SDL_TLSData *SDL_tls_storage;
+#define GET_TLS_STORAGE()           SDL_tls_storage
+#define SET_TLS_STORAGE(storage)    (SDL_tls_storage = (storage), 0)
+#else
+#define GET_TLS_STORAGE()           SDL_SYS_GetTLSData()
+#define SET_TLS_STORAGE(storage)    SDL_SYS_SetTLSData(storage)
+#endif
+
 SDL_TLSID
 SDL_TLSCreate()
 {
@@ -41,7 +52,7 @@ SDL_TLSGet(SDL_TLSID id)
 {
     SDL_TLSData *storage;
 
-    storage = SDL_SYS_GetTLSData();
+    storage = GET_TLS_STORAGE();
     if (!storage || id == 0 || id > storage->limit) {
         return NULL;
     }
@@ -57,7 +68,7 @@ SDL_TLSSet(SDL_TLSID id, const void *value, void (SDLCALL *destructor)(void *))
         return SDL_InvalidParamError("id");
     }
 
-    storage = SDL_SYS_GetTLSData();
+    storage = GET_TLS_STORAGE();
     if (!storage || (id > storage->limit)) {
         unsigned int i, oldlimit, newlimit;
 
@@ -72,7 +83,7 @@ SDL_TLSSet(SDL_TLSID id, const void *value, void (SDLCALL *destructor)(void *))
             storage->array[i].data = NULL;
             storage->array[i].destructor = NULL;
         }
-        if (SDL_SYS_SetTLSData(storage) != 0) {
+        if (SET_TLS_STORAGE(storage) != 0) {
             return -1;
         }
     }
@@ -87,7 +98,7 @@ SDL_TLSCleanup()
 {
     SDL_TLSData *storage;
 
-    storage = SDL_SYS_GetTLSData();
+    storage = GET_TLS_STORAGE();
     if (storage) {
         unsigned int i;
         for (i = 0; i < storage->limit; ++i) {
@@ -95,7 +106,7 @@ SDL_TLSCleanup()
                 storage->array[i].destructor(storage->array[i].data);
             }
         }
-        SDL_SYS_SetTLSData(NULL);
+        (void) SET_TLS_STORAGE(NULL);
         SDL_free(storage);
     }
 }
@@ -208,6 +219,10 @@ SDL_GetErrBuf(void)
     /* Non-thread-safe global error variable */
     static SDL_error SDL_global_error;
     return &SDL_global_error;
+#elif defined(SDL_THREAD_LOCAL)
+    /* Each thread gets its own statically allocated error buffer */
+    static SDL_THREAD_LOCAL SDL_error SDL_thread_errbuf;
+    return &SDL_thread_errbuf;
 #else
     static SDL_SpinLock tls_lock;
     static SDL_bool tls_being_created;
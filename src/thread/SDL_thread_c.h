@@ -85,6 +85,17 @@ typedef struct {
 /* This is how many TLS entries we allocate at once */
 #define TLS_ALLOC_CHUNKSIZE 4
 
+/* Compiler-provided thread-local storage, used for SDL's own per-thread data
+   so it doesn't have to go through SDL_SYS_GetTLSData() on every access.
+ */
+#if HAVE_THREAD_LOCAL && !SDL_THREADS_DISABLED
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+#define SDL_THREAD_LOCAL _Thread_local
+#else
+#define SDL_THREAD_LOCAL __thread
+#endif
+#endif
+
 /* Get cross-platform, slow, thread local storage for this thread.
    This is only intended as a fallback if getting real thread-local
    storage fails or isn't supported on this platform.
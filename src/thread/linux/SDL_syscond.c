@@ -0,0 +1,131 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+/* Condition variable built directly on futex(2).
+
+   Waiters sleep on a sequence counter that is bumped by every signal, so a
+   signal that arrives between unlocking the mutex and going to sleep is
+   never lost. Signaling a condition nobody waits on doesn't enter the kernel.
+ */
+
+#include "SDL_thread.h"
+#include "SDL_sysfutex_c.h"
+
+struct SDL_cond
+{
+    int seq;
+    int waiters;
+};
+
+/* Create a condition variable */
+SDL_cond *
+SDL_CreateCond(void)
+{
+    SDL_cond *cond;
+
+    cond = (SDL_cond *) SDL_calloc(1, sizeof(SDL_cond));
+    if (!cond) {
+        SDL_OutOfMemory();
+    }
+    return (cond);
+}
+
+/* Destroy a condition variable */
+void
+SDL_DestroyCond(SDL_cond * cond)
+{
+    if (cond) {
+        SDL_free(cond);
+    }
+}
+
+/* Restart one of the threads that are waiting on the condition variable */
+int
+SDL_CondSignal(SDL_cond * cond)
+{
+    if (!cond) {
+        return SDL_SetError("Passed a NULL condition variable");
+    }
+
+    __sync_fetch_and_add(&cond->seq, 1);
+    if (*(volatile int *) &cond->waiters > 0) {
+        SDL_FutexWake(&cond->seq, 1);
+    }
+    return 0;
+}
+
+/* Restart all threads that are waiting on the condition variable */
+int
+SDL_CondBroadcast(SDL_cond * cond)
+{
+    if (!cond) {
+        return SDL_SetError("Passed a NULL condition variable");
+    }
+
+    __sync_fetch_and_add(&cond->seq, 1);
+    if (*(volatile int *) &cond->waiters > 0) {
+        SDL_FutexWake(&cond->seq, INT_MAX);
+    }
+    return 0;
+}
+
+/* Wait on the condition variable for at most 'ms' milliseconds.
+   The mutex must be locked before entering this function!
+   The mutex is unlocked during the wait, and locked again after the wait.
+ */
+int
+SDL_CondWaitTimeout(SDL_cond * cond, SDL_mutex * mutex, Uint32 ms)
+{
+    int seq;
+    int retval;
+
+    if (!cond) {
+        return SDL_SetError("Passed a NULL condition variable");
+    }
+    if (!mutex) {
+        return SDL_SetError("Passed a NULL mutex");
+    }
+
+    __sync_fetch_and_add(&cond->waiters, 1);
+    seq = *(volatile int *) &cond->seq;
+
+    if (SDL_UnlockMutex(mutex) < 0) {
+        __sync_fetch_and_sub(&cond->waiters, 1);
+        return -1;
+    }
+
+    retval = SDL_FutexWait(&cond->seq, seq, ms);
+
+    SDL_LockMutex(mutex);
+    __sync_fetch_and_sub(&cond->waiters, 1);
+
+    return retval;
+}
+
+/* Wait on the condition variable forever */
+int
+SDL_CondWait(SDL_cond * cond, SDL_mutex * mutex)
+{
+    return SDL_CondWaitTimeout(cond, mutex, SDL_MUTEX_MAXWAIT);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,70 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+#ifndef SDL_sysfutex_c_h_
+#define SDL_sysfutex_c_h_
+
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include "SDL_mutex.h"
+
+/* Thin wrappers around futex(2) shared by the Linux mutex, semaphore and
+   condition variable implementations. All futex words are process-private. */
+
+/* Sleep while *addr == val. Returns 0 when woken (possibly spuriously),
+   or SDL_MUTEX_TIMEDOUT if `ms` milliseconds passed first. */
+static SDL_INLINE int
+SDL_FutexWait(int *addr, int val, Uint32 ms)
+{
+    struct timespec timeout;
+    struct timespec *ptimeout = NULL;
+
+    if (ms != SDL_MUTEX_MAXWAIT) {
+        timeout.tv_sec = ms / 1000;
+        timeout.tv_nsec = (long) (ms % 1000) * 1000000;
+        ptimeout = &timeout;
+    }
+
+    if (syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, ptimeout, NULL, 0) < 0) {
+        if (errno == ETIMEDOUT) {
+            return SDL_MUTEX_TIMEDOUT;
+        }
+        /* EAGAIN (value changed) and EINTR are treated as wakeups. */
+    }
+    return 0;
+}
+
+/* Wake up to `count` threads sleeping on addr. */
+static SDL_INLINE void
+SDL_FutexWake(int *addr, int count)
+{
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+#endif /* SDL_sysfutex_c_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,153 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+/* Recursive mutex built directly on futex(2).
+
+   The lock word is 0 (unlocked), 1 (locked) or 2 (locked, maybe waiters),
+   as described in Ulrich Drepper's "Futexes Are Tricky". Locking and
+   unlocking an uncontended mutex never enters the kernel.
+ */
+
+#include "SDL_thread.h"
+#include "SDL_sysfutex_c.h"
+
+struct SDL_mutex
+{
+    int state;
+    int recursive;
+    SDL_threadID owner;
+};
+
+SDL_mutex *
+SDL_CreateMutex(void)
+{
+    SDL_mutex *mutex;
+
+    /* Allocate the structure */
+    mutex = (SDL_mutex *) SDL_calloc(1, sizeof(*mutex));
+    if (!mutex) {
+        SDL_OutOfMemory();
+    }
+    return mutex;
+}
+
+void
+SDL_DestroyMutex(SDL_mutex * mutex)
+{
+    if (mutex) {
+        /* There are no kernel allocated resources */
+        SDL_free(mutex);
+    }
+}
+
+/* Lock the mutex */
+int
+SDL_LockMutex(SDL_mutex * mutex)
+{
+    SDL_threadID this_thread;
+    int state;
+
+    if (mutex == NULL) {
+        return SDL_SetError("Passed a NULL mutex");
+    }
+
+    this_thread = SDL_ThreadID();
+    if (mutex->owner == this_thread) {
+        ++mutex->recursive;
+        return 0;
+    }
+
+    state = __sync_val_compare_and_swap(&mutex->state, 0, 1);
+    if (state != 0) {
+        /* Contended: flag that there are waiters and sleep until released. */
+        if (state != 2) {
+            state = __sync_lock_test_and_set(&mutex->state, 2);
+        }
+        while (state != 0) {
+            SDL_FutexWait(&mutex->state, 2, SDL_MUTEX_MAXWAIT);
+            state = __sync_lock_test_and_set(&mutex->state, 2);
+        }
+    }
+
+    /* The order of operations is important.
+       We set the locking thread id after we obtain the lock
+       so unlocks from other threads will fail.
+     */
+    mutex->owner = this_thread;
+    mutex->recursive = 0;
+    return 0;
+}
+
+int
+SDL_TryLockMutex(SDL_mutex * mutex)
+{
+    SDL_threadID this_thread;
+
+    if (mutex == NULL) {
+        return SDL_SetError("Passed a NULL mutex");
+    }
+
+    this_thread = SDL_ThreadID();
+    if (mutex->owner == this_thread) {
+        ++mutex->recursive;
+        return 0;
+    }
+
+    if (!__sync_bool_compare_and_swap(&mutex->state, 0, 1)) {
+        return SDL_MUTEX_TIMEDOUT;
+    }
+    mutex->owner = this_thread;
+    mutex->recursive = 0;
+    return 0;
+}
+
+int
+SDL_UnlockMutex(SDL_mutex * mutex)
+{
+    if (mutex == NULL) {
+        return SDL_SetError("Passed a NULL mutex");
+    }
+
+    /* We can only unlock the mutex if we own it */
+    if (SDL_ThreadID() != mutex->owner) {
+        return SDL_SetError("mutex not owned by this thread");
+    }
+
+    if (mutex->recursive) {
+        --mutex->recursive;
+        return 0;
+    }
+
+    /* The order of operations is important.
+       First reset the owner so another thread doesn't lock
+       the mutex and set the ownership before we reset it,
+       then release the lock word and wake a waiter if there was one.
+     */
+    mutex->owner = 0;
+    if (__sync_fetch_and_sub(&mutex->state, 1) != 1) {
+        __sync_lock_release(&mutex->state);
+        SDL_FutexWake(&mutex->state, 1);
+    }
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,165 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+/* Counting semaphore built directly on futex(2).
+
+   Posting and waiting on a semaphore that nobody is blocked on is a single
+   atomic operation, so it's safe to use from the audio thread without
+   making system calls.
+ */
+
+#include "SDL_thread.h"
+#include "SDL_timer.h"
+#include "SDL_sysfutex_c.h"
+
+struct SDL_semaphore
+{
+    int count;
+    int waiters;
+};
+
+/* Create a semaphore, initialized with value */
+SDL_sem *
+SDL_CreateSemaphore(Uint32 initial_value)
+{
+    SDL_sem *sem;
+
+    if (initial_value > (Uint32) INT_MAX) {
+        SDL_SetError("Semaphore initial value too large");
+        return NULL;
+    }
+
+    sem = (SDL_sem *) SDL_calloc(1, sizeof(*sem));
+    if (sem) {
+        sem->count = (int) initial_value;
+    } else {
+        SDL_OutOfMemory();
+    }
+    return sem;
+}
+
+void
+SDL_DestroySemaphore(SDL_sem * sem)
+{
+    if (sem) {
+        SDL_free(sem);
+    }
+}
+
+int
+SDL_SemTryWait(SDL_sem * sem)
+{
+    int count;
+
+    if (!sem) {
+        return SDL_SetError("Passed a NULL semaphore");
+    }
+
+    count = *(volatile int *) &sem->count;
+    while (count > 0) {
+        const int prev = __sync_val_compare_and_swap(&sem->count, count, count - 1);
+        if (prev == count) {
+            return 0;
+        }
+        count = prev;
+    }
+    return SDL_MUTEX_TIMEDOUT;
+}
+
+int
+SDL_SemWaitTimeout(SDL_sem * sem, Uint32 timeout)
+{
+    Uint32 start = 0;
+    Uint32 remaining = timeout;
+    int retval;
+
+    if (!sem) {
+        return SDL_SetError("Passed a NULL semaphore");
+    }
+
+    /* Try the easy cases first */
+    retval = SDL_SemTryWait(sem);
+    if (retval != SDL_MUTEX_TIMEDOUT || timeout == 0) {
+        return retval;
+    }
+
+    if (timeout != SDL_MUTEX_MAXWAIT) {
+        start = SDL_GetTicks();
+    }
+
+    for ( ; ; ) {
+        /* Advertise that we're about to sleep, then only sleep if the count
+           is still zero; a post in between makes the futex return at once. */
+        __sync_fetch_and_add(&sem->waiters, 1);
+        retval = SDL_FutexWait(&sem->count, 0, remaining);
+        __sync_fetch_and_sub(&sem->waiters, 1);
+
+        if (SDL_SemTryWait(sem) == 0) {
+            return 0;
+        }
+        if (retval == SDL_MUTEX_TIMEDOUT) {
+            return SDL_MUTEX_TIMEDOUT;
+        }
+        if (timeout != SDL_MUTEX_MAXWAIT) {
+            const Uint32 elapsed = SDL_GetTicks() - start;
+            if (elapsed >= timeout) {
+                return SDL_MUTEX_TIMEDOUT;
+            }
+            remaining = timeout - elapsed;
+        }
+    }
+}
+
+int
+SDL_SemWait(SDL_sem * sem)
+{
+    return SDL_SemWaitTimeout(sem, SDL_MUTEX_MAXWAIT);
+}
+
+Uint32
+SDL_SemValue(SDL_sem * sem)
+{
+    int value = 0;
+    if (sem) {
+        value = *(volatile int *) &sem->count;
+        if (value < 0) {
+            value = 0;
+        }
+    }
+    return (Uint32) value;
+}
+
+int
+SDL_SemPost(SDL_sem * sem)
+{
+    if (!sem) {
+        return SDL_SetError("Passed a NULL semaphore");
+    }
+
+    __sync_fetch_and_add(&sem->count, 1);
+    if (*(volatile int *) &sem->waiters > 0) {
+        SDL_FutexWake(&sem->count, 1);
+    }
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -492,4 +492,35 @@ SDL_GetTicks(void)
     return (Uint32) (SDL_GetTicks64() & 0xFFFFFFFF);
 }
 
+#if !SDL_TIMER_UNIX && !SDL_TIMER_WINDOWS
+/* Platforms without a native nanosecond tick source use the performance
+   counter to measure time within the current millisecond tick, so both
+   clocks always agree and the result never goes backwards. */
+Uint64
+SDL_GetTicksNS(void)
+{
+    static SDL_SpinLock lock;
+    static Uint64 tick_ms;
+    static Uint64 tick_counter;
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 now_ms, counter, offset_ns;
+
+    if (frequency <= 1000) {
+        return SDL_GetTicks64() * 1000000;
+    }
+
+    SDL_AtomicLock(&lock);
+    counter = SDL_GetPerformanceCounter();
+    now_ms = SDL_GetTicks64();
+    if (now_ms != tick_ms) {
+        tick_ms = now_ms;
+        tick_counter = counter;
+    }
+    offset_ns = ((counter - tick_counter) * 1000000) / (frequency / 1000);
+    SDL_AtomicUnlock(&lock);
+
+    return now_ms * 1000000 + SDL_min(offset_ns, 999999);
+}
+#endif
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -105,7 +105,7 @@ SDL_TicksQuit(void)
 }
 
 Uint64
-SDL_GetTicks64(void)
+SDL_GetTicksNS(void)
 {
     if (!ticks_started) {
         SDL_TicksInit();
@@ -115,10 +115,10 @@ SDL_GetTicks64(void)
 #if HAVE_CLOCK_GETTIME
         struct timespec now;
         clock_gettime(SDL_MONOTONIC_CLOCK, &now);
-        return (Uint64)(((Sint64)(now.tv_sec - start_ts.tv_sec) * 1000) + ((now.tv_nsec - start_ts.tv_nsec) / 1000000));
+        return (Uint64)(((Sint64)(now.tv_sec - start_ts.tv_sec) * 1000000000) + (now.tv_nsec - start_ts.tv_nsec));
 #elif defined(__APPLE__)
         const uint64_t now = mach_absolute_time();
-        return ((((now - start_mach) * mach_base_info.numer) / mach_base_info.denom) / 1000000);
+        return (((now - start_mach) * mach_base_info.numer) / mach_base_info.denom);
 #else
         SDL_assert(SDL_FALSE);
         return 0;
@@ -126,10 +126,18 @@ SDL_GetTicks64(void)
     } else {
         struct timeval now;
         gettimeofday(&now, NULL);
-        return (Uint64)(((Sint64)(now.tv_sec - start_tv.tv_sec) * 1000) + ((now.tv_usec - start_tv.tv_usec) / 1000));
+        return (Uint64)(((Sint64)(now.tv_sec - start_tv.tv_sec) * 1000000000) + ((now.tv_usec - start_tv.tv_usec) * 1000));
     }
 }
 
+Uint64
+SDL_GetTicks64(void)
+{
+    /* Derived from the nanosecond clock so event timestamps, which are
+       taken in nanoseconds, always agree with the millisecond ticks. */
+    return SDL_GetTicksNS() / 1000000;
+}
+
 Uint64
 SDL_GetPerformanceCounter(void)
 {
@@ -111,9 +111,10 @@ SDL_TicksQuit(void)
 }
 
 Uint64
-SDL_GetTicks64(void)
+SDL_GetTicksNS(void)
 {
     LARGE_INTEGER now;
+    Uint64 elapsed;
     BOOL rc;
 
     if (!ticks_started) {
@@ -122,7 +123,19 @@ SDL_GetTicks64(void)
 
     rc = QueryPerformanceCounter(&now);
     SDL_assert(rc != 0);  /* this should _never_ fail if you're on XP or later. */
-    return (Uint64) (((now.QuadPart - start_ticks.QuadPart) * 1000) / ticks_per_second.QuadPart);
+
+    /* Split off whole seconds so the multiplication can't overflow */
+    elapsed = (Uint64) (now.QuadPart - start_ticks.QuadPart);
+    return (elapsed / ticks_per_second.QuadPart) * 1000000000 +
+           ((elapsed % ticks_per_second.QuadPart) * 1000000000) / ticks_per_second.QuadPart;
+}
+
+Uint64
+SDL_GetTicks64(void)
+{
+    /* Derived from the nanosecond clock so event timestamps, which are
+       taken in nanoseconds, always agree with the millisecond ticks. */
+    return SDL_GetTicksNS() / 1000000;
 }
 
 Uint64
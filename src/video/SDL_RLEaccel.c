@@ -62,9 +62,6 @@
  *
  * Encoding of surfaces with per-pixel alpha:
  *
- *   The sequence begins with a struct RLEDestFormat describing the target
- *   pixel format, to provide reliable un-encoding.
- *
  *   Each scan line is encoded twice: First all completely opaque pixels,
  *   encoded in the target format as described above, and then all
  *   partially transparent (translucent) pixels (where 1 <= alpha <= 254),
@@ -85,11 +82,19 @@
  *
  *   The end of the sequence is marked by a zero <skip>,<run> pair at the
  *   beginning of an opaque line.
+ *
+ * Every scan line is encoded on its own, and the surface pixels are kept
+ * alongside the encoding together with the offset and a checksum of each
+ * line. Blits start directly at the first line they need, and unlocking the
+ * surface only re-encodes the lines whose pixels have changed, copying the
+ * others over from the previous encoding. Trailing blank lines are not
+ * stored; their offsets point at the end marker.
  */
 
 #include "SDL_video.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
+#include "SDL_pixels_c.h"
 #include "SDL_RLEaccel_c.h"
 
 #ifndef MIN
@@ -99,6 +104,29 @@
 #define PIXEL_COPY(to, from, len, bpp)          \
     SDL_memcpy(to, from, (size_t)(len) * (bpp))
 
+#if defined(__SSE2__)
+#define HAVE_SSE2_RLE_SPANS 1
+#endif
+
+/* one encoded scan line */
+typedef struct
+{
+    Uint32 offset;      /* where the line starts in the encoded data */
+    Uint32 blank;       /* nonzero if the line has no visible pixels */
+    Uint64 checksum;    /* checksum of the pixels the line was encoded from */
+} RLELine;
+
+/* the RLE state of a surface, kept in surface->map->data */
+typedef struct
+{
+    Uint8 *data;        /* the encoded lines, followed by the end marker */
+    int nlines;         /* lines stored in data, the remaining ones are blank */
+    RLELine *lines;     /* one entry per scan line, plus one for the end */
+} RLEData;
+
+/* the start of the encoded data for scan line y */
+#define RLE_LINE_DATA(rle, y)   ((rle)->data + (rle)->lines[y].offset)
+
 /*
  * Various colorkey blit methods, for opaque and per-surface alpha
  */
@@ -113,23 +141,60 @@
  * of each component, so the bits from the multiplication don't collide.
  * This can be used for any RGB permutation of course.
  */
+#if HAVE_SSE2_RLE_SPANS
+/* x * a in each 32-bit lane, modulo 2^32, with a <= 255 in both 16-bit halves */
+static SDL_INLINE __m128i
+RLEMul32_SSE2(__m128i x, __m128i a)
+{
+    return _mm_add_epi32(_mm_mullo_epi16(x, a),
+                         _mm_slli_epi32(_mm_mulhi_epu16(x, a), 16));
+}
+
+/* four pixels at a time, with exactly the arithmetic of the scalar code */
+static SDL_INLINE __m128i
+RLEBlend888_SSE2(__m128i s, __m128i d, __m128i a)
+{
+    const __m128i rbmask = _mm_set1_epi32(0x00ff00ff);
+    const __m128i gmask = _mm_set1_epi32(0x0000ff00);
+    __m128i s1 = _mm_and_si128(s, rbmask);
+    __m128i d1 = _mm_and_si128(d, rbmask);
+    d1 = _mm_add_epi32(d1, _mm_srli_epi32(RLEMul32_SSE2(_mm_sub_epi32(s1, d1), a), 8));
+    d1 = _mm_and_si128(d1, rbmask);
+    s = _mm_and_si128(s, gmask);
+    d = _mm_and_si128(d, gmask);
+    d = _mm_add_epi32(d, _mm_srli_epi32(RLEMul32_SSE2(_mm_sub_epi32(s, d), a), 8));
+    d = _mm_and_si128(d, gmask);
+    return _mm_or_si128(d1, d);
+}
+#endif /* HAVE_SSE2_RLE_SPANS */
+
+static void
+BlitAlphaRun888(Uint32 * dst, const Uint32 * src, int length, unsigned alpha)
+{
+    int i = 0;
+#if HAVE_SSE2_RLE_SPANS
+    const __m128i a = _mm_set1_epi32((int)(alpha | alpha << 16));
+    for (; i + 4 <= length; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        _mm_storeu_si128((__m128i *)(dst + i), RLEBlend888_SSE2(s, d, a));
+    }
+#endif
+    for (; i < length; i++) {
+        Uint32 s = src[i];
+        Uint32 d = dst[i];
+        Uint32 s1 = s & 0xff00ff;
+        Uint32 d1 = d & 0xff00ff;
+        d1 = (d1 + ((s1 - d1) * alpha >> 8)) & 0xff00ff;
+        s &= 0xff00;
+        d &= 0xff00;
+        d = (d + ((s - d) * alpha >> 8)) & 0xff00;
+        dst[i] = d1 | d;
+    }
+}
+
 #define ALPHA_BLIT32_888(to, from, length, bpp, alpha)      \
-    do {                                                    \
-        int i;                                              \
-        Uint32 *src = (Uint32 *)(from);                     \
-        Uint32 *dst = (Uint32 *)(to);                       \
-        for (i = 0; i < (int)(length); i++) {               \
-            Uint32 s = *src++;                              \
-            Uint32 d = *dst;                                \
-            Uint32 s1 = s & 0xff00ff;                       \
-            Uint32 d1 = d & 0xff00ff;                       \
-            d1 = (d1 + ((s1 - d1) * alpha >> 8)) & 0xff00ff; \
-            s &= 0xff00;                                    \
-            d &= 0xff00;                                    \
-            d = (d + ((s - d) * alpha >> 8)) & 0xff00;      \
-            *dst++ = d1 | d;                                \
-        }                                                   \
-    } while (0)
+    BlitAlphaRun888((Uint32 *)(to), (const Uint32 *)(from), (int)(length), alpha)
 
 /*
  * For 16bpp pixels we can go a step further: put the middle component
@@ -469,51 +534,8 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     y = dstrect->y;
     dstbuf = (Uint8 *) surf_dst->pixels
         + y * surf_dst->pitch + x * surf_src->format->BytesPerPixel;
-    srcbuf = (Uint8 *) surf_src->map->data;
-
-    {
-        /* skip lines at the top if necessary */
-        int vskip = srcrect->y;
-        int ofs = 0;
-        if (vskip) {
-
-#define RLESKIP(bpp, Type)          \
-        for(;;) {           \
-            int run;            \
-            ofs += *(Type *)srcbuf; \
-            run = ((Type *)srcbuf)[1];  \
-            srcbuf += sizeof(Type) * 2; \
-            if(run) {           \
-            srcbuf += run * bpp;    \
-            ofs += run;     \
-            } else if(!ofs)     \
-            goto done;      \
-            if(ofs == w) {      \
-            ofs = 0;        \
-            if(!--vskip)        \
-                break;      \
-            }               \
-        }
-
-            switch (surf_src->format->BytesPerPixel) {
-            case 1:
-                RLESKIP(1, Uint8);
-                break;
-            case 2:
-                RLESKIP(2, Uint8);
-                break;
-            case 3:
-                RLESKIP(3, Uint8);
-                break;
-            case 4:
-                RLESKIP(4, Uint16);
-                break;
-            }
-
-#undef RLESKIP
-
-        }
-    }
+    /* start at the first line we need, skipping the ones above it */
+    srcbuf = RLE_LINE_DATA((RLEData *) surf_src->map->data, srcrect->y);
 
     alpha = surf_src->map->info.a;
     /* if left or right edge clipping needed, call clip blit */
@@ -551,7 +573,6 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
 #undef RLEBLIT
     }
 
-  done:
     /* Unlock the destination if necessary */
     if (SDL_MUSTLOCK(surf_dst)) {
         SDL_UnlockSurface(surf_dst);
@@ -612,25 +633,43 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     dst = (Uint16)(d | d >> 16);            \
     } while(0)
 
-/* used to save the destination format in the encoding. Designed to be
-   macro-compatible with SDL_PixelFormat but without the unneeded fields */
-typedef struct
+/* blend a run of translucent pixels onto a 32bpp destination */
+static void
+BlitTranslRun888(Uint32 * dst, const Uint32 * src, int length)
 {
-    Uint8 BytesPerPixel;
-    Uint8 padding[3];
-    Uint32 Rmask;
-    Uint32 Gmask;
-    Uint32 Bmask;
-    Uint32 Amask;
-    Uint8 Rloss;
-    Uint8 Gloss;
-    Uint8 Bloss;
-    Uint8 Aloss;
-    Uint8 Rshift;
-    Uint8 Gshift;
-    Uint8 Bshift;
-    Uint8 Ashift;
-} RLEDestFormat;
+    int i = 0;
+#if HAVE_SSE2_RLE_SPANS
+    const __m128i opaque = _mm_set1_epi32((int)0xff000000);
+    for (; i + 4 <= length; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        __m128i a = _mm_srli_epi32(s, 24);
+        a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+        d = _mm_or_si128(RLEBlend888_SSE2(s, d, a), opaque);
+        _mm_storeu_si128((__m128i *)(dst + i), d);
+    }
+#endif
+    for (; i < length; i++) {
+        BLIT_TRANSL_888(src[i], dst[i]);
+    }
+}
+
+/* blend a run of translucent pixels, one at a time */
+#define BLIT_TRANSL_RUN(dst, src, length, do_blend)     \
+    do {                                                \
+        int i;                                          \
+        for (i = 0; i < (int)(length); i++)             \
+            do_blend((src)[i], (dst)[i]);               \
+    } while(0)
+
+#define BLIT_TRANSL_RUN_888(dst, src, length)   \
+    BlitTranslRun888(dst, src, (int)(length))
+
+#define BLIT_TRANSL_RUN_565(dst, src, length)   \
+    BLIT_TRANSL_RUN(dst, src, length, BLIT_TRANSL_565)
+
+#define BLIT_TRANSL_RUN_555(dst, src, length)   \
+    BLIT_TRANSL_RUN(dst, src, length, BLIT_TRANSL_555)
 
 /* blit a pixel-alpha RLE surface clipped at the right and/or left edges */
 static void
@@ -640,10 +679,10 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
     SDL_PixelFormat *df = surf_dst->format;
     /*
      * clipped blitter: Ptype is the destination pixel type,
-     * Ctype the translucent count type, and do_blend the macro
-     * to blend one pixel.
+     * Ctype the translucent count type, and do_blend_run the macro
+     * to blend a run of pixels.
      */
-#define RLEALPHACLIPBLIT(Ptype, Ctype, do_blend)              \
+#define RLEALPHACLIPBLIT(Ptype, Ctype, do_blend_run)          \
     do {                                  \
     int linecount = srcrect->h;                   \
     int left = srcrect->x;                        \
@@ -699,9 +738,7 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
             if(crun > 0) {                    \
             Ptype *dst = (Ptype *)dstbuf + cofs;          \
             Uint32 *src = (Uint32 *)srcbuf + (cofs - ofs);    \
-            int i;                        \
-            for(i = 0; i < crun; i++)             \
-                do_blend(src[i], dst[i]);             \
+            do_blend_run(dst, src, crun);             \
             }                             \
             srcbuf += run * 4;                    \
             ofs += run;                       \
@@ -714,12 +751,12 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
     switch (df->BytesPerPixel) {
     case 2:
         if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0 || df->Bmask == 0x07e0)
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_565);
+            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_RUN_565);
         else
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_555);
+            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_RUN_555);
         break;
     case 4:
-        RLEALPHACLIPBLIT(Uint32, Uint16, BLIT_TRANSL_888);
+        RLEALPHACLIPBLIT(Uint32, Uint16, BLIT_TRANSL_RUN_888);
         break;
     }
 }
@@ -744,63 +781,8 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     x = dstrect->x;
     y = dstrect->y;
     dstbuf = (Uint8 *) surf_dst->pixels + y * surf_dst->pitch + x * df->BytesPerPixel;
-    srcbuf = (Uint8 *) surf_src->map->data + sizeof(RLEDestFormat);
-
-    {
-        /* skip lines at the top if necessary */
-        int vskip = srcrect->y;
-        if (vskip) {
-            int ofs;
-            if (df->BytesPerPixel == 2) {
-                /* the 16/32 interleaved format */
-                do {
-                    /* skip opaque line */
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += srcbuf[0];
-                        run = srcbuf[1];
-                        srcbuf += 2;
-                        if (run) {
-                            srcbuf += 2 * run;
-                            ofs += run;
-                        } else if (!ofs)
-                            goto done;
-                    } while (ofs < w);
-
-                    /* skip padding */
-                    srcbuf += (uintptr_t) srcbuf & 2;
-
-                    /* skip translucent line */
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += ((Uint16 *) srcbuf)[0];
-                        run = ((Uint16 *) srcbuf)[1];
-                        srcbuf += 4 * (run + 1);
-                        ofs += run;
-                    } while (ofs < w);
-                } while (--vskip);
-            } else {
-                /* the 32/32 interleaved format */
-                vskip <<= 1;    /* opaque and translucent have same format */
-                do {
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += ((Uint16 *) srcbuf)[0];
-                        run = ((Uint16 *) srcbuf)[1];
-                        srcbuf += 4;
-                        if (run) {
-                            srcbuf += 4 * run;
-                            ofs += run;
-                        } else if (!ofs)
-                            goto done;
-                    } while (ofs < w);
-                } while (--vskip);
-            }
-        }
-    }
+    /* start at the first line we need, skipping the ones above it */
+    srcbuf = RLE_LINE_DATA((RLEData *) surf_src->map->data, srcrect->y);
 
     /* if left or right edge clipping needed, call clip blit */
     if (srcrect->x || srcrect->w != surf_src->w) {
@@ -809,10 +791,10 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
 
         /*
          * non-clipped blitter. Ptype is the destination pixel type,
-         * Ctype the translucent count type, and do_blend the
-         * macro to blend one pixel.
+         * Ctype the translucent count type, and do_blend_run the
+         * macro to blend a run of pixels.
          */
-#define RLEALPHABLIT(Ptype, Ctype, do_blend)                 \
+#define RLEALPHABLIT(Ptype, Ctype, do_blend_run)             \
     do {                                 \
         int linecount = srcrect->h;                  \
         do {                             \
@@ -843,13 +825,8 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
             srcbuf += 4;                     \
             if(run) {                        \
             Ptype *dst = (Ptype *)dstbuf + ofs;      \
-            unsigned i;                  \
-            for(i = 0; i < run; i++) {           \
-                Uint32 src = *(Uint32 *)srcbuf;      \
-                do_blend(src, *dst);             \
-                srcbuf += 4;                 \
-                dst++;                   \
-            }                        \
+            do_blend_run(dst, (Uint32 *)srcbuf, run);    \
+            srcbuf += 4 * run;               \
             ofs += run;                  \
             }                            \
         } while(ofs < w);                    \
@@ -861,12 +838,12 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
         case 2:
             if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0
                 || df->Bmask == 0x07e0)
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_565);
+                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_RUN_565);
             else
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_555);
+                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_RUN_555);
             break;
         case 4:
-            RLEALPHABLIT(Uint32, Uint16, BLIT_TRANSL_888);
+            RLEALPHABLIT(Uint32, Uint16, BLIT_TRANSL_RUN_888);
             break;
         }
     }
@@ -883,9 +860,7 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
  * Auxiliary functions:
  * The encoding functions take 32bpp rgb + a, and
  * return the number of bytes copied to the destination.
- * The decoding functions copy to 32bpp rgb + a, and
- * return the number of bytes copied from the source.
- * These are only used in the encoder and un-RLE code and are therefore not
+ * These are only used in the encoder and are therefore not
  * highly optimised.
  */
 
@@ -906,26 +881,6 @@ copy_opaque_16(void *dst, Uint32 * src, int n,
     return n * 2;
 }
 
-/* decode opaque pixels from 16bpp to 32bpp rgb + a */
-static int
-uncopy_opaque_16(Uint32 * dst, void *src, int n,
-                 RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint16 *s = src;
-    unsigned alpha = dfmt->Amask ? 255 : 0;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b;
-        RGB_FROM_PIXEL(*s, sfmt, r, g, b);
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, alpha);
-        s++;
-        dst++;
-    }
-    return n * 2;
-}
-
-
-
 /* encode 32bpp rgb + a into 32bpp G0RAB format for blitting into 565 */
 static int
 copy_transl_565(void *dst, Uint32 * src, int n,
@@ -964,25 +919,6 @@ copy_transl_555(void *dst, Uint32 * src, int n,
     return n * 4;
 }
 
-/* decode translucent pixels from 32bpp GORAB to 32bpp rgb + a */
-static int
-uncopy_transl_16(Uint32 * dst, void *src, int n,
-                 RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint32 *s = src;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b, a;
-        Uint32 pix = *s++;
-        a = (pix & 0x3e0) >> 2;
-        pix = (pix & ~0x3e0) | pix >> 16;
-        RGB_FROM_PIXEL(pix, sfmt, r, g, b);
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, a);
-        dst++;
-    }
-    return n * 4;
-}
-
 /* encode 32bpp rgba into 32bpp rgba, keeping alpha (dual purpose) */
 static int
 copy_32(void *dst, Uint32 * src, int n,
@@ -1000,44 +936,179 @@ copy_32(void *dst, Uint32 * src, int n,
     return n * 4;
 }
 
-/* decode 32bpp rgba into 32bpp rgba, keeping alpha (dual purpose) */
-static int
-uncopy_32(Uint32 * dst, void *src, int n,
-          RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
+static Uint32
+getpix_8(const Uint8 * srcbuf)
 {
-    int i;
-    Uint32 *s = src;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b, a;
-        Uint32 pixel = *s++;
-        RGB_FROM_PIXEL(pixel, sfmt, r, g, b);
-        a = pixel >> 24;
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, a);
-        dst++;
-    }
-    return n * 4;
+    return *srcbuf;
+}
+
+static Uint32
+getpix_16(const Uint8 * srcbuf)
+{
+    return *(const Uint16 *) srcbuf;
+}
+
+static Uint32
+getpix_24(const Uint8 * srcbuf)
+{
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    return srcbuf[0] + (srcbuf[1] << 8) + (srcbuf[2] << 16);
+#else
+    return (srcbuf[0] << 16) + (srcbuf[1] << 8) + srcbuf[2];
+#endif
 }
 
+static Uint32
+getpix_32(const Uint8 * srcbuf)
+{
+    return *(const Uint32 *) srcbuf;
+}
+
+typedef Uint32(*getpix_func) (const Uint8 *);
+
+static const getpix_func getpixes[4] = {
+    getpix_8, getpix_16, getpix_24, getpix_32
+};
+
+typedef int (*copy_func) (void *, Uint32 *, int,
+                          SDL_PixelFormat *, SDL_PixelFormat *);
+
+/* what it takes to encode one scan line of a surface */
+typedef struct RLEEncoder
+{
+    SDL_Surface *surface;
+    int (*encode_line) (const struct RLEEncoder * enc, const Uint8 * srcbuf,
+                        Uint8 * dst, Uint32 * blank);
+    int linesize;           /* worst case size of an encoded line */
+    int endsize;            /* size of the end marker */
+    Uint64 seed;            /* the encoding parameters, for the checksums */
+
+    /* colorkey encoding */
+    getpix_func getpix;
+    Uint32 ckey, rgbmask;
+
+    /* per-pixel alpha encoding */
+    SDL_PixelFormat *df;
+    copy_func copy_opaque;
+    copy_func copy_transl;
+} RLEEncoder;
+
 #define ISOPAQUE(pixel, fmt) ((((pixel) & fmt->Amask) >> fmt->Ashift) == 255)
 
 #define ISTRANSL(pixel, fmt)    \
     ((unsigned)((((pixel) & fmt->Amask) >> fmt->Ashift) - 1U) < 254U)
 
-/* convert surface to be quickly alpha-blittable onto dest, if possible */
+/* encode one scan line of a surface with per-pixel alpha */
 static int
-RLEAlphaSurface(SDL_Surface * surface)
+RLEAlphaLine(const RLEEncoder * enc, const Uint8 * srcbuf, Uint8 * dst,
+             Uint32 * blank)
+{
+    SDL_PixelFormat *sf = enc->surface->format;
+    SDL_PixelFormat *df = enc->df;
+    Uint32 *src = (Uint32 *) srcbuf;
+    Uint8 *start = dst;
+    int w = enc->surface->w;
+    const int max_opaque_run = 255;     /* runs stored as bytes or short ints */
+    const int max_transl_run = 65535;
+    int x, runstart, skipstart;
+    int blankline = 0;
+
+    /* opaque counts are 8 or 16 bits, depending on target depth */
+#define ADD_OPAQUE_COUNTS(n, m)         \
+    if(df->BytesPerPixel == 4) {        \
+        ((Uint16 *)dst)[0] = n;     \
+        ((Uint16 *)dst)[1] = m;     \
+        dst += 4;               \
+    } else {                \
+        dst[0] = n;             \
+        dst[1] = m;             \
+        dst += 2;               \
+    }
+
+    /* translucent counts are always 16 bit */
+#define ADD_TRANSL_COUNTS(n, m)     \
+    (((Uint16 *)dst)[0] = n, ((Uint16 *)dst)[1] = m, dst += 4)
+
+    /* First encode all opaque pixels of a scan line */
+    x = 0;
+    do {
+        int run, skip, len;
+        skipstart = x;
+        while (x < w && !ISOPAQUE(src[x], sf))
+            x++;
+        runstart = x;
+        while (x < w && ISOPAQUE(src[x], sf))
+            x++;
+        skip = runstart - skipstart;
+        if (skip == w)
+            blankline = 1;
+        run = x - runstart;
+        while (skip > max_opaque_run) {
+            ADD_OPAQUE_COUNTS(max_opaque_run, 0);
+            skip -= max_opaque_run;
+        }
+        len = MIN(run, max_opaque_run);
+        ADD_OPAQUE_COUNTS(skip, len);
+        dst += enc->copy_opaque(dst, src + runstart, len, sf, df);
+        runstart += len;
+        run -= len;
+        while (run) {
+            len = MIN(run, max_opaque_run);
+            ADD_OPAQUE_COUNTS(0, len);
+            dst += enc->copy_opaque(dst, src + runstart, len, sf, df);
+            runstart += len;
+            run -= len;
+        }
+    } while (x < w);
+
+    /* Make sure the next output address is 32-bit aligned */
+    dst += (uintptr_t) dst & 2;
+
+    /* Next, encode all translucent pixels of the same scan line */
+    x = 0;
+    do {
+        int run, skip, len;
+        skipstart = x;
+        while (x < w && !ISTRANSL(src[x], sf))
+            x++;
+        runstart = x;
+        while (x < w && ISTRANSL(src[x], sf))
+            x++;
+        skip = runstart - skipstart;
+        blankline &= (skip == w);
+        run = x - runstart;
+        while (skip > max_transl_run) {
+            ADD_TRANSL_COUNTS(max_transl_run, 0);
+            skip -= max_transl_run;
+        }
+        len = MIN(run, max_transl_run);
+        ADD_TRANSL_COUNTS(skip, len);
+        dst += enc->copy_transl(dst, src + runstart, len, sf, df);
+        runstart += len;
+        run -= len;
+        while (run) {
+            len = MIN(run, max_transl_run);
+            ADD_TRANSL_COUNTS(0, len);
+            dst += enc->copy_transl(dst, src + runstart, len, sf, df);
+            runstart += len;
+            run -= len;
+        }
+    } while (x < w);
+
+#undef ADD_OPAQUE_COUNTS
+#undef ADD_TRANSL_COUNTS
+
+    *blank = blankline;
+    return (int) (dst - start);
+}
+
+/* set up encoding a surface to be quickly alpha-blittable onto dest, if possible */
+static int
+RLEAlphaEncoder(SDL_Surface * surface, RLEEncoder * enc)
 {
     SDL_Surface *dest;
     SDL_PixelFormat *df;
-    int maxsize = 0;
-    int max_opaque_run;
-    int max_transl_run = 65535;
     unsigned masksum;
-    Uint8 *rlebuf, *dst;
-    int (*copy_opaque) (void *, Uint32 *, int,
-                        SDL_PixelFormat *, SDL_PixelFormat *);
-    int (*copy_transl) (void *, Uint32 *, int,
-                        SDL_PixelFormat *, SDL_PixelFormat *);
 
     dest = surface->map->dst;
     if (!dest)
@@ -1047,7 +1118,7 @@ RLEAlphaSurface(SDL_Surface * surface)
         return -1;              /* only 32bpp source supported */
 
     /* find out whether the destination is one we support,
-       and determine the max size of the encoded result */
+       and determine the max size of an encoded line */
     masksum = df->Rmask | df->Gmask | df->Bmask;
     switch (df->BytesPerPixel) {
     case 2:
@@ -1056,77 +1127,65 @@ RLEAlphaSurface(SDL_Surface * surface)
         case 0xffff:
             if (df->Gmask == 0x07e0
                 || df->Rmask == 0x07e0 || df->Bmask == 0x07e0) {
-                copy_opaque = copy_opaque_16;
-                copy_transl = copy_transl_565;
+                enc->copy_opaque = copy_opaque_16;
+                enc->copy_transl = copy_transl_565;
             } else
                 return -1;
             break;
         case 0x7fff:
             if (df->Gmask == 0x03e0
                 || df->Rmask == 0x03e0 || df->Bmask == 0x03e0) {
-                copy_opaque = copy_opaque_16;
-                copy_transl = copy_transl_555;
+                enc->copy_opaque = copy_opaque_16;
+                enc->copy_transl = copy_transl_555;
             } else
                 return -1;
             break;
         default:
             return -1;
         }
-        max_opaque_run = 255;   /* runs stored as bytes */
 
         /* worst case is alternating opaque and translucent pixels,
            with room for alignment padding between lines */
-        maxsize = surface->h * (2 + (4 + 2) * (surface->w + 1)) + 2;
+        enc->linesize = 2 + (4 + 2) * (surface->w + 1);
+        enc->endsize = 2;
         break;
     case 4:
         if (masksum != 0x00ffffff)
             return -1;          /* requires unused high byte */
-        copy_opaque = copy_32;
-        copy_transl = copy_32;
-        max_opaque_run = 255;   /* runs stored as short ints */
+        enc->copy_opaque = copy_32;
+        enc->copy_transl = copy_32;
 
         /* worst case is alternating opaque and translucent pixels */
-        maxsize = surface->h * 2 * 4 * (surface->w + 1) + 4;
+        enc->linesize = 2 * 4 * (surface->w + 1);
+        enc->endsize = 4;
         break;
     default:
         return -1;              /* anything else unsupported right now */
     }
 
-    maxsize += sizeof(RLEDestFormat);
-    rlebuf = (Uint8 *) SDL_malloc(maxsize);
-    if (!rlebuf) {
-        return SDL_OutOfMemory();
-    }
-    {
-        /* save the destination format so we can undo the encoding later */
-        RLEDestFormat *r = (RLEDestFormat *) rlebuf;
-        r->BytesPerPixel = df->BytesPerPixel;
-        r->Rmask = df->Rmask;
-        r->Gmask = df->Gmask;
-        r->Bmask = df->Bmask;
-        r->Amask = df->Amask;
-        r->Rloss = df->Rloss;
-        r->Gloss = df->Gloss;
-        r->Bloss = df->Bloss;
-        r->Aloss = df->Aloss;
-        r->Rshift = df->Rshift;
-        r->Gshift = df->Gshift;
-        r->Bshift = df->Bshift;
-        r->Ashift = df->Ashift;
-    }
-    dst = rlebuf + sizeof(RLEDestFormat);
+    enc->surface = surface;
+    enc->encode_line = RLEAlphaLine;
+    enc->seed = ((Uint64) 1 << 32) | df->format;
+    enc->df = df;
+    return 0;
+}
 
-    /* Do the actual encoding */
-    {
-        int x, y;
-        int h = surface->h, w = surface->w;
-        SDL_PixelFormat *sf = surface->format;
-        Uint32 *src = (Uint32 *) surface->pixels;
-        Uint8 *lastline = dst;  /* end of last non-blank line */
+/* encode one scan line of a colorkeyed surface */
+static int
+RLEColorkeyLine(const RLEEncoder * enc, const Uint8 * srcbuf, Uint8 * dst,
+                Uint32 * blank)
+{
+    const int bpp = enc->surface->format->BytesPerPixel;
+    const int maxn = bpp == 4 ? 65535 : 255;
+    getpix_func getpix = enc->getpix;
+    Uint32 ckey = enc->ckey, rgbmask = enc->rgbmask;
+    Uint8 *start = dst;
+    int w = enc->surface->w;
+    int x = 0;
+    int blankline = 0;
 
-        /* opaque counts are 8 or 16 bits, depending on target depth */
-#define ADD_OPAQUE_COUNTS(n, m)         \
-    if(df->BytesPerPixel == 4) {        \
+#define ADD_COUNTS(n, m)            \
+    if(bpp == 4) {              \
         ((Uint16 *)dst)[0] = n;     \
         ((Uint16 *)dst)[1] = m;     \
         dst += 4;               \
@@ -1136,282 +1195,273 @@ RLEAlphaSurface(SDL_Surface * surface)
         dst += 2;               \
     }
 
-        /* translucent counts are always 16 bit */
-#define ADD_TRANSL_COUNTS(n, m)     \
-    (((Uint16 *)dst)[0] = n, ((Uint16 *)dst)[1] = m, dst += 4)
-
-        for (y = 0; y < h; y++) {
-            int runstart, skipstart;
-            int blankline = 0;
-            /* First encode all opaque pixels of a scan line */
-            x = 0;
-            do {
-                int run, skip, len;
-                skipstart = x;
-                while (x < w && !ISOPAQUE(src[x], sf))
-                    x++;
-                runstart = x;
-                while (x < w && ISOPAQUE(src[x], sf))
-                    x++;
-                skip = runstart - skipstart;
-                if (skip == w)
-                    blankline = 1;
-                run = x - runstart;
-                while (skip > max_opaque_run) {
-                    ADD_OPAQUE_COUNTS(max_opaque_run, 0);
-                    skip -= max_opaque_run;
-                }
-                len = MIN(run, max_opaque_run);
-                ADD_OPAQUE_COUNTS(skip, len);
-                dst += copy_opaque(dst, src + runstart, len, sf, df);
-                runstart += len;
-                run -= len;
-                while (run) {
-                    len = MIN(run, max_opaque_run);
-                    ADD_OPAQUE_COUNTS(0, len);
-                    dst += copy_opaque(dst, src + runstart, len, sf, df);
-                    runstart += len;
-                    run -= len;
-                }
-            } while (x < w);
-
-            /* Make sure the next output address is 32-bit aligned */
-            dst += (uintptr_t) dst & 2;
-
-            /* Next, encode all translucent pixels of the same scan line */
-            x = 0;
-            do {
-                int run, skip, len;
-                skipstart = x;
-                while (x < w && !ISTRANSL(src[x], sf))
-                    x++;
-                runstart = x;
-                while (x < w && ISTRANSL(src[x], sf))
-                    x++;
-                skip = runstart - skipstart;
-                blankline &= (skip == w);
-                run = x - runstart;
-                while (skip > max_transl_run) {
-                    ADD_TRANSL_COUNTS(max_transl_run, 0);
-                    skip -= max_transl_run;
-                }
-                len = MIN(run, max_transl_run);
-                ADD_TRANSL_COUNTS(skip, len);
-                dst += copy_transl(dst, src + runstart, len, sf, df);
-                runstart += len;
-                run -= len;
-                while (run) {
-                    len = MIN(run, max_transl_run);
-                    ADD_TRANSL_COUNTS(0, len);
-                    dst += copy_transl(dst, src + runstart, len, sf, df);
-                    runstart += len;
-                    run -= len;
-                }
-                if (!blankline)
-                    lastline = dst;
-            } while (x < w);
-
-            src += surface->pitch >> 2;
+    do {
+        int run, skip, len;
+        int runstart;
+        int skipstart = x;
+
+        /* find run of transparent, then opaque pixels */
+        while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) == ckey)
+            x++;
+        runstart = x;
+        while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) != ckey)
+            x++;
+        skip = runstart - skipstart;
+        if (skip == w)
+            blankline = 1;
+        run = x - runstart;
+
+        /* encode segment */
+        while (skip > maxn) {
+            ADD_COUNTS(maxn, 0);
+            skip -= maxn;
         }
-        dst = lastline;         /* back up past trailing blank lines */
-        ADD_OPAQUE_COUNTS(0, 0);
-    }
-
-#undef ADD_OPAQUE_COUNTS
-#undef ADD_TRANSL_COUNTS
-
-    /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_SIMDFree(surface->pixels);
-        surface->pixels = NULL;
-        surface->flags &= ~SDL_SIMD_ALIGNED;
-    }
-
-    /* reallocate the buffer to release unused memory */
-    {
-        Uint8 *p = SDL_realloc(rlebuf, dst - rlebuf);
-        if (!p)
-            p = rlebuf;
-        surface->map->data = p;
-    }
-
-    return 0;
-}
-
-static Uint32
-getpix_8(const Uint8 * srcbuf)
-{
-    return *srcbuf;
-}
-
-static Uint32
-getpix_16(const Uint8 * srcbuf)
-{
-    return *(const Uint16 *) srcbuf;
-}
+        len = MIN(run, maxn);
+        ADD_COUNTS(skip, len);
+        SDL_memcpy(dst, srcbuf + runstart * bpp, len * bpp);
+        dst += len * bpp;
+        run -= len;
+        runstart += len;
+        while (run) {
+            len = MIN(run, maxn);
+            ADD_COUNTS(0, len);
+            SDL_memcpy(dst, srcbuf + runstart * bpp, len * bpp);
+            dst += len * bpp;
+            runstart += len;
+            run -= len;
+        }
+    } while (x < w);
 
-static Uint32
-getpix_24(const Uint8 * srcbuf)
-{
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-    return srcbuf[0] + (srcbuf[1] << 8) + (srcbuf[2] << 16);
-#else
-    return (srcbuf[0] << 16) + (srcbuf[1] << 8) + srcbuf[2];
-#endif
-}
+#undef ADD_COUNTS
 
-static Uint32
-getpix_32(const Uint8 * srcbuf)
-{
-    return *(const Uint32 *) srcbuf;
+    *blank = blankline;
+    return (int) (dst - start);
 }
 
-typedef Uint32(*getpix_func) (const Uint8 *);
-
-static const getpix_func getpixes[4] = {
-    getpix_8, getpix_16, getpix_24, getpix_32
-};
-
+/* set up encoding a colorkeyed surface */
 static int
-RLEColorkeySurface(SDL_Surface * surface)
+RLEColorkeyEncoder(SDL_Surface * surface, RLEEncoder * enc)
 {
-    Uint8 *rlebuf, *dst;
-    int maxn;
-    int y;
-    Uint8 *srcbuf, *lastline;
-    int maxsize = 0;
     const int bpp = surface->format->BytesPerPixel;
-    getpix_func getpix;
-    Uint32 ckey, rgbmask;
-    int w, h;
 
-    /* calculate the worst case size for the compressed surface */
+    /* calculate the worst case size for a compressed line */
     switch (bpp) {
     case 1:
         /* worst case is alternating opaque and transparent pixels,
            starting with an opaque pixel */
-        maxsize = surface->h * 3 * (surface->w / 2 + 1) + 2;
+        enc->linesize = 3 * (surface->w / 2 + 1);
+        enc->endsize = 2;
         break;
     case 2:
     case 3:
         /* worst case is solid runs, at most 255 pixels wide */
-        maxsize = surface->h * (2 * (surface->w / 255 + 1)
-                                + surface->w * bpp) + 2;
+        enc->linesize = 2 * (surface->w / 255 + 1) + surface->w * bpp;
+        enc->endsize = 2;
         break;
     case 4:
         /* worst case is solid runs, at most 65535 pixels wide */
-        maxsize = surface->h * (4 * (surface->w / 65535 + 1)
-                                + surface->w * 4) + 4;
+        enc->linesize = 4 * (surface->w / 65535 + 1) + surface->w * 4;
+        enc->endsize = 4;
         break;
 
     default:
         return -1;
     }
 
-    rlebuf = (Uint8 *) SDL_malloc(maxsize);
-    if (rlebuf == NULL) {
-        return SDL_OutOfMemory();
+    enc->surface = surface;
+    enc->encode_line = RLEColorkeyLine;
+    enc->getpix = getpixes[bpp - 1];
+    enc->rgbmask = ~surface->format->Amask;
+    enc->ckey = surface->map->info.colorkey & enc->rgbmask;
+    enc->seed = enc->ckey;
+    return 0;
+}
+
+/* a checksum of the pixels of one scan line, to find the changed ones */
+#define RLE_CHECKSUM_PRIME  0x9e3779b97f4a7c15ULL
+
+#define RLE_CHECKSUM_MIX(sum, v)                \
+    do {                                        \
+        sum = (sum ^ (v)) * RLE_CHECKSUM_PRIME; \
+        sum ^= sum >> 32;                       \
+    } while (0)
+
+static Uint64
+RLELineChecksum(Uint64 seed, const Uint8 * srcbuf, size_t length)
+{
+    /* four independent lanes keep the multiplier busy */
+    Uint64 sum[4];
+    Uint64 v[4];
+    int i;
+
+    sum[0] = (seed ^ length) * RLE_CHECKSUM_PRIME;
+    sum[1] = sum[0] + 1;
+    sum[2] = sum[0] + 2;
+    sum[3] = sum[0] + 3;
+    while (length >= sizeof(v)) {
+        SDL_memcpy(v, srcbuf, sizeof(v));
+        RLE_CHECKSUM_MIX(sum[0], v[0]);
+        RLE_CHECKSUM_MIX(sum[1], v[1]);
+        RLE_CHECKSUM_MIX(sum[2], v[2]);
+        RLE_CHECKSUM_MIX(sum[3], v[3]);
+        srcbuf += sizeof(v);
+        length -= sizeof(v);
     }
+    if (length) {
+        SDL_zeroa(v);
+        SDL_memcpy(v, srcbuf, length);
+        for (i = 0; i < 4; i++) {
+            RLE_CHECKSUM_MIX(sum[i], v[i]);
+        }
+    }
+    for (i = 1; i < 4; i++) {
+        RLE_CHECKSUM_MIX(sum[0], sum[i]);
+    }
+    return sum[0];
+}
 
-    /* Set up the conversion */
-    srcbuf = (Uint8 *) surface->pixels;
-    maxn = bpp == 4 ? 65535 : 255;
-    dst = rlebuf;
-    rgbmask = ~surface->format->Amask;
-    ckey = surface->map->info.colorkey & rgbmask;
-    lastline = dst;
-    getpix = getpixes[bpp - 1];
-    w = surface->w;
-    h = surface->h;
+/*
+ * Encode the surface line by line. If a previous encoding is given, lines
+ * whose pixels have not changed since are copied over from it instead of
+ * being encoded again.
+ */
+static RLEData *
+RLEEncode(const RLEEncoder * enc, const RLEData * prev)
+{
+    SDL_Surface *surface = enc->surface;
+    const int h = surface->h;
+    const size_t linelength = (size_t) surface->w * surface->format->BytesPerPixel;
+    RLEData *rle;
+    Uint8 *srcbuf, *dst;
+    size_t maxsize;
+    int y;
 
-#define ADD_COUNTS(n, m)            \
-    if(bpp == 4) {              \
-        ((Uint16 *)dst)[0] = n;     \
-        ((Uint16 *)dst)[1] = m;     \
-        dst += 4;               \
-    } else {                \
-        dst[0] = n;             \
-        dst[1] = m;             \
-        dst += 2;               \
+    maxsize = (size_t) h * enc->linesize + enc->endsize;
+    rle = (RLEData *) SDL_calloc(1, sizeof(*rle));
+    if (rle) {
+        rle->lines = (RLELine *) SDL_malloc((h + 1) * sizeof(*rle->lines));
+        rle->data = (Uint8 *) SDL_malloc(maxsize);
+    }
+    if (!rle || !rle->lines || !rle->data) {
+        if (rle) {
+            SDL_free(rle->lines);
+            SDL_free(rle->data);
+            SDL_free(rle);
+        }
+        SDL_OutOfMemory();
+        return NULL;
     }
 
+    srcbuf = (Uint8 *) surface->pixels;
+    dst = rle->data;
     for (y = 0; y < h; y++) {
-        int x = 0;
-        int blankline = 0;
-        do {
-            int run, skip, len;
-            int runstart;
-            int skipstart = x;
-
-            /* find run of transparent, then opaque pixels */
-            while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) == ckey)
-                x++;
-            runstart = x;
-            while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) != ckey)
-                x++;
-            skip = runstart - skipstart;
-            if (skip == w)
-                blankline = 1;
-            run = x - runstart;
-
-            /* encode segment */
-            while (skip > maxn) {
-                ADD_COUNTS(maxn, 0);
-                skip -= maxn;
-            }
-            len = MIN(run, maxn);
-            ADD_COUNTS(skip, len);
-            SDL_memcpy(dst, srcbuf + runstart * bpp, len * bpp);
-            dst += len * bpp;
-            run -= len;
-            runstart += len;
-            while (run) {
-                len = MIN(run, maxn);
-                ADD_COUNTS(0, len);
-                SDL_memcpy(dst, srcbuf + runstart * bpp, len * bpp);
-                dst += len * bpp;
-                runstart += len;
-                run -= len;
-            }
-            if (!blankline)
-                lastline = dst;
-        } while (x < w);
-
+        RLELine *line = &rle->lines[y];
+
+        line->offset = (Uint32) (dst - rle->data);
+        line->checksum = RLELineChecksum(enc->seed, srcbuf, linelength);
+        if (prev && y < prev->nlines &&
+            prev->lines[y].checksum == line->checksum) {
+            /* unchanged, reuse the previous encoding of this line */
+            Uint32 length = prev->lines[y + 1].offset - prev->lines[y].offset;
+            SDL_memcpy(dst, RLE_LINE_DATA(prev, y), length);
+            line->blank = prev->lines[y].blank;
+            dst += length;
+        } else {
+            dst += enc->encode_line(enc, srcbuf, dst, &line->blank);
+        }
+        if (!line->blank) {
+            rle->nlines = y + 1;
+        }
         srcbuf += surface->pitch;
     }
-    dst = lastline;             /* back up bast trailing blank lines */
-    ADD_COUNTS(0, 0);
 
-#undef ADD_COUNTS
-
-    /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_SIMDFree(surface->pixels);
-        surface->pixels = NULL;
-        surface->flags &= ~SDL_SIMD_ALIGNED;
+    /* back up past trailing blank lines and add the end marker */
+    if (rle->nlines < h) {
+        dst = RLE_LINE_DATA(rle, rle->nlines);
+    }
+    for (y = rle->nlines; y <= h; y++) {
+        rle->lines[y].offset = (Uint32) (dst - rle->data);
     }
+    rle->lines[h].blank = 1;
+    rle->lines[h].checksum = 0;
+    SDL_memset(dst, 0, enc->endsize);
+    dst += enc->endsize;
 
     /* reallocate the buffer to release unused memory */
     {
         /* If SDL_realloc returns NULL, the original block is left intact */
-        Uint8 *p = SDL_realloc(rlebuf, dst - rlebuf);
-        if (!p)
-            p = rlebuf;
-        surface->map->data = p;
+        Uint8 *p = SDL_realloc(rle->data, dst - rle->data);
+        if (p)
+            rle->data = p;
     }
-
-    return 0;
+    return rle;
 }
 
-int
-SDL_RLESurface(SDL_Surface * surface)
+/*
+ * Re-encode the lines of the surface whose pixels have changed, in place.
+ * Returns 0 if the encoding is up to date, 1 if it has to be rebuilt because
+ * the size of a line changed, or -1 on error. Lines handled before that are
+ * left updated, so a rebuild can still reuse them.
+ */
+static int
+RLEUpdateLines(const RLEEncoder * enc, RLEData * rle)
 {
-    int flags;
+    SDL_Surface *surface = enc->surface;
+    const size_t linelength = (size_t) surface->w * surface->format->BytesPerPixel;
+    Uint8 *srcbuf = (Uint8 *) surface->pixels;
+    Uint8 *line = NULL;
+    int result = 0;
+    int y;
 
-    /* Clear any previous RLE conversion */
-    if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        SDL_UnRLESurface(surface, 1);
+    for (y = 0; y < surface->h; y++, srcbuf += surface->pitch) {
+        const Uint64 checksum = RLELineChecksum(enc->seed, srcbuf, linelength);
+        Uint32 blank;
+        int length;
+
+        if (checksum == rle->lines[y].checksum) {
+            continue;
+        }
+        if (!line) {
+            line = (Uint8 *) SDL_malloc(enc->linesize);
+            if (!line) {
+                return SDL_OutOfMemory();
+            }
+        }
+        length = enc->encode_line(enc, srcbuf, line, &blank);
+        if (y >= rle->nlines) {
+            /* trailing blank lines are not stored */
+            if (!blank) {
+                result = 1;
+                break;
+            }
+        } else if ((Uint32) length == rle->lines[y + 1].offset - rle->lines[y].offset) {
+            SDL_memcpy(RLE_LINE_DATA(rle, y), line, length);
+        } else {
+            result = 1;
+            break;
+        }
+        rle->lines[y].checksum = checksum;
+        rle->lines[y].blank = blank;
     }
+    SDL_free(line);
+    return result;
+}
+
+static void
+RLEFree(RLEData * rle)
+{
+    if (rle) {
+        SDL_free(rle->lines);
+        SDL_free(rle->data);
+        SDL_free(rle);
+    }
+}
+
+/* set up the encoder matching the way the surface is blitted */
+static int
+RLEChooseEncoder(SDL_Surface * surface, RLEEncoder * enc)
+{
+    int flags;
 
     /* We don't support RLE encoding of bitmaps */
     if (surface->format->BitsPerPixel < 8) {
@@ -1441,20 +1491,42 @@ SDL_RLESurface(SDL_Surface * surface)
         return -1;
     }
 
-    /* Encode and set up the blit */
+    SDL_zerop(enc);
     if (!surface->format->Amask || !(flags & SDL_COPY_BLEND)) {
         if (!surface->map->identity) {
             return -1;
         }
-        if (RLEColorkeySurface(surface) < 0) {
-            return -1;
-        }
+        return RLEColorkeyEncoder(surface, enc);
+    } else {
+        return RLEAlphaEncoder(surface, enc);
+    }
+}
+
+int
+SDL_RLESurface(SDL_Surface * surface)
+{
+    RLEEncoder enc;
+    RLEData *rle;
+
+    /* Clear any previous RLE conversion */
+    if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
+        SDL_UnRLESurface(surface, 1);
+    }
+
+    if (RLEChooseEncoder(surface, &enc) < 0) {
+        return -1;
+    }
+
+    /* Encode and set up the blit */
+    rle = RLEEncode(&enc, NULL);
+    if (!rle) {
+        return -1;
+    }
+    surface->map->data = rle;
+    if (enc.encode_line == RLEColorkeyLine) {
         surface->map->blit = SDL_RLEBlit;
         surface->map->info.flags |= SDL_COPY_RLE_COLORKEY;
     } else {
-        if (RLEAlphaSurface(surface) < 0) {
-            return -1;
-        }
         surface->map->blit = SDL_RLEAlphaBlit;
         surface->map->info.flags |= SDL_COPY_RLE_ALPHAKEY;
     }
@@ -1465,127 +1537,56 @@ SDL_RLESurface(SDL_Surface * surface)
     return (0);
 }
 
-/*
- * Un-RLE a surface with pixel alpha
- * This may not give back exactly the image before RLE-encoding; all
- * completely transparent pixels will be lost, and color and alpha depth
- * may have been reduced (when encoding for 16bpp targets).
- */
-static SDL_bool
-UnRLEAlpha(SDL_Surface * surface)
+int
+SDL_UpdateRLESurface(SDL_Surface * surface)
 {
-    Uint8 *srcbuf;
-    Uint32 *dst;
-    SDL_PixelFormat *sf = surface->format;
-    RLEDestFormat *df = surface->map->data;
-    int (*uncopy_opaque) (Uint32 *, void *, int,
-                          RLEDestFormat *, SDL_PixelFormat *);
-    int (*uncopy_transl) (Uint32 *, void *, int,
-                          RLEDestFormat *, SDL_PixelFormat *);
-    int w = surface->w;
-    int bpp = df->BytesPerPixel;
-
-    if (bpp == 2) {
-        uncopy_opaque = uncopy_opaque_16;
-        uncopy_transl = uncopy_transl_16;
-    } else {
-        uncopy_opaque = uncopy_transl = uncopy_32;
+    RLEEncoder enc;
+    RLEData *rle;
+
+    if ((surface->flags & SDL_RLEACCEL) != SDL_RLEACCEL) {
+        return 0;
     }
 
-    surface->pixels = SDL_SIMDAlloc(surface->h * surface->pitch);
-    if (!surface->pixels) {
-        return (SDL_FALSE);
+    /* Encode the lines that changed, starting over if that isn't possible */
+    rle = (RLEData *) surface->map->data;
+    if (RLEChooseEncoder(surface, &enc) == 0) {
+        switch (RLEUpdateLines(&enc, rle)) {
+        case 0:
+            return 0;
+        case 1:
+            rle = RLEEncode(&enc, rle);
+            break;
+        default:
+            rle = NULL;
+            break;
+        }
+    } else {
+        rle = NULL;
     }
-    surface->flags |= SDL_SIMD_ALIGNED;
-    /* fill background with transparent pixels */
-    SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
-
-    dst = surface->pixels;
-    srcbuf = (Uint8 *) (df + 1);
-    for (;;) {
-        /* copy opaque pixels */
-        int ofs = 0;
-        do {
-            unsigned run;
-            if (bpp == 2) {
-                ofs += srcbuf[0];
-                run = srcbuf[1];
-                srcbuf += 2;
-            } else {
-                ofs += ((Uint16 *) srcbuf)[0];
-                run = ((Uint16 *) srcbuf)[1];
-                srcbuf += 4;
-            }
-            if (run) {
-                srcbuf += uncopy_opaque(dst + ofs, srcbuf, run, df, sf);
-                ofs += run;
-            } else if (!ofs) {
-                goto end_function;
-            }
-        } while (ofs < w);
-
-        /* skip padding if needed */
-        if (bpp == 2)
-            srcbuf += (uintptr_t) srcbuf & 2;
-
-        /* copy translucent pixels */
-        ofs = 0;
-        do {
-            unsigned run;
-            ofs += ((Uint16 *) srcbuf)[0];
-            run = ((Uint16 *) srcbuf)[1];
-            srcbuf += 4;
-            if (run) {
-                srcbuf += uncopy_transl(dst + ofs, srcbuf, run, df, sf);
-                ofs += run;
-            }
-        } while (ofs < w);
-        dst += surface->pitch >> 2;
+    if (!rle) {
+        SDL_UnRLESurface(surface, 1);
+        SDL_InvalidateMap(surface->map);
+        return -1;
     }
-
-end_function:
-    return (SDL_TRUE);
+    RLEFree((RLEData *) surface->map->data);
+    surface->map->data = rle;
+    return 0;
 }
 
 void
 SDL_UnRLESurface(SDL_Surface * surface, int recode)
 {
+    /* The pixels are kept alongside the encoding, so there is nothing to
+       restore, whether or not the surface is recoded afterwards */
+    (void) recode;
+
     if (surface->flags & SDL_RLEACCEL) {
         surface->flags &= ~SDL_RLEACCEL;
 
-        if (recode && !(surface->flags & SDL_PREALLOC)) {
-            if (surface->map->info.flags & SDL_COPY_RLE_COLORKEY) {
-                SDL_Rect full;
-
-                /* re-create the original surface */
-                surface->pixels = SDL_SIMDAlloc(surface->h * surface->pitch);
-                if (!surface->pixels) {
-                    /* Oh crap... */
-                    surface->flags |= SDL_RLEACCEL;
-                    return;
-                }
-                surface->flags |= SDL_SIMD_ALIGNED;
-
-                /* fill it with the background color */
-                SDL_FillRect(surface, NULL, surface->map->info.colorkey);
-
-                /* now render the encoded surface */
-                full.x = full.y = 0;
-                full.w = surface->w;
-                full.h = surface->h;
-                SDL_RLEBlit(surface, &full, surface, &full);
-            } else {
-                if (!UnRLEAlpha(surface)) {
-                    /* Oh crap... */
-                    surface->flags |= SDL_RLEACCEL;
-                    return;
-                }
-            }
-        }
         surface->map->info.flags &=
             ~(SDL_COPY_RLE_COLORKEY | SDL_COPY_RLE_ALPHAKEY);
 
-        SDL_free(surface->map->data);
+        RLEFree((RLEData *) surface->map->data);
         surface->map->data = NULL;
     }
 }
@@ -27,6 +27,7 @@
 /* Useful functions and variables from SDL_RLEaccel.c */
 
 extern int SDL_RLESurface(SDL_Surface * surface);
+extern int SDL_UpdateRLESurface(SDL_Surface * surface);
 extern void SDL_UnRLESurface(SDL_Surface * surface, int recode);
 
 #endif /* SDL_RLEaccel_c_h_ */
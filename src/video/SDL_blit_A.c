@@ -1385,16 +1385,620 @@ BlitNtoNPixelAlpha(SDL_BlitInfo * info)
     }
 }
 
+/* Exact per-pixel alpha blending for 8888 sources with SSE2, AVX2 and NEON
+ *
+ * These produce the same results as SDL_Blit_Slow(), with optional surface
+ * alpha modulation:
+ *   a = sA * modA / 255
+ *   d = s * a / 255 + d * (255 - a) / 255
+ *   dA = a + dA * (255 - a) / 255
+ * where each division truncates. x / 255 is computed as
+ * (x + 1 + (x >> 8)) >> 8, which is exact for every x <= 255 * 255.
+ *
+ * Pixels are split into one 16-bit lane per channel, so any byte aligned
+ * 8888 layout can be blended onto any other 8888 layout or onto RGB565.
+ */
+
+#if defined(__SSE2__)
+#define HAVE_SSE2_PIXEL_ALPHA 1
+#endif
+#if defined(HAVE_AVX2_INTRINSICS)
+#define HAVE_AVX2_PIXEL_ALPHA 1
+#endif
+#if defined(__ARM_NEON)
+#define HAVE_NEON_PIXEL_ALPHA 1
+#endif
+
+/* The NEON kernels load pixels by byte, which requires a little endian layout */
+#if SDL_BYTEORDER != SDL_LIL_ENDIAN
+#undef HAVE_NEON_PIXEL_ALPHA
+#endif
+
+#if HAVE_SSE2_PIXEL_ALPHA || HAVE_AVX2_PIXEL_ALPHA || HAVE_NEON_PIXEL_ALPHA
+
+typedef struct
+{
+    int sR, sG, sB, sA;     /* source channel shifts */
+    int dR, dG, dB, dA;     /* destination channel shifts, dA is -1 without alpha */
+    Uint32 modA;            /* surface alpha modulation, 255 if not modulated */
+} PixelAlphaLayout;
+
+static void
+GetPixelAlphaLayout(const SDL_BlitInfo * info, PixelAlphaLayout * layout)
+{
+    const SDL_PixelFormat *srcfmt = info->src_fmt;
+    const SDL_PixelFormat *dstfmt = info->dst_fmt;
+
+    layout->sR = srcfmt->Rshift;
+    layout->sG = srcfmt->Gshift;
+    layout->sB = srcfmt->Bshift;
+    layout->sA = srcfmt->Ashift;
+    layout->dR = dstfmt->Rshift;
+    layout->dG = dstfmt->Gshift;
+    layout->dB = dstfmt->Bshift;
+    layout->dA = dstfmt->Amask ? dstfmt->Ashift : -1;
+    layout->modA = (info->flags & SDL_COPY_MODULATE_ALPHA) ? info->a : 255;
+}
+
+#define DIV255(x)   (((x) + 1 + ((x) >> 8)) >> 8)
+
+/* Scalar versions, used for the pixels left over by the SIMD loops */
+static void
+BlitRGBtoRGBPixelAlphaRow(const Uint32 * src, Uint32 * dst, int width, const PixelAlphaLayout * layout)
+{
+    int i;
+
+    for (i = 0; i < width; ++i) {
+        const Uint32 s = src[i];
+        const Uint32 d = dst[i];
+        const Uint32 a = DIV255(((s >> layout->sA) & 0xFF) * layout->modA);
+        const Uint32 ia = 255 - a;
+        Uint32 pixel;
+
+        pixel = (DIV255(((s >> layout->sR) & 0xFF) * a) + DIV255(((d >> layout->dR) & 0xFF) * ia)) << layout->dR;
+        pixel |= (DIV255(((s >> layout->sG) & 0xFF) * a) + DIV255(((d >> layout->dG) & 0xFF) * ia)) << layout->dG;
+        pixel |= (DIV255(((s >> layout->sB) & 0xFF) * a) + DIV255(((d >> layout->dB) & 0xFF) * ia)) << layout->dB;
+        if (layout->dA >= 0) {
+            pixel |= (a + DIV255(((d >> layout->dA) & 0xFF) * ia)) << layout->dA;
+        }
+        dst[i] = pixel;
+    }
+}
+
+static void
+BlitRGBto565PixelAlphaRow(const Uint32 * src, Uint16 * dst, int width, const PixelAlphaLayout * layout)
+{
+    int i;
+
+    for (i = 0; i < width; ++i) {
+        const Uint32 s = src[i];
+        const Uint32 d = dst[i];
+        const Uint32 a = DIV255(((s >> layout->sA) & 0xFF) * layout->modA);
+        const Uint32 ia = 255 - a;
+        /* Expand to 8 bits the same way SDL_expand_byte does */
+        const Uint32 dR = ((d >> layout->dR) & 0x1F) * 255 / 31;
+        const Uint32 dG = ((d >> 5) & 0x3F) * 255 / 63;
+        const Uint32 dB = ((d >> layout->dB) & 0x1F) * 255 / 31;
+        const Uint32 r = DIV255(((s >> layout->sR) & 0xFF) * a) + DIV255(dR * ia);
+        const Uint32 g = DIV255(((s >> layout->sG) & 0xFF) * a) + DIV255(dG * ia);
+        const Uint32 b = DIV255(((s >> layout->sB) & 0xFF) * a) + DIV255(dB * ia);
+
+        dst[i] = (Uint16)(((r >> 3) << layout->dR) | ((g >> 2) << 5) | ((b >> 3) << layout->dB));
+    }
+}
+
+#undef DIV255
+
+#if HAVE_SSE2_PIXEL_ALPHA
+/* One channel of 8 pixels, in 16-bit lanes */
+static SDL_INLINE __m128i
+Channel_SSE2(__m128i lo, __m128i hi, __m128i shift, __m128i mask)
+{
+    return _mm_packs_epi32(_mm_and_si128(_mm_srl_epi32(lo, shift), mask),
+                           _mm_and_si128(_mm_srl_epi32(hi, shift), mask));
+}
+
+static SDL_INLINE __m128i
+Div255_SSE2(__m128i x, __m128i one)
+{
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, one), _mm_srli_epi16(x, 8)), 8);
+}
+
+/* s * a / 255 + d * (255 - a) / 255 */
+static SDL_INLINE __m128i
+Blend_SSE2(__m128i s, __m128i d, __m128i a, __m128i ia, __m128i one)
+{
+    return _mm_add_epi16(Div255_SSE2(_mm_mullo_epi16(s, a), one),
+                         Div255_SSE2(_mm_mullo_epi16(d, ia), one));
+}
+
+static void
+BlitRGBtoRGBPixelAlphaSSE2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    PixelAlphaLayout layout;
+    __m128i sR, sG, sB, sA, dR, dG, dB, dA, modA;
+
+    GetPixelAlphaLayout(info, &layout);
+    sR = _mm_cvtsi32_si128(layout.sR);
+    sG = _mm_cvtsi32_si128(layout.sG);
+    sB = _mm_cvtsi32_si128(layout.sB);
+    sA = _mm_cvtsi32_si128(layout.sA);
+    dR = _mm_cvtsi32_si128(layout.dR);
+    dG = _mm_cvtsi32_si128(layout.dG);
+    dB = _mm_cvtsi32_si128(layout.dB);
+    dA = _mm_cvtsi32_si128(layout.dA);
+    modA = _mm_set1_epi16((short)layout.modA);
+
+    while (height--) {
+        const Uint32 *srcp = (const Uint32 *)src;
+        Uint32 *dstp = (Uint32 *)dst;
+        int i = 0;
+
+        for (; i + 8 <= width; i += 8) {
+            const __m128i s0 = _mm_loadu_si128((const __m128i *)(srcp + i));
+            const __m128i s1 = _mm_loadu_si128((const __m128i *)(srcp + i + 4));
+            const __m128i d0 = _mm_loadu_si128((const __m128i *)(dstp + i));
+            const __m128i d1 = _mm_loadu_si128((const __m128i *)(dstp + i + 4));
+            const __m128i a = Div255_SSE2(_mm_mullo_epi16(Channel_SSE2(s0, s1, sA, mask), modA), one);
+            const __m128i ia = _mm_sub_epi16(full, a);
+            const __m128i r = Blend_SSE2(Channel_SSE2(s0, s1, sR, mask), Channel_SSE2(d0, d1, dR, mask), a, ia, one);
+            const __m128i g = Blend_SSE2(Channel_SSE2(s0, s1, sG, mask), Channel_SSE2(d0, d1, dG, mask), a, ia, one);
+            const __m128i b = Blend_SSE2(Channel_SSE2(s0, s1, sB, mask), Channel_SSE2(d0, d1, dB, mask), a, ia, one);
+            __m128i lo, hi;
+
+            lo = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(r, zero), dR),
+                                           _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), dG)),
+                              _mm_sll_epi32(_mm_unpacklo_epi16(b, zero), dB));
+            hi = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(r, zero), dR),
+                                           _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), dG)),
+                              _mm_sll_epi32(_mm_unpackhi_epi16(b, zero), dB));
+            if (layout.dA >= 0) {
+                const __m128i alpha = _mm_add_epi16(a, Div255_SSE2(_mm_mullo_epi16(Channel_SSE2(d0, d1, dA, mask), ia), one));
+                lo = _mm_or_si128(lo, _mm_sll_epi32(_mm_unpacklo_epi16(alpha, zero), dA));
+                hi = _mm_or_si128(hi, _mm_sll_epi32(_mm_unpackhi_epi16(alpha, zero), dA));
+            }
+            _mm_storeu_si128((__m128i *)(dstp + i), lo);
+            _mm_storeu_si128((__m128i *)(dstp + i + 4), hi);
+        }
+        BlitRGBtoRGBPixelAlphaRow(srcp + i, dstp + i, width - i, &layout);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+}
+
+/* Expand 5 or 6 bit channels to 8 bits, x * 255 / 31 or x * 255 / 63 */
+static SDL_INLINE __m128i
+Expand_SSE2(__m128i x, __m128i full, __m128i magic)
+{
+    return _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(x, full), magic), 4);
+}
+
+static void
+BlitRGBto565PixelAlphaSSE2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+    const __m128i magic5 = _mm_set1_epi16((short)33826);
+    const __m128i magic6 = _mm_set1_epi16((short)16645);
+    PixelAlphaLayout layout;
+    __m128i sR, sG, sB, sA, dR, dB, modA;
+
+    GetPixelAlphaLayout(info, &layout);
+    sR = _mm_cvtsi32_si128(layout.sR);
+    sG = _mm_cvtsi32_si128(layout.sG);
+    sB = _mm_cvtsi32_si128(layout.sB);
+    sA = _mm_cvtsi32_si128(layout.sA);
+    dR = _mm_cvtsi32_si128(layout.dR);
+    dB = _mm_cvtsi32_si128(layout.dB);
+    modA = _mm_set1_epi16((short)layout.modA);
+
+    while (height--) {
+        const Uint32 *srcp = (const Uint32 *)src;
+        Uint16 *dstp = (Uint16 *)dst;
+        int i = 0;
+
+        for (; i + 8 <= width; i += 8) {
+            const __m128i s0 = _mm_loadu_si128((const __m128i *)(srcp + i));
+            const __m128i s1 = _mm_loadu_si128((const __m128i *)(srcp + i + 4));
+            const __m128i d = _mm_loadu_si128((const __m128i *)(dstp + i));
+            const __m128i a = Div255_SSE2(_mm_mullo_epi16(Channel_SSE2(s0, s1, sA, mask), modA), one);
+            const __m128i ia = _mm_sub_epi16(full, a);
+            const __m128i r = Blend_SSE2(Channel_SSE2(s0, s1, sR, mask),
+                                         Expand_SSE2(_mm_and_si128(_mm_srl_epi16(d, dR), mask5), full, magic5), a, ia, one);
+            const __m128i g = Blend_SSE2(Channel_SSE2(s0, s1, sG, mask),
+                                         Expand_SSE2(_mm_and_si128(_mm_srli_epi16(d, 5), mask6), full, magic6), a, ia, one);
+            const __m128i b = Blend_SSE2(Channel_SSE2(s0, s1, sB, mask),
+                                         Expand_SSE2(_mm_and_si128(_mm_srl_epi16(d, dB), mask5), full, magic5), a, ia, one);
+
+            _mm_storeu_si128((__m128i *)(dstp + i),
+                             _mm_or_si128(_mm_or_si128(_mm_sll_epi16(_mm_srli_epi16(r, 3), dR),
+                                                       _mm_slli_epi16(_mm_srli_epi16(g, 2), 5)),
+                                          _mm_sll_epi16(_mm_srli_epi16(b, 3), dB)));
+        }
+        BlitRGBto565PixelAlphaRow(srcp + i, dstp + i, width - i, &layout);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+}
+#endif /* HAVE_SSE2_PIXEL_ALPHA */
+
+#if HAVE_AVX2_PIXEL_ALPHA
+/* One channel of 16 pixels, in 16-bit lanes.
+   The pixels come out as 0-3, 8-11, 4-7, 12-15, which unpacking undoes. */
+static SDL_INLINE __m256i SDL_TARGETING("avx2")
+Channel_AVX2(__m256i lo, __m256i hi, __m128i shift, __m256i mask)
+{
+    return _mm256_packs_epi32(_mm256_and_si256(_mm256_srl_epi32(lo, shift), mask),
+                              _mm256_and_si256(_mm256_srl_epi32(hi, shift), mask));
+}
+
+static SDL_INLINE __m256i SDL_TARGETING("avx2")
+Div255_AVX2(__m256i x, __m256i one)
+{
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, one), _mm256_srli_epi16(x, 8)), 8);
+}
+
+static SDL_INLINE __m256i SDL_TARGETING("avx2")
+Blend_AVX2(__m256i s, __m256i d, __m256i a, __m256i ia, __m256i one)
+{
+    return _mm256_add_epi16(Div255_AVX2(_mm256_mullo_epi16(s, a), one),
+                            Div255_AVX2(_mm256_mullo_epi16(d, ia), one));
+}
+
+static void SDL_TARGETING("avx2")
+BlitRGBtoRGBPixelAlphaAVX2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i full = _mm256_set1_epi16(255);
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    PixelAlphaLayout layout;
+    __m128i sR, sG, sB, sA, dR, dG, dB, dA;
+    __m256i modA;
+
+    GetPixelAlphaLayout(info, &layout);
+    sR = _mm_cvtsi32_si128(layout.sR);
+    sG = _mm_cvtsi32_si128(layout.sG);
+    sB = _mm_cvtsi32_si128(layout.sB);
+    sA = _mm_cvtsi32_si128(layout.sA);
+    dR = _mm_cvtsi32_si128(layout.dR);
+    dG = _mm_cvtsi32_si128(layout.dG);
+    dB = _mm_cvtsi32_si128(layout.dB);
+    dA = _mm_cvtsi32_si128(layout.dA);
+    modA = _mm256_set1_epi16((short)layout.modA);
+
+    while (height--) {
+        const Uint32 *srcp = (const Uint32 *)src;
+        Uint32 *dstp = (Uint32 *)dst;
+        int i = 0;
+
+        for (; i + 16 <= width; i += 16) {
+            const __m256i s0 = _mm256_loadu_si256((const __m256i *)(srcp + i));
+            const __m256i s1 = _mm256_loadu_si256((const __m256i *)(srcp + i + 8));
+            const __m256i d0 = _mm256_loadu_si256((const __m256i *)(dstp + i));
+            const __m256i d1 = _mm256_loadu_si256((const __m256i *)(dstp + i + 8));
+            const __m256i a = Div255_AVX2(_mm256_mullo_epi16(Channel_AVX2(s0, s1, sA, mask), modA), one);
+            const __m256i ia = _mm256_sub_epi16(full, a);
+            const __m256i r = Blend_AVX2(Channel_AVX2(s0, s1, sR, mask), Channel_AVX2(d0, d1, dR, mask), a, ia, one);
+            const __m256i g = Blend_AVX2(Channel_AVX2(s0, s1, sG, mask), Channel_AVX2(d0, d1, dG, mask), a, ia, one);
+            const __m256i b = Blend_AVX2(Channel_AVX2(s0, s1, sB, mask), Channel_AVX2(d0, d1, dB, mask), a, ia, one);
+            __m256i lo, hi;
+
+            lo = _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi32(_mm256_unpacklo_epi16(r, zero), dR),
+                                                 _mm256_sll_epi32(_mm256_unpacklo_epi16(g, zero), dG)),
+                                 _mm256_sll_epi32(_mm256_unpacklo_epi16(b, zero), dB));
+            hi = _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi32(_mm256_unpackhi_epi16(r, zero), dR),
+                                                 _mm256_sll_epi32(_mm256_unpackhi_epi16(g, zero), dG)),
+                                 _mm256_sll_epi32(_mm256_unpackhi_epi16(b, zero), dB));
+            if (layout.dA >= 0) {
+                const __m256i alpha = _mm256_add_epi16(a, Div255_AVX2(_mm256_mullo_epi16(Channel_AVX2(d0, d1, dA, mask), ia), one));
+                lo = _mm256_or_si256(lo, _mm256_sll_epi32(_mm256_unpacklo_epi16(alpha, zero), dA));
+                hi = _mm256_or_si256(hi, _mm256_sll_epi32(_mm256_unpackhi_epi16(alpha, zero), dA));
+            }
+            _mm256_storeu_si256((__m256i *)(dstp + i), lo);
+            _mm256_storeu_si256((__m256i *)(dstp + i + 8), hi);
+        }
+        BlitRGBtoRGBPixelAlphaRow(srcp + i, dstp + i, width - i, &layout);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+}
+
+static SDL_INLINE __m256i SDL_TARGETING("avx2")
+Expand_AVX2(__m256i x, __m256i full, __m256i magic)
+{
+    return _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(x, full), magic), 4);
+}
+
+static void SDL_TARGETING("avx2")
+BlitRGBto565PixelAlphaAVX2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i full = _mm256_set1_epi16(255);
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    const __m256i mask5 = _mm256_set1_epi16(0x1F);
+    const __m256i mask6 = _mm256_set1_epi16(0x3F);
+    const __m256i magic5 = _mm256_set1_epi16((short)33826);
+    const __m256i magic6 = _mm256_set1_epi16((short)16645);
+    PixelAlphaLayout layout;
+    __m128i sR, sG, sB, sA, dR, dB;
+    __m256i modA;
+
+    GetPixelAlphaLayout(info, &layout);
+    sR = _mm_cvtsi32_si128(layout.sR);
+    sG = _mm_cvtsi32_si128(layout.sG);
+    sB = _mm_cvtsi32_si128(layout.sB);
+    sA = _mm_cvtsi32_si128(layout.sA);
+    dR = _mm_cvtsi32_si128(layout.dR);
+    dB = _mm_cvtsi32_si128(layout.dB);
+    modA = _mm256_set1_epi16((short)layout.modA);
+
+    while (height--) {
+        const Uint32 *srcp = (const Uint32 *)src;
+        Uint16 *dstp = (Uint16 *)dst;
+        int i = 0;
+
+        for (; i + 16 <= width; i += 16) {
+            /* Put the source pixels in order to match the destination */
+            const __m256i s0 = _mm256_loadu_si256((const __m256i *)(srcp + i));
+            const __m256i s1 = _mm256_loadu_si256((const __m256i *)(srcp + i + 8));
+            const __m256i d = _mm256_loadu_si256((const __m256i *)(dstp + i));
+            const __m256i a = Div255_AVX2(_mm256_mullo_epi16(_mm256_permute4x64_epi64(Channel_AVX2(s0, s1, sA, mask), _MM_SHUFFLE(3, 1, 2, 0)), modA), one);
+            const __m256i ia = _mm256_sub_epi16(full, a);
+            const __m256i r = Blend_AVX2(_mm256_permute4x64_epi64(Channel_AVX2(s0, s1, sR, mask), _MM_SHUFFLE(3, 1, 2, 0)),
+                                         Expand_AVX2(_mm256_and_si256(_mm256_srl_epi16(d, dR), mask5), full, magic5), a, ia, one);
+            const __m256i g = Blend_AVX2(_mm256_permute4x64_epi64(Channel_AVX2(s0, s1, sG, mask), _MM_SHUFFLE(3, 1, 2, 0)),
+                                         Expand_AVX2(_mm256_and_si256(_mm256_srli_epi16(d, 5), mask6), full, magic6), a, ia, one);
+            const __m256i b = Blend_AVX2(_mm256_permute4x64_epi64(Channel_AVX2(s0, s1, sB, mask), _MM_SHUFFLE(3, 1, 2, 0)),
+                                         Expand_AVX2(_mm256_and_si256(_mm256_srl_epi16(d, dB), mask5), full, magic5), a, ia, one);
+
+            _mm256_storeu_si256((__m256i *)(dstp + i),
+                                _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi16(_mm256_srli_epi16(r, 3), dR),
+                                                                _mm256_slli_epi16(_mm256_srli_epi16(g, 2), 5)),
+                                                _mm256_sll_epi16(_mm256_srli_epi16(b, 3), dB)));
+        }
+        BlitRGBto565PixelAlphaRow(srcp + i, dstp + i, width - i, &layout);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+}
+#endif /* HAVE_AVX2_PIXEL_ALPHA */
+
+#if HAVE_NEON_PIXEL_ALPHA
+static SDL_INLINE uint16x8_t
+Div255_NEON(uint16x8_t x)
+{
+    return vshrq_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+}
+
+static SDL_INLINE uint16x8_t
+Blend_NEON(uint8x8_t s, uint16x8_t d, uint16x8_t a, uint16x8_t ia)
+{
+    return vaddq_u16(Div255_NEON(vmulq_u16(vmovl_u8(s), a)), Div255_NEON(vmulq_u16(d, ia)));
+}
+
+static void
+BlitRGBtoRGBPixelAlphaNEON(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    PixelAlphaLayout layout;
+    int sR, sG, sB, sA, dR, dG, dB, dA;
+    uint16x8_t modA;
+
+    GetPixelAlphaLayout(info, &layout);
+    /* Byte offsets of the channels in memory */
+    sR = layout.sR / 8;
+    sG = layout.sG / 8;
+    sB = layout.sB / 8;
+    sA = layout.sA / 8;
+    dR = layout.dR / 8;
+    dG = layout.dG / 8;
+    dB = layout.dB / 8;
+    dA = (layout.dA >= 0) ? layout.dA / 8 : (6 - dR - dG - dB);
+    modA = vdupq_n_u16((uint16_t)layout.modA);
+
+    while (height--) {
+        const Uint32 *srcp = (const Uint32 *)src;
+        Uint32 *dstp = (Uint32 *)dst;
+        int i = 0;
+
+        for (; i + 8 <= width; i += 8) {
+            const uint8x8x4_t s = vld4_u8((const uint8_t *)(srcp + i));
+            uint8x8x4_t d = vld4_u8((const uint8_t *)(dstp + i));
+            const uint16x8_t a = Div255_NEON(vmulq_u16(vmovl_u8(s.val[sA]), modA));
+            const uint16x8_t ia = vsubq_u16(vdupq_n_u16(255), a);
+            const uint8x8_t r = vmovn_u16(Blend_NEON(s.val[sR], vmovl_u8(d.val[dR]), a, ia));
+            const uint8x8_t g = vmovn_u16(Blend_NEON(s.val[sG], vmovl_u8(d.val[dG]), a, ia));
+            const uint8x8_t b = vmovn_u16(Blend_NEON(s.val[sB], vmovl_u8(d.val[dB]), a, ia));
+
+            if (layout.dA >= 0) {
+                d.val[dA] = vmovn_u16(vaddq_u16(a, Div255_NEON(vmulq_u16(vmovl_u8(d.val[dA]), ia))));
+            } else {
+                d.val[dA] = vdup_n_u8(0);
+            }
+            d.val[dR] = r;
+            d.val[dG] = g;
+            d.val[dB] = b;
+            vst4_u8((uint8_t *)(dstp + i), d);
+        }
+        BlitRGBtoRGBPixelAlphaRow(srcp + i, dstp + i, width - i, &layout);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+}
+
+/* Expand 5 or 6 bit channels to 8 bits, x * 255 / 31 or x * 255 / 63 */
+static SDL_INLINE uint16x8_t
+Expand_NEON(uint16x8_t x, uint16x4_t magic)
+{
+    const uint16x8_t t = vmulq_n_u16(x, 255);
+    const uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(t), magic), 16);
+    const uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(t), magic), 16);
+    return vshrq_n_u16(vcombine_u16(lo, hi), 4);
+}
+
+static void
+BlitRGBto565PixelAlphaNEON(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    const uint16x4_t magic5 = vdup_n_u16(33826);
+    const uint16x4_t magic6 = vdup_n_u16(16645);
+    const uint16x8_t mask5 = vdupq_n_u16(0x1F);
+    const uint16x8_t mask6 = vdupq_n_u16(0x3F);
+    PixelAlphaLayout layout;
+    int sR, sG, sB, sA;
+    int16x8_t dR, dB, dRneg, dBneg;
+    uint16x8_t modA;
+
+    GetPixelAlphaLayout(info, &layout);
+    sR = layout.sR / 8;
+    sG = layout.sG / 8;
+    sB = layout.sB / 8;
+    sA = layout.sA / 8;
+    dR = vdupq_n_s16((int16_t)layout.dR);
+    dB = vdupq_n_s16((int16_t)layout.dB);
+    dRneg = vnegq_s16(dR);
+    dBneg = vnegq_s16(dB);
+    modA = vdupq_n_u16((uint16_t)layout.modA);
+
+    while (height--) {
+        const Uint32 *srcp = (const Uint32 *)src;
+        Uint16 *dstp = (Uint16 *)dst;
+        int i = 0;
+
+        for (; i + 8 <= width; i += 8) {
+            const uint8x8x4_t s = vld4_u8((const uint8_t *)(srcp + i));
+            const uint16x8_t d = vld1q_u16(dstp + i);
+            const uint16x8_t a = Div255_NEON(vmulq_u16(vmovl_u8(s.val[sA]), modA));
+            const uint16x8_t ia = vsubq_u16(vdupq_n_u16(255), a);
+            const uint16x8_t r = Blend_NEON(s.val[sR], Expand_NEON(vandq_u16(vshlq_u16(d, dRneg), mask5), magic5), a, ia);
+            const uint16x8_t g = Blend_NEON(s.val[sG], Expand_NEON(vandq_u16(vshrq_n_u16(d, 5), mask6), magic6), a, ia);
+            const uint16x8_t b = Blend_NEON(s.val[sB], Expand_NEON(vandq_u16(vshlq_u16(d, dBneg), mask5), magic5), a, ia);
+
+            vst1q_u16(dstp + i, vorrq_u16(vorrq_u16(vshlq_u16(vshrq_n_u16(r, 3), dR),
+                                                    vshlq_n_u16(vshrq_n_u16(g, 2), 5)),
+                                          vshlq_u16(vshrq_n_u16(b, 3), dB)));
+        }
+        BlitRGBto565PixelAlphaRow(srcp + i, dstp + i, width - i, &layout);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+}
+#endif /* HAVE_NEON_PIXEL_ALPHA */
+
+/* Whether a format holds four 8-bit channels at byte boundaries */
+static SDL_bool
+IsByteAligned8888(const SDL_PixelFormat * fmt, SDL_bool need_alpha)
+{
+    if (fmt->BytesPerPixel != 4 || (need_alpha && !fmt->Amask)) {
+        return SDL_FALSE;
+    }
+    if ((fmt->Rmask >> fmt->Rshift) != 0xFF || (fmt->Rshift % 8) != 0 ||
+        (fmt->Gmask >> fmt->Gshift) != 0xFF || (fmt->Gshift % 8) != 0 ||
+        (fmt->Bmask >> fmt->Bshift) != 0xFF || (fmt->Bshift % 8) != 0) {
+        return SDL_FALSE;
+    }
+    if (fmt->Amask && ((fmt->Amask >> fmt->Ashift) != 0xFF || (fmt->Ashift % 8) != 0)) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+/* Pick a SIMD blitter for per-pixel alpha from an 8888 surface, or NULL */
+static SDL_BlitFunc
+SDL_CalculatePixelAlphaSIMD(SDL_PixelFormat * sf, SDL_PixelFormat * df)
+{
+    if (!IsByteAligned8888(sf, SDL_TRUE)) {
+        return NULL;
+    }
+    if (IsByteAligned8888(df, SDL_FALSE)) {
+#if HAVE_AVX2_PIXEL_ALPHA
+        if (SDL_HasAVX2()) {
+            return BlitRGBtoRGBPixelAlphaAVX2;
+        }
+#endif
+#if HAVE_SSE2_PIXEL_ALPHA
+        if (SDL_HasSSE2()) {
+            return BlitRGBtoRGBPixelAlphaSSE2;
+        }
+#endif
+#if HAVE_NEON_PIXEL_ALPHA
+        if (SDL_HasNEON()) {
+            return BlitRGBtoRGBPixelAlphaNEON;
+        }
+#endif
+    } else if (df->BytesPerPixel == 2 && df->Amask == 0 && df->Gmask == 0x07E0 &&
+               ((df->Rmask == 0xF800 && df->Bmask == 0x001F) ||
+                (df->Rmask == 0x001F && df->Bmask == 0xF800))) {
+#if HAVE_AVX2_PIXEL_ALPHA
+        if (SDL_HasAVX2()) {
+            return BlitRGBto565PixelAlphaAVX2;
+        }
+#endif
+#if HAVE_SSE2_PIXEL_ALPHA
+        if (SDL_HasSSE2()) {
+            return BlitRGBto565PixelAlphaSSE2;
+        }
+#endif
+#if HAVE_NEON_PIXEL_ALPHA
+        if (SDL_HasNEON()) {
+            return BlitRGBto565PixelAlphaNEON;
+        }
+#endif
+    }
+    return NULL;
+}
+
+#endif /* HAVE_SSE2_PIXEL_ALPHA || HAVE_AVX2_PIXEL_ALPHA || HAVE_NEON_PIXEL_ALPHA */
+
 
 SDL_BlitFunc
 SDL_CalculateBlitA(SDL_Surface * surface)
 {
     SDL_PixelFormat *sf = surface->format;
     SDL_PixelFormat *df = surface->map->dst->format;
+#if HAVE_SSE2_PIXEL_ALPHA || HAVE_AVX2_PIXEL_ALPHA || HAVE_NEON_PIXEL_ALPHA
+    SDL_BlitFunc simd;
+#endif
 
     switch (surface->map->info.flags & ~SDL_COPY_RLE_MASK) {
     case SDL_COPY_BLEND:
         /* Per-pixel alpha blits */
+#if HAVE_SSE2_PIXEL_ALPHA || HAVE_AVX2_PIXEL_ALPHA || HAVE_NEON_PIXEL_ALPHA
+        simd = SDL_CalculatePixelAlphaSIMD(sf, df);
+        if (simd) {
+            return simd;
+        }
+#endif
         switch (df->BytesPerPixel) {
         case 1:
             if (df->palette != NULL) {
@@ -1530,7 +2134,12 @@ SDL_CalculateBlitA(SDL_Surface * surface)
                 return BlitNtoNSurfaceAlpha;
             }
         }
+#if HAVE_SSE2_PIXEL_ALPHA || HAVE_AVX2_PIXEL_ALPHA || HAVE_NEON_PIXEL_ALPHA
+        /* Per-pixel alpha blits with surface alpha modulation */
+        return SDL_CalculatePixelAlphaSIMD(sf, df);
+#else
         break;
+#endif
 
     case SDL_COPY_COLORKEY | SDL_COPY_MODULATE_ALPHA | SDL_COPY_BLEND:
         if (sf->Amask == 0) {
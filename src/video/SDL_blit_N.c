@@ -44,7 +44,11 @@ enum blit_features {
     BLIT_FEATURE_HAS_MMX = 1,
     BLIT_FEATURE_HAS_ALTIVEC = 2,
     BLIT_FEATURE_ALTIVEC_DONT_USE_PREFETCH = 4,
-    BLIT_FEATURE_HAS_ARM_SIMD = 8
+    BLIT_FEATURE_HAS_ARM_SIMD = 8,
+    BLIT_FEATURE_HAS_SSE2 = 16,
+    BLIT_FEATURE_HAS_SSSE3 = 32,
+    BLIT_FEATURE_HAS_AVX2 = 64,
+    BLIT_FEATURE_HAS_NEON = 128
 };
 
 #if SDL_ALTIVEC_BLITTERS
@@ -933,8 +937,11 @@ GetBlitFeatures(void)
 #pragma altivec_model off
 #endif
 #else
-/* Feature 1 is has-MMX */
-#define GetBlitFeatures() ((SDL_HasMMX() ? BLIT_FEATURE_HAS_MMX : 0) | (SDL_HasARMSIMD() ? BLIT_FEATURE_HAS_ARM_SIMD : 0))
+/* Feature 1 is has-MMX.
+   There is no SSSE3 query, but every CPU with SSE4.1 also has SSSE3. */
+#define GetBlitFeatures() ((SDL_HasMMX() ? BLIT_FEATURE_HAS_MMX : 0) | (SDL_HasARMSIMD() ? BLIT_FEATURE_HAS_ARM_SIMD : 0) | \
+                           (SDL_HasSSE2() ? BLIT_FEATURE_HAS_SSE2 : 0) | (SDL_HasSSE41() ? BLIT_FEATURE_HAS_SSSE3 : 0) | \
+                           (SDL_HasAVX2() ? BLIT_FEATURE_HAS_AVX2 : 0) | (SDL_HasNEON() ? BLIT_FEATURE_HAS_NEON : 0))
 #endif
 
 #if SDL_ARM_SIMD_BLITTERS
@@ -3248,6 +3255,641 @@ Blit_3or4_to_3or4__inversed_rgb(SDL_BlitInfo * info)
     }
 }
 
+/* SIMD channel swizzles between byte aligned 24 and 32-bit formats, and
+ * conversions between those and RGB565/BGR565.
+ *
+ * The destination gets the source channels, the source alpha if both
+ * formats have one, info->a if only the destination has alpha, and zero
+ * in any unused byte. 565 channels are expanded the way SDL_expand_byte
+ * does and truncated when packing, like the other blitters.
+ */
+
+#if defined(HAVE_AVX2_INTRINSICS)
+#define HAVE_SSSE3_SWIZZLE 1
+#define HAVE_AVX2_SWIZZLE 1
+#endif
+#if defined(__SSE2__)
+#define HAVE_SSE2_SWIZZLE 1
+#endif
+#if defined(__ARM_NEON)
+#define HAVE_NEON_SWIZZLE 1
+#endif
+
+/* The kernels address channels by their byte offset, which requires a little endian layout */
+#if SDL_BYTEORDER != SDL_LIL_ENDIAN
+#undef HAVE_SSSE3_SWIZZLE
+#undef HAVE_AVX2_SWIZZLE
+#undef HAVE_SSE2_SWIZZLE
+#undef HAVE_NEON_SWIZZLE
+#endif
+
+#if HAVE_SSSE3_SWIZZLE || HAVE_AVX2_SWIZZLE || HAVE_SSE2_SWIZZLE || HAVE_NEON_SWIZZLE
+
+#define SWIZZLE_NONE 0x80
+
+typedef struct
+{
+    int srcbpp;
+    int dstbpp;
+    Uint8 index[4];     /* source byte of each destination byte, or SWIZZLE_NONE */
+    Uint32 alpha;       /* bits set in every destination pixel */
+} SwizzleLayout;
+
+static void
+GetSwizzleLayout(const SDL_BlitInfo * info, SwizzleLayout * layout)
+{
+    const SDL_PixelFormat *srcfmt = info->src_fmt;
+    const SDL_PixelFormat *dstfmt = info->dst_fmt;
+
+    layout->srcbpp = srcfmt->BytesPerPixel;
+    layout->dstbpp = dstfmt->BytesPerPixel;
+    SDL_memset(layout->index, SWIZZLE_NONE, sizeof(layout->index));
+    layout->alpha = 0;
+
+    /* 565 formats only use the shifts of the other format */
+    if (layout->dstbpp > 2) {
+        layout->index[dstfmt->Rshift / 8] = (Uint8)(srcfmt->Rshift / 8);
+        layout->index[dstfmt->Gshift / 8] = (Uint8)(srcfmt->Gshift / 8);
+        layout->index[dstfmt->Bshift / 8] = (Uint8)(srcfmt->Bshift / 8);
+        if (dstfmt->Amask) {
+            if (srcfmt->Amask) {
+                layout->index[dstfmt->Ashift / 8] = (Uint8)(srcfmt->Ashift / 8);
+            } else {
+                layout->alpha = (Uint32)info->a << dstfmt->Ashift;
+            }
+        }
+    }
+}
+
+/* Scalar versions, used for the pixels left over by the SIMD loops */
+static void
+SwizzleRow(const Uint8 * src, Uint8 * dst, int width, const SwizzleLayout * layout)
+{
+    int i, j;
+
+    for (i = 0; i < width; ++i) {
+        for (j = 0; j < layout->dstbpp; ++j) {
+            const Uint8 index = layout->index[j];
+            dst[j] = (index == SWIZZLE_NONE) ? (Uint8)(layout->alpha >> (j * 8)) : src[index];
+        }
+        src += layout->srcbpp;
+        dst += layout->dstbpp;
+    }
+}
+
+static void
+RGB565to8888Row(const Uint16 * src, Uint32 * dst, int width, const SDL_PixelFormat * srcfmt,
+                const SDL_PixelFormat * dstfmt, Uint32 alpha)
+{
+    int i;
+
+    for (i = 0; i < width; ++i) {
+        const Uint32 pixel = src[i];
+        dst[i] = ((((pixel >> srcfmt->Rshift) & 0x1F) * 255 / 31) << dstfmt->Rshift) |
+                 ((((pixel >> 5) & 0x3F) * 255 / 63) << dstfmt->Gshift) |
+                 ((((pixel >> srcfmt->Bshift) & 0x1F) * 255 / 31) << dstfmt->Bshift) |
+                 alpha;
+    }
+}
+
+static void
+RGB8888to565Row(const Uint32 * src, Uint16 * dst, int width, const SDL_PixelFormat * srcfmt,
+                const SDL_PixelFormat * dstfmt)
+{
+    int i;
+
+    for (i = 0; i < width; ++i) {
+        const Uint32 pixel = src[i];
+        dst[i] = (Uint16)((((pixel >> (srcfmt->Rshift + 3)) & 0x1F) << dstfmt->Rshift) |
+                          (((pixel >> (srcfmt->Gshift + 2)) & 0x3F) << 5) |
+                          (((pixel >> (srcfmt->Bshift + 3)) & 0x1F) << dstfmt->Bshift));
+    }
+}
+
+/* The alpha bits to set when converting a 565 surface */
+static Uint32
+Get565Alpha(const SDL_BlitInfo * info)
+{
+    return info->dst_fmt->Amask ? ((Uint32)info->a << info->dst_fmt->Ashift) : 0;
+}
+
+#endif /* HAVE_SSSE3_SWIZZLE || HAVE_AVX2_SWIZZLE || HAVE_SSE2_SWIZZLE || HAVE_NEON_SWIZZLE */
+
+#if HAVE_SSSE3_SWIZZLE
+/* Any 3 or 4 bytes per pixel to 3 or 4 bytes per pixel, 4 pixels at a time */
+static void SDL_TARGETING("ssse3")
+Blit_Swizzle_SSSE3(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    SwizzleLayout layout;
+    Uint8 shuffle[16];
+    __m128i mask, alpha;
+    int i, j;
+
+    GetSwizzleLayout(info, &layout);
+    SDL_memset(shuffle, SWIZZLE_NONE, sizeof(shuffle));
+    for (i = 0; i < 4; ++i) {
+        for (j = 0; j < layout.dstbpp; ++j) {
+            if (layout.index[j] != SWIZZLE_NONE) {
+                shuffle[i * layout.dstbpp + j] = (Uint8)(i * layout.srcbpp + layout.index[j]);
+            }
+        }
+    }
+    mask = _mm_loadu_si128((const __m128i *)shuffle);
+    alpha = _mm_set1_epi32((int)layout.alpha);
+
+    while (height--) {
+        const Uint8 *s = src;
+        Uint8 *d = dst;
+
+        /* Each step reads 16 bytes, which is more than 4 pixels of 3 bytes */
+        for (i = 0; i + 4 <= width && (i * layout.srcbpp + 16) <= width * layout.srcbpp; i += 4) {
+            const __m128i pixels = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)s), mask);
+            if (layout.dstbpp == 4) {
+                _mm_storeu_si128((__m128i *)d, _mm_or_si128(pixels, alpha));
+            } else {
+                _mm_storel_epi64((__m128i *)d, pixels);
+                *(Uint32 *)(d + 8) = (Uint32)_mm_cvtsi128_si32(_mm_srli_si128(pixels, 8));
+            }
+            s += 4 * layout.srcbpp;
+            d += 4 * layout.dstbpp;
+        }
+        SwizzleRow(s, d, width - i, &layout);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+}
+#endif /* HAVE_SSSE3_SWIZZLE */
+
+#if HAVE_AVX2_SWIZZLE
+/* 4 bytes per pixel to 4 bytes per pixel, 8 pixels at a time */
+static void SDL_TARGETING("avx2")
+Blit_Swizzle32_AVX2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    SwizzleLayout layout;
+    Uint8 shuffle[16];
+    __m256i mask, alpha;
+    int i, j;
+
+    GetSwizzleLayout(info, &layout);
+    for (i = 0; i < 4; ++i) {
+        for (j = 0; j < 4; ++j) {
+            shuffle[i * 4 + j] = (layout.index[j] == SWIZZLE_NONE) ? SWIZZLE_NONE : (Uint8)(i * 4 + layout.index[j]);
+        }
+    }
+    /* vpshufb works within each 128-bit lane */
+    mask = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)shuffle));
+    alpha = _mm256_set1_epi32((int)layout.alpha);
+
+    while (height--) {
+        const Uint32 *s = (const Uint32 *)src;
+        Uint32 *d = (Uint32 *)dst;
+
+        for (i = 0; i + 8 <= width; i += 8) {
+            const __m256i pixels = _mm256_loadu_si256((const __m256i *)(s + i));
+            _mm256_storeu_si256((__m256i *)(d + i), _mm256_or_si256(_mm256_shuffle_epi8(pixels, mask), alpha));
+        }
+        SwizzleRow((const Uint8 *)(s + i), (Uint8 *)(d + i), width - i, &layout);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+}
+
+/* Expand 5 or 6 bit channels to 8 bits, x * 255 / 31 or x * 255 / 63 */
+static SDL_INLINE __m256i SDL_TARGETING("avx2")
+Expand565_AVX2(__m256i x, __m128i shift, __m256i mask, __m256i magic)
+{
+    x = _mm256_and_si256(_mm256_srl_epi16(x, shift), mask);
+    return _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(x, _mm256_set1_epi16(255)), magic), 4);
+}
+
+static void SDL_TARGETING("avx2")
+Blit_RGB565to8888_AVX2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    const SDL_PixelFormat *srcfmt = info->src_fmt;
+    const SDL_PixelFormat *dstfmt = info->dst_fmt;
+    const Uint32 alpha = Get565Alpha(info);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mask5 = _mm256_set1_epi16(0x1F);
+    const __m256i mask6 = _mm256_set1_epi16(0x3F);
+    const __m256i magic5 = _mm256_set1_epi16((short)33826);
+    const __m256i magic6 = _mm256_set1_epi16((short)16645);
+    const __m256i alphav = _mm256_set1_epi32((int)alpha);
+    const __m128i sR = _mm_cvtsi32_si128(srcfmt->Rshift);
+    const __m128i sG = _mm_cvtsi32_si128(5);
+    const __m128i sB = _mm_cvtsi32_si128(srcfmt->Bshift);
+    const __m128i dR = _mm_cvtsi32_si128(dstfmt->Rshift);
+    const __m128i dG = _mm_cvtsi32_si128(dstfmt->Gshift);
+    const __m128i dB = _mm_cvtsi32_si128(dstfmt->Bshift);
+    int i;
+
+    while (height--) {
+        const Uint16 *s = (const Uint16 *)src;
+        Uint32 *d = (Uint32 *)dst;
+
+        for (i = 0; i + 16 <= width; i += 16) {
+            const __m256i pixels = _mm256_loadu_si256((const __m256i *)(s + i));
+            const __m256i r = Expand565_AVX2(pixels, sR, mask5, magic5);
+            const __m256i g = Expand565_AVX2(pixels, sG, mask6, magic6);
+            const __m256i b = Expand565_AVX2(pixels, sB, mask5, magic5);
+            /* Pixels 0-3 and 8-11, then 4-7 and 12-15 */
+            const __m256i lo = _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi32(_mm256_unpacklo_epi16(r, zero), dR),
+                                                               _mm256_sll_epi32(_mm256_unpacklo_epi16(g, zero), dG)),
+                                               _mm256_or_si256(_mm256_sll_epi32(_mm256_unpacklo_epi16(b, zero), dB), alphav));
+            const __m256i hi = _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi32(_mm256_unpackhi_epi16(r, zero), dR),
+                                                               _mm256_sll_epi32(_mm256_unpackhi_epi16(g, zero), dG)),
+                                               _mm256_or_si256(_mm256_sll_epi32(_mm256_unpackhi_epi16(b, zero), dB), alphav));
+
+            _mm256_storeu_si256((__m256i *)(d + i), _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256((__m256i *)(d + i + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+        }
+        RGB565to8888Row(s + i, d + i, width - i, srcfmt, dstfmt, alpha);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+}
+
+/* Pack 8 pixels to 565 in the low 16 bits of each 32-bit lane */
+static SDL_INLINE __m256i SDL_TARGETING("avx2")
+Pack565_AVX2(__m256i pixels, __m128i sR, __m128i sG, __m128i sB, __m128i dR, __m128i dB)
+{
+    const __m256i r = _mm256_sll_epi32(_mm256_and_si256(_mm256_srl_epi32(pixels, sR), _mm256_set1_epi32(0x1F)), dR);
+    const __m256i g = _mm256_slli_epi32(_mm256_and_si256(_mm256_srl_epi32(pixels, sG), _mm256_set1_epi32(0x3F)), 5);
+    const __m256i b = _mm256_sll_epi32(_mm256_and_si256(_mm256_srl_epi32(pixels, sB), _mm256_set1_epi32(0x1F)), dB);
+    /* Sign extend the result so packing with signed saturation keeps all 16 bits */
+    return _mm256_srai_epi32(_mm256_slli_epi32(_mm256_or_si256(_mm256_or_si256(r, g), b), 16), 16);
+}
+
+static void SDL_TARGETING("avx2")
+Blit_8888toRGB565_AVX2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    const SDL_PixelFormat *srcfmt = info->src_fmt;
+    const SDL_PixelFormat *dstfmt = info->dst_fmt;
+    const __m128i sR = _mm_cvtsi32_si128(srcfmt->Rshift + 3);
+    const __m128i sG = _mm_cvtsi32_si128(srcfmt->Gshift + 2);
+    const __m128i sB = _mm_cvtsi32_si128(srcfmt->Bshift + 3);
+    const __m128i dR = _mm_cvtsi32_si128(dstfmt->Rshift);
+    const __m128i dB = _mm_cvtsi32_si128(dstfmt->Bshift);
+    int i;
+
+    while (height--) {
+        const Uint32 *s = (const Uint32 *)src;
+        Uint16 *d = (Uint16 *)dst;
+
+        for (i = 0; i + 16 <= width; i += 16) {
+            const __m256i lo = Pack565_AVX2(_mm256_loadu_si256((const __m256i *)(s + i)), sR, sG, sB, dR, dB);
+            const __m256i hi = Pack565_AVX2(_mm256_loadu_si256((const __m256i *)(s + i + 8)), sR, sG, sB, dR, dB);
+            /* Packing interleaves the 128-bit lanes, put the pixels back in order */
+            _mm256_storeu_si256((__m256i *)(d + i), _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0)));
+        }
+        RGB8888to565Row(s + i, d + i, width - i, srcfmt, dstfmt);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+}
+#endif /* HAVE_AVX2_SWIZZLE */
+
+#if HAVE_SSE2_SWIZZLE
+static SDL_INLINE __m128i
+Expand565_SSE2(__m128i x, __m128i shift, __m128i mask, __m128i magic)
+{
+    x = _mm_and_si128(_mm_srl_epi16(x, shift), mask);
+    return _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(x, _mm_set1_epi16(255)), magic), 4);
+}
+
+static void
+Blit_RGB565to8888_SSE2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    const SDL_PixelFormat *srcfmt = info->src_fmt;
+    const SDL_PixelFormat *dstfmt = info->dst_fmt;
+    const Uint32 alpha = Get565Alpha(info);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+    const __m128i magic5 = _mm_set1_epi16((short)33826);
+    const __m128i magic6 = _mm_set1_epi16((short)16645);
+    const __m128i alphav = _mm_set1_epi32((int)alpha);
+    const __m128i sR = _mm_cvtsi32_si128(srcfmt->Rshift);
+    const __m128i sG = _mm_cvtsi32_si128(5);
+    const __m128i sB = _mm_cvtsi32_si128(srcfmt->Bshift);
+    const __m128i dR = _mm_cvtsi32_si128(dstfmt->Rshift);
+    const __m128i dG = _mm_cvtsi32_si128(dstfmt->Gshift);
+    const __m128i dB = _mm_cvtsi32_si128(dstfmt->Bshift);
+    int i;
+
+    while (height--) {
+        const Uint16 *s = (const Uint16 *)src;
+        Uint32 *d = (Uint32 *)dst;
+
+        for (i = 0; i + 8 <= width; i += 8) {
+            const __m128i pixels = _mm_loadu_si128((const __m128i *)(s + i));
+            const __m128i r = Expand565_SSE2(pixels, sR, mask5, magic5);
+            const __m128i g = Expand565_SSE2(pixels, sG, mask6, magic6);
+            const __m128i b = Expand565_SSE2(pixels, sB, mask5, magic5);
+
+            _mm_storeu_si128((__m128i *)(d + i),
+                             _mm_or_si128(_mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(r, zero), dR),
+                                                       _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), dG)),
+                                          _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(b, zero), dB), alphav)));
+            _mm_storeu_si128((__m128i *)(d + i + 4),
+                             _mm_or_si128(_mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(r, zero), dR),
+                                                       _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), dG)),
+                                          _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(b, zero), dB), alphav)));
+        }
+        RGB565to8888Row(s + i, d + i, width - i, srcfmt, dstfmt, alpha);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+}
+
+static SDL_INLINE __m128i
+Pack565_SSE2(__m128i pixels, __m128i sR, __m128i sG, __m128i sB, __m128i dR, __m128i dB)
+{
+    const __m128i r = _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(pixels, sR), _mm_set1_epi32(0x1F)), dR);
+    const __m128i g = _mm_slli_epi32(_mm_and_si128(_mm_srl_epi32(pixels, sG), _mm_set1_epi32(0x3F)), 5);
+    const __m128i b = _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(pixels, sB), _mm_set1_epi32(0x1F)), dB);
+    /* Sign extend the result so packing with signed saturation keeps all 16 bits */
+    return _mm_srai_epi32(_mm_slli_epi32(_mm_or_si128(_mm_or_si128(r, g), b), 16), 16);
+}
+
+static void
+Blit_8888toRGB565_SSE2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    const SDL_PixelFormat *srcfmt = info->src_fmt;
+    const SDL_PixelFormat *dstfmt = info->dst_fmt;
+    const __m128i sR = _mm_cvtsi32_si128(srcfmt->Rshift + 3);
+    const __m128i sG = _mm_cvtsi32_si128(srcfmt->Gshift + 2);
+    const __m128i sB = _mm_cvtsi32_si128(srcfmt->Bshift + 3);
+    const __m128i dR = _mm_cvtsi32_si128(dstfmt->Rshift);
+    const __m128i dB = _mm_cvtsi32_si128(dstfmt->Bshift);
+    int i;
+
+    while (height--) {
+        const Uint32 *s = (const Uint32 *)src;
+        Uint16 *d = (Uint16 *)dst;
+
+        for (i = 0; i + 8 <= width; i += 8) {
+            const __m128i lo = Pack565_SSE2(_mm_loadu_si128((const __m128i *)(s + i)), sR, sG, sB, dR, dB);
+            const __m128i hi = Pack565_SSE2(_mm_loadu_si128((const __m128i *)(s + i + 4)), sR, sG, sB, dR, dB);
+            _mm_storeu_si128((__m128i *)(d + i), _mm_packs_epi32(lo, hi));
+        }
+        RGB8888to565Row(s + i, d + i, width - i, srcfmt, dstfmt);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+}
+#endif /* HAVE_SSE2_SWIZZLE */
+
+#if HAVE_NEON_SWIZZLE
+/* Any 3 or 4 bytes per pixel to 3 or 4 bytes per pixel, 16 pixels at a time */
+static void
+Blit_Swizzle_NEON(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    SwizzleLayout layout;
+    uint8x16_t fill[4];
+    int i, j;
+
+    GetSwizzleLayout(info, &layout);
+    for (j = 0; j < 4; ++j) {
+        fill[j] = vdupq_n_u8((uint8_t)(layout.alpha >> (j * 8)));
+    }
+
+    while (height--) {
+        const Uint8 *s = src;
+        Uint8 *d = dst;
+
+        for (i = 0; i + 16 <= width; i += 16) {
+            uint8x16_t in[4], out[4];
+
+            if (layout.srcbpp == 4) {
+                const uint8x16x4_t pixels = vld4q_u8(s);
+                in[0] = pixels.val[0];
+                in[1] = pixels.val[1];
+                in[2] = pixels.val[2];
+                in[3] = pixels.val[3];
+            } else {
+                const uint8x16x3_t pixels = vld3q_u8(s);
+                in[0] = pixels.val[0];
+                in[1] = pixels.val[1];
+                in[2] = pixels.val[2];
+                in[3] = fill[3];
+            }
+            for (j = 0; j < 4; ++j) {
+                out[j] = (layout.index[j] == SWIZZLE_NONE) ? fill[j] : in[layout.index[j]];
+            }
+            if (layout.dstbpp == 4) {
+                uint8x16x4_t pixels;
+                pixels.val[0] = out[0];
+                pixels.val[1] = out[1];
+                pixels.val[2] = out[2];
+                pixels.val[3] = out[3];
+                vst4q_u8(d, pixels);
+            } else {
+                uint8x16x3_t pixels;
+                pixels.val[0] = out[0];
+                pixels.val[1] = out[1];
+                pixels.val[2] = out[2];
+                vst3q_u8(d, pixels);
+            }
+            s += 16 * layout.srcbpp;
+            d += 16 * layout.dstbpp;
+        }
+        SwizzleRow(s, d, width - i, &layout);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+}
+
+/* Expand 5 or 6 bit channels to 8 bits, x * 255 / 31 or x * 255 / 63 */
+static SDL_INLINE uint8x8_t
+Expand565_NEON(uint16x8_t x, uint16x4_t magic)
+{
+    const uint16x8_t t = vmulq_n_u16(x, 255);
+    const uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(t), magic), 16);
+    const uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(t), magic), 16);
+    return vshrn_n_u16(vcombine_u16(lo, hi), 4);
+}
+
+static void
+Blit_RGB565to8888_NEON(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    const SDL_PixelFormat *srcfmt = info->src_fmt;
+    const SDL_PixelFormat *dstfmt = info->dst_fmt;
+    const Uint32 alpha = Get565Alpha(info);
+    const int16x8_t sR = vdupq_n_s16((int16_t)-srcfmt->Rshift);
+    const int16x8_t sB = vdupq_n_s16((int16_t)-srcfmt->Bshift);
+    const uint16x8_t mask5 = vdupq_n_u16(0x1F);
+    const uint16x8_t mask6 = vdupq_n_u16(0x3F);
+    const uint16x4_t magic5 = vdup_n_u16(33826);
+    const uint16x4_t magic6 = vdup_n_u16(16645);
+    /* The byte that holds alpha, or is unused */
+    const int dA = 6 - (dstfmt->Rshift + dstfmt->Gshift + dstfmt->Bshift) / 8;
+    int i;
+
+    while (height--) {
+        const Uint16 *s = (const Uint16 *)src;
+        Uint32 *d = (Uint32 *)dst;
+
+        for (i = 0; i + 8 <= width; i += 8) {
+            const uint16x8_t pixels = vld1q_u16(s + i);
+            uint8x8x4_t out;
+
+            out.val[dstfmt->Rshift / 8] = Expand565_NEON(vandq_u16(vshlq_u16(pixels, sR), mask5), magic5);
+            out.val[dstfmt->Gshift / 8] = Expand565_NEON(vandq_u16(vshrq_n_u16(pixels, 5), mask6), magic6);
+            out.val[dstfmt->Bshift / 8] = Expand565_NEON(vandq_u16(vshlq_u16(pixels, sB), mask5), magic5);
+            out.val[dA] = vdup_n_u8((uint8_t)(alpha >> (dA * 8)));
+            vst4_u8((uint8_t *)(d + i), out);
+        }
+        RGB565to8888Row(s + i, d + i, width - i, srcfmt, dstfmt, alpha);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+}
+
+static void
+Blit_8888toRGB565_NEON(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    const SDL_PixelFormat *srcfmt = info->src_fmt;
+    const SDL_PixelFormat *dstfmt = info->dst_fmt;
+    const int16x8_t dR = vdupq_n_s16((int16_t)dstfmt->Rshift);
+    const int16x8_t dB = vdupq_n_s16((int16_t)dstfmt->Bshift);
+    int i;
+
+    while (height--) {
+        const Uint32 *s = (const Uint32 *)src;
+        Uint16 *d = (Uint16 *)dst;
+
+        for (i = 0; i + 8 <= width; i += 8) {
+            const uint8x8x4_t pixels = vld4_u8((const uint8_t *)(s + i));
+            const uint16x8_t r = vshlq_u16(vmovl_u8(vshr_n_u8(pixels.val[srcfmt->Rshift / 8], 3)), dR);
+            const uint16x8_t g = vshlq_n_u16(vmovl_u8(vshr_n_u8(pixels.val[srcfmt->Gshift / 8], 2)), 5);
+            const uint16x8_t b = vshlq_u16(vmovl_u8(vshr_n_u8(pixels.val[srcfmt->Bshift / 8], 3)), dB);
+
+            vst1q_u16(d + i, vorrq_u16(vorrq_u16(r, g), b));
+        }
+        RGB8888to565Row(s + i, d + i, width - i, srcfmt, dstfmt);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+}
+#endif /* HAVE_NEON_SWIZZLE */
+
+#if HAVE_SSSE3_SWIZZLE || HAVE_AVX2_SWIZZLE || HAVE_SSE2_SWIZZLE || HAVE_NEON_SWIZZLE
+
+/* SIMD conversions, by bytes per pixel of byte aligned or 565 formats */
+struct swizzle_blit_table
+{
+    int srcbpp;
+    int dstbpp;
+    enum blit_features blit_features;
+    SDL_BlitFunc blitfunc;
+};
+static const struct swizzle_blit_table swizzle_blit[] = {
+#if HAVE_AVX2_SWIZZLE
+    {4, 4, BLIT_FEATURE_HAS_AVX2, Blit_Swizzle32_AVX2},
+    {2, 4, BLIT_FEATURE_HAS_AVX2, Blit_RGB565to8888_AVX2},
+    {4, 2, BLIT_FEATURE_HAS_AVX2, Blit_8888toRGB565_AVX2},
+#endif
+#if HAVE_SSSE3_SWIZZLE
+    {4, 4, BLIT_FEATURE_HAS_SSSE3, Blit_Swizzle_SSSE3},
+    {3, 4, BLIT_FEATURE_HAS_SSSE3, Blit_Swizzle_SSSE3},
+    {4, 3, BLIT_FEATURE_HAS_SSSE3, Blit_Swizzle_SSSE3},
+    {3, 3, BLIT_FEATURE_HAS_SSSE3, Blit_Swizzle_SSSE3},
+#endif
+#if HAVE_SSE2_SWIZZLE
+    {2, 4, BLIT_FEATURE_HAS_SSE2, Blit_RGB565to8888_SSE2},
+    {4, 2, BLIT_FEATURE_HAS_SSE2, Blit_8888toRGB565_SSE2},
+#endif
+#if HAVE_NEON_SWIZZLE
+    {4, 4, BLIT_FEATURE_HAS_NEON, Blit_Swizzle_NEON},
+    {3, 4, BLIT_FEATURE_HAS_NEON, Blit_Swizzle_NEON},
+    {4, 3, BLIT_FEATURE_HAS_NEON, Blit_Swizzle_NEON},
+    {3, 3, BLIT_FEATURE_HAS_NEON, Blit_Swizzle_NEON},
+    {2, 4, BLIT_FEATURE_HAS_NEON, Blit_RGB565to8888_NEON},
+    {4, 2, BLIT_FEATURE_HAS_NEON, Blit_8888toRGB565_NEON},
+#endif
+    {0, 0, 0, NULL}
+};
+
+/* Whether a 24 or 32-bit format has 8-bit channels at byte boundaries, or is RGB565/BGR565 */
+static SDL_bool
+IsSwizzleFormat(const SDL_PixelFormat * fmt)
+{
+    if (fmt->BytesPerPixel == 2) {
+        return (fmt->Amask == 0 && fmt->Gmask == 0x07E0 &&
+                ((fmt->Rmask == 0xF800 && fmt->Bmask == 0x001F) ||
+                 (fmt->Rmask == 0x001F && fmt->Bmask == 0xF800))) ? SDL_TRUE : SDL_FALSE;
+    }
+    if (fmt->BytesPerPixel != 3 && fmt->BytesPerPixel != 4) {
+        return SDL_FALSE;
+    }
+    if ((fmt->Rmask >> fmt->Rshift) != 0xFF || (fmt->Rshift % 8) != 0 ||
+        (fmt->Gmask >> fmt->Gshift) != 0xFF || (fmt->Gshift % 8) != 0 ||
+        (fmt->Bmask >> fmt->Bshift) != 0xFF || (fmt->Bshift % 8) != 0) {
+        return SDL_FALSE;
+    }
+    if (fmt->Amask && ((fmt->Amask >> fmt->Ashift) != 0xFF || (fmt->Ashift % 8) != 0)) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static SDL_BlitFunc
+SDL_CalculateBlitSwizzle(SDL_PixelFormat * srcfmt, SDL_PixelFormat * dstfmt)
+{
+    int which;
+
+    if (!IsSwizzleFormat(srcfmt) || !IsSwizzleFormat(dstfmt)) {
+        return NULL;
+    }
+    for (which = 0; swizzle_blit[which].blitfunc; ++which) {
+        if (srcfmt->BytesPerPixel == swizzle_blit[which].srcbpp &&
+            dstfmt->BytesPerPixel == swizzle_blit[which].dstbpp &&
+            ((swizzle_blit[which].blit_features & GetBlitFeatures()) ==
+             swizzle_blit[which].blit_features)) {
+            return swizzle_blit[which].blitfunc;
+        }
+    }
+    return NULL;
+}
+
+#endif /* HAVE_SSSE3_SWIZZLE || HAVE_AVX2_SWIZZLE || HAVE_SSE2_SWIZZLE || HAVE_NEON_SWIZZLE */
+
 /* Normal N to N optimized blitters */
 #define NO_ALPHA   1
 #define SET_ALPHA  2
@@ -3428,6 +4070,12 @@ SDL_CalculateBlitN(SDL_Surface * surface)
             Uint32 a_need = NO_ALPHA;
             if (dstfmt->Amask)
                 a_need = srcfmt->Amask ? COPY_ALPHA : SET_ALPHA;
+#if HAVE_SSSE3_SWIZZLE || HAVE_AVX2_SWIZZLE || HAVE_SSE2_SWIZZLE || HAVE_NEON_SWIZZLE
+            blitfun = SDL_CalculateBlitSwizzle(srcfmt, dstfmt);
+            if (blitfun) {
+                return blitfun;
+            }
+#endif
             table = normal_blit[srcfmt->BytesPerPixel - 1];
             for (which = 0; table[which].dstbpp; ++which) {
                 if (MASKOK(srcfmt->Rmask, table[which].srcR) &&
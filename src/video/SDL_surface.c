@@ -1030,15 +1030,7 @@ SDL_PrivateLowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
 int
 SDL_LockSurface(SDL_Surface * surface)
 {
-    if (!surface->locked) {
-#if SDL_HAVE_RLE
-        /* Perform the lock */
-        if (surface->flags & SDL_RLEACCEL) {
-            SDL_UnRLESurface(surface, 1);
-            surface->flags |= SDL_RLEACCEL;     /* save accel'd state */
-        }
-#endif
-    }
+    /* RLE encoded surfaces keep their pixels, so there is nothing to do */
 
     /* Increment the surface lock count, for recursive locks */
     ++surface->locked;
@@ -1061,8 +1053,7 @@ SDL_UnlockSurface(SDL_Surface * surface)
 #if SDL_HAVE_RLE
     /* Update RLE encoded surface with new data */
     if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        surface->flags &= ~SDL_RLEACCEL;        /* stop lying */
-        SDL_RLESurface(surface);
+        SDL_UpdateRLESurface(surface);
     }
 #endif
 }
@@ -1448,21 +1439,585 @@ int SDL_ConvertPixels(int width, int height,
 /*
  * Premultiply the alpha on a block of pixels
  *
- * This is currently only implemented for SDL_PIXELFORMAT_ARGB8888
+ * The work is done on 32-bit pixels with an 8-bit alpha channel in either
+ * the top byte (ARGB8888, ABGR8888) or the bottom byte (RGBA8888, BGRA8888).
+ * The color channels are scaled the same way regardless of their order, so
+ * only the position of alpha matters to the row kernels. Everything else is
+ * converted through one of these formats.
  *
- * Here are some ideas for optimization:
+ * Colors are multiplied by alpha/255 with exact rounding, using
+ *   t = c * a + 128;  c' = (t + (t >> 8)) >> 8
+ * which is identical to round(c * a / 255) for all 8-bit inputs.
+ *
+ * Some background on the SIMD approach:
  * https://github.com/Wizermil/premultiply_alpha/tree/master/premultiply_alpha
  * https://developer.arm.com/documentation/101964/0201/Pre-multiplied-alpha-channel-data
  */
-int SDL_PremultiplyAlpha(int width, int height,
-                         Uint32 src_format, const void * src, int src_pitch,
-                         Uint32 dst_format, void * dst, int dst_pitch)
+
+#if defined(__SSE2__)
+#define HAVE_SSE2_PREMULTIPLY 1
+#endif
+#if defined(HAVE_AVX2_INTRINSICS)
+#define HAVE_AVX2_PREMULTIPLY 1
+#endif
+#if defined(__ARM_NEON)
+#define HAVE_NEON_PREMULTIPLY 1
+#endif
+
+/* The SIMD kernels assume the bytes of a pixel are in memory in the order of their significance. */
+#if SDL_BYTEORDER != SDL_LIL_ENDIAN
+#undef HAVE_SSE2_PREMULTIPLY
+#undef HAVE_AVX2_PREMULTIPLY
+#undef HAVE_NEON_PREMULTIPLY
+#endif
+
+/* How the row kernels map a source 8888 pixel to a destination one */
+typedef struct
+{
+    int alpha_shift;    /* Bit position of alpha in the source pixels */
+    SDL_bool swizzle;   /* Whether the channels are reordered at all */
+    Uint8 order[4];     /* Destination byte i comes from source byte order[i] */
+} SDL_PremultiplyParams;
+
+typedef void (*SDL_PremultiplyRowFunc)(const Uint32 *src, Uint32 *dst, int width, const SDL_PremultiplyParams *params);
+
+/* Reorder the channels of a pixel between two 8888 formats */
+static SDL_INLINE Uint32
+SwizzlePixel(Uint32 pixel, const SDL_PremultiplyParams *params)
+{
+    return (((pixel >> (params->order[0] * 8)) & 0xFF)) |
+           (((pixel >> (params->order[1] * 8)) & 0xFF) << 8) |
+           (((pixel >> (params->order[2] * 8)) & 0xFF) << 16) |
+           (((pixel >> (params->order[3] * 8)) & 0xFF) << 24);
+}
+
+/* Premultiply a pixel with alpha at bit `alpha_shift`, two channels at a time */
+static SDL_INLINE Uint32
+PremultiplyPixel(Uint32 pixel, int alpha_shift)
 {
-    int c;
-    Uint32 srcpixel;
-    Uint32 srcR, srcG, srcB, srcA;
-    Uint32 dstpixel;
-    Uint32 dstR, dstG, dstB, dstA;
+    const Uint32 alpha_mask = (Uint32)0xFF << alpha_shift;
+    const Uint32 a = (pixel >> alpha_shift) & 0xFF;
+    /* Spread the three color bytes over two 16-bit lane pairs */
+    const Uint32 colors = (alpha_shift == 0) ? (pixel >> 8) : pixel;
+    Uint32 rb = (colors & 0x00FF00FF) * a + 0x00800080;
+    Uint32 g = ((colors >> 8) & 0xFF) * a + 0x80;
+
+    rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    g = ((g + (g >> 8)) >> 8) & 0xFF;
+
+    return (pixel & alpha_mask) | (((rb | (g << 8))) << (alpha_shift == 0 ? 8 : 0));
+}
+
+static void
+SDL_PremultiplyRow_Scalar(const Uint32 *src, Uint32 *dst, int width, const SDL_PremultiplyParams *params)
+{
+    const int alpha_shift = params->alpha_shift;
+    int i;
+
+    if (params->swizzle) {
+        for (i = 0; i < width; ++i) {
+            dst[i] = SwizzlePixel(PremultiplyPixel(src[i], alpha_shift), params);
+        }
+    } else {
+        for (i = 0; i < width; ++i) {
+            dst[i] = PremultiplyPixel(src[i], alpha_shift);
+        }
+    }
+}
+
+#if HAVE_SSE2_PREMULTIPLY
+/* Per-destination-byte masks and shift counts for SwizzlePixels_SSE2() */
+typedef struct
+{
+    __m128i mask[4];
+    __m128i count[4];
+    int direction[4];
+} SDL_Swizzle_SSE2;
+
+static void
+SDL_GetSwizzle_SSE2(const SDL_PremultiplyParams *params, SDL_Swizzle_SSE2 *swizzle)
+{
+    int i;
+    for (i = 0; i < 4; ++i) {
+        const int from = params->order[i];
+        swizzle->mask[i] = _mm_set1_epi32((int)((Uint32)0xFF << (from * 8)));
+        swizzle->count[i] = _mm_cvtsi32_si128(SDL_abs(i - from) * 8);
+        swizzle->direction[i] = i - from;
+    }
+}
+
+/* SSE2 has no byte shuffle, so move each channel into place with a shift */
+static SDL_INLINE __m128i
+SwizzlePixels_SSE2(__m128i pixels, const SDL_Swizzle_SSE2 *swizzle)
+{
+    __m128i result = _mm_setzero_si128();
+    int i;
+
+    for (i = 0; i < 4; ++i) {
+        __m128i c = _mm_and_si128(pixels, swizzle->mask[i]);
+        if (swizzle->direction[i] > 0) {
+            c = _mm_sll_epi32(c, swizzle->count[i]);
+        } else if (swizzle->direction[i] < 0) {
+            c = _mm_srl_epi32(c, swizzle->count[i]);
+        }
+        result = _mm_or_si128(result, c);
+    }
+    return result;
+}
+
+static SDL_INLINE __m128i
+PremultiplyPixels_SSE2(__m128i pixels, __m128i zero, __m128i alpha_keep, __m128i alpha_one, int alpha_shift)
+{
+    const __m128i bias = _mm_set1_epi16(128);
+    __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+    __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+    __m128i alo, ahi;
+
+    if (alpha_shift == 24) {
+        alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    } else {
+        alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(0, 0, 0, 0));
+        ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(0, 0, 0, 0));
+    }
+    /* Multiply alpha by 255 so it comes out unchanged */
+    alo = _mm_or_si128(_mm_and_si128(alo, alpha_keep), alpha_one);
+    ahi = _mm_or_si128(_mm_and_si128(ahi, alpha_keep), alpha_one);
+
+    lo = _mm_add_epi16(_mm_mullo_epi16(lo, alo), bias);
+    hi = _mm_add_epi16(_mm_mullo_epi16(hi, ahi), bias);
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+    return _mm_packus_epi16(lo, hi);
+}
+
+static void
+SDL_PremultiplyRow_SSE2(const Uint32 *src, Uint32 *dst, int width, const SDL_PremultiplyParams *params)
+{
+    const int alpha_shift = params->alpha_shift;
+    const __m128i zero = _mm_setzero_si128();
+    /* 16-bit lanes: keep the alpha multiplier for colors, use 255 for alpha itself */
+    const __m128i alpha_keep = (alpha_shift == 24) ? _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1) : _mm_set_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+    const __m128i alpha_one = (alpha_shift == 24) ? _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0) : _mm_set_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+    SDL_Swizzle_SSE2 swizzle;
+    int i = 0;
+
+    if (params->swizzle) {
+        SDL_GetSwizzle_SSE2(params, &swizzle);
+        for (; i + 4 <= width; i += 4) {
+            const __m128i pixels = _mm_loadu_si128((const __m128i *)(src + i));
+            const __m128i result = PremultiplyPixels_SSE2(pixels, zero, alpha_keep, alpha_one, alpha_shift);
+            _mm_storeu_si128((__m128i *)(dst + i), SwizzlePixels_SSE2(result, &swizzle));
+        }
+    } else {
+        for (; i + 4 <= width; i += 4) {
+            const __m128i pixels = _mm_loadu_si128((const __m128i *)(src + i));
+            _mm_storeu_si128((__m128i *)(dst + i), PremultiplyPixels_SSE2(pixels, zero, alpha_keep, alpha_one, alpha_shift));
+        }
+    }
+    SDL_PremultiplyRow_Scalar(src + i, dst + i, width - i, params);
+}
+#endif /* HAVE_SSE2_PREMULTIPLY */
+
+#if HAVE_AVX2_PREMULTIPLY
+/* Byte shuffle that reorders the channels of eight pixels at once */
+static __m256i SDL_TARGETING("avx2")
+SDL_GetSwizzle_AVX2(const SDL_PremultiplyParams *params)
+{
+    Uint8 shuffle[32];
+    int i;
+
+    for (i = 0; i < 32; ++i) {
+        /* The shuffle works within each 128-bit half */
+        shuffle[i] = (Uint8)(((i & 15) & ~3) + params->order[i & 3]);
+    }
+    return _mm256_loadu_si256((const __m256i *)shuffle);
+}
+
+static void SDL_TARGETING("avx2")
+SDL_PremultiplyRow_AVX2(const Uint32 *src, Uint32 *dst, int width, const SDL_PremultiplyParams *params)
+{
+    const int alpha_shift = params->alpha_shift;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i bias = _mm256_set1_epi16(128);
+    const __m256i alpha_keep = (alpha_shift == 24) ?
+        _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1) :
+        _mm256_set_epi16(-1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0);
+    const __m256i alpha_one = (alpha_shift == 24) ?
+        _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0) :
+        _mm256_set_epi16(0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255);
+    /* Broadcast the alpha byte of each pixel over its four bytes */
+    const __m256i alpha_shuffle = (alpha_shift == 24) ?
+        _mm256_set_epi8(15, 15, 15, 15, 11, 11, 11, 11, 7, 7, 7, 7, 3, 3, 3, 3,
+                        15, 15, 15, 15, 11, 11, 11, 11, 7, 7, 7, 7, 3, 3, 3, 3) :
+        _mm256_set_epi8(12, 12, 12, 12, 8, 8, 8, 8, 4, 4, 4, 4, 0, 0, 0, 0,
+                        12, 12, 12, 12, 8, 8, 8, 8, 4, 4, 4, 4, 0, 0, 0, 0);
+    /* Shuffling with the identity is as cheap as not shuffling at all */
+    const __m256i swizzle = SDL_GetSwizzle_AVX2(params);
+    int i = 0;
+
+    for (; i + 8 <= width; i += 8) {
+        const __m256i pixels = _mm256_loadu_si256((const __m256i *)(src + i));
+        const __m256i alpha = _mm256_shuffle_epi8(pixels, alpha_shuffle);
+        __m256i lo = _mm256_unpacklo_epi8(pixels, zero);
+        __m256i hi = _mm256_unpackhi_epi8(pixels, zero);
+        __m256i alo = _mm256_or_si256(_mm256_and_si256(_mm256_unpacklo_epi8(alpha, zero), alpha_keep), alpha_one);
+        __m256i ahi = _mm256_or_si256(_mm256_and_si256(_mm256_unpackhi_epi8(alpha, zero), alpha_keep), alpha_one);
+
+        lo = _mm256_add_epi16(_mm256_mullo_epi16(lo, alo), bias);
+        hi = _mm256_add_epi16(_mm256_mullo_epi16(hi, ahi), bias);
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_shuffle_epi8(_mm256_packus_epi16(lo, hi), swizzle));
+    }
+    SDL_PremultiplyRow_Scalar(src + i, dst + i, width - i, params);
+}
+#endif /* HAVE_AVX2_PREMULTIPLY */
+
+#if HAVE_NEON_PREMULTIPLY
+static SDL_INLINE uint8x8_t
+PremultiplyChannel_NEON(uint8x8_t c, uint8x8_t a)
+{
+    /* (t + ((t + 128) >> 8) + 128) >> 8 is round(t / 255) */
+    const uint16x8_t t = vmull_u8(c, a);
+    return vraddhn_u16(t, vrshrq_n_u16(t, 8));
+}
+
+/* The channels are already split into separate registers, so reordering them is free */
+static SDL_INLINE uint8x8x4_t
+SwizzleChannels_NEON(uint8x8x4_t pixels, const SDL_PremultiplyParams *params)
+{
+    uint8x8x4_t result;
+    result.val[0] = pixels.val[params->order[0]];
+    result.val[1] = pixels.val[params->order[1]];
+    result.val[2] = pixels.val[params->order[2]];
+    result.val[3] = pixels.val[params->order[3]];
+    return result;
+}
+
+static void
+SDL_PremultiplyRow_NEON(const Uint32 *src, Uint32 *dst, int width, const SDL_PremultiplyParams *params)
+{
+    const int a = params->alpha_shift / 8;
+    int i = 0;
+
+    for (; i + 8 <= width; i += 8) {
+        uint8x8x4_t pixels = vld4_u8((const uint8_t *)(src + i));
+        const uint8x8_t alpha = pixels.val[a];
+        if (a == 3) {
+            pixels.val[0] = PremultiplyChannel_NEON(pixels.val[0], alpha);
+            pixels.val[1] = PremultiplyChannel_NEON(pixels.val[1], alpha);
+            pixels.val[2] = PremultiplyChannel_NEON(pixels.val[2], alpha);
+        } else {
+            pixels.val[1] = PremultiplyChannel_NEON(pixels.val[1], alpha);
+            pixels.val[2] = PremultiplyChannel_NEON(pixels.val[2], alpha);
+            pixels.val[3] = PremultiplyChannel_NEON(pixels.val[3], alpha);
+        }
+        vst4_u8((uint8_t *)(dst + i), SwizzleChannels_NEON(pixels, params));
+    }
+    SDL_PremultiplyRow_Scalar(src + i, dst + i, width - i, params);
+}
+#endif /* HAVE_NEON_PREMULTIPLY */
+
+static SDL_PremultiplyRowFunc
+SDL_GetPremultiplyRowFunc(void)
+{
+#if HAVE_AVX2_PREMULTIPLY
+    if (SDL_HasAVX2()) {
+        return SDL_PremultiplyRow_AVX2;
+    }
+#endif
+#if HAVE_SSE2_PREMULTIPLY
+    if (SDL_HasSSE2()) {
+        return SDL_PremultiplyRow_SSE2;
+    }
+#endif
+#if HAVE_NEON_PREMULTIPLY
+    if (SDL_HasNEON()) {
+        return SDL_PremultiplyRow_NEON;
+    }
+#endif
+    return SDL_PremultiplyRow_Scalar;
+}
+
+/* Undo premultiplication of a pixel with alpha at bit `alpha_shift` */
+static SDL_INLINE Uint32
+UnpremultiplyPixel(Uint32 pixel, int alpha_shift)
+{
+    const Uint32 a = (pixel >> alpha_shift) & 0xFF;
+    Uint32 result = pixel & ((Uint32)0xFF << alpha_shift);
+    int shift;
+
+    if (a == 0xFF) {
+        return pixel;
+    }
+    if (a == 0) {
+        return 0;
+    }
+    for (shift = 0; shift < 32; shift += 8) {
+        if (shift != alpha_shift) {
+            Uint32 c = (((pixel >> shift) & 0xFF) * 255 + a / 2) / a;
+            if (c > 0xFF) {
+                c = 0xFF;
+            }
+            result |= c << shift;
+        }
+    }
+    return result;
+}
+
+static void
+SDL_UnpremultiplyRow_Scalar(const Uint32 *src, Uint32 *dst, int width, const SDL_PremultiplyParams *params)
+{
+    const int alpha_shift = params->alpha_shift;
+    int i;
+
+    if (params->swizzle) {
+        for (i = 0; i < width; ++i) {
+            dst[i] = SwizzlePixel(UnpremultiplyPixel(src[i], alpha_shift), params);
+        }
+    } else {
+        for (i = 0; i < width; ++i) {
+            dst[i] = UnpremultiplyPixel(src[i], alpha_shift);
+        }
+    }
+}
+
+#if HAVE_SSE2_PREMULTIPLY
+/* Single precision division is exact enough here: for every 8-bit color and
+   alpha, truncating c * 255 / a + 0.5 gives the same result as the integer
+   (c * 255 + a / 2) / a of the scalar code. */
+static void
+SDL_UnpremultiplyRow_SSE2(const Uint32 *src, Uint32 *dst, int width, const SDL_PremultiplyParams *params)
+{
+    const int alpha_shift = params->alpha_shift;
+    const __m128i byte_mask = _mm_set1_epi32(0xFF);
+    const __m128i alpha_mask = _mm_set1_epi32(0xFF << alpha_shift);
+    const __m128i scale = _mm_set1_epi32(255);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 max = _mm_set1_ps(255.0f);
+    SDL_Swizzle_SSE2 swizzle;
+    int i = 0;
+
+    if (params->swizzle) {
+        SDL_GetSwizzle_SSE2(params, &swizzle);
+    }
+    for (; i + 4 <= width; i += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(src + i));
+        const __m128i alpha = _mm_and_si128(_mm_srli_epi32(pixels, alpha_shift), byte_mask);
+        const __m128i transparent = _mm_cmpeq_epi32(alpha, _mm_setzero_si128());
+        /* Avoid dividing by zero, those pixels are cleared below */
+        const __m128 a = _mm_max_ps(_mm_cvtepi32_ps(alpha), one);
+        __m128i result = _mm_and_si128(pixels, alpha_mask);
+        int shift;
+
+        for (shift = 0; shift < 32; shift += 8) {
+            if (shift != alpha_shift) {
+                const __m128i c = _mm_and_si128(_mm_srli_epi32(pixels, shift), byte_mask);
+                /* c * 255 fits in the low 16 bits of each 32-bit lane */
+                const __m128 q = _mm_div_ps(_mm_cvtepi32_ps(_mm_mullo_epi16(c, scale)), a);
+                const __m128i v = _mm_cvttps_epi32(_mm_min_ps(_mm_add_ps(q, half), max));
+                result = _mm_or_si128(result, _mm_slli_epi32(v, shift));
+            }
+        }
+        result = _mm_andnot_si128(transparent, result);
+        if (params->swizzle) {
+            result = SwizzlePixels_SSE2(result, &swizzle);
+        }
+        _mm_storeu_si128((__m128i *)(dst + i), result);
+    }
+    SDL_UnpremultiplyRow_Scalar(src + i, dst + i, width - i, params);
+}
+#endif /* HAVE_SSE2_PREMULTIPLY */
+
+#if HAVE_AVX2_PREMULTIPLY
+/* The same division as the SSE2 version, eight pixels at a time */
+static void SDL_TARGETING("avx2")
+SDL_UnpremultiplyRow_AVX2(const Uint32 *src, Uint32 *dst, int width, const SDL_PremultiplyParams *params)
+{
+    const int alpha_shift = params->alpha_shift;
+    const __m256i byte_mask = _mm256_set1_epi32(0xFF);
+    const __m256i alpha_mask = _mm256_set1_epi32(0xFF << alpha_shift);
+    const __m256i scale = _mm256_set1_epi32(255);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 max = _mm256_set1_ps(255.0f);
+    const __m256i swizzle = SDL_GetSwizzle_AVX2(params);
+    int i = 0;
+
+    for (; i + 8 <= width; i += 8) {
+        const __m256i pixels = _mm256_loadu_si256((const __m256i *)(src + i));
+        const __m256i alpha = _mm256_and_si256(_mm256_srli_epi32(pixels, alpha_shift), byte_mask);
+        const __m256i transparent = _mm256_cmpeq_epi32(alpha, _mm256_setzero_si256());
+        /* Avoid dividing by zero, those pixels are cleared below */
+        const __m256 a = _mm256_max_ps(_mm256_cvtepi32_ps(alpha), one);
+        __m256i result = _mm256_and_si256(pixels, alpha_mask);
+        int shift;
+
+        for (shift = 0; shift < 32; shift += 8) {
+            if (shift != alpha_shift) {
+                const __m256i c = _mm256_and_si256(_mm256_srli_epi32(pixels, shift), byte_mask);
+                const __m256 q = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_mullo_epi16(c, scale)), a);
+                const __m256i v = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_add_ps(q, half), max));
+                result = _mm256_or_si256(result, _mm256_slli_epi32(v, shift));
+            }
+        }
+        result = _mm256_andnot_si256(transparent, result);
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_shuffle_epi8(result, swizzle));
+    }
+    SDL_UnpremultiplyRow_Scalar(src + i, dst + i, width - i, params);
+}
+#endif /* HAVE_AVX2_PREMULTIPLY */
+
+#if HAVE_NEON_PREMULTIPLY
+/* Round up or down by one where the reciprocal estimate got the quotient wrong */
+static SDL_INLINE uint32x4_t
+FixQuotient_NEON(uint32x4_t q, uint32x4_t n, uint32x4_t a)
+{
+    /* Adding an all ones comparison result subtracts one */
+    q = vaddq_u32(q, vcgtq_u32(vmulq_u32(q, a), n));
+    return vsubq_u32(q, vcleq_u32(vmulq_u32(vaddq_u32(q, vdupq_n_u32(1)), a), n));
+}
+
+/* Compute (c * 255 + a / 2) / a like the scalar code. ARMv7 NEON has no
+   division, so multiply by a refined reciprocal and correct the result. */
+static SDL_INLINE uint8x8_t
+UnpremultiplyChannel_NEON(uint8x8_t c, uint16x8_t half_alpha, uint32x4_t alo, uint32x4_t ahi, float32x4_t rlo, float32x4_t rhi)
+{
+    const uint16x8_t n = vmlal_u8(half_alpha, c, vdup_n_u8(255));
+    const uint32x4_t nlo = vmovl_u16(vget_low_u16(n));
+    const uint32x4_t nhi = vmovl_u16(vget_high_u16(n));
+    uint32x4_t qlo = vcvtq_u32_f32(vmulq_f32(vcvtq_f32_u32(nlo), rlo));
+    uint32x4_t qhi = vcvtq_u32_f32(vmulq_f32(vcvtq_f32_u32(nhi), rhi));
+
+    qlo = FixQuotient_NEON(qlo, nlo, alo);
+    qhi = FixQuotient_NEON(qhi, nhi, ahi);
+    /* The saturating narrows clamp colors brighter than alpha to 255 */
+    return vqmovn_u16(vcombine_u16(vqmovn_u32(qlo), vqmovn_u32(qhi)));
+}
+
+static SDL_INLINE float32x4_t
+Reciprocal_NEON(uint32x4_t a)
+{
+    const float32x4_t x = vcvtq_f32_u32(a);
+    float32x4_t r = vrecpeq_f32(x);
+    r = vmulq_f32(vrecpsq_f32(x, r), r);
+    return vmulq_f32(vrecpsq_f32(x, r), r);
+}
+
+static void
+SDL_UnpremultiplyRow_NEON(const Uint32 *src, Uint32 *dst, int width, const SDL_PremultiplyParams *params)
+{
+    const int a = params->alpha_shift / 8;
+    int i = 0;
+
+    for (; i + 8 <= width; i += 8) {
+        uint8x8x4_t pixels = vld4_u8((const uint8_t *)(src + i));
+        const uint8x8_t alpha = pixels.val[a];
+        const uint8x8_t transparent = vceq_u8(alpha, vdup_n_u8(0));
+        /* Avoid dividing by zero, those pixels are cleared below */
+        const uint16x8_t divisor = vmovl_u8(vmax_u8(alpha, vdup_n_u8(1)));
+        const uint16x8_t half_alpha = vshrq_n_u16(vmovl_u8(alpha), 1);
+        const uint32x4_t alo = vmovl_u16(vget_low_u16(divisor));
+        const uint32x4_t ahi = vmovl_u16(vget_high_u16(divisor));
+        const float32x4_t rlo = Reciprocal_NEON(alo);
+        const float32x4_t rhi = Reciprocal_NEON(ahi);
+        int channel;
+
+        for (channel = 0; channel < 4; ++channel) {
+            if (channel != a) {
+                pixels.val[channel] = vbic_u8(UnpremultiplyChannel_NEON(pixels.val[channel], half_alpha, alo, ahi, rlo, rhi), transparent);
+            }
+        }
+        vst4_u8((uint8_t *)(dst + i), SwizzleChannels_NEON(pixels, params));
+    }
+    SDL_UnpremultiplyRow_Scalar(src + i, dst + i, width - i, params);
+}
+#endif /* HAVE_NEON_PREMULTIPLY */
+
+static SDL_PremultiplyRowFunc
+SDL_GetUnpremultiplyRowFunc(void)
+{
+#if HAVE_AVX2_PREMULTIPLY
+    if (SDL_HasAVX2()) {
+        return SDL_UnpremultiplyRow_AVX2;
+    }
+#endif
+#if HAVE_SSE2_PREMULTIPLY
+    if (SDL_HasSSE2()) {
+        return SDL_UnpremultiplyRow_SSE2;
+    }
+#endif
+#if HAVE_NEON_PREMULTIPLY
+    if (SDL_HasNEON()) {
+        return SDL_UnpremultiplyRow_NEON;
+    }
+#endif
+    return SDL_UnpremultiplyRow_Scalar;
+}
+
+/* Get the alpha position of the formats the row kernels handle directly */
+static SDL_bool
+SDL_GetAlpha8888Shift(Uint32 format, int *alpha_shift)
+{
+    switch (format) {
+    case SDL_PIXELFORMAT_ARGB8888:
+    case SDL_PIXELFORMAT_ABGR8888:
+        *alpha_shift = 24;
+        return SDL_TRUE;
+    case SDL_PIXELFORMAT_RGBA8888:
+    case SDL_PIXELFORMAT_BGRA8888:
+        *alpha_shift = 0;
+        return SDL_TRUE;
+    default:
+        return SDL_FALSE;
+    }
+}
+
+static int
+SDL_GetMaskShift(Uint32 mask)
+{
+    int shift = 0;
+    while (shift < 32 && !(mask & ((Uint32)1 << shift))) {
+        ++shift;
+    }
+    return shift;
+}
+
+/* Work out the channel reordering between two 8888 formats, once per call */
+static void
+SDL_GetPremultiplyParams(Uint32 src_format, Uint32 dst_format, SDL_PremultiplyParams *params)
+{
+    Uint32 src_masks[4], dst_masks[4];
+    int bpp, i;
+
+    SDL_GetAlpha8888Shift(src_format, &params->alpha_shift);
+    SDL_PixelFormatEnumToMasks(src_format, &bpp, &src_masks[0], &src_masks[1], &src_masks[2], &src_masks[3]);
+    SDL_PixelFormatEnumToMasks(dst_format, &bpp, &dst_masks[0], &dst_masks[1], &dst_masks[2], &dst_masks[3]);
+    for (i = 0; i < 4; ++i) {
+        params->order[SDL_GetMaskShift(dst_masks[i]) / 8] = (Uint8)(SDL_GetMaskShift(src_masks[i]) / 8);
+    }
+    params->swizzle = (src_format != dst_format);
+}
+
+/* Formats the row kernels can't handle are converted through ARGB8888 in
+   bands of rows this big, so the intermediate stays in the cache */
+#define PREMULTIPLY_BAND_SIZE   (64 * 1024)
+
+static int
+SDL_PremultiplyAlphaPixels(int width, int height,
+                           Uint32 src_format, const void * src, int src_pitch,
+                           Uint32 dst_format, void * dst, int dst_pitch,
+                           SDL_bool premultiply)
+{
+    const SDL_PremultiplyRowFunc func = premultiply ? SDL_GetPremultiplyRowFunc() : SDL_GetUnpremultiplyRowFunc();
+    SDL_PremultiplyParams params;
+    SDL_bool src_8888, dst_8888;
+    Uint8 *tmp = NULL;
+    int tmp_pitch = 0, band = height;
 
     if (!src) {
         return SDL_InvalidParamError("src");
@@ -1476,37 +2031,98 @@ int SDL_PremultiplyAlpha(int width, int height,
     if (!dst_pitch) {
         return SDL_InvalidParamError("dst_pitch");
     }
-    if (src_format != SDL_PIXELFORMAT_ARGB8888) {
-        return SDL_InvalidParamError("src_format");
+    if (width <= 0 || height <= 0) {
+        return 0;
+    }
+
+    src_8888 = SDL_GetAlpha8888Shift(src_format, &params.alpha_shift);
+    dst_8888 = SDL_GetAlpha8888Shift(dst_format, &params.alpha_shift);
+    if (src_8888 && dst_8888) {
+        /* Convert and (un)premultiply in a single pass over the pixels */
+        SDL_GetPremultiplyParams(src_format, dst_format, &params);
+        while (height--) {
+            func((const Uint32 *)src, (Uint32 *)dst, width, &params);
+            src = (const Uint8 *)src + src_pitch;
+            dst = (Uint8 *)dst + dst_pitch;
+        }
+        return 0;
+    }
+
+    if (!dst_8888) {
+        tmp_pitch = width * 4;
+        band = SDL_max(1, SDL_min(height, PREMULTIPLY_BAND_SIZE / tmp_pitch));
+        tmp = (Uint8 *)SDL_malloc((size_t)tmp_pitch * band);
+        if (!tmp) {
+            return SDL_OutOfMemory();
+        }
     }
-    if (dst_format != SDL_PIXELFORMAT_ARGB8888) {
-        return SDL_InvalidParamError("dst_format");
+    if (dst_8888) {
+        /* Convert into the destination and finish the job there */
+        SDL_GetPremultiplyParams(dst_format, dst_format, &params);
+    } else if (src_8888) {
+        /* Premultiply straight out of the source into ARGB8888 */
+        SDL_GetPremultiplyParams(src_format, SDL_PIXELFORMAT_ARGB8888, &params);
+    } else {
+        SDL_GetPremultiplyParams(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, &params);
     }
 
-    while (height--) {
-        const Uint32 *src_px = (const Uint32 *)src;
-        Uint32 *dst_px = (Uint32 *)dst;
-        for (c = width; c; --c) {
-            /* Component bytes extraction. */
-            srcpixel = *src_px++;
-            RGBA_FROM_ARGB8888(srcpixel, srcR, srcG, srcB, srcA);
+    while (height > 0) {
+        const int rows = SDL_min(band, height);
+        const Uint8 *in;
+        Uint8 *out;
+        int in_pitch, out_pitch, y;
+
+        if (dst_8888) {
+            if (SDL_ConvertPixels(width, rows, src_format, src, src_pitch, dst_format, dst, dst_pitch) < 0) {
+                return -1;
+            }
+            in = out = (Uint8 *)dst;
+            in_pitch = out_pitch = dst_pitch;
+        } else if (src_8888) {
+            in = (const Uint8 *)src;
+            in_pitch = src_pitch;
+            out = tmp;
+            out_pitch = tmp_pitch;
+        } else {
+            if (SDL_ConvertPixels(width, rows, src_format, src, src_pitch, SDL_PIXELFORMAT_ARGB8888, tmp, tmp_pitch) < 0) {
+                SDL_free(tmp);
+                return -1;
+            }
+            in = out = tmp;
+            in_pitch = out_pitch = tmp_pitch;
+        }
 
-            /* Alpha pre-multiplication of each component. */
-            dstA = srcA;
-            dstR = (srcA * srcR) / 255;
-            dstG = (srcA * srcG) / 255;
-            dstB = (srcA * srcB) / 255;
+        for (y = 0; y < rows; ++y) {
+            func((const Uint32 *)(in + y * in_pitch), (Uint32 *)(out + y * out_pitch), width, &params);
+        }
 
-            /* ARGB8888 pixel recomposition. */
-            ARGB8888_FROM_RGBA(dstpixel, dstR, dstG, dstB, dstA);
-            *dst_px++ = dstpixel;
+        if (!dst_8888 &&
+            SDL_ConvertPixels(width, rows, SDL_PIXELFORMAT_ARGB8888, tmp, tmp_pitch, dst_format, dst, dst_pitch) < 0) {
+            SDL_free(tmp);
+            return -1;
         }
-        src = (const Uint8 *)src + src_pitch;
-        dst = (Uint8 *)dst + dst_pitch;
+        src = (const Uint8 *)src + rows * src_pitch;
+        dst = (Uint8 *)dst + rows * dst_pitch;
+        height -= rows;
     }
+    SDL_free(tmp);
     return 0;
 }
 
+int SDL_PremultiplyAlpha(int width, int height,
+                         Uint32 src_format, const void * src, int src_pitch,
+                         Uint32 dst_format, void * dst, int dst_pitch)
+{
+    return SDL_PremultiplyAlphaPixels(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch, SDL_TRUE);
+}
+
+int SDL_UnpremultiplyAlpha(int width, int height,
+                           Uint32 src_format, const void * src, int src_pitch,
+                           Uint32 dst_format, void * dst, int dst_pitch)
+{
+    return SDL_PremultiplyAlphaPixels(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch, SDL_FALSE);
+}
+
 /*
  * Free a surface created by the above function.
  */
@@ -702,6 +702,73 @@ static void RunFIFOTest(SDL_bool lock_free)
 /* End FIFO test */
 /**************************************************************************/
 
+/**************************************************************************/
+/* Spin lock stress test */
+
+/* Oversubscribe the CPUs so lock holders get preempted while others wait. */
+#define SPINLOCK_THREADS_PER_CPU    4
+#define SPINLOCK_ITERATIONS         200000
+
+static SDL_SpinLock stressLock;
+static int stressCounter;
+
+static
+int SDLCALL SpinLockStress(void *junk)
+{
+    int i;
+    for (i = 0; i < SPINLOCK_ITERATIONS; ++i) {
+        SDL_AtomicLock(&stressLock);
+        ++stressCounter;
+        SDL_AtomicUnlock(&stressLock);
+    }
+    return 0;
+}
+
+static void RunSpinLockStressTest(void)
+{
+    SDL_Thread *threads[256];
+    SDL_SpinLockStats stats;
+    int num_threads = SDL_GetCPUCount() * SPINLOCK_THREADS_PER_CPU;
+    Uint64 start, end;
+    double elapsed;
+    int i;
+
+    if (num_threads > (int) SDL_arraysize(threads)) {
+        num_threads = (int) SDL_arraysize(threads);
+    }
+
+    SDL_Log("\nspin lock stress test---------------------------\n\n");
+    SDL_Log("Starting %d threads, %d lock/unlock pairs each\n", num_threads, SPINLOCK_ITERATIONS);
+
+    stressCounter = 0;
+    SDL_AtomicResetSpinLockStats();
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < num_threads; ++i) {
+        threads[i] = SDL_CreateThread(SpinLockStress, "SpinLockStress", NULL);
+    }
+    for (i = 0; i < num_threads; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    end = SDL_GetPerformanceCounter();
+
+    SDL_AtomicGetSpinLockStats(&stats);
+
+    elapsed = (double)(end - start) / SDL_GetPerformanceFrequency();
+    SDL_Log("Finished in %f sec, %.1f ns per lock\n", elapsed,
+            (elapsed * 1e9) / ((double)num_threads * SPINLOCK_ITERATIONS));
+    if (stats.contended) {
+        SDL_Log("Contended %u, spin rounds %u, waits %u\n",
+                (unsigned int)stats.contended, (unsigned int)stats.spins, (unsigned int)stats.waits);
+    } else {
+        SDL_Log("No contention statistics, build SDL with SDL_SPINLOCK_STATS=1 to collect them\n");
+    }
+    SDL_assert(stressCounter == num_threads * SPINLOCK_ITERATIONS);
+}
+
+/* End spin lock stress test */
+/**************************************************************************/
+
 int
 main(int argc, char *argv[])
 {
@@ -710,6 +777,7 @@ main(int argc, char *argv[])
 
     RunBasicTest();
     RunEpicTest();
+    RunSpinLockStressTest();
 /* This test is really slow, so don't run it by default */
 #if 0
     RunFIFOTest(SDL_FALSE);
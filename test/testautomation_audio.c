@@ -968,6 +968,505 @@ int audio_openCloseAudioDeviceConnected()
 }
 
 
+/**
+ * \brief Opens a pull-mode device, fills and plays a buffer and queries the device delay.
+ *
+ * \sa https://wiki.libsdl.org/SDL_OpenAudioDevicePull
+ * \sa https://wiki.libsdl.org/SDL_GetAudioDeviceBuffer
+ * \sa https://wiki.libsdl.org/SDL_PlayAudioDeviceBuffer
+ * \sa https://wiki.libsdl.org/SDL_GetAudioDeviceDelay
+ */
+int audio_pullModeDevice()
+{
+   int result;
+   int len;
+   int i;
+   Uint8 *buffer;
+   Uint8 *again;
+   SDL_AudioDeviceID id;
+   SDL_AudioSpec desired, obtained;
+
+   /* The dummy driver is always available and does not need real hardware */
+   SDL_AudioQuit();
+   SDLTest_AssertPass("Call to SDL_AudioQuit()");
+   result = SDL_AudioInit("dummy");
+   SDLTest_AssertPass("Call to SDL_AudioInit('dummy')");
+   SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+   if (result != 0) return TEST_ABORTED;
+
+   SDL_zero(desired);
+   desired.freq = 22050;
+   desired.format = AUDIO_S16SYS;
+   desired.channels = 2;
+   desired.samples = 512;
+   desired.callback = _audio_testCallback;
+
+   /* A callback is not used in pull mode, but passing one is harmless */
+   id = SDL_OpenAudioDevicePull(NULL, &desired, &obtained);
+   SDLTest_AssertPass("Call to SDL_OpenAudioDevicePull()");
+   SDLTest_AssertCheck(id > 0, "Validate device ID; expected: >0, got: %u", (unsigned int) id);
+   if (id == 0) {
+      SDLTest_LogError("SDL_OpenAudioDevicePull() failed: %s", SDL_GetError());
+      SDL_AudioQuit();
+      SDL_InitSubSystem(SDL_INIT_AUDIO);
+      return TEST_ABORTED;
+   }
+   SDLTest_AssertCheck(obtained.callback == NULL, "Validate obtained callback is NULL");
+   SDLTest_AssertCheck(SDL_GetAudioDeviceStatus(id) == SDL_AUDIO_PLAYING, "Validate pull-mode device starts unpaused");
+
+   /* Playing without a buffer is an error */
+   result = SDL_PlayAudioDeviceBuffer(id);
+   SDLTest_AssertPass("Call to SDL_PlayAudioDeviceBuffer() without a buffer");
+   SDLTest_AssertCheck(result == -1, "Validate result value; expected: -1 got: %d", result);
+
+   for (i = 0; i < 3; i++) {
+      buffer = SDL_GetAudioDeviceBuffer(id, &len);
+      SDLTest_AssertPass("Call to SDL_GetAudioDeviceBuffer()");
+      SDLTest_AssertCheck(buffer != NULL, "Validate buffer is not NULL");
+      SDLTest_AssertCheck(len == (int) obtained.size, "Validate buffer length; expected: %u got: %d", obtained.size, len);
+      if (buffer == NULL) break;
+
+      /* Asking again before playing hands back the same buffer */
+      again = SDL_GetAudioDeviceBuffer(id, NULL);
+      SDLTest_AssertCheck(again == buffer, "Validate repeated call returns the same buffer");
+
+      SDL_memset(buffer, obtained.silence, len);
+      result = SDL_PlayAudioDeviceBuffer(id);
+      SDLTest_AssertPass("Call to SDL_PlayAudioDeviceBuffer()");
+      SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+
+      result = SDL_GetAudioDeviceDelay(id);
+      SDLTest_AssertPass("Call to SDL_GetAudioDeviceDelay()");
+      SDLTest_AssertCheck(result >= 0 && result <= (int) obtained.samples,
+                          "Validate delay; expected: 0..%d got: %d", (int) obtained.samples, result);
+   }
+
+   SDL_CloseAudioDevice(id);
+   SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+
+   /* Invalid device IDs are rejected */
+   buffer = SDL_GetAudioDeviceBuffer(id, &len);
+   SDLTest_AssertCheck(buffer == NULL, "Validate closed device returns NULL buffer");
+   result = SDL_GetAudioDeviceDelay(id);
+   SDLTest_AssertCheck(result == -1, "Validate closed device delay; expected: -1 got: %d", result);
+
+   /* A callback device can't hand out buffers, but does report its delay */
+   id = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+   SDLTest_AssertPass("Call to SDL_OpenAudioDevice()");
+   SDLTest_AssertCheck(id > 0, "Validate device ID; expected: >0, got: %u", (unsigned int) id);
+   if (id > 0) {
+      buffer = SDL_GetAudioDeviceBuffer(id, &len);
+      SDLTest_AssertPass("Call to SDL_GetAudioDeviceBuffer() on a callback device");
+      SDLTest_AssertCheck(buffer == NULL, "Validate buffer is NULL");
+      result = SDL_GetAudioDeviceDelay(id);
+      SDLTest_AssertPass("Call to SDL_GetAudioDeviceDelay() on a callback device");
+      SDLTest_AssertCheck(result >= 0, "Validate delay; expected: >=0 got: %d", result);
+      SDL_CloseAudioDevice(id);
+      SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+   }
+
+   /* Restore the audio subsystem for the remaining tests */
+   SDL_AudioQuit();
+   SDLTest_AssertPass("Call to SDL_AudioQuit()");
+   result = SDL_InitSubSystem(SDL_INIT_AUDIO);
+   SDLTest_AssertPass("Call to SDL_InitSubSystem(SDL_INIT_AUDIO)");
+   SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+
+   return TEST_COMPLETED;
+}
+
+
+/**
+ * \brief Renders audio on a virtual clock with the disk and dummy drivers.
+ *
+ * \sa https://wiki.libsdl.org/SDL_HINT_AUDIO_VIRTUAL_CLOCK
+ * \sa https://wiki.libsdl.org/SDL_GetAudioDeviceTimeNS
+ */
+int audio_virtualClock()
+{
+   const int buffers = 3000;  /* 64 seconds of audio */
+   const char *filename = "testautomation_virtualclock.raw";
+   char *diskfile;
+   int result;
+   int len;
+   int i;
+   int count;
+   Uint8 *buffer;
+   Uint32 start, elapsed;
+   Uint64 timens, timestart, expected, period;
+   Sint64 filesize;
+   SDL_RWops *rw;
+   SDL_AudioDeviceID id;
+   SDL_AudioSpec desired, obtained;
+
+   SDL_SetHint(SDL_HINT_AUDIO_VIRTUAL_CLOCK, "1");
+   SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_AUDIO_VIRTUAL_CLOCK, \"1\")");
+
+   /* Have the disk driver write to a file owned by this test */
+   diskfile = SDL_getenv("SDL_DISKAUDIOFILE");
+   diskfile = diskfile ? SDL_strdup(diskfile) : NULL;
+   SDL_setenv("SDL_DISKAUDIOFILE", filename, 1);
+   SDLTest_AssertPass("Call to SDL_setenv(\"SDL_DISKAUDIOFILE\", \"%s\")", filename);
+
+   SDL_zero(desired);
+   desired.freq = 48000;
+   desired.format = AUDIO_S16SYS;
+   desired.channels = 2;
+   desired.samples = 1024;
+
+   /* Disk driver in pull mode: the output is exactly what was played */
+   SDL_AudioQuit();
+   SDLTest_AssertPass("Call to SDL_AudioQuit()");
+   result = SDL_AudioInit("disk");
+   SDLTest_AssertPass("Call to SDL_AudioInit('disk')");
+   SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+   if (result == 0) {
+      id = SDL_OpenAudioDevicePull(NULL, &desired, &obtained);
+      SDLTest_AssertPass("Call to SDL_OpenAudioDevicePull()");
+      SDLTest_AssertCheck(id > 0, "Validate device ID; expected: >0, got: %u", (unsigned int) id);
+      if (id > 0) {
+         start = SDL_GetTicks();
+         for (i = 0; i < buffers; i++) {
+            buffer = SDL_GetAudioDeviceBuffer(id, &len);
+            if (buffer == NULL) break;
+            SDL_memset(buffer, i & 0xFF, len);
+            SDL_PlayAudioDeviceBuffer(id);
+         }
+         elapsed = SDL_GetTicks() - start;
+         SDLTest_AssertCheck(i == buffers, "Validate buffers played; expected: %d got: %d", buffers, i);
+
+         timens = SDL_GetAudioDeviceTimeNS(id);
+         expected = ((Uint64) buffers * obtained.samples * 1000000000) / obtained.freq;
+         SDLTest_AssertPass("Call to SDL_GetAudioDeviceTimeNS()");
+         SDLTest_AssertCheck(timens == expected, "Validate device time; expected: %" SDL_PRIu64 " got: %" SDL_PRIu64, expected, timens);
+         SDLTest_AssertCheck(SDL_GetAudioDeviceDelay(id) == 0, "Validate virtual device has no delay");
+         SDLTest_Log("Rendered %d ms of audio in %d ms", (int) (timens / 1000000), (int) elapsed);
+         SDLTest_AssertCheck((Uint64) elapsed * 1000000 < timens / 2, "Validate audio rendered faster than real time");
+
+         SDL_CloseAudioDevice(id);
+         SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+
+         rw = SDL_RWFromFile(filename, "rb");
+         SDLTest_AssertCheck(rw != NULL, "Validate output file can be opened");
+         if (rw != NULL) {
+            filesize = SDL_RWsize(rw);
+            SDL_RWclose(rw);
+            SDLTest_AssertCheck(filesize == (Sint64) buffers * obtained.size,
+                                "Validate output file size; expected: %" SDL_PRIs64 " got: %" SDL_PRIs64,
+                                (Sint64) buffers * obtained.size, filesize);
+         }
+      }
+
+      /* A paused device doesn't play anything, not even silence */
+      desired.callback = _audio_testCallback;
+      _audio_testCallbackCounter = 0;
+      id = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+      SDLTest_AssertPass("Call to SDL_OpenAudioDevice()");
+      SDLTest_AssertCheck(id > 0, "Validate device ID; expected: >0, got: %u", (unsigned int) id);
+      if (id > 0) {
+         SDL_Delay(100);
+         timens = SDL_GetAudioDeviceTimeNS(id);
+         SDLTest_AssertCheck(timens == 0, "Validate device time while paused; expected: 0 got: %" SDL_PRIu64, timens);
+         SDL_CloseAudioDevice(id);
+         SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+         SDLTest_AssertCheck(_audio_testCallbackCounter == 0, "Validate no callbacks while paused; expected: 0 got: %d", _audio_testCallbackCounter);
+
+         rw = SDL_RWFromFile(filename, "rb");
+         SDLTest_AssertCheck(rw != NULL, "Validate output file can be opened");
+         if (rw != NULL) {
+            filesize = SDL_RWsize(rw);
+            SDL_RWclose(rw);
+            SDLTest_AssertCheck(filesize == 0, "Validate nothing was written while paused; expected: 0 got: %" SDL_PRIs64, filesize);
+         }
+      }
+   }
+
+   /* Dummy driver with a callback: the callback runs as fast as it can */
+   SDL_AudioQuit();
+   SDLTest_AssertPass("Call to SDL_AudioQuit()");
+   result = SDL_AudioInit("dummy");
+   SDLTest_AssertPass("Call to SDL_AudioInit('dummy')");
+   SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+   if (result == 0) {
+      desired.callback = _audio_testCallback;
+      _audio_testCallbackCounter = 0;
+      id = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+      SDLTest_AssertPass("Call to SDL_OpenAudioDevice()");
+      SDLTest_AssertCheck(id > 0, "Validate device ID; expected: >0, got: %u", (unsigned int) id);
+      if (id > 0) {
+         /* Nothing is played while paused, so the clock hasn't started yet */
+         SDL_Delay(50);
+         SDL_LockAudioDevice(id);
+         count = _audio_testCallbackCounter;
+         timens = SDL_GetAudioDeviceTimeNS(id);
+         SDL_UnlockAudioDevice(id);
+         SDLTest_AssertCheck(count == 0, "Validate no callbacks while paused; expected: 0 got: %d", count);
+         SDLTest_AssertCheck(timens == 0, "Validate device time while paused; expected: 0 got: %" SDL_PRIu64, timens);
+
+         start = SDL_GetTicks();
+         SDL_LockAudioDevice(id);
+         SDL_PauseAudioDevice(id, 0);
+         timestart = SDL_GetAudioDeviceTimeNS(id);
+         SDL_UnlockAudioDevice(id);
+         do {
+            SDL_Delay(10);
+            SDL_LockAudioDevice(id);
+            count = _audio_testCallbackCounter;
+            timens = SDL_GetAudioDeviceTimeNS(id);
+            SDL_UnlockAudioDevice(id);
+         } while (count < buffers && (SDL_GetTicks() - start) < 30000);
+         elapsed = SDL_GetTicks() - start;
+         SDLTest_AssertCheck(count >= buffers, "Validate callback count; expected: >=%d got: %d", buffers, count);
+
+         /* The audio thread might be between a callback and playing what it got, both times,
+            and the times are rounded down to nanoseconds separately */
+         period = ((Uint64) obtained.samples * 1000000000) / obtained.freq + 1;
+         expected = timestart + ((Uint64) count * obtained.samples * 1000000000) / obtained.freq;
+         SDLTest_AssertCheck(timens + period >= expected && timens <= expected + period,
+                             "Validate device time follows callbacks; expected: ~%" SDL_PRIu64 " got: %" SDL_PRIu64, expected, timens);
+         SDLTest_Log("Called back %d times in %d ms", count, (int) elapsed);
+
+         SDL_CloseAudioDevice(id);
+         SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+      }
+   }
+
+   /* Restore the audio subsystem and the disk driver's output file for the remaining tests */
+   SDL_setenv("SDL_DISKAUDIOFILE", diskfile ? diskfile : "sdlaudio.raw", 1);
+   SDL_free(diskfile);
+   remove(filename);
+   SDL_SetHint(SDL_HINT_AUDIO_VIRTUAL_CLOCK, "0");
+   SDL_AudioQuit();
+   SDLTest_AssertPass("Call to SDL_AudioQuit()");
+   result = SDL_InitSubSystem(SDL_INIT_AUDIO);
+   SDLTest_AssertPass("Call to SDL_InitSubSystem(SDL_INIT_AUDIO)");
+   SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+
+   return TEST_COMPLETED;
+}
+
+
+/* Writes a little-endian value into a buffer. */
+static Uint8 *_audio_putLE(Uint8 *p, Uint32 value, int bytes)
+{
+   int i;
+   for (i = 0; i < bytes; i++) {
+      *p++ = (Uint8) (value >> (i * 8));
+   }
+   return p;
+}
+
+/* Builds a WAVE file in memory with random audio data. Block headers of ADPCM
+ * data are made valid, and the data ends with part of a block.
+ */
+static Uint8 *_audio_buildWAV(Uint16 encoding, Uint16 channels, Uint16 bits, int blocks, int *len)
+{
+   const Sint16 coeffs[14] = { 256, 0, 512, -256, 0, 0, 192, 64, 240, 0, 460, -208, 392, -232 };
+   Uint16 blockalign, samplesperblock = 0, extsize = 0, headersize = 0;
+   Uint32 datalen, fmtlen;
+   Uint8 *wav, *p, *data;
+   int i, b, c;
+
+   switch (encoding) {
+   case 0x0002: /* MS ADPCM */
+      blockalign = 256 * channels;
+      headersize = 7 * channels;
+      samplesperblock = (blockalign - headersize) * 8 / (4 * channels) + 2;
+      extsize = 4 + 7 * 4;
+      break;
+   case 0x0011: /* IMA ADPCM */
+      blockalign = 256 * channels;
+      headersize = 4 * channels;
+      samplesperblock = (blockalign - headersize) * 8 / (4 * channels) + 1;
+      extsize = 2;
+      break;
+   default:
+      blockalign = channels * bits / 8;
+      break;
+   }
+
+   fmtlen = 18 + extsize;
+   datalen = blocks * blockalign + blockalign / 3;
+   *len = 12 + (8 + fmtlen) + (8 + datalen);
+   wav = (Uint8 *) SDL_malloc(*len + 1);
+   if (wav == NULL) {
+      return NULL;
+   }
+
+   p = wav;
+   SDL_memcpy(p, "RIFF", 4); p += 4;
+   p = _audio_putLE(p, *len - 8, 4);
+   SDL_memcpy(p, "WAVE", 4); p += 4;
+   SDL_memcpy(p, "fmt ", 4); p += 4;
+   p = _audio_putLE(p, fmtlen, 4);
+   p = _audio_putLE(p, encoding, 2);
+   p = _audio_putLE(p, channels, 2);
+   p = _audio_putLE(p, 22050, 4);
+   p = _audio_putLE(p, 22050 * blockalign, 4);
+   p = _audio_putLE(p, blockalign, 2);
+   p = _audio_putLE(p, bits, 2);
+   p = _audio_putLE(p, extsize, 2);
+   if (extsize) {
+      p = _audio_putLE(p, samplesperblock, 2);
+   }
+   if (encoding == 0x0002) {
+      p = _audio_putLE(p, 7, 2);
+      for (i = 0; i < 14; i++) {
+         p = _audio_putLE(p, (Uint16) coeffs[i], 2);
+      }
+   }
+   SDL_memcpy(p, "data", 4); p += 4;
+   p = _audio_putLE(p, datalen, 4);
+
+   data = p;
+   for (i = 0; i < (int) datalen; i++) {
+      data[i] = SDLTest_RandomUint8();
+   }
+   for (b = 0; b <= blocks && headersize > 0; b++) {
+      Uint8 *h = data + b * blockalign;
+      if ((Uint32) (b * blockalign + headersize) > datalen) {
+         break;
+      }
+      for (c = 0; c < channels; c++) {
+         if (encoding == 0x0002) {
+            h[c] = (Uint8) SDLTest_RandomIntegerInRange(0, 6);  /* predictor */
+            _audio_putLE(h + channels + c * 2, SDLTest_RandomIntegerInRange(16, 2048), 2);  /* delta */
+         } else {
+            h[c * 4 + 2] = (Uint8) SDLTest_RandomIntegerInRange(0, 88);  /* step index */
+            h[c * 4 + 3] = 0;
+         }
+      }
+   }
+
+   return wav;
+}
+
+/**
+ * \brief Decodes WAVE files with the streaming decoder and compares with SDL_LoadWAV_RW.
+ *
+ * \sa https://wiki.libsdl.org/SDL_OpenWAVDecoder_RW
+ * \sa https://wiki.libsdl.org/SDL_WAVDecoderRead
+ * \sa https://wiki.libsdl.org/SDL_WAVDecoderSeek
+ * \sa https://wiki.libsdl.org/SDL_WAVDecoderPutStream
+ */
+int audio_wavDecoder()
+{
+   const struct { Uint16 encoding, channels, bits; const char *name; } formats[] = {
+      { 0x0001, 2, 16, "PCM 16-bit" },
+      { 0x0001, 1, 24, "PCM 24-bit" },
+      { 0x0007, 2, 8, "mu-law" },
+      { 0x0011, 2, 4, "IMA ADPCM" },
+      { 0x0002, 2, 4, "MS ADPCM" },
+   };
+   int f, i;
+
+   for (f = 0; f < SDL_arraysize(formats); f++) {
+      SDL_AudioSpec loadspec, spec;
+      SDL_WAVDecoder *decoder;
+      SDL_AudioStream *stream;
+      Uint8 *wav, *loaded = NULL, *decoded;
+      Uint32 loadedlen = 0;
+      Sint64 frames;
+      int wavlen, framesize, pos, got, mismatch;
+
+      wav = _audio_buildWAV(formats[f].encoding, formats[f].channels, formats[f].bits, 40, &wavlen);
+      SDLTest_AssertCheck(wav != NULL, "%s: Validate WAVE data was built", formats[f].name);
+      if (wav == NULL) {
+         continue;
+      }
+
+      SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, wavlen), 1, &loadspec, &loaded, &loadedlen);
+      SDLTest_AssertPass("%s: Call to SDL_LoadWAV_RW()", formats[f].name);
+      SDLTest_AssertCheck(loaded != NULL, "%s: Validate loaded data is not NULL", formats[f].name);
+
+      decoder = SDL_OpenWAVDecoder_RW(SDL_RWFromConstMem(wav, wavlen), 1, &spec);
+      SDLTest_AssertPass("%s: Call to SDL_OpenWAVDecoder_RW()", formats[f].name);
+      SDLTest_AssertCheck(decoder != NULL, "%s: Validate decoder is not NULL", formats[f].name);
+      if (loaded == NULL || decoder == NULL) {
+         SDL_FreeWAV(loaded);
+         SDL_CloseWAVDecoder(decoder);
+         SDL_free(wav);
+         continue;
+      }
+
+      SDLTest_AssertCheck(spec.format == loadspec.format && spec.channels == loadspec.channels && spec.freq == loadspec.freq,
+                          "%s: Validate decoder spec matches SDL_LoadWAV_RW", formats[f].name);
+      framesize = SDL_AUDIO_BITSIZE(spec.format) / 8 * spec.channels;
+      frames = SDL_WAVDecoderLength(decoder);
+      SDLTest_AssertCheck(frames * framesize == (Sint64) loadedlen,
+                          "%s: Validate decoder length; expected: %d got: %d", formats[f].name, (int) (loadedlen / framesize), (int) frames);
+
+      /* Decode everything in odd-sized pieces */
+      decoded = (Uint8 *) SDL_malloc(loadedlen + framesize * 8);
+      if (decoded == NULL) {
+         break;
+      }
+      pos = 0;
+      do {
+         got = SDL_WAVDecoderRead(decoder, decoded + pos, SDLTest_RandomIntegerInRange(1, framesize * 777));
+         if (got > 0) {
+            pos += got;
+         }
+      } while (got > 0);
+      SDLTest_AssertCheck(got == 0, "%s: Validate end of data; expected: 0 got: %d", formats[f].name, got);
+      SDLTest_AssertCheck(pos == (int) loadedlen && SDL_memcmp(decoded, loaded, loadedlen) == 0,
+                          "%s: Validate decoded data matches SDL_LoadWAV_RW (%d of %d bytes)", formats[f].name, pos, (int) loadedlen);
+      SDLTest_AssertCheck(SDL_WAVDecoderTell(decoder) == frames, "%s: Validate position is at the end", formats[f].name);
+
+      /* Seek around */
+      mismatch = 0;
+      for (i = 0; i < 50; i++) {
+         const int frame = SDLTest_RandomIntegerInRange(0, (int) frames);
+         const int want = SDLTest_RandomIntegerInRange(1, 1500) * framesize;
+         int expect = (int) loadedlen - frame * framesize;
+         expect = (expect < want) ? expect : want;
+         if (SDL_WAVDecoderSeek(decoder, frame) != 0) {
+            mismatch++;
+            continue;
+         }
+         got = SDL_WAVDecoderRead(decoder, decoded, want);
+         if (got != expect || SDL_memcmp(decoded, loaded + frame * framesize, expect) != 0) {
+            mismatch++;
+         }
+      }
+      SDLTest_AssertCheck(mismatch == 0, "%s: Validate seeking; expected: 0 mismatches got: %d", formats[f].name, mismatch);
+      SDLTest_AssertCheck(SDL_WAVDecoderSeek(decoder, frames + 1) == -1, "%s: Validate seek past the end fails", formats[f].name);
+
+      /* Feed an audio stream */
+      stream = SDL_NewAudioStream(spec.format, spec.channels, spec.freq, spec.format, spec.channels, spec.freq);
+      SDLTest_AssertCheck(stream != NULL, "%s: Validate audio stream is not NULL", formats[f].name);
+      if (stream != NULL) {
+         SDL_WAVDecoderSeek(decoder, 0);
+         pos = 0;
+         do {
+            got = SDL_WAVDecoderPutStream(decoder, stream, 10000);
+            if (got > 0) {
+               pos += got;
+            }
+         } while (got > 0);
+         SDL_AudioStreamFlush(stream);
+         got = SDL_AudioStreamGet(stream, decoded, loadedlen + framesize * 8);
+         SDLTest_AssertCheck(pos == (int) loadedlen && got == (int) loadedlen && SDL_memcmp(decoded, loaded, loadedlen) == 0,
+                             "%s: Validate streamed data matches SDL_LoadWAV_RW (%d of %d bytes)", formats[f].name, got, (int) loadedlen);
+         SDL_FreeAudioStream(stream);
+      }
+
+      SDL_CloseWAVDecoder(decoder);
+      SDLTest_AssertPass("%s: Call to SDL_CloseWAVDecoder()", formats[f].name);
+      SDL_free(decoded);
+      SDL_FreeWAV(loaded);
+      SDL_free(wav);
+   }
+
+   /* Negative cases */
+   SDLTest_AssertCheck(SDL_OpenWAVDecoder_RW(NULL, 0, NULL) == NULL, "Validate NULL source fails");
+   SDLTest_AssertCheck(SDL_WAVDecoderRead(NULL, &i, 4) == -1, "Validate reading a NULL decoder fails");
+   SDL_CloseWAVDecoder(NULL);
+   SDLTest_AssertPass("Call to SDL_CloseWAVDecoder(NULL)");
+
+   return TEST_COMPLETED;
+}
+
 
 /* ================= Test Case References ================== */
 
@@ -1022,11 +1521,21 @@ static const SDLTest_TestCaseReference audioTest14 =
 static const SDLTest_TestCaseReference audioTest15 =
         { (SDLTest_TestCaseFp)audio_pauseUnpauseAudio, "audio_pauseUnpauseAudio", "Pause and Unpause audio for various audio specs while testing callback.", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference audioTest16 =
+        { (SDLTest_TestCaseFp)audio_pullModeDevice, "audio_pullModeDevice", "Fill and play buffers on a pull-mode audio device and query its delay.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest17 =
+        { (SDLTest_TestCaseFp)audio_virtualClock, "audio_virtualClock", "Render audio faster than real time on a virtual clock.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest18 =
+        { (SDLTest_TestCaseFp)audio_wavDecoder, "audio_wavDecoder", "Decode WAVE files on demand and compare with SDL_LoadWAV_RW.", TEST_ENABLED };
+
 /* Sequence of Audio test cases */
 static const SDLTest_TestCaseReference *audioTests[] =  {
     &audioTest1, &audioTest2, &audioTest3, &audioTest4, &audioTest5, &audioTest6,
     &audioTest7, &audioTest8, &audioTest9, &audioTest10, &audioTest11,
-    &audioTest12, &audioTest13, &audioTest14, &audioTest15, NULL
+    &audioTest12, &audioTest13, &audioTest14, &audioTest15, &audioTest16,
+    &audioTest17, &audioTest18, NULL
 };
 
 /* Audio test suite (global) */
@@ -174,6 +174,362 @@ events_addDelEventWatchWithUserdata(void *arg)
    return TEST_COMPLETED;
 }
 
+/**
+ * @brief Checks the high resolution timestamps of pushed events
+ *
+ * @sa http://wiki.libsdl.org/SDL_GetEventTimestampNS
+ * @sa http://wiki.libsdl.org/SDL_GetTicksNS
+ */
+int
+events_timestampNS(void *arg)
+{
+   SDL_Event event1;
+   SDL_Event event2;
+   struct {
+      SDL_UserEvent user;
+      Uint8 guard[sizeof(SDL_Event)];
+   } padded;
+   Uint64 before, after, timestamp1, timestamp2;
+   int result;
+   int i;
+
+   SDL_FlushEvents(SDL_USEREVENT, SDL_USEREVENT);
+
+   SDL_zero(event1);
+   event1.type = SDL_USEREVENT;
+   event1.user.code = SDLTest_RandomSint32();
+
+   before = SDL_GetTicksNS();
+   SDLTest_AssertPass("Call to SDL_GetTicksNS()");
+   result = SDL_PushEvent(&event1);
+   SDLTest_AssertPass("Call to SDL_PushEvent()");
+   SDLTest_AssertCheck(result == 1, "Check result from SDL_PushEvent, expected: 1, got: %d", result);
+   after = SDL_GetTicksNS();
+
+   result = SDL_PeepEvents(&event2, 1, SDL_GETEVENT, SDL_USEREVENT, SDL_USEREVENT);
+   SDLTest_AssertPass("Call to SDL_PeepEvents()");
+   SDLTest_AssertCheck(result == 1, "Check result from SDL_PeepEvents, expected: 1, got: %d", result);
+
+   timestamp2 = SDL_GetEventTimestampNS(&event2);
+   SDLTest_AssertPass("Call to SDL_GetEventTimestampNS()");
+   SDLTest_AssertCheck(timestamp2 >= before && timestamp2 <= after, "Check timestamp is between %"SDL_PRIu64" and %"SDL_PRIu64", got: %"SDL_PRIu64, before, after, timestamp2);
+   SDLTest_AssertCheck(event2.common.timestamp == (Uint32)(timestamp2 / 1000000), "Check millisecond timestamp, expected: %u, got: %u", (Uint32)(timestamp2 / 1000000), event2.common.timestamp);
+   SDLTest_AssertCheck(event1.common.timestamp == event2.common.timestamp, "Check pushed event timestamp was updated, expected: %u, got: %u", event2.common.timestamp, event1.common.timestamp);
+   SDLTest_AssertCheck(event1.user.code == event2.user.code, "Check event was queued, expected code: %d, got: %d", event1.user.code, event2.user.code);
+
+   /* Only the common fields of a pushed event are written, it can be a smaller structure */
+   SDL_memset(padded.guard, 0x55, sizeof(padded.guard));
+   SDL_zero(padded.user);
+   padded.user.type = SDL_USEREVENT;
+   result = SDL_PushEvent((SDL_Event *)&padded.user);
+   SDLTest_AssertCheck(result == 1, "Check result from SDL_PushEvent, expected: 1, got: %d", result);
+   for (i = 0; i < (int)sizeof(padded.guard); ++i) {
+      if (padded.guard[i] != 0x55) {
+         break;
+      }
+   }
+   SDLTest_AssertCheck(i == (int)sizeof(padded.guard), "Check memory after SDL_UserEvent wasn't written");
+   SDL_FlushEvents(SDL_USEREVENT, SDL_USEREVENT);
+
+   /* Events that SDL didn't stamp fall back to the millisecond timestamp */
+   SDL_memset(&event1, 0xAA, sizeof(event1));
+   event1.type = SDL_USEREVENT;
+   event1.common.timestamp = 1234;
+   timestamp1 = SDL_GetEventTimestampNS(&event1);
+   SDLTest_AssertCheck(timestamp1 == 1234000000, "Check fallback timestamp, expected: 1234000000, got: %"SDL_PRIu64, timestamp1);
+
+   /* Text editing events have no room for the high resolution timestamp */
+   event2.type = SDL_TEXTEDITING;
+   timestamp2 = SDL_GetEventTimestampNS(&event2);
+   SDLTest_AssertCheck(timestamp2 == (Uint64)event2.common.timestamp * 1000000, "Check SDL_TEXTEDITING timestamp, expected: %"SDL_PRIu64", got: %"SDL_PRIu64, (Uint64)event2.common.timestamp * 1000000, timestamp2);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Checks that consecutive motion events are merged when coalescing is enabled
+ *
+ * @sa http://wiki.libsdl.org/SDL_HINT_EVENT_COALESCING
+ * @sa http://wiki.libsdl.org/SDL_GetMotionHistory
+ */
+int
+events_coalesceMotion(void *arg)
+{
+   SDL_Event event;
+   SDL_Event history[128];
+   const int numMotion = 100;
+   int i, result;
+
+   SDL_SetHint(SDL_HINT_EVENT_COALESCING, "2");
+   SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_EVENT_COALESCING, \"2\")");
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDL_GetMotionHistory(history, SDL_arraysize(history));
+
+   /* A run of motion events for the same mouse becomes one event */
+   for (i = 0; i < numMotion; ++i) {
+      SDL_zero(event);
+      event.type = SDL_MOUSEMOTION;
+      event.motion.which = 1;
+      event.motion.x = i;
+      event.motion.y = 2 * i;
+      event.motion.xrel = 1;
+      event.motion.yrel = 2;
+      SDL_PushEvent(&event);
+   }
+
+   /* A motion event for another mouse isn't merged */
+   event.motion.which = 2;
+   SDL_PushEvent(&event);
+
+   /* Neither is motion after an unrelated event */
+   SDL_zero(event);
+   event.type = SDL_USEREVENT;
+   SDL_PushEvent(&event);
+   SDL_zero(event);
+   event.type = SDL_MOUSEMOTION;
+   event.motion.which = 1;
+   event.motion.xrel = 5;
+   SDL_PushEvent(&event);
+   SDLTest_AssertPass("Call to SDL_PushEvent()");
+
+   result = SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result == 4, "Check queued event count, expected: 4, got: %d", result);
+
+   result = SDL_PollEvent(&event);
+   SDLTest_AssertCheck(result == 1 && event.type == SDL_MOUSEMOTION, "Check merged event type, expected: SDL_MOUSEMOTION, got: 0x%x", event.type);
+   SDLTest_AssertCheck(event.motion.x == numMotion - 1 && event.motion.y == 2 * (numMotion - 1), "Check merged position, expected: %d,%d, got: %d,%d", numMotion - 1, 2 * (numMotion - 1), event.motion.x, event.motion.y);
+   SDLTest_AssertCheck(event.motion.xrel == numMotion && event.motion.yrel == 2 * numMotion, "Check merged relative motion, expected: %d,%d, got: %d,%d", numMotion, 2 * numMotion, event.motion.xrel, event.motion.yrel);
+
+   result = SDL_PollEvent(&event);
+   SDLTest_AssertCheck(result == 1 && event.type == SDL_MOUSEMOTION && event.motion.which == 2, "Check second mouse event, expected: which 2, got: %u", event.motion.which);
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   /* Every raw sample was kept */
+   result = SDL_GetMotionHistory(history, SDL_arraysize(history));
+   SDLTest_AssertPass("Call to SDL_GetMotionHistory()");
+   SDLTest_AssertCheck(result == numMotion + 2, "Check motion history count, expected: %d, got: %d", numMotion + 2, result);
+   for (i = 0; i < numMotion; ++i) {
+      if (history[i].motion.x != i) {
+         break;
+      }
+   }
+   SDLTest_AssertCheck(i == numMotion, "Check motion history order, expected: %d in order, got: %d", numMotion, i);
+   result = SDL_GetMotionHistory(history, SDL_arraysize(history));
+   SDLTest_AssertCheck(result == 0, "Check motion history is empty, expected: 0, got: %d", result);
+
+   SDL_SetHint(SDL_HINT_EVENT_COALESCING, NULL);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Checks that events can be retrieved in bulk and by type range
+ *
+ * @sa http://wiki.libsdl.org/SDL_PollEvents
+ * @sa http://wiki.libsdl.org/SDL_HasEvents
+ * @sa http://wiki.libsdl.org/SDL_FlushEvents
+ */
+int
+events_pollEvents(void *arg)
+{
+   SDL_Event event;
+   SDL_Event events[64];
+   const int numUser = 40;
+   int i, result;
+
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   /* Interleave events from a few different categories */
+   for (i = 0; i < numUser; ++i) {
+      SDL_zero(event);
+      event.type = SDL_USEREVENT;
+      event.user.code = i;
+      SDL_PushEvent(&event);
+      if ((i % 4) == 0) {
+         SDL_zero(event);
+         event.type = SDL_KEYDOWN;
+         SDL_PushEvent(&event);
+      }
+   }
+   SDL_zero(event);
+   event.type = SDL_DROPFILE + 1;
+   SDL_PushEvent(&event);
+   SDLTest_AssertPass("Call to SDL_PushEvent()");
+
+   SDLTest_AssertCheck(SDL_HasEvent(SDL_KEYDOWN) == SDL_TRUE, "Check SDL_HasEvent(SDL_KEYDOWN), expected: SDL_TRUE");
+   SDLTest_AssertCheck(SDL_HasEvent(SDL_KEYUP) == SDL_FALSE, "Check SDL_HasEvent(SDL_KEYUP), expected: SDL_FALSE");
+   SDLTest_AssertCheck(SDL_HasEvents(SDL_DROPFILE, SDL_USEREVENT - 1) == SDL_TRUE, "Check SDL_HasEvents() across categories, expected: SDL_TRUE");
+   SDLTest_AssertCheck(SDL_HasEvents(SDL_MOUSEMOTION, SDL_DROPFILE) == SDL_FALSE, "Check SDL_HasEvents() for empty categories, expected: SDL_FALSE");
+
+   /* Only the requested range is drained, in queue order */
+   result = SDL_PollEvents(events, SDL_arraysize(events), SDL_USEREVENT, SDL_LASTEVENT);
+   SDLTest_AssertPass("Call to SDL_PollEvents()");
+   SDLTest_AssertCheck(result == numUser, "Check SDL_PollEvents() count, expected: %d, got: %d", numUser, result);
+   for (i = 0; i < result; ++i) {
+      if (events[i].type != SDL_USEREVENT || events[i].user.code != i) {
+         break;
+      }
+   }
+   SDLTest_AssertCheck(i == numUser, "Check SDL_PollEvents() order, expected: %d in order, got: %d", numUser, i);
+   SDLTest_AssertCheck(SDL_HasEvent(SDL_USEREVENT) == SDL_FALSE, "Check SDL_HasEvent(SDL_USEREVENT), expected: SDL_FALSE");
+   SDLTest_AssertCheck(SDL_HasEvents(SDL_KEYDOWN, SDL_KEYUP) == SDL_TRUE, "Check SDL_HasEvents(SDL_KEYDOWN, SDL_KEYUP), expected: SDL_TRUE");
+   SDLTest_AssertCheck(SDL_HasEvents(SDL_KEYUP, SDL_TEXTINPUT) == SDL_FALSE, "Check SDL_HasEvents(SDL_KEYUP, SDL_TEXTINPUT), expected: SDL_FALSE");
+
+   /* Flushing a category leaves the others alone */
+   SDL_FlushEvents(SDL_KEYDOWN, SDL_KEYDOWN);
+   SDLTest_AssertPass("Call to SDL_FlushEvents()");
+   SDLTest_AssertCheck(SDL_HasEvent(SDL_KEYDOWN) == SDL_FALSE, "Check SDL_HasEvent(SDL_KEYDOWN) after flush, expected: SDL_FALSE");
+   result = SDL_PollEvents(events, SDL_arraysize(events), SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result == 1 && events[0].type == SDL_DROPFILE + 1, "Check remaining event, expected: 1 of type 0x%x, got: %d", SDL_DROPFILE + 1, result);
+
+   result = SDL_PollEvents(events, SDL_arraysize(events), SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result == 0, "Check empty queue, expected: 0, got: %d", result);
+   result = SDL_PollEvents(NULL, 0, SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result < 0, "Check invalid parameters, expected: < 0, got: %d", result);
+
+   return TEST_COMPLETED;
+}
+
+/* Event watchers used by the dispatch benchmark */
+static int SDLCALL _events_countingWatcher(void *userdata, SDL_Event *event)
+{
+   ++*(int *)userdata;
+   return 0;
+}
+
+static int SDLCALL _events_selfRemovingWatcher(void *userdata, SDL_Event *event)
+{
+   ++*(int *)userdata;
+   SDL_DelEventWatch(_events_selfRemovingWatcher, userdata);
+   return 0;
+}
+
+static int SDLCALL _events_watcherChurnThread(void *data)
+{
+   SDL_atomic_t *done = (SDL_atomic_t *)data;
+   int calls = 0;
+
+   while (!SDL_AtomicGet(done)) {
+      SDL_AddEventWatch(_events_countingWatcher, &calls);
+      SDL_DelEventWatch(_events_countingWatcher, &calls);
+   }
+   return 0;
+}
+
+/**
+ * @brief Measures event watcher dispatch and checks watchers can change while events are pushed
+ *
+ * @sa http://wiki.libsdl.org/SDL_AddEventWatch
+ * @sa http://wiki.libsdl.org/SDL_DelEventWatch
+ */
+int
+events_watcherDispatch(void *arg)
+{
+   SDL_Event event;
+   SDL_Thread *thread;
+   SDL_atomic_t done;
+   const int numEvents = 50000;
+   int counted = 0, removed = 0;
+   Uint64 start, elapsed;
+   int i;
+
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDL_zero(event);
+   event.type = SDL_USEREVENT;
+
+   SDL_AddEventWatch(_events_countingWatcher, &counted);
+   SDL_AddEventWatch(_events_selfRemovingWatcher, &removed);
+   SDLTest_AssertPass("Call to SDL_AddEventWatch()");
+
+   start = SDL_GetPerformanceCounter();
+   for (i = 0; i < numEvents; ++i) {
+      SDL_PushEvent(&event);
+   }
+   elapsed = SDL_GetPerformanceCounter() - start;
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_Log("SDL_PushEvent() with watchers: %d events in %.3f ms, %.1f ns/event", numEvents,
+               (double)elapsed * 1000.0 / SDL_GetPerformanceFrequency(),
+               (double)elapsed * 1000000000.0 / SDL_GetPerformanceFrequency() / numEvents);
+
+   SDLTest_AssertCheck(counted == numEvents, "Check watcher calls, expected: %d, got: %d", numEvents, counted);
+   SDLTest_AssertCheck(removed == 1, "Check self removing watcher calls, expected: 1, got: %d", removed);
+
+   /* Dispatch keeps working while another thread changes the watchers */
+   counted = 0;
+   SDL_AtomicSet(&done, 0);
+   thread = SDL_CreateThread(_events_watcherChurnThread, "WatcherChurn", &done);
+   SDLTest_AssertCheck(thread != NULL, "Check SDL_CreateThread(), expected: non-NULL");
+   start = SDL_GetPerformanceCounter();
+   for (i = 0; i < numEvents; ++i) {
+      SDL_PushEvent(&event);
+   }
+   elapsed = SDL_GetPerformanceCounter() - start;
+   SDL_AtomicSet(&done, 1);
+   SDL_WaitThread(thread, NULL);
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_Log("SDL_PushEvent() with changing watchers: %d events in %.3f ms, %.1f ns/event", numEvents,
+               (double)elapsed * 1000.0 / SDL_GetPerformanceFrequency(),
+               (double)elapsed * 1000000000.0 / SDL_GetPerformanceFrequency() / numEvents);
+   SDLTest_AssertCheck(counted == numEvents, "Check watcher calls, expected: %d, got: %d", numEvents, counted);
+
+   SDL_DelEventWatch(_events_countingWatcher, &counted);
+   SDLTest_AssertPass("Call to SDL_DelEventWatch()");
+
+   return TEST_COMPLETED;
+}
+
+/* Watcher that stays in the callback for a while, used to check removal waits for it */
+static int SDLCALL _events_slowWatcher(void *userdata, SDL_Event *event)
+{
+   SDL_atomic_t *state = (SDL_atomic_t *)userdata;
+
+   SDL_AtomicSet(state, 1);
+   SDL_Delay(100);
+   SDL_AtomicSet(state, 2);
+   return 0;
+}
+
+static int SDLCALL _events_pushEventThread(void *data)
+{
+   SDL_Event event;
+
+   SDL_zero(event);
+   event.type = SDL_USEREVENT;
+   SDL_PushEvent(&event);
+   return 0;
+}
+
+/**
+ * @brief Checks that deleting an event watch waits for callbacks running on other threads
+ *
+ * @sa http://wiki.libsdl.org/SDL_DelEventWatch
+ */
+int
+events_delEventWatchWaits(void *arg)
+{
+   SDL_Thread *thread;
+   SDL_atomic_t state;
+
+   SDL_AtomicSet(&state, 0);
+   SDL_AddEventWatch(_events_slowWatcher, &state);
+   SDLTest_AssertPass("Call to SDL_AddEventWatch()");
+
+   thread = SDL_CreateThread(_events_pushEventThread, "PushEvent", NULL);
+   SDLTest_AssertCheck(thread != NULL, "Check SDL_CreateThread(), expected: non-NULL");
+   while (thread && SDL_AtomicGet(&state) == 0) {
+      SDL_Delay(1);
+   }
+
+   SDL_DelEventWatch(_events_slowWatcher, &state);
+   SDLTest_AssertPass("Call to SDL_DelEventWatch()");
+   SDLTest_AssertCheck(SDL_AtomicGet(&state) == 2, "Check watcher finished before SDL_DelEventWatch() returned, expected: 2, got: %d", SDL_AtomicGet(&state));
+
+   SDL_WaitThread(thread, NULL);
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   return TEST_COMPLETED;
+}
+
 
 /* ================= Test References ================== */
 
@@ -187,9 +543,24 @@ static const SDLTest_TestCaseReference eventsTest2 =
 static const SDLTest_TestCaseReference eventsTest3 =
         { (SDLTest_TestCaseFp)events_addDelEventWatchWithUserdata, "events_addDelEventWatchWithUserdata", "Adds and deletes an event watch function with userdata", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference eventsTest4 =
+        { (SDLTest_TestCaseFp)events_timestampNS, "events_timestampNS", "Checks the high resolution timestamps of pushed events", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest5 =
+        { (SDLTest_TestCaseFp)events_coalesceMotion, "events_coalesceMotion", "Checks that consecutive motion events are merged when coalescing is enabled", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest6 =
+        { (SDLTest_TestCaseFp)events_pollEvents, "events_pollEvents", "Checks that events can be retrieved in bulk and by type range", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest7 =
+        { (SDLTest_TestCaseFp)events_watcherDispatch, "events_watcherDispatch", "Measures event watcher dispatch and checks watchers can change while events are pushed", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest8 =
+        { (SDLTest_TestCaseFp)events_delEventWatchWaits, "events_delEventWatchWaits", "Checks that deleting an event watch waits for callbacks running on other threads", TEST_ENABLED };
+
 /* Sequence of Events test cases */
 static const SDLTest_TestCaseReference *eventsTests[] =  {
-    &eventsTest1, &eventsTest2, &eventsTest3, NULL
+    &eventsTest1, &eventsTest2, &eventsTest3, &eventsTest4, &eventsTest5, &eventsTest6, &eventsTest7, &eventsTest8, NULL
 };
 
 /* Events test suite (global) */
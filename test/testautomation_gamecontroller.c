@@ -0,0 +1,255 @@
+/**
+ * Game controller test suite
+ */
+
+#include "SDL.h"
+#include "SDL_test.h"
+
+/* GUIDs that no built-in mapping or automatic mapping uses */
+#define TEST_GUID_A "05000000aabbccdd0100000000000000"
+#define TEST_GUID_B "05000000aabbccdd0200000000000000"
+#define TEST_GUID_C "05000000aabbccdd0300000000000000"
+#define TEST_GUID_MISSING "05000000aabbccdd0400000000000000"
+
+#define TEST_MAPPING_A1 "a:b0,b:b1,x:b2,y:b3,"
+#define TEST_MAPPING_A2 "a:b1,b:b0,x:b3,y:b2,"
+#define TEST_MAPPING_B  "a:b4,b:b5,leftx:a0,lefty:a1,"
+#define TEST_MAPPING_C1 "a:b6,b:b7,"
+#define TEST_MAPPING_C2 "a:b7,b:b6,"
+
+/* Fixture */
+
+void
+_gamecontrollerSetUp(void *arg)
+{
+    int ret = SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER);
+    SDLTest_AssertPass("Call to SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER)");
+    SDLTest_AssertCheck(ret == 0, "Check result from SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER)");
+    if (ret != 0) {
+        SDLTest_LogError("%s", SDL_GetError());
+    }
+}
+
+void
+_gamecontrollerTearDown(void *arg)
+{
+    SDL_QuitSubSystem(SDL_INIT_GAMECONTROLLER);
+    SDLTest_AssertPass("Call to SDL_QuitSubSystem(SDL_INIT_GAMECONTROLLER)");
+}
+
+/* Helper functions */
+
+/* Check that the mapping for a GUID has the given name and bindings */
+static void
+_checkMapping(const char *guid, const char *name, const char *bindings)
+{
+    char *mapping = SDL_GameControllerMappingForGUID(SDL_JoystickGetGUIDFromString(guid));
+
+    SDLTest_AssertCheck(mapping != NULL, "Check mapping for %s exists", guid);
+    if (mapping) {
+        char expected[256];
+
+        SDL_snprintf(expected, sizeof(expected), "%s,%s,%s", guid, name, bindings);
+        SDLTest_AssertCheck(SDL_strncmp(mapping, expected, SDL_strlen(expected)) == 0,
+                            "Check mapping for %s, expected: %s..., got: %s", guid, expected, mapping);
+        SDL_free(mapping);
+    }
+}
+
+/* Write the mappings database into a newly allocated cache */
+static void *
+_saveMappingCache(size_t *size)
+{
+    const size_t max_size = 4 * 1024 * 1024;
+    void *cache = SDL_malloc(max_size);
+    SDL_RWops *rw;
+    int ret;
+
+    *size = 0;
+    if (!cache) {
+        return NULL;
+    }
+    rw = SDL_RWFromMem(cache, (int)max_size);
+    ret = SDL_GameControllerSaveMappingCacheRW(rw, 0);
+    /* The default mapping is saved too, but isn't counted by SDL_GameControllerNumMappings() */
+    SDLTest_AssertCheck(ret >= SDL_GameControllerNumMappings(), "Check result from SDL_GameControllerSaveMappingCacheRW(), expected: >= %i, got: %i",
+                        SDL_GameControllerNumMappings(), ret);
+    *size = (size_t)SDL_RWtell(rw);
+    SDL_RWclose(rw);
+    return cache;
+}
+
+/* Test case functions */
+
+/**
+ * @brief Adds, replaces and looks up mappings by GUID
+ *
+ * @sa http://wiki.libsdl.org/SDL_GameControllerAddMapping
+ * @sa http://wiki.libsdl.org/SDL_GameControllerMappingForGUID
+ */
+int
+gamecontroller_testAddMapping(void *arg)
+{
+    const int num_mappings = SDL_GameControllerNumMappings();
+    char *mapping;
+    int ret;
+
+    ret = SDL_GameControllerAddMapping(TEST_GUID_A ",Test Controller A," TEST_MAPPING_A1);
+    SDLTest_AssertCheck(ret == 1, "Check result from SDL_GameControllerAddMapping(), expected: 1 (added), got: %i", ret);
+    ret = SDL_GameControllerAddMapping(TEST_GUID_B ",Test Controller B," TEST_MAPPING_B);
+    SDLTest_AssertCheck(ret == 1, "Check result from SDL_GameControllerAddMapping(), expected: 1 (added), got: %i", ret);
+    SDLTest_AssertCheck(SDL_GameControllerNumMappings() == num_mappings + 2, "Check number of mappings, expected: %i, got: %i",
+                        num_mappings + 2, SDL_GameControllerNumMappings());
+    _checkMapping(TEST_GUID_A, "Test Controller A", TEST_MAPPING_A1);
+    _checkMapping(TEST_GUID_B, "Test Controller B", TEST_MAPPING_B);
+
+    /* Replacing a mapping keeps its place in the database */
+    ret = SDL_GameControllerAddMapping(TEST_GUID_A ",Test Controller A2," TEST_MAPPING_A2);
+    SDLTest_AssertCheck(ret == 0, "Check result from SDL_GameControllerAddMapping(), expected: 0 (updated), got: %i", ret);
+    SDLTest_AssertCheck(SDL_GameControllerNumMappings() == num_mappings + 2, "Check number of mappings, expected: %i, got: %i",
+                        num_mappings + 2, SDL_GameControllerNumMappings());
+    _checkMapping(TEST_GUID_A, "Test Controller A2", TEST_MAPPING_A2);
+    _checkMapping(TEST_GUID_B, "Test Controller B", TEST_MAPPING_B);
+
+    mapping = SDL_GameControllerMappingForIndex(num_mappings);
+    SDLTest_AssertCheck(mapping && SDL_strncmp(mapping, TEST_GUID_A ",Test Controller A2,", 52) == 0,
+                        "Check mapping at index %i, got: %s", num_mappings, mapping ? mapping : "(null)");
+    SDL_free(mapping);
+
+    mapping = SDL_GameControllerMappingForGUID(SDL_JoystickGetGUIDFromString(TEST_GUID_MISSING));
+    SDLTest_AssertCheck(mapping == NULL, "Check mapping for an unknown GUID, expected: NULL, got: %s", mapping ? mapping : "(null)");
+    SDL_free(mapping);
+
+    ret = SDL_GameControllerAddMapping("not a mapping");
+    SDLTest_AssertCheck(ret == -1, "Check result from SDL_GameControllerAddMapping() with a bad mapping, expected: -1, got: %i", ret);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Loads text mappings that are parsed on demand and replaces them before and after they are used
+ *
+ * @sa http://wiki.libsdl.org/SDL_GameControllerAddMappingsFromRW
+ */
+int
+gamecontroller_testLazyMappings(void *arg)
+{
+    const char *platform = SDL_GetPlatform();
+    char db[1024];
+    int ret;
+
+    SDL_snprintf(db, sizeof(db),
+                 "# Test database\n"
+                 TEST_GUID_A ",Lazy Controller A," TEST_MAPPING_A1 "platform:%s,\n"
+                 TEST_GUID_B ",Other Platform B," TEST_MAPPING_B "platform:Not A Platform,\n"
+                 TEST_GUID_C ",Lazy Controller C," TEST_MAPPING_C1 "platform:%s,\n"
+                 TEST_GUID_C ",Lazy Controller C2," TEST_MAPPING_C2 "platform:%s,\n",
+                 platform, platform, platform);
+    ret = SDL_GameControllerAddMappingsFromRW(SDL_RWFromConstMem(db, (int)SDL_strlen(db)), 1);
+    SDLTest_AssertCheck(ret == 2, "Check result from SDL_GameControllerAddMappingsFromRW(), expected: 2, got: %i", ret);
+
+    /* Later lines for the same GUID replace earlier ones */
+    _checkMapping(TEST_GUID_C, "Lazy Controller C2", TEST_MAPPING_C2);
+
+    /* Only the lines for this platform are added */
+    SDLTest_AssertCheck(SDL_GameControllerMappingForGUID(SDL_JoystickGetGUIDFromString(TEST_GUID_B)) == NULL,
+                        "Check mapping for another platform wasn't added");
+
+    /* Override a mapping that hasn't been parsed yet */
+    ret = SDL_GameControllerAddMapping(TEST_GUID_A ",Override A," TEST_MAPPING_A2);
+    SDLTest_AssertCheck(ret == 0, "Check result from SDL_GameControllerAddMapping(), expected: 0 (updated), got: %i", ret);
+    _checkMapping(TEST_GUID_A, "Override A", TEST_MAPPING_A2);
+
+    /* Reloading the database replaces the override again, and parsed mappings too */
+    ret = SDL_GameControllerAddMappingsFromRW(SDL_RWFromConstMem(db, (int)SDL_strlen(db)), 1);
+    SDLTest_AssertCheck(ret == 0, "Check result from SDL_GameControllerAddMappingsFromRW(), expected: 0, got: %i", ret);
+    _checkMapping(TEST_GUID_A, "Lazy Controller A", TEST_MAPPING_A1);
+    _checkMapping(TEST_GUID_C, "Lazy Controller C2", TEST_MAPPING_C2);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Saves the mappings database as a binary cache and loads it back
+ *
+ * @sa http://wiki.libsdl.org/SDL_GameControllerSaveMappingCacheRW
+ * @sa http://wiki.libsdl.org/SDL_GameControllerAddMappingsFromCacheRW
+ */
+int
+gamecontroller_testMappingCache(void *arg)
+{
+    int num_mappings, ret;
+    size_t size;
+    Uint8 *cache;
+    char *mapping;
+
+    SDL_GameControllerAddMapping(TEST_GUID_A ",Cached Controller A," TEST_MAPPING_A1);
+    SDL_GameControllerAddMapping(TEST_GUID_B ",Cached Controller B," TEST_MAPPING_B);
+    num_mappings = SDL_GameControllerNumMappings();
+
+    cache = (Uint8 *)_saveMappingCache(&size);
+    SDLTest_AssertCheck(cache != NULL && size > 0, "Check mapping cache was written, size: %u", (unsigned int)size);
+    if (!cache) {
+        return TEST_ABORTED;
+    }
+
+    /* Start over with only the built-in mappings */
+    SDL_QuitSubSystem(SDL_INIT_GAMECONTROLLER);
+    SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER);
+    mapping = SDL_GameControllerMappingForGUID(SDL_JoystickGetGUIDFromString(TEST_GUID_A));
+    SDLTest_AssertCheck(mapping == NULL, "Check cache miss before loading the cache, expected: NULL, got: %s", mapping ? mapping : "(null)");
+    SDL_free(mapping);
+
+    ret = SDL_GameControllerAddMappingsFromCacheRW(SDL_RWFromConstMem(cache, (int)size), 1);
+    SDLTest_AssertCheck(ret >= 2, "Check result from SDL_GameControllerAddMappingsFromCacheRW(), expected: >= 2, got: %i", ret);
+    SDLTest_AssertCheck(SDL_GameControllerNumMappings() == num_mappings, "Check number of mappings, expected: %i, got: %i",
+                        num_mappings, SDL_GameControllerNumMappings());
+
+    /* Cache hits, including one that is overridden before it is ever parsed */
+    _checkMapping(TEST_GUID_A, "Cached Controller A", TEST_MAPPING_A1);
+    ret = SDL_GameControllerAddMapping(TEST_GUID_B ",Override B," TEST_MAPPING_C1);
+    SDLTest_AssertCheck(ret == 0, "Check result from SDL_GameControllerAddMapping(), expected: 0 (updated), got: %i", ret);
+    _checkMapping(TEST_GUID_B, "Override B", TEST_MAPPING_C1);
+
+    /* Cache miss */
+    mapping = SDL_GameControllerMappingForGUID(SDL_JoystickGetGUIDFromString(TEST_GUID_MISSING));
+    SDLTest_AssertCheck(mapping == NULL, "Check cache miss, expected: NULL, got: %s", mapping ? mapping : "(null)");
+    SDL_free(mapping);
+
+    /* Damaged caches are rejected */
+    ret = SDL_GameControllerAddMappingsFromCacheRW(SDL_RWFromConstMem(cache, (int)size / 2), 1);
+    SDLTest_AssertCheck(ret == -1, "Check result from SDL_GameControllerAddMappingsFromCacheRW() with a truncated cache, expected: -1, got: %i", ret);
+    cache[0] ^= 0xFF;
+    ret = SDL_GameControllerAddMappingsFromCacheRW(SDL_RWFromConstMem(cache, (int)size), 1);
+    SDLTest_AssertCheck(ret == -1, "Check result from SDL_GameControllerAddMappingsFromCacheRW() with a bad header, expected: -1, got: %i", ret);
+
+    SDL_free(cache);
+    return TEST_COMPLETED;
+}
+
+/* ================= Test References ================== */
+
+/* Game controller test cases */
+static const SDLTest_TestCaseReference gamecontrollerTest1 =
+        { (SDLTest_TestCaseFp)gamecontroller_testAddMapping, "gamecontroller_testAddMapping", "Add, replace and look up mappings by GUID", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference gamecontrollerTest2 =
+        { (SDLTest_TestCaseFp)gamecontroller_testLazyMappings, "gamecontroller_testLazyMappings", "Replace mappings loaded from text before and after they are parsed", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference gamecontrollerTest3 =
+        { (SDLTest_TestCaseFp)gamecontroller_testMappingCache, "gamecontroller_testMappingCache", "Save and load a binary mapping cache", TEST_ENABLED };
+
+/* Sequence of Game controller test cases */
+static const SDLTest_TestCaseReference *gamecontrollerTests[] =  {
+    &gamecontrollerTest1, &gamecontrollerTest2, &gamecontrollerTest3, NULL
+};
+
+/* Game controller test suite (global) */
+SDLTest_TestSuiteReference gamecontrollerTestSuite = {
+    "GameController",
+    _gamecontrollerSetUp,
+    gamecontrollerTests,
+    _gamecontrollerTearDown
+};
+
+/* vi: set ts=4 sw=4 expandtab: */
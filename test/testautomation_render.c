@@ -36,6 +36,8 @@ static SDL_Texture *_loadTestFace(void);
 static int _hasBlendModes(void);
 static int _hasDrawColor(void);
 static int _isSupported(int code);
+static int _drawCommandListContent(SDL_Texture *tface, int x, int y);
+static int _drawSortScene(SDL_Renderer *target, SDL_Texture *tface, SDL_Texture *tblit);
 
 /**
  * Create software renderer for tests
@@ -420,6 +422,754 @@ render_testBlit(void *arg)
 }
 
 
+/**
+ * @brief Tests blitting from a texture atlas.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_CreateTextureAtlas
+ * http://wiki.libsdl.org/SDL_CreateAtlasTextureFromSurface
+ * http://wiki.libsdl.org/SDL_RenderCopy
+ * http://wiki.libsdl.org/SDL_DestroyTextureAtlas
+ */
+int
+render_testBlitAtlas(void *arg)
+{
+   int ret;
+   SDL_Rect rect;
+   SDL_TextureAtlas *atlas;
+   SDL_Texture *tface, *tfiller;
+   SDL_Surface *face, *referenceSurface = NULL;
+   int tw, th;
+   int i, j, ni, nj;
+   int checkFailCount1;
+
+   /* Clear surface. */
+   _clearScreen();
+
+   face = SDLTest_ImageFace();
+   SDLTest_AssertCheck(face != NULL, "Verify SDLTest_ImageFace() result");
+   if (face == NULL) {
+       return TEST_ABORTED;
+   }
+
+   /* Pages fit a single face, so the fillers push it onto a later page */
+   atlas = SDL_CreateTextureAtlas(renderer, 0, face->w + 8, face->h + 8);
+   SDLTest_AssertCheck(atlas != NULL, "Verify SDL_CreateTextureAtlas() result");
+   if (atlas == NULL) {
+       SDL_FreeSurface(face);
+       return TEST_ABORTED;
+   }
+   for (i = 0; i < 5; i++) {
+      tfiller = SDL_CreateAtlasTexture(atlas, face->w / 2 + 3, face->h / 3);
+      SDLTest_AssertCheck(tfiller != NULL, "Verify SDL_CreateAtlasTexture() result");
+   }
+   tfiller = SDL_CreateAtlasTexture(atlas, face->w + 9, 1);
+   SDLTest_AssertCheck(tfiller == NULL, "Verify SDL_CreateAtlasTexture() fails for textures larger than a page");
+
+   tface = SDL_CreateAtlasTextureFromSurface(atlas, face);
+   SDL_FreeSurface(face);
+   SDLTest_AssertCheck(tface != NULL, "Verify SDL_CreateAtlasTextureFromSurface() result");
+   if (tface == NULL) {
+       SDL_DestroyTextureAtlas(atlas);
+       return TEST_ABORTED;
+   }
+
+   /* Constant values. */
+   ret = SDL_QueryTexture(tface, NULL, NULL, &tw, &th);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_QueryTexture, expected 0, got %i", ret);
+   rect.w = tw;
+   rect.h = th;
+   ni     = TESTRENDER_SCREEN_W - tw;
+   nj     = TESTRENDER_SCREEN_H - th;
+
+   /* Loop blit. */
+   checkFailCount1 = 0;
+   for (j=0; j <= nj; j+=4) {
+      for (i=0; i <= ni; i+=4) {
+         /* Blitting. */
+         rect.x = i;
+         rect.y = j;
+         ret = SDL_RenderCopy(renderer, tface, NULL, &rect );
+         if (ret != 0) checkFailCount1++;
+      }
+   }
+   SDLTest_AssertCheck(checkFailCount1 == 0, "Validate results from calls to SDL_RenderCopy, expected: 0, got: %i", checkFailCount1);
+
+   /* Make current */
+   SDL_RenderPresent(renderer);
+
+   /* See if it's the same */
+   referenceSurface = SDLTest_ImageBlit();
+   _compare(referenceSurface, ALLOWABLE_ERROR_OPAQUE );
+
+   /* Clean up, destroying the atlas takes the remaining textures with it. */
+   SDL_DestroyTexture( tface );
+   SDL_DestroyTextureAtlas( atlas );
+   SDL_FreeSurface(referenceSurface);
+   referenceSurface = NULL;
+
+   return TEST_COMPLETED;
+}
+
+
+/**
+ * @brief Tests recording a command list and replaying it at an offset.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_RenderBeginCommandList
+ * http://wiki.libsdl.org/SDL_RenderEndCommandList
+ * http://wiki.libsdl.org/SDL_RenderReplayCommandList
+ * http://wiki.libsdl.org/SDL_DestroyRenderCommandList
+ */
+int
+render_testCommandList(void *arg)
+{
+   int ret;
+   SDL_Rect rect;
+   SDL_Point offset;
+   SDL_RenderCommandList *list, *changedList;
+   SDL_Texture *tface;
+   Uint32 format;
+   Uint8 pixel[16];
+   SDL_Surface *referenceSurface;
+
+   list = SDL_RenderEndCommandList(renderer);
+   SDLTest_AssertCheck(list == NULL, "Verify SDL_RenderEndCommandList() fails when not recording");
+
+   tface = _loadTestFace();
+   SDLTest_AssertCheck(tface != NULL, "Verify _loadTestFace() result");
+   if (tface == NULL) {
+       return TEST_ABORTED;
+   }
+
+   referenceSurface = SDL_CreateRGBSurfaceWithFormat(0, TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H, 32, RENDER_COMPARE_FORMAT);
+   SDLTest_AssertCheck(referenceSurface != NULL, "Verify SDL_CreateRGBSurfaceWithFormat() result");
+   if (referenceSurface == NULL) {
+       SDL_DestroyTexture(tface);
+       return TEST_ABORTED;
+   }
+
+   /* Draw the reference directly, in two places. */
+   _clearScreen();
+   _drawCommandListContent(tface, 0, 0);
+   _drawCommandListContent(tface, TESTRENDER_SCREEN_W / 2, TESTRENDER_SCREEN_H / 2);
+   rect.x = 0;
+   rect.y = 0;
+   rect.w = TESTRENDER_SCREEN_W;
+   rect.h = TESTRENDER_SCREEN_H;
+   ret = SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, referenceSurface->pixels, referenceSurface->pitch);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+
+   /* Record the same drawing once. */
+   _clearScreen();
+   ret = SDL_RenderBeginCommandList(renderer);
+   if (!_isSupported(ret)) {
+       SDL_FreeSurface(referenceSurface);
+       SDL_DestroyTexture(tface);
+       return TEST_SKIPPED;
+   }
+   ret = SDL_RenderBeginCommandList(renderer);
+   SDLTest_AssertCheck(ret != 0, "Verify SDL_RenderBeginCommandList() fails while recording");
+   _drawCommandListContent(tface, 0, 0);
+   ret = SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, referenceSurface->pixels, referenceSurface->pitch);
+   SDLTest_AssertCheck(ret != 0, "Verify SDL_RenderReadPixels() fails while recording");
+   ret = SDL_RenderFlush(renderer);
+   SDLTest_AssertCheck(ret != 0, "Verify SDL_RenderFlush() fails while recording");
+   list = SDL_RenderEndCommandList(renderer);
+   SDLTest_AssertCheck(list != NULL, "Verify SDL_RenderEndCommandList() result");
+   if (list == NULL) {
+       SDL_FreeSurface(referenceSurface);
+       SDL_DestroyTexture(tface);
+       return TEST_ABORTED;
+   }
+
+   /* Nothing was drawn while recording, the replays draw everything. */
+   ret = SDL_RenderReplayCommandList(renderer, list, NULL);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReplayCommandList, expected: 0, got: %i", ret);
+   offset.x = TESTRENDER_SCREEN_W / 2;
+   offset.y = TESTRENDER_SCREEN_H / 2;
+   ret = SDL_RenderReplayCommandList(renderer, list, &offset);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReplayCommandList, expected: 0, got: %i", ret);
+   _compare(referenceSurface, ALLOWABLE_ERROR_OPAQUE);
+
+   /* Replaying again must give the same result. */
+   _clearScreen();
+   ret = SDL_RenderReplayCommandList(renderer, list, NULL);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReplayCommandList, expected: 0, got: %i", ret);
+   ret = SDL_RenderReplayCommandList(renderer, list, &offset);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReplayCommandList, expected: 0, got: %i", ret);
+   _compare(referenceSurface, ALLOWABLE_ERROR_OPAQUE);
+
+   /* The list can't be replayed if a texture it draws with changed while recording. */
+   ret = SDL_RenderBeginCommandList(renderer);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderBeginCommandList, expected: 0, got: %i", ret);
+   _drawCommandListContent(tface, 0, 0);
+   SDL_QueryTexture(tface, &format, NULL, NULL, NULL);
+   SDL_zeroa(pixel);
+   rect.w = rect.h = 1;
+   ret = SDL_UpdateTexture(tface, &rect, pixel, SDL_BYTESPERPIXEL(format));
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+   changedList = SDL_RenderEndCommandList(renderer);
+   SDLTest_AssertCheck(changedList != NULL, "Verify SDL_RenderEndCommandList() result");
+   ret = SDL_RenderReplayCommandList(renderer, changedList, NULL);
+   SDLTest_AssertCheck(ret != 0, "Verify SDL_RenderReplayCommandList() fails after updating a texture while recording");
+   SDL_DestroyRenderCommandList(changedList);
+
+   /* Updating it between replays is fine. */
+   ret = SDL_RenderReplayCommandList(renderer, list, NULL);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReplayCommandList, expected: 0, got: %i", ret);
+
+   /* The list can't be replayed without its texture. */
+   SDL_DestroyTexture(tface);
+   ret = SDL_RenderReplayCommandList(renderer, list, NULL);
+   SDLTest_AssertCheck(ret != 0, "Verify SDL_RenderReplayCommandList() fails after destroying a texture it uses");
+
+   /* Clean up. */
+   SDL_DestroyRenderCommandList(list);
+   SDL_FreeSurface(referenceSurface);
+
+   return TEST_COMPLETED;
+}
+
+/* Pushes window events from another thread, so the renderer's event watcher runs there */
+static int SDLCALL
+_pushWindowEventsThread(void *data)
+{
+   SDL_Window *target = (SDL_Window *)data;
+   SDL_Event event;
+   int i;
+
+   SDL_zero(event);
+   event.type = SDL_WINDOWEVENT;
+   event.window.event = SDL_WINDOWEVENT_EXPOSED;
+   event.window.windowID = SDL_GetWindowID(target);
+   for (i = 0; i < 1000; i++) {
+      SDL_PushEvent(&event);
+   }
+   return 0;
+}
+
+/**
+ * @brief Tests drawing frames on a render thread.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_HINT_RENDER_THREAD
+ * http://wiki.libsdl.org/SDL_RenderPresent
+ * http://wiki.libsdl.org/SDL_UpdateTexture
+ */
+int
+render_testRenderThread(void *arg)
+{
+   int ret;
+   int i, j;
+   int checkFailCount1, checkFailCount2;
+   SDL_Window *threadedWindow;
+   SDL_Renderer *threaded;
+   SDL_Thread *pusher;
+   SDL_Texture *texture;
+   SDL_Rect rect;
+   const SDL_Rect probe[2] = { { 0, 0, 1, 1 }, { 12, 12, 1, 1 } };
+   Uint32 texels[16 * 16];
+   Uint32 pixels[2];
+
+   SDL_SetHint(SDL_HINT_RENDER_THREAD, "1");
+   threadedWindow = SDL_CreateWindow("render_testRenderThread", 100, 100, TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H, 0);
+   SDLTest_AssertCheck(threadedWindow != NULL, "Check SDL_CreateWindow result");
+   if (threadedWindow == NULL) {
+       SDL_SetHint(SDL_HINT_RENDER_THREAD, "0");
+       return TEST_ABORTED;
+   }
+   threaded = SDL_CreateRenderer(threadedWindow, -1, SDL_RENDERER_SOFTWARE);
+   SDL_SetHint(SDL_HINT_RENDER_THREAD, "0");
+   SDLTest_AssertCheck(threaded != NULL, "Check SDL_CreateRenderer result");
+   if (threaded == NULL) {
+       SDL_DestroyWindow(threadedWindow);
+       return TEST_ABORTED;
+   }
+
+   texture = SDL_CreateTexture(threaded, RENDER_COMPARE_FORMAT, SDL_TEXTUREACCESS_STREAMING, 16, 16);
+   SDLTest_AssertCheck(texture != NULL, "Check SDL_CreateTexture result");
+   if (texture == NULL) {
+       SDL_DestroyRenderer(threaded);
+       SDL_DestroyWindow(threadedWindow);
+       return TEST_ABORTED;
+   }
+
+   /* Each frame updates the texture the previous frame is still drawing. */
+   checkFailCount1 = 0;
+   checkFailCount2 = 0;
+   rect.x = 8;
+   rect.y = 8;
+   rect.w = 16;
+   rect.h = 16;
+   for (i = 0; i < 16; i++) {
+      const Uint8 shade = (Uint8)(i * 16);
+
+      for (j = 0; j < SDL_arraysize(texels); j++) {
+         texels[j] = 0xFF000000 | shade;
+      }
+      ret = SDL_UpdateTexture(texture, NULL, texels, 16 * sizeof(Uint32));
+      ret |= SDL_SetRenderDrawColor(threaded, shade, 0, 0, SDL_ALPHA_OPAQUE);
+      ret |= SDL_RenderClear(threaded);
+      ret |= SDL_RenderCopy(threaded, texture, NULL, &rect);
+      if (ret != 0) checkFailCount1++;
+      SDL_RenderPresent(threaded);
+
+      /* Reading waits for the frame on the render thread. */
+      ret = SDL_RenderReadPixels(threaded, &probe[0], RENDER_COMPARE_FORMAT, &pixels[0], sizeof(Uint32));
+      ret |= SDL_RenderReadPixels(threaded, &probe[1], RENDER_COMPARE_FORMAT, &pixels[1], sizeof(Uint32));
+      if (ret != 0 || pixels[0] != (0xFF000000 | (shade << 16)) || pixels[1] != (0xFF000000 | shade)) {
+         checkFailCount2++;
+      }
+   }
+   SDLTest_AssertCheck(checkFailCount1 == 0, "Validate results from drawing, expected: 0, got: %i", checkFailCount1);
+   SDLTest_AssertCheck(checkFailCount2 == 0, "Validate pixels of each frame, expected: 0 failures, got: %i", checkFailCount2);
+
+   /* Window events can wait for the render thread from another thread. */
+   checkFailCount1 = 0;
+   pusher = SDL_CreateThread(_pushWindowEventsThread, "PushWindowEvents", threadedWindow);
+   SDLTest_AssertCheck(pusher != NULL, "Check SDL_CreateThread result");
+   for (i = 0; i < 200; i++) {
+      ret = SDL_RenderClear(threaded);
+      ret |= SDL_RenderCopy(threaded, texture, NULL, &rect);
+      if (ret != 0) checkFailCount1++;
+      SDL_RenderPresent(threaded);
+   }
+   SDL_WaitThread(pusher, NULL);
+   SDL_FlushEvent(SDL_WINDOWEVENT);
+   SDLTest_AssertCheck(checkFailCount1 == 0, "Validate results from drawing, expected: 0, got: %i", checkFailCount1);
+
+   /* Clean up. */
+   SDL_DestroyTexture(texture);
+   SDL_DestroyRenderer(threaded);
+   SDL_DestroyWindow(threadedWindow);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests the renderer counters.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_RenderGetStats
+ * http://wiki.libsdl.org/SDL_RenderResetStats
+ */
+int
+render_testStats(void *arg)
+{
+   int ret;
+   SDL_Rect rect;
+   SDL_Texture *tface;
+   SDL_RenderStats total, frame;
+   Uint32 *pixels;
+   int tw, th;
+
+   tface = _loadTestFace();
+   SDLTest_AssertCheck(tface != NULL, "Verify _loadTestFace() result");
+   if (tface == NULL) {
+       return TEST_ABORTED;
+   }
+   ret = SDL_QueryTexture(tface, NULL, NULL, &tw, &th);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_QueryTexture, expected 0, got %i", ret);
+   pixels = (Uint32 *)SDL_calloc(tw * th, sizeof(Uint32));
+   SDLTest_AssertCheck(pixels != NULL, "Validate allocated temp pixel buffer");
+   if (pixels == NULL) {
+       SDL_DestroyTexture(tface);
+       return TEST_ABORTED;
+   }
+
+   /* Start from a clean frame. */
+   SDL_RenderPresent(renderer);
+   SDL_RenderResetStats(renderer);
+   ret = SDL_RenderGetStats(renderer, &total, &frame);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(total.frames == 0 && total.flushes == 0 && frame.frames == 0,
+                       "Verify SDL_RenderResetStats() cleared the counters");
+
+   /* Updating the texture after drawing with it forces a flush. */
+   ret = SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   ret |= SDL_RenderClear(renderer);
+   rect.x = 0;
+   rect.y = 0;
+   rect.w = tw;
+   rect.h = th;
+   ret |= SDL_RenderCopy(renderer, tface, NULL, &rect);
+   ret |= SDL_UpdateTexture(tface, NULL, pixels, tw * sizeof(Uint32));
+   ret |= SDL_RenderCopy(renderer, tface, NULL, &rect);
+   SDLTest_AssertCheck(ret == 0, "Validate results from drawing, expected: 0, got: %i", ret);
+   SDL_RenderPresent(renderer);
+
+   ret = SDL_RenderGetStats(renderer, &total, &frame);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(frame.frames == 1, "Verify frame count, expected: 1, got: %u", frame.frames);
+   SDLTest_AssertCheck(frame.forced_flushes == 1, "Verify forced flushes, expected: 1, got: %u", frame.forced_flushes);
+   SDLTest_AssertCheck(frame.flushes == 2, "Verify flushes, expected: 2, got: %u", frame.flushes);
+   SDLTest_AssertCheck(frame.clear_commands == 1, "Verify clears, expected: 1, got: %u", frame.clear_commands);
+   SDLTest_AssertCheck(frame.draw_calls >= 2, "Verify draw calls, expected: >= 2, got: %u", frame.draw_calls);
+   SDLTest_AssertCheck(frame.vertices > 0 && frame.vertex_bytes > 0, "Verify vertices were counted");
+   SDLTest_AssertCheck(frame.texture_uploads == 1, "Verify texture uploads, expected: 1, got: %u", frame.texture_uploads);
+   SDLTest_AssertCheck(frame.texture_upload_bytes > 0, "Verify texture upload bytes were counted");
+
+   /* The totals keep adding up. */
+   SDL_RenderPresent(renderer);
+   ret = SDL_RenderGetStats(renderer, &total, &frame);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(total.frames == 2, "Verify total frame count, expected: 2, got: %u", total.frames);
+   SDLTest_AssertCheck(total.texture_uploads == 1, "Verify total texture uploads, expected: 1, got: %u", total.texture_uploads);
+   SDLTest_AssertCheck(frame.flushes == 0, "Verify flushes of an empty frame, expected: 0, got: %u", frame.flushes);
+
+   /* Clean up. */
+   SDL_free(pixels);
+   SDL_DestroyTexture(tface);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that sorting draws by state keeps the output the same.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_CreateRenderer
+ * http://wiki.libsdl.org/SDL_RenderGetStats
+ */
+int
+render_testSortDraws(void *arg)
+{
+   int ret;
+   int i;
+   int checkFailCount1;
+   SDL_Surface *face;
+   SDL_Window *windows[2] = { NULL, NULL };
+   SDL_Renderer *renderers[2] = { NULL, NULL };
+   Uint32 *pixels[2] = { NULL, NULL };
+   SDL_RenderStats stats[2];
+   const int w = 180, h = 140;
+   int result = TEST_ABORTED;
+
+   face = SDLTest_ImageFace();
+   SDLTest_AssertCheck(face != NULL, "Verify SDLTest_ImageFace() result");
+   if (face == NULL) {
+       return TEST_ABORTED;
+   }
+
+   /* Draw the same scene in order and sorted, both batched. */
+   for (i = 0; i < 2; i++) {
+      SDL_Texture *tface, *tblit;
+
+      windows[i] = SDL_CreateWindow("render_testSortDraws", 100, 100, w, h, 0);
+      SDLTest_AssertCheck(windows[i] != NULL, "Check SDL_CreateWindow result");
+      if (windows[i] == NULL) {
+          goto done;
+      }
+      SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+      SDL_SetHint(SDL_HINT_RENDER_SORT_DRAWS, i ? "1" : "0");
+      renderers[i] = SDL_CreateRenderer(windows[i], -1, SDL_RENDERER_SOFTWARE);
+      SDL_SetHint(SDL_HINT_RENDER_BATCHING, NULL);
+      SDL_SetHint(SDL_HINT_RENDER_SORT_DRAWS, "0");
+      SDLTest_AssertCheck(renderers[i] != NULL, "Check SDL_CreateRenderer result");
+      if (renderers[i] == NULL) {
+          goto done;
+      }
+
+      tface = SDL_CreateTextureFromSurface(renderers[i], face);
+      tblit = SDL_CreateTextureFromSurface(renderers[i], face);
+      SDLTest_AssertCheck(tface != NULL && tblit != NULL, "Check SDL_CreateTextureFromSurface results");
+      if (tface == NULL || tblit == NULL) {
+          goto done;
+      }
+      ret = SDL_SetTextureBlendMode(tface, SDL_BLENDMODE_BLEND);
+      ret |= SDL_SetTextureBlendMode(tblit, SDL_BLENDMODE_ADD);
+      ret |= SDL_SetTextureColorMod(tblit, 128, 255, 64);
+      SDLTest_AssertCheck(ret == 0, "Validate results from setting texture state, expected: 0, got: %i", ret);
+
+      SDL_RenderResetStats(renderers[i]);
+      if (_drawSortScene(renderers[i], tface, tblit) != 0) {
+          goto done;
+      }
+      SDL_RenderGetStats(renderers[i], &stats[i], NULL);
+
+      pixels[i] = (Uint32 *)SDL_malloc(w * h * sizeof(Uint32));
+      SDLTest_AssertCheck(pixels[i] != NULL, "Validate allocated temp pixel buffer");
+      if (pixels[i] == NULL) {
+          goto done;
+      }
+      ret = SDL_RenderReadPixels(renderers[i], NULL, RENDER_COMPARE_FORMAT, pixels[i], w * sizeof(Uint32));
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+   }
+
+   /* The unsorted software renderer is the reference, the pixels must match exactly. */
+   checkFailCount1 = 0;
+   for (i = 0; i < w * h; i++) {
+      if (pixels[0][i] != pixels[1][i]) {
+         checkFailCount1++;
+      }
+   }
+   SDLTest_AssertCheck(checkFailCount1 == 0, "Validate sorted pixels, expected: 0 different, got: %i", checkFailCount1);
+
+   SDLTest_AssertCheck(stats[1].copy_commands < stats[0].copy_commands,
+                       "Verify copies were merged, expected: < %u, got: %u", stats[0].copy_commands, stats[1].copy_commands);
+   SDLTest_AssertCheck(stats[1].geometry_commands < stats[0].geometry_commands,
+                       "Verify geometry was merged, expected: < %u, got: %u", stats[0].geometry_commands, stats[1].geometry_commands);
+   result = TEST_COMPLETED;
+
+done:
+   /* Clean up, destroying the renderers destroys their textures. */
+   for (i = 0; i < 2; i++) {
+      SDL_free(pixels[i]);
+      if (renderers[i]) {
+          SDL_DestroyRenderer(renderers[i]);
+      }
+      if (windows[i]) {
+          SDL_DestroyWindow(windows[i]);
+      }
+   }
+   SDL_FreeSurface(face);
+
+   return result;
+}
+
+/**
+ * @brief Tests that the software span rasterizer matches the generic one.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_CreateSoftwareRenderer
+ * http://wiki.libsdl.org/SDL_RenderGeometry
+ */
+int
+render_testGeometrySpans(void *arg)
+{
+   int ret;
+   int i, j;
+   int checkFailCount1;
+   SDL_Surface *face;
+   SDL_Surface *targets[2] = { NULL, NULL };
+   SDL_Surface *converted = NULL;
+   SDL_Renderer *renderers[2] = { NULL, NULL };
+   /* ARGB8888 targets take the span path, RGB24 ones the generic path */
+   const Uint32 formats[2] = { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB24 };
+   const int w = 160, h = 120;
+   int result = TEST_ABORTED;
+
+   face = SDLTest_ImageFace();
+   SDLTest_AssertCheck(face != NULL, "Verify SDLTest_ImageFace() result");
+   if (face == NULL) {
+       return TEST_ABORTED;
+   }
+
+   for (i = 0; i < 2; i++) {
+      SDL_Texture *tface;
+      SDL_Vertex verts[6];
+
+      targets[i] = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, formats[i]);
+      SDLTest_AssertCheck(targets[i] != NULL, "Check SDL_CreateRGBSurfaceWithFormat result");
+      if (targets[i] == NULL) {
+          goto done;
+      }
+      renderers[i] = SDL_CreateSoftwareRenderer(targets[i]);
+      SDLTest_AssertCheck(renderers[i] != NULL, "Check SDL_CreateSoftwareRenderer result");
+      if (renderers[i] == NULL) {
+          goto done;
+      }
+      tface = SDL_CreateTextureFromSurface(renderers[i], face);
+      SDLTest_AssertCheck(tface != NULL, "Check SDL_CreateTextureFromSurface result");
+      if (tface == NULL) {
+          goto done;
+      }
+
+      ret = SDL_SetRenderDrawColor(renderers[i], 40, 80, 120, SDL_ALPHA_OPAQUE);
+      ret |= SDL_RenderClear(renderers[i]);
+
+      /* A skewed quad with a color per corner, once opaque and once blended */
+      for (j = 0; j < 6; j++) {
+         static const float pos[6][2] = { { 10, 5 }, { 150, 20 }, { 130, 110 }, { 10, 5 }, { 130, 110 }, { 3, 90 } };
+         static const float tex[6][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 0, 1 } };
+         verts[j].position.x = pos[j][0];
+         verts[j].position.y = pos[j][1];
+         verts[j].tex_coord.x = tex[j][0];
+         verts[j].tex_coord.y = tex[j][1];
+         verts[j].color.r = (Uint8)(255 - j * 30);
+         verts[j].color.g = (Uint8)(j * 40);
+         verts[j].color.b = (Uint8)(128 + j * 20);
+         verts[j].color.a = (Uint8)(255 - j * 25);
+      }
+      ret |= SDL_SetTextureBlendMode(tface, SDL_BLENDMODE_NONE);
+      ret |= SDL_RenderGeometry(renderers[i], tface, verts, 6, NULL, 0);
+      for (j = 0; j < 6; j++) {
+         verts[j].position.x = 160 - verts[j].position.x;
+      }
+      ret |= SDL_SetTextureBlendMode(tface, SDL_BLENDMODE_BLEND);
+      ret |= SDL_RenderGeometry(renderers[i], tface, verts, 6, NULL, 0);
+
+      /* The same quad without a texture, blended and added */
+      for (j = 0; j < 6; j++) {
+         verts[j].position.y = 120 - verts[j].position.y;
+      }
+      ret |= SDL_SetRenderDrawBlendMode(renderers[i], SDL_BLENDMODE_BLEND);
+      ret |= SDL_RenderGeometry(renderers[i], NULL, verts, 6, NULL, 0);
+      for (j = 0; j < 6; j++) {
+         verts[j].position.x = 160 - verts[j].position.x;
+      }
+      ret |= SDL_SetRenderDrawBlendMode(renderers[i], SDL_BLENDMODE_ADD);
+      ret |= SDL_RenderGeometry(renderers[i], NULL, verts, 6, NULL, 0);
+      SDLTest_AssertCheck(ret == 0, "Validate results from drawing, expected: 0, got: %i", ret);
+      SDL_RenderPresent(renderers[i]);
+   }
+
+   /* Compare the colors, the RGB24 target has no alpha and blends round differently. */
+   converted = SDL_ConvertSurfaceFormat(targets[1], SDL_PIXELFORMAT_ARGB8888, 0);
+   SDLTest_AssertCheck(converted != NULL, "Check SDL_ConvertSurfaceFormat result");
+   if (converted == NULL) {
+       goto done;
+   }
+   checkFailCount1 = 0;
+   for (j = 0; j < h; j++) {
+      const Uint32 *a = (const Uint32 *)((const Uint8 *)targets[0]->pixels + j * targets[0]->pitch);
+      const Uint32 *b = (const Uint32 *)((const Uint8 *)converted->pixels + j * converted->pitch);
+      for (i = 0; i < w; i++) {
+         int shift;
+         for (shift = 0; shift < 24; shift += 8) {
+            if (SDL_abs((int)((a[i] >> shift) & 0xFF) - (int)((b[i] >> shift) & 0xFF)) > 2) {
+               checkFailCount1++;
+               break;
+            }
+         }
+      }
+   }
+   SDLTest_AssertCheck(checkFailCount1 == 0, "Validate span pixels, expected: 0 different, got: %i", checkFailCount1);
+   result = TEST_COMPLETED;
+
+done:
+   /* Clean up, destroying the renderers destroys their textures. */
+   for (i = 0; i < 2; i++) {
+      if (renderers[i]) {
+          SDL_DestroyRenderer(renderers[i]);
+      }
+      SDL_FreeSurface(targets[i]);
+   }
+   SDL_FreeSurface(converted);
+   SDL_FreeSurface(face);
+
+   return result;
+}
+
+/**
+ * @brief Tests reading pixels without waiting for them.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_RenderReadPixelsAsync
+ * http://wiki.libsdl.org/SDL_RenderGetReadbackPixels
+ * http://wiki.libsdl.org/SDL_DestroyRenderReadback
+ */
+int
+render_testReadPixelsAsync(void *arg)
+{
+   int ret;
+   int i;
+   SDL_Rect rect, part;
+   SDL_Texture *tface;
+   SDL_Surface *referenceSurface;
+   SDL_RenderReadback *readbacks[2];
+   Uint32 *pixels;
+   Uint8 *partPixels, *partReference;
+   const int partPitch = 50 * 3;
+
+   tface = _loadTestFace();
+   SDLTest_AssertCheck(tface != NULL, "Verify _loadTestFace() result");
+   if (tface == NULL) {
+       return TEST_ABORTED;
+   }
+   referenceSurface = SDL_CreateRGBSurfaceWithFormat(0, TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H, 32, RENDER_COMPARE_FORMAT);
+   pixels = (Uint32 *)SDL_malloc(TESTRENDER_SCREEN_W * TESTRENDER_SCREEN_H * sizeof(Uint32));
+   partPixels = (Uint8 *)SDL_malloc(40 * partPitch);
+   partReference = (Uint8 *)SDL_malloc(40 * partPitch);
+   SDLTest_AssertCheck(referenceSurface && pixels && partPixels && partReference, "Validate allocated buffers");
+   if (!referenceSurface || !pixels || !partPixels || !partReference) {
+       ret = TEST_ABORTED;
+       goto done;
+   }
+
+   /* Draw something and read it the usual way. */
+   _clearScreen();
+   rect.x = 0;
+   rect.y = 0;
+   SDL_QueryTexture(tface, NULL, NULL, &rect.w, &rect.h);
+   SDL_RenderCopy(renderer, tface, NULL, &rect);
+   rect.w = TESTRENDER_SCREEN_W;
+   rect.h = TESTRENDER_SCREEN_H;
+   ret = SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, referenceSurface->pixels, referenceSurface->pitch);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+
+   /* Read it again without waiting, whole and partly outside the target, in another format. */
+   readbacks[0] = SDL_RenderReadPixelsAsync(renderer, &rect, RENDER_COMPARE_FORMAT);
+   part.x = -10;
+   part.y = -10;
+   part.w = 50;
+   part.h = 40;
+   readbacks[1] = SDL_RenderReadPixelsAsync(renderer, &part, SDL_PIXELFORMAT_RGB24);
+   SDLTest_AssertCheck(readbacks[0] != NULL && readbacks[1] != NULL, "Verify SDL_RenderReadPixelsAsync() results");
+   if (readbacks[0] == NULL || readbacks[1] == NULL) {
+       SDL_DestroyRenderReadback(readbacks[0]);
+       SDL_DestroyRenderReadback(readbacks[1]);
+       ret = TEST_ABORTED;
+       goto done;
+   }
+
+   /* Drawing after the reads started doesn't change what they see. */
+   SDL_SetRenderDrawColor(renderer, 0, 255, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(renderer);
+   SDL_RenderFlush(renderer);
+
+   for (i = 0; i < 1000; i++) {
+      ret = SDL_RenderGetReadbackPixels(readbacks[0], pixels, TESTRENDER_SCREEN_W * sizeof(Uint32));
+      if (ret != 1) {
+         break;
+      }
+      SDL_Delay(1);
+   }
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetReadbackPixels, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(SDL_memcmp(pixels, referenceSurface->pixels, TESTRENDER_SCREEN_W * TESTRENDER_SCREEN_H * sizeof(Uint32)) == 0,
+                       "Validate pixels read without waiting match SDL_RenderReadPixels()");
+
+   /* Only the part inside the target is written. */
+   SDL_memset(partPixels, 0xAB, 40 * partPitch);
+   SDL_memset(partReference, 0xAB, 40 * partPitch);
+   SDL_ConvertPixels(40, 30, RENDER_COMPARE_FORMAT, referenceSurface->pixels, referenceSurface->pitch,
+                     SDL_PIXELFORMAT_RGB24, partReference + 10 * partPitch + 10 * 3, partPitch);
+   for (i = 0; i < 1000; i++) {
+      ret = SDL_RenderGetReadbackPixels(readbacks[1], partPixels, partPitch);
+      if (ret != 1) {
+         break;
+      }
+      SDL_Delay(1);
+   }
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetReadbackPixels, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(SDL_memcmp(partPixels, partReference, 40 * partPitch) == 0,
+                       "Validate clipped and converted pixels");
+
+   SDL_DestroyRenderReadback(readbacks[0]);
+   SDL_DestroyRenderReadback(readbacks[1]);
+
+   /* Reads can be dropped before they are done. */
+   for (i = 0; i < 8; i++) {
+      readbacks[0] = SDL_RenderReadPixelsAsync(renderer, &rect, SDL_PIXELFORMAT_RGB24);
+      readbacks[1] = SDL_RenderReadPixelsAsync(renderer, &rect, SDL_PIXELFORMAT_RGB24);
+      SDLTest_AssertCheck(readbacks[0] != NULL && readbacks[1] != NULL, "Verify SDL_RenderReadPixelsAsync() results");
+      SDL_DestroyRenderReadback(readbacks[1]);
+      SDL_DestroyRenderReadback(readbacks[0]);
+   }
+   ret = TEST_COMPLETED;
+
+done:
+   /* Clean up. */
+   SDL_free(partReference);
+   SDL_free(partPixels);
+   SDL_free(pixels);
+   SDL_FreeSurface(referenceSurface);
+   SDL_DestroyTexture(tface);
+
+   return ret;
+}
+
 /**
  * @brief Blits doing color tests.
  *
@@ -898,6 +1648,118 @@ _loadTestFace(void)
 }
 
 
+/**
+ * @brief Draws a few primitives and a copy with their top left at x, y. Helper function.
+ */
+static int
+_drawCommandListContent(SDL_Texture *tface, int x, int y)
+{
+   int ret = 0;
+   SDL_Rect rect;
+
+   /* The point below falls outside the clip rectangle */
+   rect.x = x;
+   rect.y = y;
+   rect.w = 34;
+   rect.h = 30;
+   ret |= SDL_RenderSetClipRect(renderer, &rect);
+
+   ret |= SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE);
+   rect.x = x + 2;
+   rect.y = y + 2;
+   rect.w = 12;
+   rect.h = 10;
+   ret |= SDL_RenderFillRect(renderer, &rect);
+
+   ret |= SDL_SetRenderDrawColor(renderer, 0, 255, 0, SDL_ALPHA_OPAQUE);
+   ret |= SDL_RenderDrawLine(renderer, x, y + 20, x + 30, y + 20);
+   ret |= SDL_RenderDrawPoint(renderer, x + 35, y + 25);
+
+   rect.x = x + 16;
+   rect.y = y + 2;
+   rect.w = 16;
+   rect.h = 16;
+   ret |= SDL_RenderCopy(renderer, tface, NULL, &rect);
+
+   ret |= SDL_RenderSetClipRect(renderer, NULL);
+
+   SDLTest_AssertCheck(ret == 0, "Validate results from drawing, expected: 0, got: %i", ret);
+   return ret;
+}
+
+/**
+ * @brief Draws interleaved copies and geometry of two textures, some of them overlapping. Helper function.
+ */
+static int
+_drawSortScene(SDL_Renderer *target, SDL_Texture *tface, SDL_Texture *tblit)
+{
+   int ret = 0;
+   int i, j;
+   SDL_Rect rect;
+   SDL_Vertex verts[3];
+
+   ret |= SDL_SetRenderDrawColor(target, 32, 64, 96, SDL_ALPHA_OPAQUE);
+   ret |= SDL_RenderClear(target);
+
+   /* A grid alternating between the textures, none of these overlap. */
+   rect.w = 24;
+   rect.h = 24;
+   for (j = 0; j < 4; j++) {
+      for (i = 0; i < 6; i++) {
+         rect.x = i * 30;
+         rect.y = j * 30;
+         ret |= SDL_RenderCopy(target, ((i + j) & 1) ? tface : tblit, NULL, &rect);
+      }
+   }
+
+   /* A fill in between, drawn over by the copies that follow. */
+   ret |= SDL_SetRenderDrawColor(target, 255, 255, 0, SDL_ALPHA_OPAQUE);
+   rect.x = 40;
+   rect.y = 40;
+   rect.w = 50;
+   rect.h = 30;
+   ret |= SDL_RenderFillRect(target, &rect);
+
+   /* A blended stack where every copy overlaps the previous one. */
+   rect.w = 40;
+   rect.h = 40;
+   for (i = 0; i < 8; i++) {
+      rect.x = 30 + i * 7;
+      rect.y = 20 + i * 5;
+      ret |= SDL_RenderCopy(target, (i & 1) ? tface : tblit, NULL, &rect);
+   }
+
+   /* Triangles side by side, alternating between textured and not. */
+   for (i = 0; i < 6; i++) {
+      const float x = (float)(20 + i * 25);
+      const float y = (float)(90 + (i % 3) * 5);
+
+      verts[0].position.x = x;
+      verts[0].position.y = y;
+      verts[1].position.x = x + 20.0f;
+      verts[1].position.y = y + 5.0f;
+      verts[2].position.x = x + 10.0f;
+      verts[2].position.y = y + 28.0f;
+      for (j = 0; j < 3; j++) {
+         verts[j].color.r = (Uint8)(80 * j);
+         verts[j].color.g = 200;
+         verts[j].color.b = (Uint8)(40 * i);
+         verts[j].color.a = 160;
+      }
+      verts[0].tex_coord.x = 0.0f;
+      verts[0].tex_coord.y = 0.0f;
+      verts[1].tex_coord.x = 1.0f;
+      verts[1].tex_coord.y = 0.0f;
+      verts[2].tex_coord.x = 0.5f;
+      verts[2].tex_coord.y = 1.0f;
+      ret |= SDL_RenderGeometry(target, (i & 1) ? tface : NULL, verts, 3, NULL, 0);
+   }
+
+   ret |= SDL_RenderFlush(target);
+   SDLTest_AssertCheck(ret == 0, "Validate results from drawing, expected: 0, got: %i", ret);
+   return ret;
+}
+
 /**
  * @brief Test to see if can set texture color mode. Helper function.
  *
@@ -1085,9 +1947,30 @@ static const SDLTest_TestCaseReference renderTest6 =
 static const SDLTest_TestCaseReference renderTest7 =
         {  (SDLTest_TestCaseFp)render_testBlitBlend, "render_testBlitBlend", "Tests blitting with blending", TEST_DISABLED };
 
+static const SDLTest_TestCaseReference renderTest8 =
+        { (SDLTest_TestCaseFp)render_testBlitAtlas, "render_testBlitAtlas", "Tests blitting from a texture atlas", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest9 =
+        { (SDLTest_TestCaseFp)render_testCommandList, "render_testCommandList", "Tests recording and replaying a command list", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest10 =
+        { (SDLTest_TestCaseFp)render_testRenderThread, "render_testRenderThread", "Tests drawing frames on a render thread", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest11 =
+        { (SDLTest_TestCaseFp)render_testStats, "render_testStats", "Tests the renderer counters", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest12 =
+        { (SDLTest_TestCaseFp)render_testSortDraws, "render_testSortDraws", "Tests that sorting draws keeps the output the same", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest13 =
+        { (SDLTest_TestCaseFp)render_testGeometrySpans, "render_testGeometrySpans", "Tests the software span rasterizer against the generic one", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest14 =
+        { (SDLTest_TestCaseFp)render_testReadPixelsAsync, "render_testReadPixelsAsync", "Tests reading pixels without waiting for them", TEST_ENABLED };
+
 /* Sequence of Render test cases */
 static const SDLTest_TestCaseReference *renderTests[] =  {
-    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, NULL
+    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, &renderTest8, &renderTest9, &renderTest10, &renderTest11, &renderTest12, &renderTest13, &renderTest14, NULL
 };
 
 /* Render test suite (global) */
@@ -589,6 +589,553 @@ surface_testBlitBlendLoop(void *arg) {
 
 }
 
+/**
+ * @brief Tests alpha premultiplication and its reverse across the 8888 formats
+ *
+ * @sa http://wiki.libsdl.org/SDL_PremultiplyAlpha
+ * @sa http://wiki.libsdl.org/SDL_UnpremultiplyAlpha
+ */
+int
+surface_testPremultiplyAlpha(void *arg)
+{
+    static const Uint32 formats[] = {
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGBA8888,
+        SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_BGRA8888
+    };
+    /* An odd width exercises the scalar tail of the SIMD row functions */
+    const int width = 257;
+    int height = 3;
+    Uint32 *src, *dst, *expected;
+    int i, j, x, ret, mismatches;
+    Uint8 r, g, b, a, er, eg, eb, ea;
+    SDL_PixelFormat *fmt;
+
+    src = (Uint32 *)SDL_malloc(width * height * sizeof(Uint32));
+    dst = (Uint32 *)SDL_malloc(width * height * sizeof(Uint32));
+    expected = (Uint32 *)SDL_malloc(width * height * sizeof(Uint32));
+    SDLTest_AssertCheck(src && dst && expected, "Allocate pixel buffers");
+    if (!src || !dst || !expected) {
+        SDL_free(src);
+        SDL_free(dst);
+        SDL_free(expected);
+        return TEST_ABORTED;
+    }
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        fmt = SDL_AllocFormat(formats[i]);
+        for (x = 0; x < width * height; ++x) {
+            src[x] = SDL_MapRGBA(fmt, (Uint8)SDLTest_RandomUint8(), (Uint8)SDLTest_RandomUint8(), (Uint8)SDLTest_RandomUint8(), (Uint8)x);
+        }
+        for (j = 0; j < SDL_arraysize(formats); ++j) {
+            SDL_PixelFormat *dst_fmt = SDL_AllocFormat(formats[j]);
+
+            ret = SDL_PremultiplyAlpha(width, height, formats[i], src, width * 4, formats[j], dst, width * 4);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_PremultiplyAlpha(%s, %s), expected: 0, got: %i",
+                                SDL_GetPixelFormatName(formats[i]), SDL_GetPixelFormatName(formats[j]), ret);
+            mismatches = 0;
+            for (x = 0; x < width * height; ++x) {
+                SDL_GetRGBA(src[x], fmt, &r, &g, &b, &a);
+                er = (Uint8)((r * a + 127) / 255);
+                eg = (Uint8)((g * a + 127) / 255);
+                eb = (Uint8)((b * a + 127) / 255);
+                expected[x] = SDL_MapRGBA(dst_fmt, er, eg, eb, a);
+                if (dst[x] != expected[x]) {
+                    ++mismatches;
+                }
+            }
+            SDLTest_AssertCheck(mismatches == 0, "Verify premultiplied pixels, expected: 0 mismatches, got: %i", mismatches);
+
+            ret = SDL_UnpremultiplyAlpha(width, height, formats[j], expected, width * 4, formats[i], dst, width * 4);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_UnpremultiplyAlpha(%s, %s), expected: 0, got: %i",
+                                SDL_GetPixelFormatName(formats[j]), SDL_GetPixelFormatName(formats[i]), ret);
+            mismatches = 0;
+            for (x = 0; x < width * height; ++x) {
+                SDL_GetRGBA(expected[x], dst_fmt, &r, &g, &b, &a);
+                if (a) {
+                    er = (Uint8)SDL_min((r * 255 + a / 2) / a, 255);
+                    eg = (Uint8)SDL_min((g * 255 + a / 2) / a, 255);
+                    eb = (Uint8)SDL_min((b * 255 + a / 2) / a, 255);
+                } else {
+                    er = eg = eb = 0;
+                }
+                SDL_GetRGBA(dst[x], fmt, &r, &g, &b, &ea);
+                if (r != er || g != eg || b != eb || a != ea) {
+                    ++mismatches;
+                }
+            }
+            SDLTest_AssertCheck(mismatches == 0, "Verify unpremultiplied pixels, expected: 0 mismatches, got: %i", mismatches);
+
+            SDL_FreeFormat(dst_fmt);
+        }
+
+        /* In-place conversion */
+        SDL_memcpy(dst, src, width * height * sizeof(Uint32));
+        ret = SDL_PremultiplyAlpha(width, height, formats[i], dst, width * 4, formats[i], dst, width * 4);
+        SDLTest_AssertCheck(ret == 0, "Verify result from in-place SDL_PremultiplyAlpha(), expected: 0, got: %i", ret);
+        ret = SDL_PremultiplyAlpha(width, height, formats[i], src, width * 4, formats[i], expected, width * 4);
+        SDLTest_AssertCheck(SDL_memcmp(dst, expected, width * height * sizeof(Uint32)) == 0, "Verify in-place premultiplication matches");
+
+        SDL_FreeFormat(fmt);
+    }
+
+    /* Formats without an alpha channel go through a conversion */
+    ret = SDL_PremultiplyAlpha(width, height, SDL_PIXELFORMAT_ARGB8888, src, width * 4, SDL_PIXELFORMAT_RGB565, dst, width * 2);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_PremultiplyAlpha(ARGB8888, RGB565), expected: 0, got: %i", ret);
+    ret = SDL_UnpremultiplyAlpha(width, height, SDL_PIXELFORMAT_RGB565, dst, width * 2, SDL_PIXELFORMAT_ABGR8888, expected, width * 4);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_UnpremultiplyAlpha(RGB565, ABGR8888), expected: 0, got: %i", ret);
+
+    SDL_free(src);
+    SDL_free(dst);
+    SDL_free(expected);
+
+    /* Conversions are done in bands of rows, use enough rows for several of them */
+    height = 300;
+    src = (Uint32 *)SDL_malloc(width * height * sizeof(Uint32));
+    dst = (Uint32 *)SDL_malloc(width * height * sizeof(Uint32));
+    expected = (Uint32 *)SDL_malloc(width * height * sizeof(Uint32));
+    SDLTest_AssertCheck(src && dst && expected, "Allocate pixel buffers");
+    if (src && dst && expected) {
+        /* The ARGB4444 pixels use the first half of each buffer */
+        Uint16 *packed = (Uint16 *)dst;
+        Uint16 *packed_expected = (Uint16 *)expected;
+
+        for (x = 0; x < width * height; ++x) {
+            src[x] = SDLTest_RandomUint32();
+        }
+        ret = SDL_PremultiplyAlpha(width, height, SDL_PIXELFORMAT_ARGB8888, src, width * 4, SDL_PIXELFORMAT_ARGB4444, packed, width * 2);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_PremultiplyAlpha(ARGB8888, ARGB4444), expected: 0, got: %i", ret);
+        ret = SDL_PremultiplyAlpha(width, height, SDL_PIXELFORMAT_ARGB8888, src, width * 4, SDL_PIXELFORMAT_ARGB8888, src, width * 4);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_PremultiplyAlpha(ARGB8888, ARGB8888), expected: 0, got: %i", ret);
+        ret = SDL_ConvertPixels(width, height, SDL_PIXELFORMAT_ARGB8888, src, width * 4, SDL_PIXELFORMAT_ARGB4444, packed_expected, width * 2);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_ConvertPixels(ARGB8888, ARGB4444), expected: 0, got: %i", ret);
+        SDLTest_AssertCheck(SDL_memcmp(packed, packed_expected, width * height * sizeof(Uint16)) == 0, "Verify premultiplying into ARGB4444 matches a separate conversion");
+
+        /* Premultiplying ARGB4444 in place goes through ARGB8888 both ways */
+        ret = SDL_ConvertPixels(width, height, SDL_PIXELFORMAT_ARGB4444, packed, width * 2, SDL_PIXELFORMAT_ARGB8888, src, width * 4);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_ConvertPixels(ARGB4444, ARGB8888), expected: 0, got: %i", ret);
+        ret = SDL_PremultiplyAlpha(width, height, SDL_PIXELFORMAT_ARGB8888, src, width * 4, SDL_PIXELFORMAT_ARGB4444, packed_expected, width * 2);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_PremultiplyAlpha(ARGB8888, ARGB4444), expected: 0, got: %i", ret);
+        ret = SDL_PremultiplyAlpha(width, height, SDL_PIXELFORMAT_ARGB4444, packed, width * 2, SDL_PIXELFORMAT_ARGB4444, packed, width * 2);
+        SDLTest_AssertCheck(ret == 0, "Verify result from in-place SDL_PremultiplyAlpha(ARGB4444), expected: 0, got: %i", ret);
+        SDLTest_AssertCheck(SDL_memcmp(packed, packed_expected, width * height * sizeof(Uint16)) == 0, "Verify premultiplying ARGB4444 in place matches");
+    }
+
+    SDL_free(src);
+    SDL_free(dst);
+    SDL_free(expected);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests per-pixel alpha blending from 8888 surfaces into 8888 and 565 surfaces
+ *
+ * @sa http://wiki.libsdl.org/SDL_SetSurfaceAlphaMod
+ * @sa http://wiki.libsdl.org/SDL_BlitSurface
+ */
+int
+surface_testBlitPixelAlpha(void *arg)
+{
+    static const Uint32 src_formats[] = {
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGBA8888
+    };
+    static const Uint32 dst_formats[] = {
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_BGRA8888,
+        SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_RGB565
+    };
+    static const Uint8 alpha_mods[] = { 255, 200 };
+    /* An odd width exercises the scalar tail of the SIMD blitters */
+    const int width = 37, height = 3;
+    SDL_Surface *src, *dst, *orig;
+    int i, j, k, x, y, ret, mismatches, tolerance;
+    Uint8 sr, sg, sb, sa, dr, dg, db, da, r, g, b, a;
+
+    for (i = 0; i < SDL_arraysize(src_formats); ++i) {
+        src = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, src_formats[i]);
+        SDLTest_AssertCheck(src != NULL, "Verify source surface is not NULL");
+        if (src == NULL) {
+            return TEST_ABORTED;
+        }
+        for (y = 0; y < height; ++y) {
+            Uint32 *row = (Uint32 *)((Uint8 *)src->pixels + y * src->pitch);
+            for (x = 0; x < width; ++x) {
+                /* Include fully transparent and fully opaque pixels */
+                sa = (x % 5 == 0) ? 0 : (x % 5 == 1) ? 255 : (Uint8)SDLTest_RandomUint8();
+                row[x] = SDL_MapRGBA(src->format, (Uint8)SDLTest_RandomUint8(), (Uint8)SDLTest_RandomUint8(), (Uint8)SDLTest_RandomUint8(), sa);
+            }
+        }
+        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_BLEND);
+
+        for (j = 0; j < SDL_arraysize(dst_formats); ++j) {
+            orig = SDL_CreateRGBSurfaceWithFormat(0, width, height, 0, dst_formats[j]);
+            SDLTest_AssertCheck(orig != NULL, "Verify destination surface is not NULL");
+            if (orig == NULL) {
+                SDL_FreeSurface(src);
+                return TEST_ABORTED;
+            }
+            for (y = 0; y < height; ++y) {
+                for (x = 0; x < orig->pitch; ++x) {
+                    ((Uint8 *)orig->pixels)[y * orig->pitch + x] = (Uint8)SDLTest_RandomUint8();
+                }
+            }
+
+            for (k = 0; k < SDL_arraysize(alpha_mods); ++k) {
+                dst = SDL_ConvertSurface(orig, orig->format, 0);
+                SDL_SetSurfaceAlphaMod(src, alpha_mods[k]);
+                ret = SDL_BlitSurface(src, NULL, dst, NULL);
+                SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface(%s, %s), expected: 0, got: %i",
+                                    SDL_GetPixelFormatName(src_formats[i]), SDL_GetPixelFormatName(dst_formats[j]), ret);
+
+                /* Modulated blits are exact everywhere, plain blends may use an approximation of / 255 */
+                tolerance = (alpha_mods[k] == 255) ? (orig->format->BytesPerPixel == 2 ? 8 : 2) : 0;
+                mismatches = 0;
+                for (y = 0; y < height; ++y) {
+                    for (x = 0; x < width; ++x) {
+                        const Uint8 *sp = (Uint8 *)src->pixels + y * src->pitch + x * 4;
+                        const Uint8 *op = (Uint8 *)orig->pixels + y * orig->pitch + x * orig->format->BytesPerPixel;
+                        const Uint8 *dp = (Uint8 *)dst->pixels + y * dst->pitch + x * dst->format->BytesPerPixel;
+                        Uint32 spixel = *(const Uint32 *)sp;
+                        Uint32 opixel = (orig->format->BytesPerPixel == 2) ? *(const Uint16 *)op : *(const Uint32 *)op;
+                        Uint32 dpixel = (dst->format->BytesPerPixel == 2) ? *(const Uint16 *)dp : *(const Uint32 *)dp;
+
+                        SDL_GetRGBA(spixel, src->format, &sr, &sg, &sb, &sa);
+                        SDL_GetRGBA(opixel, orig->format, &dr, &dg, &db, &da);
+                        SDL_GetRGBA(dpixel, dst->format, &r, &g, &b, &a);
+                        sa = (Uint8)(sa * alpha_mods[k] / 255);
+                        dr = (Uint8)(sr * sa / 255 + dr * (255 - sa) / 255);
+                        dg = (Uint8)(sg * sa / 255 + dg * (255 - sa) / 255);
+                        db = (Uint8)(sb * sa / 255 + db * (255 - sa) / 255);
+                        da = (Uint8)(sa + da * (255 - sa) / 255);
+                        if (orig->format->BytesPerPixel == 2) {
+                            /* Compare at the precision of the destination */
+                            SDL_GetRGB(SDL_MapRGB(dst->format, dr, dg, db), dst->format, &dr, &dg, &db);
+                        }
+                        if (!orig->format->Amask) {
+                            da = a;
+                        }
+                        if (SDL_abs(r - dr) > tolerance || SDL_abs(g - dg) > tolerance ||
+                            SDL_abs(b - db) > tolerance || SDL_abs(a - da) > tolerance) {
+                            ++mismatches;
+                        }
+                    }
+                }
+                SDLTest_AssertCheck(mismatches == 0, "Verify blended pixels with alpha mod %d, expected: 0 mismatches, got: %i",
+                                    alpha_mods[k], mismatches);
+                SDL_FreeSurface(dst);
+            }
+            SDL_FreeSurface(orig);
+        }
+        SDL_FreeSurface(src);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests SDL_ConvertPixels between the common RGB and RGBA formats
+ *
+ * @sa http://wiki.libsdl.org/SDL_ConvertPixels
+ */
+int
+surface_testConvertPixelsChannels(void *arg)
+{
+    static const Uint32 formats[] = {
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGBA8888,
+        SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_BGRX8888,
+        SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_BGR24, SDL_PIXELFORMAT_RGB565,
+        SDL_PIXELFORMAT_BGR565
+    };
+    /* An odd width exercises the scalar tail of the SIMD blitters */
+    const int width = 67, height = 2;
+    Uint8 src[67 * 2 * 4], dst[67 * 2 * 4];
+    int i, j, x, ret, mismatches;
+    Uint8 r, g, b, a, er, eg, eb, ea;
+
+    for (x = 0; x < sizeof(src); ++x) {
+        src[x] = (Uint8)SDLTest_RandomUint8();
+    }
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        SDL_PixelFormat *src_fmt = SDL_AllocFormat(formats[i]);
+        const int src_pitch = width * src_fmt->BytesPerPixel;
+
+        for (j = 0; j < SDL_arraysize(formats); ++j) {
+            SDL_PixelFormat *dst_fmt = SDL_AllocFormat(formats[j]);
+            const int dst_pitch = width * dst_fmt->BytesPerPixel;
+
+            ret = SDL_ConvertPixels(width, height, formats[i], src, src_pitch, formats[j], dst, dst_pitch);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_ConvertPixels(%s, %s), expected: 0, got: %i",
+                                SDL_GetPixelFormatName(formats[i]), SDL_GetPixelFormatName(formats[j]), ret);
+            mismatches = 0;
+            for (x = 0; x < width * height; ++x) {
+                Uint32 spixel = 0, dpixel = 0;
+
+                SDL_memcpy(&spixel, src + x * src_fmt->BytesPerPixel, src_fmt->BytesPerPixel);
+                SDL_memcpy(&dpixel, dst + x * dst_fmt->BytesPerPixel, dst_fmt->BytesPerPixel);
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+                spixel >>= (4 - src_fmt->BytesPerPixel) * 8;
+                dpixel >>= (4 - dst_fmt->BytesPerPixel) * 8;
+#endif
+                SDL_GetRGBA(spixel, src_fmt, &r, &g, &b, &a);
+                SDL_GetRGBA(SDL_MapRGBA(dst_fmt, r, g, b, a), dst_fmt, &er, &eg, &eb, &ea);
+                SDL_GetRGBA(dpixel, dst_fmt, &r, &g, &b, &a);
+                if (r != er || g != eg || b != eb || a != ea) {
+                    ++mismatches;
+                }
+            }
+            SDLTest_AssertCheck(mismatches == 0, "Verify converted pixels, expected: 0 mismatches, got: %i", mismatches);
+            SDL_FreeFormat(dst_fmt);
+        }
+        SDL_FreeFormat(src_fmt);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests blended rectangles, lines and points drawn by the software renderer
+ *
+ * @sa http://wiki.libsdl.org/SDL_CreateSoftwareRenderer
+ * @sa http://wiki.libsdl.org/SDL_SetRenderDrawBlendMode
+ */
+int
+surface_testBlendPrimitives(void *arg)
+{
+    static const Uint32 formats[] = {
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGB888,
+        SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_BGR565
+    };
+    static const SDL_BlendMode modes[] = {
+        SDL_BLENDMODE_BLEND, SDL_BLENDMODE_ADD, SDL_BLENDMODE_MOD, SDL_BLENDMODE_MUL
+    };
+    /* An odd width exercises the scalar tail of the SIMD span fills */
+    const int width = 67, height = 5;
+    SDL_Surface *surface, *orig;
+    SDL_Renderer *renderer;
+    SDL_Rect rect;
+    SDL_Point points[67];
+    int i, j, x, y, mismatches;
+    Uint32 c[4], d[4], inva;
+    Uint8 r, g, b, a;
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        orig = SDL_CreateRGBSurfaceWithFormat(0, width, height, 0, formats[i]);
+        SDLTest_AssertCheck(orig != NULL, "Verify surface is not NULL");
+        if (orig == NULL) {
+            return TEST_ABORTED;
+        }
+        for (y = 0; y < height; ++y) {
+            for (x = 0; x < orig->pitch; ++x) {
+                ((Uint8 *)orig->pixels)[y * orig->pitch + x] = (Uint8)SDLTest_RandomUint8();
+            }
+        }
+
+        for (j = 0; j < SDL_arraysize(modes); ++j) {
+            surface = SDL_ConvertSurface(orig, orig->format, 0);
+            renderer = SDL_CreateSoftwareRenderer(surface);
+            SDLTest_AssertCheck(renderer != NULL, "Verify software renderer is not NULL");
+            if (renderer == NULL) {
+                SDL_FreeSurface(surface);
+                SDL_FreeSurface(orig);
+                return TEST_ABORTED;
+            }
+            c[0] = SDLTest_RandomUint8();
+            c[1] = SDLTest_RandomUint8();
+            c[2] = SDLTest_RandomUint8();
+            c[3] = SDLTest_RandomIntegerInRange(1, 254);
+            SDL_SetRenderDrawBlendMode(renderer, modes[j]);
+            SDL_SetRenderDrawColor(renderer, (Uint8)c[0], (Uint8)c[1], (Uint8)c[2], (Uint8)c[3]);
+
+            /* Every pixel is drawn once: two rows of rectangle, a line and a row of points */
+            rect.x = 0;
+            rect.y = 0;
+            rect.w = width;
+            rect.h = 2;
+            SDL_RenderFillRect(renderer, &rect);
+            SDL_RenderDrawLine(renderer, 0, 2, width - 1, 2);
+            for (x = 0; x < width; ++x) {
+                points[x].x = x;
+                points[x].y = 3;
+            }
+            SDL_RenderDrawPoints(renderer, points, width);
+            SDL_RenderPresent(renderer);
+
+            if (modes[j] == SDL_BLENDMODE_BLEND || modes[j] == SDL_BLENDMODE_ADD) {
+                c[0] = c[0] * c[3] / 255;
+                c[1] = c[1] * c[3] / 255;
+                c[2] = c[2] * c[3] / 255;
+            }
+            inva = 255 - c[3];
+            mismatches = 0;
+            for (y = 0; y < height; ++y) {
+                for (x = 0; x < width; ++x) {
+                    const Uint8 *op = (Uint8 *)orig->pixels + y * orig->pitch + x * orig->format->BytesPerPixel;
+                    const Uint8 *sp = (Uint8 *)surface->pixels + y * surface->pitch + x * surface->format->BytesPerPixel;
+                    Uint32 opixel = (orig->format->BytesPerPixel == 2) ? *(const Uint16 *)op : *(const Uint32 *)op;
+                    Uint32 spixel = (surface->format->BytesPerPixel == 2) ? *(const Uint16 *)sp : *(const Uint32 *)sp;
+                    Uint32 expected = opixel;
+                    int k;
+
+                    if (y < 4) {
+                        SDL_GetRGBA(opixel, orig->format, &r, &g, &b, &a);
+                        d[0] = r;
+                        d[1] = g;
+                        d[2] = b;
+                        d[3] = a;
+                        for (k = 0; k < 4; ++k) {
+                            switch (modes[j]) {
+                            case SDL_BLENDMODE_BLEND:
+                                d[k] = d[k] * inva / 255 + c[k];
+                                break;
+                            case SDL_BLENDMODE_ADD:
+                                /* Alpha is left alone */
+                                d[k] = (k == 3) ? d[k] : SDL_min(d[k] + c[k], 255);
+                                break;
+                            case SDL_BLENDMODE_MOD:
+                                d[k] = (k == 3) ? d[k] : d[k] * c[k] / 255;
+                                break;
+                            default:
+                                d[k] = SDL_min(d[k] * c[k] / 255 + d[k] * inva / 255, 255);
+                                break;
+                            }
+                        }
+                        expected = SDL_MapRGBA(orig->format, (Uint8)d[0], (Uint8)d[1], (Uint8)d[2], (Uint8)d[3]);
+                    }
+                    if (spixel != expected) {
+                        ++mismatches;
+                    }
+                }
+            }
+            SDLTest_AssertCheck(mismatches == 0, "Verify %s pixels blended with mode %d, expected: 0 mismatches, got: %i",
+                                SDL_GetPixelFormatName(formats[i]), modes[j], mismatches);
+            SDL_DestroyRenderer(renderer);
+            SDL_FreeSurface(surface);
+        }
+        SDL_FreeSurface(orig);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that RLE encoded surfaces keep their pixels and pick up changes made while locked
+ *
+ * @sa http://wiki.libsdl.org/SDL_SetSurfaceRLE
+ * @sa http://wiki.libsdl.org/SDL_LockSurface
+ */
+int
+surface_testRLEUpdate(void *arg)
+{
+    static const Uint32 formats[] = { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_ARGB8888 };
+    const int width = 67, height = 40;
+    SDL_Surface *src, *copy, *dst, *expected;
+    SDL_Rect srcrect, dstrect;
+    Uint32 key;
+    int i, x, y, ret, changed;
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        src = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, formats[i]);
+        dst = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGB888);
+        expected = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGB888);
+        SDLTest_AssertCheck(src != NULL && dst != NULL && expected != NULL, "Verify surfaces are not NULL");
+        if (src == NULL || dst == NULL || expected == NULL) {
+            SDL_FreeSurface(src);
+            SDL_FreeSurface(dst);
+            SDL_FreeSurface(expected);
+            return TEST_ABORTED;
+        }
+
+        /* Sprites on a transparent background, with translucent pixels if there is alpha */
+        key = SDL_MapRGBA(src->format, 255, 0, 255, 0);
+        for (y = 0; y < height; ++y) {
+            Uint32 *row = (Uint32 *)((Uint8 *)src->pixels + y * src->pitch);
+            for (x = 0; x < width; ++x) {
+                const Uint8 a = (x % 3 == 0) ? 255 : (Uint8)SDLTest_RandomIntegerInRange(1, 254);
+                row[x] = ((x / 8 + y / 8) % 2) ? key : SDL_MapRGBA(src->format, (Uint8)x, (Uint8)y, (Uint8)SDLTest_RandomUint8(), a);
+            }
+        }
+        if (src->format->Amask) {
+            SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_BLEND);
+        } else {
+            SDL_SetColorKey(src, SDL_TRUE, key);
+        }
+        SDL_SetSurfaceRLE(src, 1);
+        ret = SDL_BlitSurface(src, NULL, dst, NULL);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+        SDLTest_AssertCheck(src->flags & SDL_RLEACCEL, "Verify %s surface is RLE encoded", SDL_GetPixelFormatName(formats[i]));
+
+        /* Recolor some rows and change the shape of others */
+        SDL_LockSurface(src);
+        changed = 0;
+        for (y = 3; y < height; y += 7) {
+            Uint32 *row = (Uint32 *)((Uint8 *)src->pixels + y * src->pitch);
+            for (x = 0; x < width; ++x) {
+                if (y % 2) {
+                    row[x] = (x % 4) ? SDL_MapRGBA(src->format, 10, 20, (Uint8)x, 200) : key;
+                } else if (row[x] != key) {
+                    row[x] ^= 0x00010101;
+                }
+            }
+            ++changed;
+        }
+        copy = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, formats[i]);
+        if (copy != NULL) {
+            for (y = 0; y < height; ++y) {
+                SDL_memcpy((Uint8 *)copy->pixels + y * copy->pitch, (Uint8 *)src->pixels + y * src->pitch, width * 4);
+            }
+        }
+        SDL_UnlockSurface(src);
+        SDLTest_AssertCheck(copy != NULL, "Verify copy surface is not NULL");
+        if (copy == NULL) {
+            SDL_FreeSurface(src);
+            SDL_FreeSurface(dst);
+            SDL_FreeSurface(expected);
+            return TEST_ABORTED;
+        }
+        SDLTest_AssertCheck(src->flags & SDL_RLEACCEL, "Verify surface is still RLE encoded after changing %d rows", changed);
+
+        /* The pixels are exactly what was written, transparent ones included */
+        SDL_LockSurface(src);
+        ret = 0;
+        for (y = 0; y < height; ++y) {
+            if (SDL_memcmp((Uint8 *)copy->pixels + y * copy->pitch, (Uint8 *)src->pixels + y * src->pitch, width * 4) != 0) {
+                ++ret;
+            }
+        }
+        SDL_UnlockSurface(src);
+        SDLTest_AssertCheck(ret == 0, "Verify pixels are kept while RLE encoded, expected: 0 changed rows, got: %i", ret);
+
+        /* A clipped blit must match one from a surface encoded from scratch */
+        if (src->format->Amask) {
+            SDL_SetSurfaceBlendMode(copy, SDL_BLENDMODE_BLEND);
+        } else {
+            SDL_SetColorKey(copy, SDL_TRUE, key);
+        }
+        SDL_SetSurfaceRLE(copy, 1);
+        srcrect.x = 5;
+        srcrect.y = 9;
+        srcrect.w = 50;
+        srcrect.h = 25;
+        SDL_FillRect(dst, NULL, SDL_MapRGB(dst->format, 40, 80, 120));
+        SDL_FillRect(expected, NULL, SDL_MapRGB(expected->format, 40, 80, 120));
+        dstrect.x = dstrect.y = 3;
+        ret = SDL_BlitSurface(src, &srcrect, dst, &dstrect);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+        dstrect.x = dstrect.y = 3;
+        ret = SDL_BlitSurface(copy, &srcrect, expected, &dstrect);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+        ret = SDLTest_CompareSurfaces(dst, expected, 0);
+        SDLTest_AssertCheck(ret == 0, "Validate result from SDLTest_CompareSurfaces, expected: 0, got: %i", ret);
+
+        SDL_FreeSurface(copy);
+        SDL_FreeSurface(expected);
+        SDL_FreeSurface(dst);
+        SDL_FreeSurface(src);
+    }
+
+    return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Surface test cases */
@@ -631,11 +1178,27 @@ static const SDLTest_TestCaseReference surfaceTest11 =
 static const SDLTest_TestCaseReference surfaceTest12 =
         { (SDLTest_TestCaseFp)surface_testBlitBlendMod, "surface_testBlitBlendMod", "Tests blitting routines with mod blending mode.", TEST_ENABLED};
 
+static const SDLTest_TestCaseReference surfaceTest13 =
+        { (SDLTest_TestCaseFp)surface_testPremultiplyAlpha, "surface_testPremultiplyAlpha", "Tests alpha premultiplication across pixel formats", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest14 =
+        { (SDLTest_TestCaseFp)surface_testBlitPixelAlpha, "surface_testBlitPixelAlpha", "Tests per-pixel alpha blending with and without alpha mod", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest15 =
+        { (SDLTest_TestCaseFp)surface_testConvertPixelsChannels, "surface_testConvertPixelsChannels", "Tests pixel conversion between RGB and RGBA formats", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest16 =
+        { (SDLTest_TestCaseFp)surface_testBlendPrimitives, "surface_testBlendPrimitives", "Tests blended primitives drawn by the software renderer", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest17 =
+        { (SDLTest_TestCaseFp)surface_testRLEUpdate, "surface_testRLEUpdate", "Tests changing the pixels of RLE encoded surfaces", TEST_ENABLED};
+
 /* Sequence of Surface test cases */
 static const SDLTest_TestCaseReference *surfaceTests[] =  {
     &surfaceTest1, &surfaceTest2, &surfaceTest3, &surfaceTest4, &surfaceTest5,
     &surfaceTest6, &surfaceTest7, &surfaceTest8, &surfaceTest9, &surfaceTest10,
-    &surfaceTest11, &surfaceTest12, NULL
+    &surfaceTest11, &surfaceTest12, &surfaceTest13, &surfaceTest14, &surfaceTest15,
+    &surfaceTest16, &surfaceTest17, NULL
 };
 
 /* Surface test suite (global) */
@@ -0,0 +1,387 @@
+/*
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measures software blit throughput for a matrix of pixel format pairs */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+static const Uint32 blend_src_formats[] = {
+    SDL_PIXELFORMAT_ARGB8888,
+    SDL_PIXELFORMAT_ABGR8888,
+    SDL_PIXELFORMAT_RGBA8888,
+};
+
+static const Uint32 blend_dst_formats[] = {
+    SDL_PIXELFORMAT_ARGB8888,
+    SDL_PIXELFORMAT_ABGR8888,
+    SDL_PIXELFORMAT_RGBA8888,
+    SDL_PIXELFORMAT_RGB888,
+    SDL_PIXELFORMAT_BGR888,
+    SDL_PIXELFORMAT_RGB565,
+    SDL_PIXELFORMAT_BGR565,
+};
+
+static const struct
+{
+    const char *name;
+    Uint32 src_format;
+    Uint32 dst_format;
+} rle_cases[] = {
+    { "colorkey", SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_RGB888 },
+    { "colorkey", SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB565 },
+    { "alpha", SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888 },
+    { "alpha", SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565 },
+};
+
+#define SPRITE_SIZE 64
+
+static const Uint32 convert_formats[] = {
+    SDL_PIXELFORMAT_ARGB8888,
+    SDL_PIXELFORMAT_ABGR8888,
+    SDL_PIXELFORMAT_RGBA8888,
+    SDL_PIXELFORMAT_BGRA8888,
+    SDL_PIXELFORMAT_RGB888,
+    SDL_PIXELFORMAT_RGB24,
+    SDL_PIXELFORMAT_BGR24,
+    SDL_PIXELFORMAT_RGB565,
+};
+
+static SDL_Surface *
+CreateRandomSurface(Uint32 format, int width, int height)
+{
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 0, format);
+    int y, x;
+
+    if (!surface) {
+        SDL_Log("Couldn't create %s surface: %s", SDL_GetPixelFormatName(format), SDL_GetError());
+        return NULL;
+    }
+    for (y = 0; y < height; ++y) {
+        Uint8 *row = (Uint8 *)surface->pixels + y * surface->pitch;
+        for (x = 0; x < surface->pitch; ++x) {
+            row[x] = (Uint8)rand();
+        }
+    }
+    return surface;
+}
+
+/* Returns millions of pixels per second */
+static double
+TimeBlits(SDL_Surface *src, SDL_Surface *dst, int iterations)
+{
+    Uint64 start, elapsed;
+    int i;
+
+    /* The first blit builds the blit map, keep it out of the measurement */
+    SDL_BlitSurface(src, NULL, dst, NULL);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        SDL_BlitSurface(src, NULL, dst, NULL);
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+    return ((double)src->w * src->h * iterations) / ((double)elapsed / SDL_GetPerformanceFrequency()) / 1000000.0;
+}
+
+static int
+BenchmarkBlend(int width, int height, int iterations)
+{
+    int i, j;
+
+    SDL_Log("Per-pixel alpha blending, %dx%d, %d iterations (Mpixels/s)", width, height, iterations);
+    SDL_Log("%-24s %-24s %10s %10s", "source", "destination", "blend", "alpha mod");
+
+    for (i = 0; i < SDL_arraysize(blend_src_formats); ++i) {
+        SDL_Surface *src = CreateRandomSurface(blend_src_formats[i], width, height);
+        if (!src) {
+            return -1;
+        }
+        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_BLEND);
+
+        for (j = 0; j < SDL_arraysize(blend_dst_formats); ++j) {
+            SDL_Surface *dst = CreateRandomSurface(blend_dst_formats[j], width, height);
+            double blend, modulated;
+
+            if (!dst) {
+                SDL_FreeSurface(src);
+                return -1;
+            }
+            SDL_SetSurfaceAlphaMod(src, 255);
+            blend = TimeBlits(src, dst, iterations);
+            SDL_SetSurfaceAlphaMod(src, 192);
+            modulated = TimeBlits(src, dst, iterations);
+
+            SDL_Log("%-24s %-24s %10.1f %10.1f",
+                    SDL_GetPixelFormatName(blend_src_formats[i]),
+                    SDL_GetPixelFormatName(blend_dst_formats[j]),
+                    blend, modulated);
+            SDL_FreeSurface(dst);
+        }
+        SDL_FreeSurface(src);
+    }
+    return 0;
+}
+
+/* A sheet of round sprites on a transparent background, with soft edges if
+   the format has alpha */
+static SDL_Surface *
+CreateSpriteSheet(Uint32 format, int width, int height, int sprite)
+{
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 0, format);
+    const int radius = sprite / 2 - 1;
+    Uint32 key;
+    int y, x;
+
+    if (!surface) {
+        SDL_Log("Couldn't create %s surface: %s", SDL_GetPixelFormatName(format), SDL_GetError());
+        return NULL;
+    }
+    key = SDL_MapRGBA(surface->format, 255, 0, 255, 0);
+    for (y = 0; y < height; ++y) {
+        Uint8 *row = (Uint8 *)surface->pixels + y * surface->pitch;
+        for (x = 0; x < width; ++x) {
+            const int dx = x % sprite - sprite / 2;
+            const int dy = y % sprite - sprite / 2;
+            const int d2 = dx * dx + dy * dy;
+            Uint32 pixel;
+
+            if (d2 < (radius - 2) * (radius - 2)) {
+                pixel = SDL_MapRGBA(surface->format, (Uint8)(x * 4), (Uint8)(y * 4), (Uint8)rand(), 255);
+            } else if (d2 < radius * radius) {
+                pixel = SDL_MapRGBA(surface->format, (Uint8)(x * 4), (Uint8)(y * 4), (Uint8)rand(), 128);
+            } else {
+                pixel = key;
+            }
+            if (surface->format->BytesPerPixel == 2) {
+                ((Uint16 *)row)[x] = (Uint16)pixel;
+            } else {
+                ((Uint32 *)row)[x] = pixel;
+            }
+        }
+    }
+    SDL_SetColorKey(surface, !surface->format->Amask, key);
+    return surface;
+}
+
+/* Returns millions of pixels per second, blitting the sheet sprite by sprite */
+static double
+TimeSpriteBlits(SDL_Surface *sheet, SDL_Surface *dst, int sprite, int iterations)
+{
+    Uint64 start, elapsed;
+    int i, y, x;
+
+    /* The first blit builds the blit map and encodes the sheet */
+    SDL_BlitSurface(sheet, NULL, dst, NULL);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        for (y = 0; y + sprite <= sheet->h; y += sprite) {
+            for (x = 0; x + sprite <= sheet->w; x += sprite) {
+                SDL_Rect srcrect, dstrect;
+                srcrect.x = dstrect.x = x;
+                srcrect.y = dstrect.y = y;
+                srcrect.w = srcrect.h = sprite;
+                SDL_BlitSurface(sheet, &srcrect, dst, &dstrect);
+            }
+        }
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+    return ((double)sheet->w * sheet->h * iterations) / ((double)elapsed / SDL_GetPerformanceFrequency()) / 1000000.0;
+}
+
+/* Returns microseconds per update of a single sprite through lock and unlock */
+static double
+TimeSpriteUpdates(SDL_Surface *sheet, int sprite, int iterations)
+{
+    const int columns = sheet->w / sprite;
+    const int sprites = columns * (sheet->h / sprite);
+    const Uint32 key = SDL_MapRGBA(sheet->format, 255, 0, 255, 0);
+    Uint64 start, elapsed;
+    int i, y, x;
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        const int left = (i % sprites) % columns * sprite;
+        const int top = (i % sprites) / columns * sprite;
+
+        /* touch the visible pixels of one sprite */
+        SDL_LockSurface(sheet);
+        for (y = top; y < top + sprite; ++y) {
+            Uint8 *row = (Uint8 *)sheet->pixels + y * sheet->pitch;
+            for (x = left; x < left + sprite; ++x) {
+                if (sheet->format->BytesPerPixel == 2) {
+                    Uint16 *pixel = (Uint16 *)row + x;
+                    if (*pixel != key) {
+                        *pixel ^= 1;
+                    }
+                } else {
+                    Uint32 *pixel = (Uint32 *)row + x;
+                    if (*pixel != key) {
+                        *pixel ^= 1;
+                    }
+                }
+            }
+        }
+        SDL_UnlockSurface(sheet);
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+    return (double)elapsed * 1000000.0 / SDL_GetPerformanceFrequency() / iterations;
+}
+
+static int
+BenchmarkRLE(int width, int height, int iterations)
+{
+    const int sprite = SDL_min(SPRITE_SIZE, SDL_min(width, height));
+    int i;
+
+    SDL_Log("RLE sprite sheets, %dx%d with %dx%d sprites, %d iterations (Mpixels/s, time per sprite edit)",
+            width, height, sprite, sprite, iterations);
+    SDL_Log("%-10s %-24s %-24s %10s %10s %12s %12s", "sprites", "source", "destination",
+            "plain", "RLE", "plain edit", "RLE edit");
+
+    for (i = 0; i < SDL_arraysize(rle_cases); ++i) {
+        SDL_Surface *sheet = CreateSpriteSheet(rle_cases[i].src_format, width, height, sprite);
+        SDL_Surface *dst = CreateRandomSurface(rle_cases[i].dst_format, width, height);
+        double plain, rle, plain_edit, rle_edit;
+
+        if (!sheet || !dst) {
+            SDL_FreeSurface(sheet);
+            SDL_FreeSurface(dst);
+            return -1;
+        }
+        SDL_SetSurfaceRLE(sheet, 0);
+        plain = TimeSpriteBlits(sheet, dst, sprite, iterations);
+        plain_edit = TimeSpriteUpdates(sheet, sprite, iterations);
+        SDL_SetSurfaceRLE(sheet, 1);
+        rle = TimeSpriteBlits(sheet, dst, sprite, iterations);
+        rle_edit = TimeSpriteUpdates(sheet, sprite, iterations);
+
+        SDL_Log("%-10s %-24s %-24s %10.1f %10.1f %10.1fus %10.1fus", rle_cases[i].name,
+                SDL_GetPixelFormatName(rle_cases[i].src_format),
+                SDL_GetPixelFormatName(rle_cases[i].dst_format),
+                plain, rle, plain_edit, rle_edit);
+        SDL_FreeSurface(dst);
+        SDL_FreeSurface(sheet);
+    }
+    return 0;
+}
+
+static int
+BenchmarkConvert(int width, int height, int iterations)
+{
+    int i, j, k;
+
+    SDL_Log("SDL_ConvertPixels, %dx%d, %d iterations (Mpixels/s)", width, height, iterations);
+    SDL_Log("%-24s %-24s %10s", "source", "destination", "convert");
+
+    for (i = 0; i < SDL_arraysize(convert_formats); ++i) {
+        SDL_Surface *src = CreateRandomSurface(convert_formats[i], width, height);
+        if (!src) {
+            return -1;
+        }
+
+        for (j = 0; j < SDL_arraysize(convert_formats); ++j) {
+            SDL_Surface *dst;
+            Uint64 start, elapsed;
+
+            if (i == j) {
+                continue;
+            }
+            dst = CreateRandomSurface(convert_formats[j], width, height);
+            if (!dst) {
+                SDL_FreeSurface(src);
+                return -1;
+            }
+
+            start = SDL_GetPerformanceCounter();
+            for (k = 0; k < iterations; ++k) {
+                SDL_ConvertPixels(width, height, src->format->format, src->pixels, src->pitch,
+                                  dst->format->format, dst->pixels, dst->pitch);
+            }
+            elapsed = SDL_GetPerformanceCounter() - start;
+            if (elapsed == 0) {
+                elapsed = 1;
+            }
+
+            SDL_Log("%-24s %-24s %10.1f",
+                    SDL_GetPixelFormatName(convert_formats[i]),
+                    SDL_GetPixelFormatName(convert_formats[j]),
+                    ((double)width * height * iterations) / ((double)elapsed / SDL_GetPerformanceFrequency()) / 1000000.0);
+            SDL_FreeSurface(dst);
+        }
+        SDL_FreeSurface(src);
+    }
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int width = 1024;
+    int height = 1024;
+    int iterations = 20;
+    SDL_bool blend = SDL_FALSE;
+    SDL_bool convert = SDL_FALSE;
+    SDL_bool rle = SDL_FALSE;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcmp(argv[i], "--size") == 0 && argv[i + 1] &&
+            SDL_sscanf(argv[i + 1], "%dx%d", &width, &height) == 2 && width > 0 && height > 0) {
+            ++i;
+        } else if (SDL_strcmp(argv[i], "--iterations") == 0 && argv[i + 1] && SDL_atoi(argv[i + 1]) > 0) {
+            iterations = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--blend") == 0) {
+            blend = SDL_TRUE;
+        } else if (SDL_strcmp(argv[i], "--convert") == 0) {
+            convert = SDL_TRUE;
+        } else if (SDL_strcmp(argv[i], "--rle") == 0) {
+            rle = SDL_TRUE;
+        } else {
+            SDL_Log("Usage: %s [--size WxH] [--iterations N] [--blend] [--convert] [--rle]", argv[0]);
+            return 1;
+        }
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s", SDL_GetError());
+        return 1;
+    }
+
+    srand((unsigned int)SDL_GetPerformanceCounter());
+    /* Run everything unless specific benchmarks were asked for */
+    if (!blend && !convert && !rle) {
+        blend = convert = rle = SDL_TRUE;
+    }
+    if ((blend && BenchmarkBlend(width, height, iterations) < 0) ||
+        (convert && BenchmarkConvert(width, height, iterations) < 0) ||
+        (rle && BenchmarkRLE(width, height, iterations) < 0)) {
+        SDL_Quit();
+        return 1;
+    }
+
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -28,6 +28,9 @@ static SDL_Texture **sprites;
 static SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
 static double angle = 0.0;
 static int sprite_w, sprite_h;
+static int benchmark_quads = 0;
+
+#define BENCHMARK_FRAMES    100
 
 int done;
 
@@ -98,6 +101,67 @@ LoadSprite(const char *file)
 }
 
 
+/* Draws a grid of small colored quads with a single call, like an immediate mode GUI would */
+static void
+DrawBenchmarkQuads(SDL_Renderer *renderer, SDL_Texture *texture)
+{
+    SDL_Rect viewport;
+    SDL_Vertex *verts;
+    int *indices;
+    int columns, size, i;
+    float s, c;
+
+    verts = (SDL_Vertex *) SDL_malloc(benchmark_quads * 4 * sizeof(*verts));
+    indices = (int *) SDL_malloc(benchmark_quads * 6 * sizeof(*indices));
+    if (!verts || !indices) {
+        SDL_free(verts);
+        SDL_free(indices);
+        return;
+    }
+
+    SDL_RenderGetViewport(renderer, &viewport);
+    columns = (int) SDL_ceil(SDL_sqrt(benchmark_quads));
+    size = SDL_max(SDL_min(viewport.w, viewport.h) / columns, 4);
+    s = (float) SDL_sin((angle * 3.1415) / 180.0) * size / 8;
+    c = size - s;
+
+    for (i = 0; i < benchmark_quads; ++i) {
+        SDL_Vertex *v = &verts[i * 4];
+        float x = (float) ((i % columns) * size);
+        float y = (float) ((i / columns) * size);
+        int j;
+
+        /* Slightly skewed, so they are rasterized as triangles */
+        v[0].position.x = x + s;
+        v[0].position.y = y;
+        v[1].position.x = x + c;
+        v[1].position.y = y + s;
+        v[2].position.x = x + c - s;
+        v[2].position.y = y + c;
+        v[3].position.x = x;
+        v[3].position.y = y + c - s;
+        for (j = 0; j < 4; ++j) {
+            v[j].color.r = (j == 0 || j == 3) ? 0xFF : (Uint8) (i * 7);
+            v[j].color.g = (j == 1 || j == 3) ? 0xFF : (Uint8) (i * 13);
+            v[j].color.b = (j == 2 || j == 3) ? 0xFF : (Uint8) (i * 29);
+            v[j].color.a = (j == 3) ? 0x80 : 0xFF;
+            v[j].tex_coord.x = (j == 1 || j == 2) ? 1.0f : 0.0f;
+            v[j].tex_coord.y = (j >= 2) ? 1.0f : 0.0f;
+        }
+        indices[i * 6 + 0] = i * 4 + 0;
+        indices[i * 6 + 1] = i * 4 + 1;
+        indices[i * 6 + 2] = i * 4 + 2;
+        indices[i * 6 + 3] = i * 4 + 0;
+        indices[i * 6 + 4] = i * 4 + 2;
+        indices[i * 6 + 5] = i * 4 + 3;
+    }
+
+    SDL_RenderGeometry(renderer, texture, verts, benchmark_quads * 4, indices, benchmark_quads * 6);
+
+    SDL_free(verts);
+    SDL_free(indices);
+}
+
 void
 loop()
 {
@@ -138,7 +202,9 @@ loop()
         SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
         SDL_RenderClear(renderer);
 
-        {
+        if (benchmark_quads > 0) {
+            DrawBenchmarkQuads(renderer, sprites[i]);
+        } else {
             SDL_Rect viewport;
             SDL_Vertex verts[3];
             double a;
@@ -190,6 +256,10 @@ loop()
 
         SDL_RenderPresent(renderer);
     }
+
+    if (benchmark_quads > 0) {
+        angle += 1.0;
+    }
 #ifdef __EMSCRIPTEN__
     if (done) {
         emscripten_cancel_main_loop();
@@ -237,10 +307,15 @@ main(int argc, char *argv[])
             } else if (SDL_strcasecmp(argv[i], "--use-texture") == 0) {
                 use_texture = SDL_TRUE;
                 consumed = 1;
+            } else if (SDL_strcasecmp(argv[i], "--benchmark") == 0) {
+                if (argv[i + 1] && SDL_atoi(argv[i + 1]) > 0) {
+                    benchmark_quads = SDL_atoi(argv[i + 1]);
+                    consumed = 2;
+                }
             }
         }
         if (consumed < 0) {
-            static const char *options[] = { "[--blend none|blend|add|mod]", "[--use-texture]", NULL };
+            static const char *options[] = { "[--blend none|blend|add|mod]", "[--use-texture]", "[--benchmark N]", NULL };
             SDLTest_CommonLogUsage(state, argv[0], options);
             return 1;
         }
@@ -285,6 +360,9 @@ main(int argc, char *argv[])
     while (!done) {
         ++frames;
         loop();
+        if (benchmark_quads > 0 && frames == BENCHMARK_FRAMES) {
+            done = 1;
+        }
         }
 #endif
 
@@ -293,6 +371,9 @@ main(int argc, char *argv[])
     if (now > then) {
         double fps = ((double) frames * 1000) / (now - then);
         SDL_Log("%2.2f frames per second\n", fps);
+        if (benchmark_quads > 0) {
+            SDL_Log("%2.2f quads per second\n", fps * benchmark_quads);
+        }
     }
     
     quit(0);
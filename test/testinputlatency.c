@@ -0,0 +1,214 @@
+/*
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measures how long input takes to reach the application.
+
+   A virtual joystick measures the cost of delivering a state change through
+   the event queue. Then events from real devices are collected while the
+   application pumps events at a fixed frame rate, and their age is measured
+   against their high resolution timestamps. Run it again with
+   SDL_LINUX_INPUT_THREAD=1 to compare with the Linux input thread; see
+   testinputthread for a benchmark that doesn't need real devices.
+ */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define VIRTUAL_ITERATIONS 10000
+
+typedef struct
+{
+    Uint64 count;
+    Uint64 total_ns;
+    Uint64 max_ns;
+} LatencyStats;
+
+static void
+AddSample(LatencyStats *stats, Uint64 ns)
+{
+    ++stats->count;
+    stats->total_ns += ns;
+    if (ns > stats->max_ns) {
+        stats->max_ns = ns;
+    }
+}
+
+static void
+PrintStats(const char *name, const LatencyStats *stats)
+{
+    if (stats->count == 0) {
+        SDL_Log("%-24s no events\n", name);
+        return;
+    }
+    SDL_Log("%-24s %8u events, average %8.1f us, max %8.1f us\n", name,
+            (unsigned int)stats->count,
+            (double)stats->total_ns / stats->count / 1000.0,
+            (double)stats->max_ns / 1000.0);
+}
+
+static SDL_bool
+IsInputEvent(const SDL_Event *event)
+{
+    switch (event->type) {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+    case SDL_MOUSEMOTION:
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+    case SDL_MOUSEWHEEL:
+    case SDL_JOYAXISMOTION:
+    case SDL_JOYHATMOTION:
+    case SDL_JOYBUTTONDOWN:
+    case SDL_JOYBUTTONUP:
+    case SDL_FINGERDOWN:
+    case SDL_FINGERUP:
+    case SDL_FINGERMOTION:
+        return SDL_TRUE;
+    default:
+        return SDL_FALSE;
+    }
+}
+
+static void
+MeasureVirtualJoystick(void)
+{
+    LatencyStats queued, received;
+    SDL_Joystick *joystick;
+    SDL_JoystickID id;
+    SDL_Event event;
+    int device_index, i;
+
+    SDL_zero(queued);
+    SDL_zero(received);
+
+    device_index = SDL_JoystickAttachVirtual(SDL_JOYSTICK_TYPE_GAMECONTROLLER, 0, 1, 0);
+    if (device_index < 0) {
+        SDL_Log("Couldn't attach virtual joystick: %s\n", SDL_GetError());
+        return;
+    }
+    joystick = SDL_JoystickOpen(device_index);
+    if (!joystick) {
+        SDL_Log("Couldn't open virtual joystick: %s\n", SDL_GetError());
+        SDL_JoystickDetachVirtual(device_index);
+        return;
+    }
+    id = SDL_JoystickInstanceID(joystick);
+
+    while (SDL_PollEvent(&event)) {
+        continue;
+    }
+
+    for (i = 0; i < VIRTUAL_ITERATIONS; ++i) {
+        const Uint64 start = SDL_GetTicksNS();
+        SDL_bool done = SDL_FALSE;
+
+        SDL_JoystickSetVirtualButton(joystick, 0, (i & 1) ? SDL_RELEASED : SDL_PRESSED);
+        while (!done) {
+            while (SDL_PollEvent(&event)) {
+                if ((event.type == SDL_JOYBUTTONDOWN || event.type == SDL_JOYBUTTONUP) && event.jbutton.which == id) {
+                    const Uint64 now = SDL_GetTicksNS();
+                    AddSample(&queued, SDL_GetEventTimestampNS(&event) - start);
+                    AddSample(&received, now - start);
+                    done = SDL_TRUE;
+                }
+            }
+        }
+    }
+
+    SDL_JoystickClose(joystick);
+    SDL_JoystickDetachVirtual(device_index);
+
+    PrintStats("virtual joystick queued", &queued);
+    PrintStats("virtual joystick read", &received);
+}
+
+static void
+MeasureDevices(int seconds, int fps)
+{
+    const Uint32 frame_ms = 1000 / fps;
+    LatencyStats stats;
+    SDL_Joystick **joysticks;
+    SDL_Event event;
+    Uint32 end;
+    int i, num_joysticks;
+
+    SDL_zero(stats);
+
+    num_joysticks = SDL_NumJoysticks();
+    joysticks = (SDL_Joystick **)SDL_calloc(num_joysticks + 1, sizeof(*joysticks));
+    for (i = 0; i < num_joysticks; ++i) {
+        joysticks[i] = SDL_JoystickOpen(i);
+    }
+
+    SDL_Log("Reading input devices for %d seconds at %d frames per second, use them now!\n", seconds, fps);
+    end = SDL_GetTicks() + seconds * 1000;
+    while (!SDL_TICKS_PASSED(SDL_GetTicks(), end)) {
+        SDL_Delay(frame_ms);
+
+        while (SDL_PollEvent(&event)) {
+            if (IsInputEvent(&event)) {
+                AddSample(&stats, SDL_GetTicksNS() - SDL_GetEventTimestampNS(&event));
+            }
+        }
+    }
+
+    for (i = 0; i < num_joysticks; ++i) {
+        if (joysticks[i]) {
+            SDL_JoystickClose(joysticks[i]);
+        }
+    }
+    SDL_free(joysticks);
+
+    PrintStats("input devices", &stats);
+}
+
+int
+main(int argc, char *argv[])
+{
+    int seconds = 0;
+    int fps = 60;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcmp(argv[i], "--devices") == 0 && argv[i + 1]) {
+            seconds = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--fps") == 0 && argv[i + 1]) {
+            fps = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("Usage: %s [--devices seconds] [--fps frames-per-second]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (fps <= 0) {
+        fps = 60;
+    }
+
+    if (SDL_Init(SDL_INIT_JOYSTICK | SDL_INIT_EVENTS) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+    SDL_Log("Linux input thread: %s\n", SDL_GetHintBoolean(SDL_HINT_LINUX_INPUT_THREAD, SDL_FALSE) ? "on" : "off");
+
+    MeasureVirtualJoystick();
+    if (seconds > 0) {
+        MeasureDevices(seconds, fps);
+    }
+
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,257 @@
+/*
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmarks the Linux input thread against a mock device, without uinput
+   or real hardware.
+
+   The mock device is a pipe with a kernel buffer about the size of an evdev
+   client buffer. A producer thread writes timestamped input_event records
+   into it at a fixed rate, dropping them when the buffer is full like the
+   kernel does, while the main thread reads it once per frame. The same run
+   is made reading the pipe directly, and through the input thread, which
+   drains the kernel buffer as soon as data arrives.
+
+   This needs internal functions, so it must be linked with the static
+   library.
+ */
+
+#include "../src/SDL_internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+static int run_test(int argc, char *argv[]);
+
+#if defined(__LINUX__) && !SDL_THREADS_DISABLED
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/input.h>
+
+#include "../src/core/linux/SDL_inputthread.h"
+
+typedef struct
+{
+    int fd;
+    int rate;
+    Uint32 duration_ms;
+    SDL_atomic_t dropped;
+    SDL_atomic_t done;
+} MockDevice;
+
+typedef struct
+{
+    Uint64 count;
+    Uint64 total_ns;
+    Uint64 max_ns;
+} LatencyStats;
+
+static void
+AddSample(LatencyStats *stats, Uint64 ns)
+{
+    ++stats->count;
+    stats->total_ns += ns;
+    if (ns > stats->max_ns) {
+        stats->max_ns = ns;
+    }
+}
+
+static int SDLCALL
+MockDeviceThread(void *data)
+{
+    MockDevice *device = (MockDevice *)data;
+    const Uint64 start = SDL_GetTicksNS();
+    const Uint64 end = start + (Uint64)device->duration_ms * 1000000;
+    Uint64 sent = 0;
+    Uint64 now;
+
+    while ((now = SDL_GetTicksNS()) < end) {
+        const Uint64 due = (now - start) * device->rate / 1000000000;
+
+        while (sent < due) {
+            struct input_event event;
+
+            SDL_zero(event);
+            event.time.tv_sec = (long)(now / 1000000000);
+            event.time.tv_usec = (long)((now / 1000) % 1000000);
+            event.type = EV_REL;
+            event.code = REL_X;
+            event.value = 1;
+            if (write(device->fd, &event, sizeof(event)) != sizeof(event)) {
+                SDL_AtomicAdd(&device->dropped, 1);
+            }
+            ++sent;
+        }
+        SDL_Delay(1);
+    }
+    SDL_AtomicSet(&device->done, 1);
+    return 0;
+}
+
+static int
+ReadRecords(int fd, SDL_bool threaded, LatencyStats *stats)
+{
+    struct input_event events[32];
+    int i, len, count = 0;
+
+    for (;;) {
+        if (threaded) {
+            len = SDL_InputThread_Read(fd, events, sizeof(events));
+        } else {
+            len = (int)read(fd, events, sizeof(events));
+        }
+        if (len <= 0) {
+            break;
+        }
+
+        for (i = 0; i < len / (int)sizeof(events[0]); ++i) {
+            const Uint64 sent = (Uint64)events[i].time.tv_sec * 1000000000 + (Uint64)events[i].time.tv_usec * 1000;
+            AddSample(stats, SDL_GetTicksNS() - sent);
+            ++count;
+        }
+    }
+    return count;
+}
+
+static int
+RunMockDevice(SDL_bool threaded, int rate, int fps, int seconds, int buffer_size)
+{
+    const Uint32 frame_ms = 1000 / fps;
+    MockDevice device;
+    LatencyStats stats;
+    SDL_Thread *thread;
+    int fds[2];
+    int received = 0;
+
+    SDL_zero(device);
+    SDL_zero(stats);
+
+    if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) < 0) {
+        return SDL_SetError("Couldn't create pipe: %s", strerror(errno));
+    }
+    /* Rounded up to a page by the kernel */
+    fcntl(fds[1], F_SETPIPE_SZ, buffer_size);
+
+    if (threaded && SDL_InputThread_AddFd(fds[0], sizeof(struct input_event)) < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+
+    device.fd = fds[1];
+    device.rate = rate;
+    device.duration_ms = seconds * 1000;
+    thread = SDL_CreateThread(MockDeviceThread, "MockDevice", &device);
+    if (!thread) {
+        if (threaded) {
+            SDL_InputThread_RemoveFd(fds[0]);
+        }
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+
+    while (!SDL_AtomicGet(&device.done)) {
+        SDL_Delay(frame_ms);
+        received += ReadRecords(fds[0], threaded, &stats);
+    }
+    SDL_WaitThread(thread, NULL);
+    SDL_Delay(frame_ms);
+    received += ReadRecords(fds[0], threaded, &stats);
+
+    if (threaded) {
+        SDL_InputThread_RemoveFd(fds[0]);
+    }
+    close(fds[0]);
+    close(fds[1]);
+
+    SDL_Log("%-14s %8d records, %8d dropped, average %8.1f us, max %8.1f us\n",
+            threaded ? "input thread" : "direct read",
+            received, SDL_AtomicGet(&device.dropped),
+            stats.count ? (double)stats.total_ns / stats.count / 1000.0 : 0.0,
+            (double)stats.max_ns / 1000.0);
+    return 0;
+}
+
+static int
+run_test(int argc, char *argv[])
+{
+    int rate = 8000;
+    int fps = 30;
+    int seconds = 2;
+    int buffer_size = 4096;
+    int i;
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcmp(argv[i], "--rate") == 0 && argv[i + 1]) {
+            rate = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--fps") == 0 && argv[i + 1]) {
+            fps = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--seconds") == 0 && argv[i + 1]) {
+            seconds = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--buffer") == 0 && argv[i + 1]) {
+            buffer_size = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("Usage: %s [--rate records-per-second] [--fps frames-per-second] [--seconds seconds] [--buffer bytes]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (rate <= 0 || fps <= 0 || seconds <= 0 || buffer_size <= 0) {
+        SDL_Log("All values must be positive\n");
+        return 1;
+    }
+
+    SDL_SetHint(SDL_HINT_LINUX_INPUT_THREAD, "1");
+    if (SDL_Init(0) < 0 || !SDL_InputThread_Init()) {
+        SDL_Log("Couldn't start the input thread: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("Mock device writing %d records per second for %d seconds, read at %d frames per second\n", rate, seconds, fps);
+    if (RunMockDevice(SDL_FALSE, rate, fps, seconds, buffer_size) < 0 ||
+        RunMockDevice(SDL_TRUE, rate, fps, seconds, buffer_size) < 0) {
+        SDL_Log("Couldn't run the mock device: %s\n", SDL_GetError());
+        SDL_InputThread_Quit();
+        SDL_Quit();
+        return 1;
+    }
+
+    SDL_InputThread_Quit();
+    SDL_Quit();
+    return 0;
+}
+
+#else /* !__LINUX__ || SDL_THREADS_DISABLED */
+
+static int
+run_test(int argc, char *argv[])
+{
+    SDL_Log("The input thread is only available on Linux\n");
+    return 0;
+}
+
+#endif
+
+int
+main(int argc, char *argv[])
+{
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    return run_test(argc, argv);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
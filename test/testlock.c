@@ -89,6 +89,64 @@ Run(void *data)
     return (0);
 }
 
+#define NUM_BENCHMARK_OPS 1000000
+
+static int SDLCALL
+BenchmarkContended(void *data)
+{
+    int *counter = (int *) data;
+    int i;
+    for (i = 0; i < NUM_BENCHMARK_OPS; ++i) {
+        SDL_LockMutex(mutex);
+        ++*counter;
+        SDL_UnlockMutex(mutex);
+    }
+    return 0;
+}
+
+/* Measure lock/unlock throughput, uncontended and with all workers fighting
+   over the mutex, instead of running the interactive test. */
+static void
+RunBenchmark(int num_threads)
+{
+    Uint64 start, end;
+    double elapsed;
+    int counter = 0;
+    int i;
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_BENCHMARK_OPS; ++i) {
+        SDL_LockMutex(mutex);
+        SDL_UnlockMutex(mutex);
+    }
+    end = SDL_GetPerformanceCounter();
+    elapsed = (double)(end - start) / SDL_GetPerformanceFrequency();
+    SDL_Log("Uncontended: %d lock/unlock pairs in %f sec, %.1f ns each\n",
+            NUM_BENCHMARK_OPS, elapsed, (elapsed * 1e9) / NUM_BENCHMARK_OPS);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < num_threads; ++i) {
+        char name[64];
+        SDL_snprintf(name, sizeof (name), "Bench%d", i);
+        threads[i] = SDL_CreateThread(BenchmarkContended, name, &counter);
+    }
+    for (i = 0; i < num_threads; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+        threads[i] = NULL;
+    }
+    end = SDL_GetPerformanceCounter();
+    elapsed = (double)(end - start) / SDL_GetPerformanceFrequency();
+    SDL_Log("Contended: %d threads, %d lock/unlock pairs in %f sec, %.1f ns each\n",
+            num_threads, num_threads * NUM_BENCHMARK_OPS, elapsed,
+            (elapsed * 1e9) / ((double)num_threads * NUM_BENCHMARK_OPS));
+
+    if (counter != num_threads * NUM_BENCHMARK_OPS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Mutex failed to serialize: counted %d, expected %d\n",
+                     counter, num_threads * NUM_BENCHMARK_OPS);
+        exit(1);
+    }
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -112,6 +170,12 @@ main(int argc, char *argv[])
         exit(1);
     }
 
+    if (argc > 1 && SDL_strcmp(argv[1], "--benchmark") == 0) {
+        RunBenchmark(maxproc);
+        SDL_DestroyMutex(mutex);
+        return (0);
+    }
+
     mainthread = SDL_ThreadID();
     SDL_Log("Main thread: %lu\n", mainthread);
     atexit(printid);
@@ -241,6 +241,50 @@ TestOverheadContended(SDL_bool try_wait)
     SDL_DestroySemaphore(sem);
 }
 
+static SDL_sem *pong_sem;
+
+static int SDLCALL
+ThreadFuncPingPong(void *data)
+{
+    int i;
+    for (i = 0; i < NUM_OVERHEAD_OPS; i++) {
+        SDL_SemWait(sem);
+        SDL_SemPost(pong_sem);
+    }
+    return 0;
+}
+
+static void
+TestPingPongLatency(void)
+{
+    SDL_Thread *thread;
+    Uint64 start, end;
+    double elapsed;
+    int i;
+
+    sem = SDL_CreateSemaphore(0);
+    pong_sem = SDL_CreateSemaphore(0);
+    SDL_Log("Doing %d Post/Wait round trips between two threads\n", NUM_OVERHEAD_OPS);
+
+    thread = SDL_CreateThread(ThreadFuncPingPong, "PingPong", NULL);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_OVERHEAD_OPS; i++) {
+        SDL_SemPost(sem);
+        SDL_SemWait(pong_sem);
+    }
+    end = SDL_GetPerformanceCounter();
+
+    SDL_WaitThread(thread, NULL);
+
+    elapsed = (double)(end - start) / SDL_GetPerformanceFrequency();
+    SDL_Log("Took %d milliseconds, %.2f microseconds per round trip\n\n",
+            (int)(elapsed * 1000.0), (elapsed * 1000000.0) / NUM_OVERHEAD_OPS);
+
+    SDL_DestroySemaphore(pong_sem);
+    SDL_DestroySemaphore(sem);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -275,6 +319,8 @@ main(int argc, char **argv)
 
     TestOverheadContended(SDL_TRUE);
 
+    TestPingPongLatency();
+
     SDL_Quit();
     return (0);
 }
@@ -76,10 +76,52 @@ killed(int sig)
     quit(0);
 }
 
+#define NUM_BENCHMARK_OPS 1000000
+
+/* Time the thread-local storage and error reporting hot paths */
+static void
+RunBenchmark(void)
+{
+    Uint64 start, end;
+    double elapsed;
+    const void *value = NULL;
+    int i;
+
+    SDL_TLSSet(tls, "benchmark", NULL);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_BENCHMARK_OPS; ++i) {
+        value = SDL_TLSGet(tls);
+    }
+    end = SDL_GetPerformanceCounter();
+    elapsed = (double)(end - start) / SDL_GetPerformanceFrequency();
+    SDL_Log("SDL_TLSGet: %d calls in %f sec, %.1f ns each (%s)\n",
+            NUM_BENCHMARK_OPS, elapsed, (elapsed * 1e9) / NUM_BENCHMARK_OPS, (const char *)value);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_BENCHMARK_OPS; ++i) {
+        SDL_SetError("benchmark error %d", i);
+    }
+    end = SDL_GetPerformanceCounter();
+    elapsed = (double)(end - start) / SDL_GetPerformanceFrequency();
+    SDL_Log("SDL_SetError: %d calls in %f sec, %.1f ns each\n",
+            NUM_BENCHMARK_OPS, elapsed, (elapsed * 1e9) / NUM_BENCHMARK_OPS);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_BENCHMARK_OPS; ++i) {
+        value = SDL_GetError();
+    }
+    end = SDL_GetPerformanceCounter();
+    elapsed = (double)(end - start) / SDL_GetPerformanceFrequency();
+    SDL_Log("SDL_GetError: %d calls in %f sec, %.1f ns each (%s)\n",
+            NUM_BENCHMARK_OPS, elapsed, (elapsed * 1e9) / NUM_BENCHMARK_OPS, (const char *)value);
+}
+
 int
 main(int argc, char *argv[])
 {
     int arg = 1;
+    int benchmark = 0;
     SDL_Thread *thread;
 
     /* Enable standard application logging */
@@ -94,6 +136,8 @@ main(int argc, char *argv[])
     while (argv[arg] && *argv[arg] == '-') {
         if (SDL_strcmp(argv[arg], "--prio") == 0) {
             testprio = 1;
+        } else if (SDL_strcmp(argv[arg], "--benchmark") == 0) {
+            benchmark = 1;
         }
         ++arg;
     }
@@ -103,6 +147,11 @@ main(int argc, char *argv[])
     SDL_TLSSet(tls, "main thread", NULL);
     SDL_Log("Main thread data initially: %s\n", (const char *)SDL_TLSGet(tls));
 
+    if (benchmark) {
+        RunBenchmark();
+        quit(0);
+    }
+
     alive = 1;
     thread = SDL_CreateThread(ThreadFunc, "One", "#1");
     if (thread == NULL) {